@@ -0,0 +1,86 @@
+/***************************************************************************************************
+ * @file actionring.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Ring für die von den Arduinos kommenden Actions (Daemon → Plugin).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Die Ringe brauchen lock-freie 32-Bit-Atomics");
+
+const size_t ACTION_LENGTH = 32;    ///< Maximale Länge einer Action `Device;Event;P1;P2` einschließlich '\0'
+
+
+/***************************************************************************************************
+ * @brief Sperrfreier Ring für genau einen Erzeuger (Daemon) und einen Verbraucher (Plugin).
+ *
+ * Die Einträge haben eine feste Länge. @em head und @em tail laufen frei über den ganzen
+ * Wertebereich; der Platz eines Eintrags ergibt sich aus dem Index modulo @em SIZE. Ist der Ring
+ * voll, wird die neue Action verworfen und in @em dropped gezählt; weder Erzeuger noch Verbraucher
+ * warten jemals aufeinander.
+ *
+ * Wie SnapshotRing ohne Zeiger und damit für Shared Memory geeignet.
+ *
+ * @tparam SIZE Anzahl Einträge; eine Zweierpotenz.
+ **************************************************************************************************/
+template <uint32_t SIZE>
+class ActionRing {
+public:
+    static_assert((SIZE >= 2) && ((SIZE & (SIZE - 1)) == 0), "ActionRing braucht eine Zweierpotenz als Größe");
+
+    ActionRing() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * @brief Action anfügen. Nur vom Erzeuger aufrufen.
+     *
+     * @param action Die Action als C-String; höchstens @em ACTION_LENGTH - 1 Zeichen.
+     * @return true Die Action wurde angefügt.
+     * @return false Der Ring ist voll oder die Action zu lang; sie wurde verworfen und gezählt.
+     */
+    bool push(const char *action) {
+        const size_t length = strlen(action);
+        const uint32_t position = head.load(std::memory_order_relaxed);
+        if ((length >= ACTION_LENGTH) || (position - tail.load(std::memory_order_acquire) == SIZE)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        memcpy(entries[position % SIZE], action, length + 1);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Älteste Action entnehmen. Nur vom Verbraucher aufrufen.
+     *
+     * @param action Puffer für mindestens @em ACTION_LENGTH Zeichen.
+     * @return true Die Action wurde nach @em action kopiert.
+     * @return false Der Ring ist leer.
+     */
+    bool pop(char *action) {
+        const uint32_t position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        memcpy(action, entries[position % SIZE], ACTION_LENGTH);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Anzahl der verworfenen Actions seit dem Anlegen.
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> head;         ///< Nächster freier Eintrag; nur der Erzeuger schreibt
+    std::atomic<uint32_t> tail;         ///< Ältester Eintrag; nur der Verbraucher schreibt
+    std::atomic<uint32_t> dropped;      ///< Verworfene Actions; nur der Erzeuger schreibt
+    char entries[SIZE][ACTION_LENGTH];  ///< Die Actions als C-Strings
+};
@@ -0,0 +1,72 @@
+/***************************************************************************************************
+ * @file allocationaudit.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em AllocationAudit und Ersatz für die globalen new/delete.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Nur im Debug-Build bzw. in die Tests linken: Die Ersatzfunktionen gelten für das ganze Programm.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <allocationaudit.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+static thread_local uint32_t flightLoopDepth = 0;   ///< Verschachtelte Scopes im aktuellen Thread
+static std::atomic<uint32_t> violations(0);          ///< Anforderungen im Flight-Loop
+static std::atomic<bool> isAbortOnAllocation(true);  ///< @em false: nur zählen
+
+
+void AllocationAudit::setAbortOnAllocation(const bool isAbort) { isAbortOnAllocation.store(isAbort); }
+uint32_t AllocationAudit::getViolations() { return violations.load(); }
+bool AllocationAudit::isInFlightLoop() { return flightLoopDepth != 0; }
+
+
+void AllocationAudit::noteAllocation() {
+    if (flightLoopDepth != 0) {
+        violations.fetch_add(1);
+        assert(! isAbortOnAllocation.load() && "Speicheranforderung im Flight-Loop");
+    }
+}
+
+
+AllocationAudit::Scope::Scope() { ++flightLoopDepth; }
+AllocationAudit::Scope::~Scope() { --flightLoopDepth; }
+
+
+/**************************************************************************************************
+ * Ersatz für die globalen operator new und operator delete
+ *
+ * Die Array- und nothrow-Varianten rufen nach dem Standard diese Funktionen auf.
+ **************************************************************************************************/
+
+void *operator new(const size_t size) {
+    AllocationAudit::noteAllocation();
+    void *memory = malloc((size == 0) ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+
+void *operator new(const size_t size, const std::align_val_t alignment) {
+    AllocationAudit::noteAllocation();
+    const size_t align = static_cast<size_t>(alignment);
+    void *memory = aligned_alloc(align, ((size + align - 1) / align) * align);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { free(memory); }
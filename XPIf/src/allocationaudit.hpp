@@ -0,0 +1,48 @@
+/***************************************************************************************************
+ * @file allocationaudit.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Prüfung, dass der Sim-Thread im Flight-Loop keinen Speicher vom Heap anfordert.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+
+/***************************************************************************************************
+ * @brief Zählt Speicheranforderungen im Flight-Loop.
+ *
+ * allocationaudit.cpp ersetzt die globalen @em operator new und @em operator delete und wird nur im
+ * Debug-Build bzw. in die Tests mit gelinkt. Solange im aktuellen Thread ein AllocationAudit::Scope
+ * besteht (d.h. im Flight-Loop-Callback), löst jede Anforderung ein @em assert aus; mit
+ * setAbortOnAllocation(false) wird sie nur gezählt, z.B. in einem Test, der das Ergebnis selbst prüft.
+ **************************************************************************************************/
+class AllocationAudit {
+public:
+    /// @brief @em false: Anforderungen im Flight-Loop nur zählen, statt abzubrechen.
+    static void setAbortOnAllocation(bool isAbort);
+
+    /// @brief Anzahl der Anforderungen im Flight-Loop seit dem Start (alle Threads).
+    static uint32_t getViolations();
+
+    /// @brief @em true, solange im aktuellen Thread ein Scope besteht.
+    static bool isInFlightLoop();
+
+    /// @brief Wird von @em operator new aufgerufen.
+    static void noteAllocation();
+
+    /***********************************************************************************************
+     * @brief Markiert den aktuellen Thread für die Dauer des Gültigkeitsbereichs als "im Flight-Loop".
+     **********************************************************************************************/
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+};
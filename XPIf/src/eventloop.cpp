@@ -0,0 +1,443 @@
+/***************************************************************************************************
+ * @file eventloop.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Ereignisschleifen EpollLoop und UringLoop.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <eventloop.hpp>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef XPIF_IO_URING
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+
+EventHandler::~EventHandler() = default;
+
+void EventHandler::onClosed(size_t) {}
+
+EventLoop::~EventLoop() = default;
+
+
+/**************************************************************************************************
+ * EpollLoop
+ **************************************************************************************************/
+
+EpollLoop::EpollLoop() : epollFd(epoll_create1(EPOLL_CLOEXEC)), panels(new Panel[LOOP_MAX_PANELS]) {}
+
+
+EpollLoop::~EpollLoop() {
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+}
+
+
+int EpollLoop::addPanel(const int fd) {
+    if ((epollFd < 0) || (panelCount == LOOP_MAX_PANELS)) {
+        return -1;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = panelCount;
+    ++syscalls;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        return -1;
+    }
+    Panel &panel = panels[panelCount];
+    panel.fd = fd;
+    panel.closed = false;
+    panel.txCount = 0;
+    return static_cast<int>(panelCount++);
+}
+
+
+bool EpollLoop::queueWrite(const size_t index, const char *data, const size_t length) {
+    if ((index >= panelCount) || (length == 0) || (length > LOOP_TX_SLOT_SIZE)) {
+        return false;
+    }
+    Panel &panel = panels[index];
+    if (panel.closed || (panel.txCount == LOOP_TX_SLOTS)) {
+        return false;
+    }
+    memcpy(panel.tx[panel.txCount], data, length);
+    panel.txLength[panel.txCount++] = static_cast<uint8_t>(length);
+    return true;
+}
+
+
+/// Je Nachricht ein write(). Ist der Sendepuffer des Kernels voll, bleibt der Rest für den nächsten Aufruf.
+void EpollLoop::flush() {
+    for (size_t index = 0; index < panelCount; ++index) {
+        Panel &panel = panels[index];
+        size_t written = 0;
+        while (! panel.closed && (written < panel.txCount)) {
+            ++syscalls;
+            const ssize_t result = write(panel.fd, panel.tx[written], panel.txLength[written]);
+            if ((result < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+                break;
+            }
+            if (result != panel.txLength[written]) {
+                ++writeErrors;
+            }
+            ++written;
+        }
+        if (panel.closed) {
+            written = panel.txCount;
+        }
+        if (written != 0) {
+            memmove(panel.tx, panel.tx[written], (panel.txCount - written) * LOOP_TX_SLOT_SIZE);
+            memmove(panel.txLength, panel.txLength + written, panel.txCount - written);
+            panel.txCount -= written;
+        }
+    }
+}
+
+
+size_t EpollLoop::run(const int timeoutMs, EventHandler &handler) {
+    flush();
+    epoll_event events[LOOP_MAX_PANELS];
+    ++syscalls;
+    const int count = epoll_wait(epollFd, events, LOOP_MAX_PANELS, timeoutMs);
+    size_t reported = 0;
+    for (int i = 0; i < count; ++i) {
+        const size_t index = events[i].data.u64;
+        Panel &panel = panels[index];
+        ++syscalls;
+        const ssize_t length = read(panel.fd, rx, sizeof(rx));
+        if (length > 0) {
+            handler.onReceive(index, rx, static_cast<size_t>(length));
+            ++reported;
+        } else if ((length == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+            ++syscalls;
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, panel.fd, nullptr);
+            panel.closed = true;
+            handler.onClosed(index);
+            ++reported;
+        }
+    }
+    return reported;
+}
+
+
+#ifdef XPIF_IO_URING
+
+/**************************************************************************************************
+ * UringLoop
+ **************************************************************************************************/
+
+namespace {
+
+const unsigned URING_ENTRIES = 4096;        ///< SQ; reicht für LOOP_MAX_PANELS Reads und alle Writes
+
+/// user_data einer Completion: Art, Panel und laufende Nummer des Writes
+enum class Operation : uint64_t { READ = 1, WRITE = 2, POLL = 3 };
+
+uint64_t makeUserData(const Operation operation, const size_t panel, const uint32_t sequence) {
+    return (static_cast<uint64_t>(operation) << 56) | (static_cast<uint64_t>(panel) << 32) | sequence;
+}
+
+Operation getOperation(const uint64_t userData) { return static_cast<Operation>(userData >> 56); }
+size_t getPanel(const uint64_t userData) { return static_cast<size_t>((userData >> 32) & 0xffffff); }
+uint32_t getSequence(const uint64_t userData) { return static_cast<uint32_t>(userData); }
+
+}
+
+
+UringLoop::UringLoop() : buffers(new Buffers) {
+    // DEFER_TASKRUN: Die Completion-Arbeit (z.B. der nächste Write einer Kette) läuft nur in
+    // io_uring_enter(GETEVENTS). Sonst läuft sie als task_work mit gesetztem TIF_NOTIFY_SIGNAL, und
+    // n_tty_write() bricht wegen signal_pending() mit -EINTR ab (ab Linux 6.1, sonst Rückfall auf epoll).
+    io_uring_params params = {};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    params.cq_entries = 2 * URING_ENTRIES;
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, URING_ENTRIES, &params));
+    if (ringFd < 0) {
+        setupError = errno;
+        return;
+    }
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool isSingleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (isSingleMmap) {
+        sqRingSize = cqRingSize = (sqRingSize > cqRingSize) ? sqRingSize : cqRingSize;
+    }
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    cqRing = isSingleMmap ? sqRing
+                          : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                                 IORING_OFF_CQ_RING);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqeMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    const iovec registered = {buffers.get(), sizeof(Buffers)};
+    if ((sqRing == MAP_FAILED) || (cqRing == MAP_FAILED) || (sqeMemory == MAP_FAILED)
+            || (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, &registered, 1) != 0)) {
+        setupError = errno;
+        sqRing = (sqRing == MAP_FAILED) ? nullptr : sqRing;
+        cqRing = (cqRing == MAP_FAILED) ? nullptr : cqRing;
+        sqes = (sqeMemory == MAP_FAILED) ? nullptr : static_cast<io_uring_sqe *>(sqeMemory);
+        release();
+        return;
+    }
+    sqes = static_cast<io_uring_sqe *>(sqeMemory);
+    char *sq = static_cast<char *>(sqRing);
+    char *cq = static_cast<char *>(cqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+
+UringLoop::~UringLoop() { release(); }
+
+
+void UringLoop::release() {
+    if (sqes != nullptr) {
+        munmap(sqes, sqesSize);
+    }
+    if ((cqRing != nullptr) && (cqRing != sqRing)) {
+        munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != nullptr) {
+        munmap(sqRing, sqRingSize);
+    }
+    if (ringFd >= 0) {
+        close(ringFd);
+    }
+    sqes = nullptr;
+    sqRing = cqRing = nullptr;
+    ringFd = -1;
+}
+
+
+/// Nächsten freien Eintrag der SQ; ist sie voll, werden die vorhandenen zuerst eingereicht.
+io_uring_sqe *UringLoop::getSqe() {
+    unsigned tail = *sqTail;
+    if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) == sqEntries) {
+        enter(0, 0);
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) == sqEntries) {
+            return nullptr;
+        }
+    }
+    const unsigned index = tail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++pendingSubmissions;
+    return sqe;
+}
+
+
+void UringLoop::submitRead(const size_t index) {
+    io_uring_sqe *sqe = getSqe();
+    if (sqe == nullptr) {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = panels[index].fd;
+    sqe->off = static_cast<uint64_t>(-1);       // aktuelle Position (tty, Socket)
+    sqe->addr = reinterpret_cast<uint64_t>(buffers->rx[index]);
+    sqe->len = LOOP_RX_BUFFER;
+    sqe->buf_index = 0;
+    sqe->user_data = makeUserData(Operation::READ, index, 0);
+}
+
+
+/// Deskriptor mit O_NONBLOCK: der Read endet mit EAGAIN; dann erst auf Lesbarkeit warten.
+void UringLoop::submitPoll(const size_t index) {
+    io_uring_sqe *sqe = getSqe();
+    if (sqe == nullptr) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = panels[index].fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = makeUserData(Operation::POLL, index, 0);
+}
+
+
+void UringLoop::submitWrites() {
+    for (size_t index = 0; index < panelCount; ++index) {
+        Panel &panel = panels[index];
+        while (panel.txSubmitted != panel.txQueued) {
+            io_uring_sqe *sqe = getSqe();
+            if (sqe == nullptr) {
+                return;
+            }
+            const uint32_t sequence = panel.txSubmitted++;
+            const size_t slot = sequence % LOOP_TX_SLOTS;
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = panel.fd;
+            sqe->off = static_cast<uint64_t>(-1);
+            sqe->addr = reinterpret_cast<uint64_t>(buffers->tx[index][slot]);
+            sqe->len = panel.txLength[slot];
+            sqe->buf_index = 0;
+            sqe->flags = (panel.txSubmitted != panel.txQueued) ? IOSQE_IO_LINK : 0;
+            sqe->user_data = makeUserData(Operation::WRITE, index, sequence);
+        }
+    }
+}
+
+
+/**
+ * Ein io_uring_enter: alle eingereichten Einträge abgeben, die Completion-Arbeit ausführen und ggf.
+ * bis zu @em timeoutMs auf @em minComplete Completions warten.
+ */
+int UringLoop::enter(const unsigned minComplete, const int timeoutMs) {
+    __kernel_timespec timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000000LL};
+    io_uring_getevents_arg arg = {};
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(&timeout);
+    ++syscalls;
+    const long result = syscall(__NR_io_uring_enter, ringFd, pendingSubmissions, minComplete,
+                                IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    pendingSubmissions = *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    return static_cast<int>(result);
+}
+
+
+/// Completions auswerten. Empfangenes bleibt im Puffer des Panels, bis deliver() es meldet.
+void UringLoop::reap() {
+    unsigned head = *cqHead;
+    while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        const uint64_t userData = cqe.user_data;
+        const int result = cqe.res;
+        ++head;
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        const size_t index = getPanel(userData);
+        Panel &panel = panels[index];
+        switch (getOperation(userData)) {
+            case Operation::READ:
+                if (result == -EAGAIN) {
+                    submitPoll(index);
+                } else if ((result == -EINTR) || (result == -ECANCELED)) {
+                    submitRead(index);
+                } else {
+                    panel.rxReady = true;
+                    panel.rxResult = result;
+                    ++rxReadyCount;
+                }
+                break;
+            case Operation::POLL:
+                submitRead(index);
+                break;
+            case Operation::WRITE:
+                if (result != panel.txLength[getSequence(userData) % LOOP_TX_SLOTS]) {
+                    ++writeErrors;          // auch -ECANCELED der folgenden Writes einer gebrochenen Kette
+                }
+                ++panel.txDone;
+                break;
+        }
+    }
+}
+
+
+/// Empfangenes und Trennungen melden und die Reads neu einreichen.
+size_t UringLoop::deliver(EventHandler &handler) {
+    size_t reported = 0;
+    for (size_t index = 0; (index < panelCount) && (rxReadyCount != 0); ++index) {
+        Panel &panel = panels[index];
+        if (! panel.rxReady) {
+            continue;
+        }
+        panel.rxReady = false;
+        --rxReadyCount;
+        ++reported;
+        if (panel.rxResult > 0) {
+            handler.onReceive(index, buffers->rx[index], static_cast<size_t>(panel.rxResult));
+            submitRead(index);
+        } else {
+            panel.closed = true;
+            handler.onClosed(index);
+        }
+    }
+    return reported;
+}
+
+
+int UringLoop::addPanel(const int fd) {
+    if ((ringFd < 0) || (panelCount == LOOP_MAX_PANELS)) {
+        return -1;
+    }
+    Panel &panel = panels[panelCount];
+    panel = Panel();
+    panel.fd = fd;
+    submitRead(panelCount);
+    return static_cast<int>(panelCount++);
+}
+
+
+bool UringLoop::queueWrite(const size_t index, const char *data, const size_t length) {
+    if ((index >= panelCount) || (length == 0) || (length > LOOP_TX_SLOT_SIZE)) {
+        return false;
+    }
+    Panel &panel = panels[index];
+    if (panel.closed || (panel.txQueued - panel.txDone == LOOP_TX_SLOTS)) {
+        return false;
+    }
+    const size_t slot = panel.txQueued % LOOP_TX_SLOTS;
+    memcpy(buffers->tx[index][slot], data, length);
+    panel.txLength[slot] = static_cast<uint8_t>(length);
+    ++panel.txQueued;
+    return true;
+}
+
+
+size_t UringLoop::run(const int timeoutMs, EventHandler &handler) {
+    submitWrites();
+    enter((rxReadyCount == 0) ? 1 : 0, timeoutMs);
+    reap();
+    return deliver(handler);
+}
+
+
+/// Jeder Write einer Kette wird erst nach seinem Vorgänger ausgeführt; deshalb bis zu FLUSH_ROUNDS Mal eintreten.
+void UringLoop::flush() {
+    submitWrites();
+    for (int round = 0; round < FLUSH_ROUNDS; ++round) {
+        bool isWriting = false;
+        for (size_t index = 0; index < panelCount; ++index) {
+            isWriting = isWriting || (panels[index].txDone != panels[index].txSubmitted);
+        }
+        if (! isWriting && (pendingSubmissions == 0)) {
+            break;
+        }
+        enter(isWriting ? 1 : 0, FLUSH_TIMEOUT_MS);
+        reap();
+    }
+}
+
+#endif
+
+
+std::unique_ptr<EventLoop> createEventLoop() {
+#ifdef XPIF_IO_URING
+    std::unique_ptr<UringLoop> uring(new UringLoop);
+    if (uring->isValid()) {
+        return uring;
+    }
+#endif
+    return std::unique_ptr<EventLoop>(new EpollLoop);
+}
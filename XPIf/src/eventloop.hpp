@@ -0,0 +1,206 @@
+/***************************************************************************************************
+ * @file eventloop.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Ereignisschleife des Daemons für alle Panels: epoll (Standard) oder io_uring (Build-Option).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Ein einziger Thread bedient alle Panels (Byteströme: tty oder TCP). Empfangene Zeichen gehen an
+ * einen EventHandler; zu sendende Nachrichten werden mit queueWrite() in feste Sendepuffer kopiert
+ * und beim nächsten run() hinausgeschrieben. Beide Schleifen fordern nach dem Anlegen keinen
+ * Speicher mehr an.
+ *
+ * `UringLoop` gibt es nur mit `-DXPIF_IO_URING` (`make IO_URING=1`); createEventLoop() fällt auf
+ * `EpollLoop` zurück, wenn der Kernel io_uring nicht anbietet oder es gesperrt ist (seccomp,
+ * `kernel.io_uring_disabled`). Vgl. Doku/xpif.md, Abschnitt "io_uring als optionales I/O-Backend".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+const size_t LOOP_MAX_PANELS = 64;          ///< Panels je Ereignisschleife
+const size_t LOOP_RX_BUFFER = 256;          ///< Empfangspuffer je Panel
+const size_t LOOP_TX_SLOTS = 32;            ///< Noch nicht geschriebene Nachrichten je Panel
+const size_t LOOP_TX_SLOT_SIZE = 64;        ///< Größte Nachricht (ein USB-Paket des 16U2)
+
+
+/// Empfänger der Ereignisse einer Ereignisschleife.
+class EventHandler {
+public:
+    virtual ~EventHandler();
+
+    /// @brief Zeichen von Panel @em panel empfangen; @em data gilt nur während des Aufrufs.
+    virtual void onReceive(size_t panel, const char *data, size_t length) = 0;
+
+    /// @brief Panel @em panel ist getrennt (EOF oder Fehler); es wird nicht mehr gelesen.
+    virtual void onClosed(size_t panel);
+};
+
+
+/***************************************************************************************************
+ * @brief Schnittstelle der Ereignisschleife.
+ **************************************************************************************************/
+class EventLoop {
+public:
+    virtual ~EventLoop();
+
+    /**
+     * @brief Deskriptor eines Panels übernehmen (er bleibt Eigentum des Aufrufers).
+     *
+     * @return Nummer des Panels; -1, falls alle LOOP_MAX_PANELS belegt sind oder ein Fehler auftrat.
+     */
+    virtual int addPanel(int fd) = 0;
+
+    /**
+     * @brief Nachricht für Panel @em panel vormerken; sie wird beim nächsten run() oder flush() gesendet.
+     *
+     * @return false Nachricht zu lang, Panel getrennt oder alle LOOP_TX_SLOTS belegt.
+     */
+    virtual bool queueWrite(size_t panel, const char *data, size_t length) = 0;
+
+    /**
+     * @brief Vorgemerkte Nachrichten senden, höchstens @em timeoutMs auf Ereignisse warten und sie an
+     *        @em handler melden.
+     *
+     * @return Anzahl der gemeldeten Ereignisse (Empfang oder Trennung).
+     */
+    virtual size_t run(int timeoutMs, EventHandler &handler) = 0;
+
+    /// @brief Vorgemerkte Nachrichten senden, ohne zu warten.
+    virtual void flush() = 0;
+
+    virtual const char *name() const = 0;
+
+    uint64_t getSyscalls() const { return syscalls; }           ///< Systemaufrufe seit dem Anlegen
+    uint64_t getWriteErrors() const { return writeErrors; }     ///< Nicht (vollständig) geschriebene Nachrichten
+
+protected:
+    uint64_t syscalls = 0;
+    uint64_t writeErrors = 0;
+};
+
+
+/***************************************************************************************************
+ * @brief Standard: epoll (level-triggered), ein read() je lesbarem Panel, ein write() je Nachricht.
+ **************************************************************************************************/
+class EpollLoop : public EventLoop {
+public:
+    EpollLoop();
+    ~EpollLoop() override;
+
+    /// @brief false epoll_create1() ist fehlgeschlagen.
+    bool isValid() const { return epollFd >= 0; }
+
+    int addPanel(int fd) override;
+    bool queueWrite(size_t panel, const char *data, size_t length) override;
+    size_t run(int timeoutMs, EventHandler &handler) override;
+    void flush() override;
+    const char *name() const override { return "epoll"; }
+
+private:
+    struct Panel {
+        int fd;
+        bool closed;
+        size_t txCount;
+        uint8_t txLength[LOOP_TX_SLOTS];
+        char tx[LOOP_TX_SLOTS][LOOP_TX_SLOT_SIZE];
+    };
+
+    int epollFd;
+    size_t panelCount = 0;
+    std::unique_ptr<Panel[]> panels;
+    char rx[LOOP_RX_BUFFER];
+};
+
+
+#ifdef XPIF_IO_URING
+
+/***************************************************************************************************
+ * @brief io_uring über die Systemaufrufe direkt (ohne liburing).
+ *
+ * * Alle Empfangs- und Sendepuffer liegen in einem Block, der einmal als Fixed Buffer registriert
+ *   wird (`IORING_REGISTER_BUFFERS`); gelesen und geschrieben wird mit `READ_FIXED`/`WRITE_FIXED`.
+ * * Je Panel ist immer ein Read eingereicht; nach seiner Completion wird er neu eingereicht, und zwar
+ *   im selben `io_uring_enter` wie die nächsten Writes. Multishot-Reads gibt es nur mit bereitgestellten
+ *   Puffern (Buffer Ring, ab Linux 6.7) und nicht zusammen mit registrierten Puffern; sie sind deshalb
+ *   nicht verwendet. Das Neueinreichen kostet keinen zusätzlichen Systemaufruf.
+ * * Die Nachrichten eines Panels werden als verkettete Writes (`IOSQE_IO_LINK`) eingereicht, damit sie
+ *   in Reihenfolge geschrieben werden.
+ * * run() ist genau ein `io_uring_enter`: Einreichen und Warten (mit Timeout, `IORING_ENTER_EXT_ARG`).
+ *   flush() tritt so oft ein, bis alle Writes abgeschlossen sind.
+ **************************************************************************************************/
+class UringLoop : public EventLoop {
+public:
+    UringLoop();
+    ~UringLoop() override;
+
+    /// @brief false io_uring ist nicht verfügbar; @em getSetupError() liefert errno.
+    bool isValid() const { return ringFd >= 0; }
+    int getSetupError() const { return setupError; }
+
+    int addPanel(int fd) override;
+    bool queueWrite(size_t panel, const char *data, size_t length) override;
+    size_t run(int timeoutMs, EventHandler &handler) override;
+    void flush() override;
+    const char *name() const override { return "io_uring"; }
+
+private:
+    static const int FLUSH_ROUNDS = 2 * LOOP_TX_SLOTS;
+    static const int FLUSH_TIMEOUT_MS = 10;
+
+    struct Panel {
+        int fd;
+        bool closed;
+        bool rxReady;                   ///< Read abgeschlossen, noch nicht gemeldet
+        int rxResult;                   ///< Ergebnis des Reads: Länge, 0 (EOF) oder -errno
+        uint32_t txQueued;              ///< Laufende Nummern: vorgemerkt
+        uint32_t txSubmitted;           ///< eingereicht
+        uint32_t txDone;                ///< abgeschlossen
+        uint8_t txLength[LOOP_TX_SLOTS];
+    };
+
+    /// Registrierter Block aller Puffer
+    struct Buffers {
+        char rx[LOOP_MAX_PANELS][LOOP_RX_BUFFER];
+        char tx[LOOP_MAX_PANELS][LOOP_TX_SLOTS][LOOP_TX_SLOT_SIZE];
+    };
+
+    int ringFd = -1;
+    int setupError = 0;
+    void *sqRing = nullptr;
+    size_t sqRingSize = 0;
+    void *cqRing = nullptr;
+    size_t cqRingSize = 0;
+    struct io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned *sqHead = nullptr, *sqTail = nullptr, *sqArray = nullptr;
+    unsigned *cqHead = nullptr, *cqTail = nullptr;
+    unsigned sqMask = 0, sqEntries = 0, cqMask = 0;
+    struct io_uring_cqe *cqes = nullptr;
+    unsigned pendingSubmissions = 0;
+    size_t rxReadyCount = 0;
+
+    size_t panelCount = 0;
+    Panel panels[LOOP_MAX_PANELS] = {};
+    std::unique_ptr<Buffers> buffers;
+
+    void release();
+    struct io_uring_sqe *getSqe();
+    void submitRead(size_t panel);
+    void submitPoll(size_t panel);
+    void submitWrites();
+    int enter(unsigned minComplete, int timeoutMs);
+    void reap();
+    size_t deliver(EventHandler &handler);
+};
+
+#endif
+
+
+/// @brief Ereignisschleife anlegen: io_uring, falls eingebaut und verfügbar, sonst epoll.
+std::unique_ptr<EventLoop> createEventLoop();
@@ -0,0 +1,457 @@
+/***************************************************************************************************
+ * @file expression.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em ExpressionCompiler und @em ExpressionProgram.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <expression.hpp>
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+
+/**************************************************************************************************
+ * ExpressionProgram
+ *
+ **************************************************************************************************/
+
+int ExpressionProgram::find(const char *name) const {
+    for (size_t index = 0; index < results.size(); ++index) {
+        if (results[index].name == name) {
+            return static_cast<int>(index);
+        }
+    }
+    return -1;
+}
+
+
+float ExpressionProgram::roundValue(const float value) { return std::round(value); }
+
+float ExpressionProgram::floorValue(const float value) { return std::floor(value); }
+
+
+/**************************************************************************************************
+ * ExpressionCompiler::Parser - rekursiver Abstieg über eine Zeile
+ *
+ *   expression := comparison [ '?' expression ':' expression ]
+ *   comparison := sum { ('<' | '<=' | '>' | '>=' | '==' | '!=') sum }
+ *   sum        := product { ('+' | '-') product }
+ *   product    := unary { ('*' | '/') unary }
+ *   unary      := '-' unary | primary
+ *   primary    := number | name | function '(' expression { ',' expression } ')' | '(' expression ')'
+ *
+ **************************************************************************************************/
+
+struct ExpressionCompiler::Parser {
+    ExpressionCompiler &compiler;
+    const char *line;
+    const char *pos;
+    unsigned lineNumber;
+    ExpressionError *error;
+
+    /// Fehler an der aktuellen Position melden; es zählt nur der erste.
+    Operand fail(const std::string &message) {
+        if (error->message.empty()) {
+            error->line = lineNumber;
+            error->column = static_cast<unsigned>(pos - line) + 1;
+            error->message = message;
+        }
+        return Operand{true, 0.0f, 0};
+    }
+
+    bool isFailed() const { return ! error->message.empty(); }
+
+    void skipSpace() {
+        while ((*pos == ' ') || (*pos == '\t')) {
+            ++pos;
+        }
+    }
+
+    /// Zeichenfolge @em token überlesen, falls sie als nächstes kommt.
+    bool accept(const char *token) {
+        skipSpace();
+        const size_t length = strlen(token);
+        if (strncmp(pos, token, length) == 0) {
+            pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    /// Einen Namen lesen; leer, falls keiner folgt.
+    std::string readName() {
+        skipSpace();
+        const char *start = pos;
+        if ((isalpha(static_cast<unsigned char>(*pos)) != 0) || (*pos == '_')) {
+            while ((isalnum(static_cast<unsigned char>(*pos)) != 0) || (*pos == '_')) {
+                ++pos;
+            }
+        }
+        return std::string(start, pos);
+    }
+
+    /// Ende der Zeile bzw. Beginn eines Kommentars erreicht?
+    bool atEnd() {
+        skipSpace();
+        return (*pos == '\0') || (*pos == '#') || (*pos == '\r') || (*pos == '\n');
+    }
+
+    Operand expression() {
+        Operand condition = comparison();
+        if (isFailed() || ! accept("?")) {
+            return condition;
+        }
+        const Operand a = expression();
+        if (isFailed()) {
+            return a;
+        }
+        if (! accept(":")) {
+            return fail("':' erwartet");
+        }
+        const Operand b = expression();
+        if (isFailed()) {
+            return b;
+        }
+        return compiler.emitSelect(condition, a, b);
+    }
+
+    Operand comparison() {
+        // Längere Operatoren zuerst, damit "<=" nicht als "<" gelesen wird.
+        static const struct { const char *token; Opcode opcode; } OPERATORS[] = {
+            {"<=", Opcode::LE}, {">=", Opcode::GE}, {"==", Opcode::EQ}, {"!=", Opcode::NE},
+            {"<", Opcode::LT}, {">", Opcode::GT}
+        };
+        Operand left = sum();
+        bool isFound = true;
+        while (! isFailed() && isFound) {
+            isFound = false;
+            for (const auto &op : OPERATORS) {
+                if (accept(op.token)) {
+                    const Operand right = sum();
+                    if (isFailed()) {
+                        return right;
+                    }
+                    left = compiler.emitBinary(op.opcode, left, right);
+                    isFound = true;
+                    break;
+                }
+            }
+        }
+        return left;
+    }
+
+    Operand sum() {
+        Operand left = product();
+        while (! isFailed()) {
+            Opcode opcode;
+            if (accept("+")) {
+                opcode = Opcode::ADD;
+            } else if (accept("-")) {
+                opcode = Opcode::SUB;
+            } else {
+                break;
+            }
+            const Operand right = product();
+            if (isFailed()) {
+                return right;
+            }
+            left = compiler.emitBinary(opcode, left, right);
+        }
+        return left;
+    }
+
+    Operand product() {
+        Operand left = unary();
+        while (! isFailed()) {
+            Opcode opcode;
+            if (accept("*")) {
+                opcode = Opcode::MUL;
+            } else if (accept("/")) {
+                opcode = Opcode::DIV;
+            } else {
+                break;
+            }
+            const Operand right = unary();
+            if (isFailed()) {
+                return right;
+            }
+            left = compiler.emitBinary(opcode, left, right);
+        }
+        return left;
+    }
+
+    Operand unary() {
+        if (accept("-")) {
+            const Operand a = unary();
+            return isFailed() ? a : compiler.emitUnary(Opcode::NEG, a);
+        }
+        return primary();
+    }
+
+    Operand primary() {
+        skipSpace();
+        if (accept("(")) {
+            const Operand a = expression();
+            if (! isFailed() && ! accept(")")) {
+                return fail("')' erwartet");
+            }
+            return a;
+        }
+        if ((isdigit(static_cast<unsigned char>(*pos)) != 0) || (*pos == '.')) {
+            char *end;
+            const float value = strtof(pos, &end);
+            if (end == pos) {
+                return fail("Zahl erwartet");
+            }
+            pos = end;
+            return Operand{true, value, 0};
+        }
+        const char *start = pos;
+        const std::string name = readName();
+        if (name.empty()) {
+            return fail((*pos == '\0') ? "Ausdruck unvollständig" : "Unerwartetes Zeichen");
+        }
+        if (accept("(")) {
+            return function(name, start);
+        }
+        const auto value = compiler.values.find(name);
+        if (value != compiler.values.end()) {
+            return value->second;
+        }
+        const auto dataRef = compiler.dataRefs.find(name);
+        if (dataRef != compiler.dataRefs.end()) {
+            return Operand{false, 0.0f, compiler.loadDataRef(dataRef->second)};
+        }
+        pos = start;
+        return fail("Unbekannter Name '" + name + "'");
+    }
+
+    /// Aufruf einer Funktion; die öffnende Klammer ist schon gelesen.
+    Operand function(const std::string &name, const char *start) {
+        static const struct { const char *name; Opcode opcode; size_t argCount; } FUNCTIONS[] = {
+            {"round", Opcode::ROUND, 1}, {"floor", Opcode::FLOOR, 1}, {"abs", Opcode::ABS, 1},
+            {"min", Opcode::MIN, 2}, {"max", Opcode::MAX, 2}, {"clamp", Opcode::CLAMP, 3}
+        };
+        for (const auto &f : FUNCTIONS) {
+            if (name != f.name) {
+                continue;
+            }
+            Operand args[3];
+            for (size_t arg = 0; arg < f.argCount; ++arg) {
+                if ((arg > 0) && ! accept(",")) {
+                    return fail("',' erwartet");
+                }
+                args[arg] = expression();
+                if (isFailed()) {
+                    return args[arg];
+                }
+            }
+            if (! accept(")")) {
+                return fail("')' erwartet");
+            }
+            switch (f.argCount) {
+                case 1  : return compiler.emitUnary(f.opcode, args[0]);
+                case 2  : return compiler.emitBinary(f.opcode, args[0], args[1]);
+                default : return compiler.emitClamp(args[0], args[1], args[2]);
+            }
+        }
+        pos = start;
+        return fail("Unbekannte Funktion '" + name + "'");
+    }
+};
+
+
+/**************************************************************************************************
+ * ExpressionCompiler - public Methoden
+ *
+ **************************************************************************************************/
+
+void ExpressionCompiler::addDataRef(const std::string &name, const uint16_t snapshotIndex) {
+    dataRefs[name] = snapshotIndex;
+}
+
+
+bool ExpressionCompiler::addLine(const char *line, const unsigned lineNumber, ExpressionError &error) {
+    error = ExpressionError{lineNumber, 0, std::string()};
+    Parser parser{*this, line, line, lineNumber, &error};
+    if (parser.atEnd()) {
+        return true;
+    }
+    const std::string name = parser.readName();
+    if (name.empty()) {
+        parser.fail("Name erwartet");
+        return false;
+    }
+    if ((values.count(name) != 0) || (dataRefs.count(name) != 0)) {
+        parser.pos -= name.size();
+        parser.fail("'" + name + "' ist schon definiert");
+        return false;
+    }
+    if (! parser.accept("=")) {
+        parser.fail("'=' erwartet");
+        return false;
+    }
+
+    // Bei einem Fehler wird alles verworfen, was für diese Zeile schon erzeugt wurde.
+    const size_t codeSize = program.code.size();
+    const size_t constantCount = program.constants.size();
+    const uint16_t registerCount = nextRegister;
+    const auto savedDataRefs = loadedDataRefs;
+    const auto savedConstants = loadedConstants;
+
+    Operand result = parser.expression();
+    if (! parser.isFailed() && ! parser.atEnd()) {
+        parser.fail("Unerwartetes Zeichen");
+    }
+    if (parser.isFailed()) {
+        program.code.resize(codeSize);
+        program.constants.resize(constantCount);
+        nextRegister = registerCount;
+        loadedDataRefs = savedDataRefs;
+        loadedConstants = savedConstants;
+        return false;
+    }
+    program.results.push_back(ExpressionProgram::Result{name, toRegister(result)});
+    values[name] = result;
+    return true;
+}
+
+
+std::vector<ExpressionError> ExpressionCompiler::addText(const char *text) {
+    std::vector<ExpressionError> errors;
+    unsigned lineNumber = 1;
+    while (*text != '\0') {
+        const char *end = strchr(text, '\n');
+        const std::string line = (end == nullptr) ? std::string(text) : std::string(text, end);
+        ExpressionError error;
+        if (! addLine(line.c_str(), lineNumber, error)) {
+            errors.push_back(error);
+        }
+        if (end == nullptr) {
+            break;
+        }
+        text = end + 1;
+        ++lineNumber;
+    }
+    return errors;
+}
+
+
+ExpressionProgram ExpressionCompiler::finish() {
+    program.registers.assign(nextRegister, 0.0f);
+    ExpressionProgram result = std::move(program);
+    program = ExpressionProgram();
+    values.clear();
+    loadedDataRefs.clear();
+    loadedConstants.clear();
+    nextRegister = 0;
+    return result;
+}
+
+
+/**************************************************************************************************
+ * ExpressionCompiler - private Methoden
+ *
+ **************************************************************************************************/
+
+uint16_t ExpressionCompiler::allocateRegister() { return nextRegister++; }
+
+
+uint16_t ExpressionCompiler::toRegister(const Operand &operand) {
+    if (! operand.isConstant) {
+        return operand.reg;
+    }
+    const auto loaded = loadedConstants.find(operand.value);
+    if (loaded != loadedConstants.end()) {
+        return loaded->second;
+    }
+    const uint16_t dst = allocateRegister();
+    emit(Opcode::CONST, dst, static_cast<uint16_t>(program.constants.size()));
+    program.constants.push_back(operand.value);
+    loadedConstants[operand.value] = dst;
+    return dst;
+}
+
+
+uint16_t ExpressionCompiler::loadDataRef(const uint16_t snapshotIndex) {
+    const auto loaded = loadedDataRefs.find(snapshotIndex);
+    if (loaded != loadedDataRefs.end()) {
+        return loaded->second;
+    }
+    const uint16_t dst = allocateRegister();
+    emit(Opcode::LOAD, dst, snapshotIndex);
+    loadedDataRefs[snapshotIndex] = dst;
+    return dst;
+}
+
+
+void ExpressionCompiler::emit(const Opcode opcode, const uint16_t dst, const uint16_t a, const uint16_t b,
+                              const uint16_t c) {
+    program.code.push_back(Instruction{opcode, dst, a, b, c});
+}
+
+
+ExpressionCompiler::Operand ExpressionCompiler::emitUnary(const Opcode opcode, const Operand &a) {
+    if (a.isConstant) {
+        return Operand{true, fold(opcode, a.value, 0.0f, 0.0f), 0};
+    }
+    const uint16_t dst = allocateRegister();
+    emit(opcode, dst, a.reg);
+    return Operand{false, 0.0f, dst};
+}
+
+
+ExpressionCompiler::Operand ExpressionCompiler::emitBinary(const Opcode opcode, const Operand &a, const Operand &b) {
+    if (a.isConstant && b.isConstant) {
+        return Operand{true, fold(opcode, a.value, b.value, 0.0f), 0};
+    }
+    const uint16_t ra = toRegister(a);
+    const uint16_t rb = toRegister(b);
+    const uint16_t dst = allocateRegister();
+    emit(opcode, dst, ra, rb);
+    return Operand{false, 0.0f, dst};
+}
+
+
+ExpressionCompiler::Operand ExpressionCompiler::emitSelect(const Operand &condition, const Operand &a,
+                                                           const Operand &b) {
+    if (condition.isConstant) {
+        return (condition.value != 0.0f) ? a : b;
+    }
+    const uint16_t ra = toRegister(a);
+    const uint16_t rb = toRegister(b);
+    const uint16_t dst = allocateRegister();
+    emit(Opcode::SELECT, dst, condition.reg, ra, rb);
+    return Operand{false, 0.0f, dst};
+}
+
+
+ExpressionCompiler::Operand ExpressionCompiler::emitClamp(const Operand &value, const Operand &low,
+                                                          const Operand &high) {
+    if (value.isConstant && low.isConstant && high.isConstant) {
+        return Operand{true, fold(Opcode::CLAMP, value.value, low.value, high.value), 0};
+    }
+    const uint16_t rv = toRegister(value);
+    const uint16_t rl = toRegister(low);
+    const uint16_t rh = toRegister(high);
+    const uint16_t dst = allocateRegister();
+    emit(Opcode::CLAMP, dst, rv, rl, rh);
+    return Operand{false, 0.0f, dst};
+}
+
+
+/// Rechnet mit einem Programm aus einem Befehl, damit Faltung und Auswertung exakt gleich rechnen.
+float ExpressionCompiler::fold(const Opcode opcode, const float a, const float b, const float c) {
+    ExpressionProgram single;
+    single.code.push_back(Instruction{opcode, 3, 0, 1, 2});
+    single.registers = {a, b, c, 0.0f};
+    single.run(nullptr);
+    return single.registers[3];
+}
@@ -0,0 +1,192 @@
+/***************************************************************************************************
+ * @file expression.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Abgeleitete Werte: Ausdrücke einmal in Bytecode übersetzen und je Frame auswerten.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Die Ausdrücke der Konfiguration (z.B. `QNH = baro * 33.8637526`) werden beim Laden mit dem
+ * ExpressionCompiler übersetzt. Alle Ausdrücke zusammen ergeben ein ExpressionProgram für eine
+ * Registermaschine ohne Sprünge; ExpressionProgram::run() wertet es einmal je Frame auf dem Snapshot
+ * aus, ohne Speicher anzufordern. Vgl. Doku/xpif.md, Abschnitt "Abgeleitete Werte".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/// Befehle der Registermaschine
+enum class Opcode : uint8_t {
+    LOAD,           ///< dst = snapshot[a]
+    CONST,          ///< dst = constants[a]
+    ADD, SUB, MUL, DIV,             ///< dst = a op b
+    NEG,            ///< dst = -a
+    LT, LE, GT, GE, EQ, NE,         ///< dst = (a op b) ? 1 : 0
+    SELECT,         ///< dst = (a != 0) ? b : c
+    ROUND, FLOOR, ABS,              ///< dst = f(a)
+    MIN, MAX,       ///< dst = f(a, b)
+    CLAMP           ///< dst = min(max(a, b), c)
+};
+
+
+/// Ein Befehl; a, b und c sind Quellregister bzw. Snapshot-Index bzw. Index in die Konstantentabelle.
+struct Instruction {
+    Opcode opcode;
+    uint16_t dst;
+    uint16_t a, b, c;
+};
+
+
+/// Ein Fehler beim Übersetzen; Zeile und Spalte zählen ab 1.
+struct ExpressionError {
+    unsigned line;
+    unsigned column;
+    std::string message;
+};
+
+
+/***************************************************************************************************
+ * @brief Übersetztes Programm aller abgeleiteten Werte.
+ *
+ * Register, Konstantentabelle und Befehlsfolge haben nach dem Übersetzen ihre endgültige Größe.
+ * run() fordert keinen Speicher an und hat eine konstante Laufzeit.
+ **************************************************************************************************/
+class ExpressionProgram {
+public:
+    /// @brief Alle Befehle auf dem Snapshot eines Frames ausführen.
+    void run(const float *snapshot) {
+        float *r = registers.data();
+        for (const Instruction &in : code) {
+            switch (in.opcode) {
+                case Opcode::LOAD   : r[in.dst] = snapshot[in.a]; break;
+                case Opcode::CONST  : r[in.dst] = constants[in.a]; break;
+                case Opcode::ADD    : r[in.dst] = r[in.a] + r[in.b]; break;
+                case Opcode::SUB    : r[in.dst] = r[in.a] - r[in.b]; break;
+                case Opcode::MUL    : r[in.dst] = r[in.a] * r[in.b]; break;
+                case Opcode::DIV    : r[in.dst] = r[in.a] / r[in.b]; break;
+                case Opcode::NEG    : r[in.dst] = -r[in.a]; break;
+                case Opcode::LT     : r[in.dst] = (r[in.a] < r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::LE     : r[in.dst] = (r[in.a] <= r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::GT     : r[in.dst] = (r[in.a] > r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::GE     : r[in.dst] = (r[in.a] >= r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::EQ     : r[in.dst] = (r[in.a] == r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::NE     : r[in.dst] = (r[in.a] != r[in.b]) ? 1.0f : 0.0f; break;
+                case Opcode::SELECT : r[in.dst] = (r[in.a] != 0.0f) ? r[in.b] : r[in.c]; break;
+                case Opcode::ROUND  : r[in.dst] = roundValue(r[in.a]); break;
+                case Opcode::FLOOR  : r[in.dst] = floorValue(r[in.a]); break;
+                case Opcode::ABS    : r[in.dst] = (r[in.a] < 0.0f) ? -r[in.a] : r[in.a]; break;
+                case Opcode::MIN    : r[in.dst] = (r[in.b] < r[in.a]) ? r[in.b] : r[in.a]; break;
+                case Opcode::MAX    : r[in.dst] = (r[in.a] < r[in.b]) ? r[in.b] : r[in.a]; break;
+                case Opcode::CLAMP  : {
+                    const float low = (r[in.a] < r[in.b]) ? r[in.b] : r[in.a];
+                    r[in.dst] = (r[in.c] < low) ? r[in.c] : low;
+                    break;
+                }
+            }
+        }
+    }
+
+    /// @brief Index des abgeleiteten Werts @em name; -1, falls er nicht (fehlerfrei) definiert ist.
+    int find(const char *name) const;
+
+    /// @brief Wert Nummer @em index (vgl. find()) nach dem letzten run().
+    float value(const size_t index) const { return registers[results[index].reg]; }
+
+    /// @brief Name des abgeleiteten Werts Nummer @em index.
+    const std::string &name(const size_t index) const { return results[index].name; }
+
+    /// @brief Anzahl der fehlerfrei definierten Werte.
+    size_t valueCount() const { return results.size(); }
+
+    const std::vector<Instruction> &instructions() const { return code; }
+    size_t registerCount() const { return registers.size(); }
+
+private:
+    friend class ExpressionCompiler;
+
+    struct Result {
+        std::string name;
+        uint16_t reg;
+    };
+
+    std::vector<Instruction> code;
+    std::vector<float> constants;
+    std::vector<float> registers;
+    std::vector<Result> results;
+
+    static float roundValue(float value);
+    static float floorValue(float value);
+};
+
+
+/***************************************************************************************************
+ * @brief Übersetzer für die Ausdrücke der Konfiguration (rekursiver Abstieg).
+ *
+ * Sprache: Zahlen, Namen von Datarefs des Snapshots (vorher mit addDataRef() bekannt gemacht) und
+ * vorher definierter Werte, `+ - * /`, Vergleiche `< <= > >= == !=`, `?:`, Klammern und die
+ * Funktionen `round`, `floor`, `abs`, `min`, `max`, `clamp`.
+ *
+ * Konstante Teilausdrücke werden gefaltet, jeder Dataref wird nur einmal geladen und jede Konstante
+ * nur einmal in ein Register gelegt. Eine fehlerhafte Definition erzeugt keinen Code; die übrigen
+ * werden trotzdem übersetzt.
+ **************************************************************************************************/
+class ExpressionCompiler {
+public:
+    /// @brief Namen @em name für den Wert an Index @em snapshotIndex des Snapshots festlegen.
+    void addDataRef(const std::string &name, uint16_t snapshotIndex);
+
+    /**
+     * @brief Eine Zeile der Konfiguration `Name = Ausdruck` übersetzen; leere Zeilen und Kommentare
+     *        (`#`) werden übergangen.
+     *
+     * @param lineNumber Zeilennummer für die Fehlermeldung.
+     * @return false Fehler, beschrieben in @em error; der Wert wird nicht definiert.
+     */
+    bool addLine(const char *line, unsigned lineNumber, ExpressionError &error);
+
+    /**
+     * @brief Alle Zeilen eines Texts übersetzen.
+     *
+     * @return Die Fehler aller fehlerhaften Zeilen.
+     */
+    std::vector<ExpressionError> addText(const char *text);
+
+    /// @brief Das Programm aller bisher fehlerfrei definierten Werte liefern; der Compiler ist danach leer.
+    ExpressionProgram finish();
+
+private:
+    /// Zwischenergebnis beim Übersetzen: Konstante (gefaltet) oder Register.
+    struct Operand {
+        bool isConstant;
+        float value;
+        uint16_t reg;
+    };
+
+    struct Parser;
+
+    std::map<std::string, uint16_t> dataRefs;       ///< Name -> Index im Snapshot
+    std::map<std::string, Operand> values;          ///< Bereits definierte Werte
+    std::map<uint16_t, uint16_t> loadedDataRefs;    ///< Index im Snapshot -> Register
+    std::map<float, uint16_t> loadedConstants;      ///< Konstante -> Register
+    ExpressionProgram program;
+    uint16_t nextRegister = 0;
+
+    uint16_t allocateRegister();
+    uint16_t toRegister(const Operand &operand);
+    uint16_t loadDataRef(uint16_t snapshotIndex);
+    void emit(Opcode opcode, uint16_t dst, uint16_t a, uint16_t b = 0, uint16_t c = 0);
+    Operand emitUnary(Opcode opcode, const Operand &a);
+    Operand emitBinary(Opcode opcode, const Operand &a, const Operand &b);
+    Operand emitSelect(const Operand &condition, const Operand &a, const Operand &b);
+    Operand emitClamp(const Operand &value, const Operand &low, const Operand &high);
+
+    /// Wert einer Operation auf Konstanten (Konstantenfaltung).
+    static float fold(Opcode opcode, float a, float b, float c);
+};
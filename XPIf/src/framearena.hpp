@@ -0,0 +1,107 @@
+/***************************************************************************************************
+ * @file framearena.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Arena für den temporären Speicher eines Flight-Loop-Callbacks.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+
+/***************************************************************************************************
+ * @brief Bump-Allocator für alle temporären Daten im Sim-Thread.
+ *
+ * Der Speicher wird einmal beim Start angefordert und sofort beschrieben, damit im Flight-Loop
+ * weder der Allokator noch ein Page Fault nötig ist. allocate() schiebt nur einen Zeiger weiter, es
+ * gibt kein einzelnes Freigeben; reset() gibt am Ende des Callbacks alles auf einmal frei (vgl.
+ * FrameArena::Scope). Reicht der Platz nicht, liefert allocate() @em nullptr und zählt den Fehler;
+ * die Arena wächst nie.
+ *
+ * Nur von einem Thread benutzen.
+ **************************************************************************************************/
+class FrameArena {
+public:
+    /// @param capacity Größe der Arena in Byte.
+    explicit FrameArena(const size_t capacity)
+        : memory(static_cast<unsigned char *>(::operator new(capacity))), capacity(capacity), offset(0),
+          highWater(0), failures(0) {
+        memset(memory, 0, capacity);    // Seiten sofort anfassen
+    }
+
+    ~FrameArena() { ::operator delete(memory); }
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /**
+     * @brief Speicher aus der Arena holen.
+     *
+     * @param size      Größe in Byte.
+     * @param alignment Ausrichtung; eine Zweierpotenz.
+     * @return Zeiger auf den Speicher; @em nullptr, wenn die Arena für diesen Frame voll ist.
+     */
+    void *allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) {
+        assert((alignment != 0) && ((alignment & (alignment - 1)) == 0));
+        const uintptr_t base = reinterpret_cast<uintptr_t>(memory);
+        const uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const size_t start = aligned - base;
+        if ((start > capacity) || (size > capacity - start)) {
+            ++failures;
+            return nullptr;
+        }
+        offset = start + size;
+        highWater = (offset > highWater) ? offset : highWater;
+        return memory + start;
+    }
+
+    /// @brief Speicher für @em count Objekte vom Typ @em T holen (nicht initialisiert).
+    template <class T>
+    T *allocateArray(const size_t count) {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// @brief Allen Speicher freigeben. Am Ende des Flight-Loop-Callbacks aufrufen.
+    void reset() { offset = 0; }
+
+    /// @brief Im aktuellen Frame belegte Byte.
+    size_t getUsed() const { return offset; }
+
+    /// @brief Größte Belegung seit dem Start; zum Bemessen der Kapazität.
+    size_t getHighWater() const { return highWater; }
+
+    /// @brief Anzahl der Anforderungen, die nicht erfüllt werden konnten.
+    uint32_t getFailures() const { return failures; }
+
+    /***********************************************************************************************
+     * @brief Setzt die Arena beim Verlassen des Gültigkeitsbereichs zurück.
+     *
+     * Am Anfang des Flight-Loop-Callbacks anlegen, dann wird die Arena auf jedem Weg aus dem Callback
+     * zurückgesetzt.
+     **********************************************************************************************/
+    class Scope {
+    public:
+        explicit Scope(FrameArena &arena) : arena(arena) {}
+        ~Scope() { arena.reset(); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        FrameArena &arena;
+    };
+
+private:
+    unsigned char *memory;      ///< Der Speicher der Arena
+    size_t capacity;            ///< Größe von @em memory in Byte
+    size_t offset;              ///< Erstes freies Byte im aktuellen Frame
+    size_t highWater;           ///< Größter Wert von @em offset seit dem Start
+    uint32_t failures;          ///< Nicht erfüllte Anforderungen
+};
@@ -0,0 +1,385 @@
+/***************************************************************************************************
+ * @file logring.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Logging ohne Formatieren und ohne Speicheranforderung im aufrufenden Thread.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Ein Thread (z.B. der Sim-Thread) legt mit LogRing::log() nur einen kompakten LogRecord in seinen
+ * eigenen Ring. LogWriter formatiert die Einträge aller Ringe in einem Hintergrund-Thread, schreibt
+ * sie in eine Datei und gibt die wichtigen Meldungen gesammelt einmal pro Sekunde an eine
+ * Ausgabefunktion (im Plugin XPLMDebugString) weiter.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+const size_t LOG_ARG_COUNT = 4;         ///< Maximale Anzahl Argumente eines Log-Eintrags
+const size_t LOG_LINE_LENGTH = 256;     ///< Maximale Länge einer formatierten Zeile einschließlich '\0'
+
+/// Wichtige Meldungen (Fehler, Start/Stopp) gehen zusätzlich an die Ausgabefunktion des LogWriter.
+enum class LogLevel : uint8_t { INFO, IMPORTANT };
+
+
+/***************************************************************************************************
+ * @brief Ein Log-Eintrag, so wie er im Ring liegt.
+ *
+ * @em format muss ein String mit statischer Lebensdauer sein (ein Literal), weil er erst im
+ * Hintergrund-Thread gelesen wird.
+ **************************************************************************************************/
+struct LogRecord {
+    uint64_t timestamp;             ///< steady_clock in ns
+    const char *format;             ///< printf-Format ohne Längenangaben (%d, %u, %x, %f, %g ...)
+    union {
+        int32_t i;
+        float f;
+    } args[LOG_ARG_COUNT];          ///< Die Argumente
+    uint32_t suppressed;            ///< Seit dem letzten Eintrag dieser Message-Id unterdrückte Einträge
+    uint16_t messageId;
+    LogLevel level;
+    uint8_t argCount;
+    uint8_t floatMask;              ///< Bit n gesetzt: args[n] ist ein float
+};
+
+
+/// @name Argumente eines Log-Eintrags speichern; nur ganze Zahlen und Gleitkommazahlen.
+/// @{
+inline void storeLogArg(LogRecord &record, const int32_t value) {
+    record.args[record.argCount++].i = value;
+}
+
+inline void storeLogArg(LogRecord &record, const uint32_t value) {
+    record.args[record.argCount++].i = static_cast<int32_t>(value);
+}
+
+inline void storeLogArg(LogRecord &record, const float value) {
+    record.floatMask |= static_cast<uint8_t>(1 << record.argCount);
+    record.args[record.argCount++].f = value;
+}
+
+inline void storeLogArg(LogRecord &record, const double value) {
+    storeLogArg(record, static_cast<float>(value));
+}
+/// @}
+
+
+/***************************************************************************************************
+ * @brief Einen Log-Eintrag als Zeile formatieren.
+ *
+ * Die Zeile hat die Form `<Sekunden> [<Message-Id>] <Text>` mit angehängtem `(n unterdrückt)` und
+ * '\\n'. Jede Umwandlung im Format verbraucht ein Argument; passt dessen Typ nicht zur Umwandlung,
+ * wird es umgerechnet. Längenangaben (l, h, z ...) werden ignoriert, überzählige Umwandlungen
+ * unverändert ausgegeben.
+ *
+ * @return Länge der Zeile ohne '\\0'.
+ **************************************************************************************************/
+inline size_t formatLogRecord(const LogRecord &record, char *line, const size_t size) {
+    assert(size > 0);
+    size_t length = static_cast<size_t>(snprintf(line, size, "%10.3f [%u] ", record.timestamp / 1e9,
+                                                 static_cast<unsigned>(record.messageId)));
+    length = (length < size) ? length : size - 1;
+    uint8_t arg = 0;
+    for (const char *c = record.format; (*c != '\0') && (length + 1 < size); ++c) {
+        if (*c != '%') {
+            line[length++] = *c;
+            continue;
+        }
+        if (c[1] == '%') {
+            line[length++] = '%';
+            ++c;
+            continue;
+        }
+        // Umwandlung ohne Längenangaben nach spec kopieren
+        char spec[16] = "%";
+        size_t specLength = 1;
+        const char *end = c + 1;
+        while ((*end != '\0') && (strchr("diouxXcfFeEgGaA", *end) == nullptr)) {
+            if ((strchr("hlLqjzt", *end) == nullptr) && (specLength + 2 < sizeof(spec))) {
+                spec[specLength++] = *end;
+            }
+            ++end;
+        }
+        if ((*end == '\0') || (arg >= record.argCount)) {
+            line[length++] = *c;
+            continue;
+        }
+        spec[specLength++] = *end;
+        spec[specLength] = '\0';
+        const bool isFloat = (record.floatMask & (1 << arg)) != 0;
+        int written;
+        if (strchr("fFeEgGaA", *end) != nullptr) {
+            written = snprintf(line + length, size - length, spec,
+                               isFloat ? static_cast<double>(record.args[arg].f) : record.args[arg].i);
+        } else {
+            written = snprintf(line + length, size - length, spec,
+                               isFloat ? static_cast<int>(record.args[arg].f) : record.args[arg].i);
+        }
+        length += (written > 0) ? static_cast<size_t>(written) : 0;
+        length = (length < size) ? length : size - 1;
+        ++arg;
+        c = end;
+    }
+    if (record.suppressed > 0) {
+        const int written = snprintf(line + length, size - length, " (%u unterdrückt)",
+                                     static_cast<unsigned>(record.suppressed));
+        length += (written > 0) ? static_cast<size_t>(written) : 0;
+        length = (length < size) ? length : size - 1;
+    }
+    length = (length + 1 < size) ? length : size - 2;
+    line[length++] = '\n';
+    line[length] = '\0';
+    return length;
+}
+
+
+/***************************************************************************************************
+ * @brief Sperrfreier Ring von Log-Einträgen für genau einen Erzeuger und den LogWriter.
+ *
+ * Jeder Thread, der loggt, hat seinen eigenen Ring. Je Message-Id lässt ein Token-Bucket höchstens
+ * @em ratePerSecond Einträge pro Sekunde durch; die übrigen werden nur gezählt und beim nächsten
+ * erlaubten Eintrag als LogRecord::suppressed mitgegeben. Ist der Ring voll, wird der Eintrag
+ * verworfen und in @em dropped gezählt. log() wartet also nie, formatiert nicht und fordert keinen
+ * Speicher an.
+ *
+ * @tparam SIZE        Anzahl Einträge; eine Zweierpotenz.
+ * @tparam MESSAGE_IDS Anzahl der Message-Ids (0 .. MESSAGE_IDS - 1).
+ **************************************************************************************************/
+template <uint32_t SIZE, uint16_t MESSAGE_IDS>
+class LogRing {
+public:
+    static_assert((SIZE >= 2) && ((SIZE & (SIZE - 1)) == 0), "LogRing braucht eine Zweierpotenz als Größe");
+
+    /// @param ratePerSecond Erlaubte Einträge je Message-Id und Sekunde; zugleich die Größe des Buckets.
+    explicit LogRing(const uint32_t ratePerSecond = 10)
+        : head(0), tail(0), dropped(0), interval(1000000000ULL / ratePerSecond),
+          tolerance((ratePerSecond - 1) * (1000000000ULL / ratePerSecond)), limits() {}
+
+    /**
+     * @brief Eintrag mit der aktuellen Zeit anlegen. Nur vom Erzeuger aufrufen.
+     *
+     * @param args Höchstens @em LOG_ARG_COUNT Werte vom Typ int32_t, uint32_t, float oder double.
+     * @return true Der Eintrag liegt im Ring.
+     * @return false Der Eintrag wurde unterdrückt oder verworfen.
+     */
+    template <class... Args>
+    bool log(const LogLevel level, const uint16_t messageId, const char *format, const Args... args) {
+        const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        return logAt(now, level, messageId, format, args...);
+    }
+
+    /// @brief Wie log(), aber mit vorgegebenem Zeitstempel in ns.
+    template <class... Args>
+    bool logAt(const uint64_t now, const LogLevel level, const uint16_t messageId, const char *format,
+               const Args... args) {
+        static_assert(sizeof...(Args) <= LOG_ARG_COUNT, "Zu viele Argumente für einen Log-Eintrag");
+        assert(messageId < MESSAGE_IDS);
+        Limit &limit = limits[messageId];
+        // Token-Bucket als "Generic Cell Rate Algorithm": nextTime ist der Zeitpunkt, zu dem der Bucket
+        // wieder voll wäre.
+        if (now + tolerance < limit.nextTime) {
+            ++limit.suppressed;
+            return false;
+        }
+        const uint32_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) == SIZE) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        limit.nextTime = ((limit.nextTime > now) ? limit.nextTime : now) + interval;
+
+        LogRecord &record = records[position % SIZE];
+        record.timestamp = now;
+        record.format = format;
+        record.suppressed = limit.suppressed;
+        record.messageId = messageId;
+        record.level = level;
+        record.argCount = 0;
+        record.floatMask = 0;
+        (storeLogArg(record, args), ...);
+        head.store(position + 1, std::memory_order_release);
+        limit.suppressed = 0;
+        return true;
+    }
+
+    /**
+     * @brief Ältesten Eintrag entnehmen. Nur vom Verbraucher aufrufen.
+     *
+     * @return false Der Ring ist leer.
+     */
+    bool pop(LogRecord &record) {
+        const uint32_t position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = records[position % SIZE];
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Anzahl der wegen eines vollen Rings verworfenen Einträge seit dem Anlegen.
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    /// Zustand des Token-Buckets einer Message-Id; nur der Erzeuger liest und schreibt ihn.
+    struct Limit {
+        uint64_t nextTime;
+        uint32_t suppressed;
+    };
+
+    std::atomic<uint32_t> head;         ///< Nächster freier Eintrag; nur der Erzeuger schreibt
+    std::atomic<uint32_t> tail;         ///< Ältester Eintrag; nur der Verbraucher schreibt
+    std::atomic<uint32_t> dropped;      ///< Verworfene Einträge; nur der Erzeuger schreibt
+    const uint64_t interval;            ///< Abstand zweier Tokens in ns
+    const uint64_t tolerance;           ///< Größe des Buckets (ohne das erste Token) in ns
+    Limit limits[MESSAGE_IDS];
+    LogRecord records[SIZE];
+};
+
+
+/***************************************************************************************************
+ * @brief Hintergrund-Thread, der die Log-Ringe leert und in eine Datei schreibt.
+ *
+ * Alle @em DRAIN_INTERVAL_MS werden die Einträge aller Ringe formatiert und mit einem fwrite() je
+ * Durchgang in die Datei geschrieben. Zeilen mit LogLevel::IMPORTANT werden außerdem gesammelt und
+ * höchstens einmal pro Sekunde (und beim Anhalten) mit einem einzigen Aufruf an @em debugString
+ * übergeben. Neu verworfene Einträge eines Rings werden als eigene Zeile gemeldet.
+ *
+ * @tparam SIZE, MESSAGE_IDS Wie bei LogRing.
+ **************************************************************************************************/
+template <uint32_t SIZE, uint16_t MESSAGE_IDS>
+class LogWriter {
+public:
+    static const size_t MAX_SOURCES = 4;            ///< Maximale Anzahl Ringe (Threads, die loggen)
+    static const unsigned DRAIN_INTERVAL_MS = 10;
+
+    using Ring = LogRing<SIZE, MESSAGE_IDS>;
+
+    /**
+     * @param file        Ziel der formatierten Zeilen; bleibt im Besitz des Aufrufers.
+     * @param debugString Ausgabe für wichtige Meldungen, z.B. XPLMDebugString; darf @em nullptr sein.
+     */
+    LogWriter(FILE *file, void (*debugString)(const char *))
+        : file(file), debugString(debugString), sourceCount(0), isRunning(false) {
+        important.reserve(4096);
+        batch.reserve(SIZE * 64);
+    }
+
+    ~LogWriter() { stop(); }
+
+    LogWriter(const LogWriter &) = delete;
+    LogWriter &operator=(const LogWriter &) = delete;
+
+    /// @brief Ring hinzufügen; nur vor start() aufrufen. @return false Es gibt schon @em MAX_SOURCES Ringe.
+    bool addSource(Ring &ring) {
+        if (sourceCount == MAX_SOURCES) {
+            return false;
+        }
+        sources[sourceCount] = &ring;
+        reportedDrops[sourceCount] = 0;
+        ++sourceCount;
+        return true;
+    }
+
+    /// @brief Hintergrund-Thread starten.
+    void start() {
+        isRunning = true;
+        thread = std::thread(&LogWriter::run, this);
+    }
+
+    /// @brief Hintergrund-Thread anhalten; alle noch vorhandenen Einträge werden vorher geschrieben.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (! isRunning) {
+                return;
+            }
+            isRunning = false;
+        }
+        wakeUp.notify_one();
+        thread.join();
+    }
+
+private:
+    /// Alle Ringe einmal leeren. @return Anzahl der geschriebenen Zeilen.
+    size_t drain() {
+        size_t lines = 0;
+        batch.clear();
+        for (size_t source = 0; source < sourceCount; ++source) {
+            LogRecord record;
+            while (sources[source]->pop(record)) {
+                const size_t length = formatLogRecord(record, line, sizeof(line));
+                batch.append(line, length);
+                if (record.level == LogLevel::IMPORTANT) {
+                    important.append(line, length);
+                }
+                ++lines;
+            }
+            const uint32_t dropped = sources[source]->getDropped();
+            if (dropped != reportedDrops[source]) {
+                const int length = snprintf(line, sizeof(line), "Log-Ring %u: %u Einträge verworfen\n",
+                                            static_cast<unsigned>(source), dropped - reportedDrops[source]);
+                batch.append(line, static_cast<size_t>(length));
+                reportedDrops[source] = dropped;
+            }
+        }
+        if (! batch.empty()) {
+            fwrite(batch.data(), 1, batch.size(), file);
+            fflush(file);
+        }
+        return lines;
+    }
+
+    /// Gesammelte wichtige Meldungen mit einem Aufruf ausgeben.
+    void flushImportant() {
+        if ((debugString != nullptr) && ! important.empty()) {
+            debugString(important.c_str());
+        }
+        important.clear();
+    }
+
+    void run() {
+        auto lastFlush = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (isRunning) {
+            wakeUp.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL_MS));
+            lock.unlock();
+            drain();
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastFlush >= std::chrono::seconds(1)) {
+                flushImportant();
+                lastFlush = now;
+            }
+            lock.lock();
+        }
+        lock.unlock();
+        drain();
+        flushImportant();
+    }
+
+    FILE *file;
+    void (*debugString)(const char *);
+    Ring *sources[MAX_SOURCES];
+    uint32_t reportedDrops[MAX_SOURCES];    ///< Bereits gemeldete verworfene Einträge je Ring
+    size_t sourceCount;
+    std::string batch;                      ///< Zeilen eines Durchgangs
+    std::string important;                  ///< Gesammelte wichtige Meldungen
+    char line[LOG_LINE_LENGTH];
+    bool isRunning;                         ///< Durch @em mutex geschützt
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread thread;
+};
@@ -0,0 +1,87 @@
+/***************************************************************************************************
+ * @file messagewriter.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Nachrichten an die Panels `DEV;EVENT;P1;P2\n` ohne printf zusammensetzen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+/***************************************************************************************************
+ * @brief Setzt eine Nachricht im Format der Panels (siehe Doku/kommunikation.md) in einen Puffer.
+ *
+ * Felder werden mit ';' getrennt, finish() hängt '\n' an. Zahlen werden ohne printf umgewandelt,
+ * auf Wunsch mit führenden Nullen (z.B. Squawk `0700`, Uhrzeit `093000`). Passt die Nachricht nicht
+ * in den Puffer, liefert finish() 0; der Puffer enthält dann keine gültige Nachricht.
+ *
+ *     MessageWriter(buffer, sizeof(buffer)).text("XPDR").text("CODE").number(700, 4).finish();
+ **************************************************************************************************/
+class MessageWriter {
+public:
+    MessageWriter(char *buffer, const size_t size) : buffer(buffer), size(size), length(0), fields(0), isOverflow(false) {}
+
+    /// @brief Text als nächstes Feld.
+    MessageWriter &text(const char *field) {
+        separate();
+        while (*field != '\0') {
+            put(*field++);
+        }
+        return *this;
+    }
+
+    /// @brief Ganze Zahl als nächstes Feld, mit führenden Nullen auf mindestens @em width Stellen.
+    MessageWriter &number(const int32_t value, const uint8_t width = 0) {
+        separate();
+        uint32_t magnitude = (value < 0) ? 0U - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+        char digits[10];
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            put('-');
+        }
+        for (size_t i = count; i < width; ++i) {
+            put('0');
+        }
+        while (count > 0) {
+            put(digits[--count]);
+        }
+        return *this;
+    }
+
+    /// @brief '\n' anhängen. @return Länge der Nachricht; 0, falls sie nicht in den Puffer passt.
+    size_t finish() {
+        put('\n');
+        return isOverflow ? 0 : length;
+    }
+
+private:
+    void separate() {
+        if (fields++ != 0) {
+            put(';');
+        }
+    }
+
+    void put(const char c) {
+        if (length < size) {
+            buffer[length++] = c;
+        } else {
+            isOverflow = true;
+        }
+    }
+
+    char *buffer;
+    size_t size;
+    size_t length;
+    size_t fields;
+    bool isOverflow;
+};
@@ -0,0 +1,409 @@
+/***************************************************************************************************
+ * @file metrics.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em Metrics, @em PanelMetrics und @em MetricsServer.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <metrics.hpp>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/// Quantile, die für jedes Histogramm auf der Seite stehen.
+static const double QUANTILES[] = {0.5, 0.9, 0.99};
+
+
+/**************************************************************************************************
+ * MetricsShard
+ *
+ **************************************************************************************************/
+
+MetricsShard::MetricsShard() {
+    for (std::atomic<uint64_t> &counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (size_t histogram = 0; histogram < METRICS_MAX_HISTOGRAMS; ++histogram) {
+        for (std::atomic<uint64_t> &bucket : buckets[histogram]) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        sumsNs[histogram].store(0, std::memory_order_relaxed);
+    }
+}
+
+
+uint64_t MetricsShard::bucketStartNs(const size_t bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    const size_t octave = (bucket - 1) / 2;
+    const uint64_t start = 1000ULL << octave;
+    return ((bucket - 1) % 2 == 0) ? start : start + start / 2;
+}
+
+
+/**************************************************************************************************
+ * Metrics
+ *
+ **************************************************************************************************/
+
+Metrics::Metrics()
+    : gauges(new std::atomic<double>[METRICS_MAX_GAUGES]), shards(new MetricsShard[METRICS_MAX_THREADS]),
+      shardCount(0) {
+    for (size_t gauge = 0; gauge < METRICS_MAX_GAUGES; ++gauge) {
+        gauges[gauge].store(0, std::memory_order_relaxed);
+    }
+}
+
+
+int Metrics::addCounter(const std::string &name) {
+    if (counterNames.size() == METRICS_MAX_COUNTERS) {
+        return -1;
+    }
+    counterNames.push_back(name);
+    return static_cast<int>(counterNames.size() - 1);
+}
+
+
+int Metrics::addGauge(const std::string &name) {
+    if (gaugeNames.size() == METRICS_MAX_GAUGES) {
+        return -1;
+    }
+    gaugeNames.push_back(name);
+    return static_cast<int>(gaugeNames.size() - 1);
+}
+
+
+int Metrics::addHistogram(const std::string &name) {
+    if (histogramNames.size() == METRICS_MAX_HISTOGRAMS) {
+        return -1;
+    }
+    histogramNames.push_back(name);
+    return static_cast<int>(histogramNames.size() - 1);
+}
+
+
+MetricsShard *Metrics::addThread() {
+    const size_t shard = shardCount.load(std::memory_order_relaxed);
+    if (shard == METRICS_MAX_THREADS) {
+        return nullptr;
+    }
+    shardCount.store(shard + 1, std::memory_order_release);
+    return &shards[shard];
+}
+
+
+uint64_t Metrics::getCounter(const size_t counter) const {
+    uint64_t sum = 0;
+    const size_t count = shardCount.load(std::memory_order_acquire);
+    for (size_t shard = 0; shard < count; ++shard) {
+        sum += shards[shard].counters[counter].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+
+void Metrics::sumBuckets(const size_t histogram, uint64_t *buckets, uint64_t &count, uint64_t &sumNs) const {
+    count = 0;
+    sumNs = 0;
+    const size_t shardTotal = shardCount.load(std::memory_order_acquire);
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        buckets[bucket] = 0;
+        for (size_t shard = 0; shard < shardTotal; ++shard) {
+            buckets[bucket] += shards[shard].buckets[histogram][bucket].load(std::memory_order_relaxed);
+        }
+        count += buckets[bucket];
+    }
+    for (size_t shard = 0; shard < shardTotal; ++shard) {
+        sumNs += shards[shard].sumsNs[histogram].load(std::memory_order_relaxed);
+    }
+}
+
+
+uint64_t Metrics::getQuantileNs(const size_t histogram, const double q) const {
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+    uint64_t count, sumNs;
+    sumBuckets(histogram, buckets, count, sumNs);
+    if (count == 0) {
+        return 0;
+    }
+    // Innerhalb der Klasse linear interpolieren
+    const double rank = q * static_cast<double>(count);
+    uint64_t below = 0;
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        if ((buckets[bucket] > 0) && (static_cast<double>(below + buckets[bucket]) >= rank)) {
+            const uint64_t start = MetricsShard::bucketStartNs(bucket);
+            const uint64_t end = (bucket + 1 < HISTOGRAM_BUCKETS) ? MetricsShard::bucketStartNs(bucket + 1) : start + start / 2;
+            const double fraction = (rank - static_cast<double>(below)) / static_cast<double>(buckets[bucket]);
+            return start + static_cast<uint64_t>(fraction * static_cast<double>(end - start));
+        }
+        below += buckets[bucket];
+    }
+    return MetricsShard::bucketStartNs(HISTOGRAM_BUCKETS - 1);
+}
+
+
+/// Name bis '{'.
+static std::string familyOf(const std::string &name) { return name.substr(0, name.find('{')); }
+
+/// Labels einschließlich der Klammern; leer, falls keine.
+static std::string labelsOf(const std::string &name) {
+    const size_t brace = name.find('{');
+    return (brace == std::string::npos) ? std::string() : name.substr(brace);
+}
+
+/// Label an die Labels von @em name anhängen.
+static std::string withLabel(const std::string &name, const std::string &label) {
+    const size_t brace = name.find('{');
+    if (brace == std::string::npos) {
+        return name + "{" + label + "}";
+    }
+    return name.substr(0, name.size() - 1) + "," + label + "}";
+}
+
+
+/// `# TYPE`-Zeile, falls mit @em name ein neuer Name beginnt.
+static void appendType(std::string &page, std::string &family, const std::string &name, const char *type) {
+    if (familyOf(name) != family) {
+        family = familyOf(name);
+        page += "# TYPE " + family + " " + type + "\n";
+    }
+}
+
+
+std::string Metrics::render() const {
+    std::string page;
+    std::string family;
+    char value[64];
+    for (size_t counter = 0; counter < counterNames.size(); ++counter) {
+        appendType(page, family, counterNames[counter], "counter");
+        snprintf(value, sizeof(value), " %llu\n", static_cast<unsigned long long>(getCounter(counter)));
+        page += counterNames[counter] + value;
+    }
+    for (size_t gauge = 0; gauge < gaugeNames.size(); ++gauge) {
+        appendType(page, family, gaugeNames[gauge], "gauge");
+        snprintf(value, sizeof(value), " %.9g\n", gauges[gauge].load(std::memory_order_relaxed));
+        page += gaugeNames[gauge] + value;
+    }
+    for (size_t histogram = 0; histogram < histogramNames.size(); ++histogram) {
+        const std::string &name = histogramNames[histogram];
+        appendType(page, family, name, "summary");
+        for (const double q : QUANTILES) {
+            snprintf(value, sizeof(value), "quantile=\"%g\"", q);
+            const std::string line = withLabel(name, value);
+            snprintf(value, sizeof(value), " %.9g\n", getQuantileNs(histogram, q) / 1e9);
+            page += line + value;
+        }
+        uint64_t buckets[HISTOGRAM_BUCKETS];
+        uint64_t count, sumNs;
+        sumBuckets(histogram, buckets, count, sumNs);
+        snprintf(value, sizeof(value), " %.9g\n", sumNs / 1e9);
+        page += familyOf(name) + "_sum" + labelsOf(name) + value;
+        snprintf(value, sizeof(value), " %llu\n", static_cast<unsigned long long>(count));
+        page += familyOf(name) + "_count" + labelsOf(name) + value;
+    }
+    return page;
+}
+
+
+/**************************************************************************************************
+ * PanelMetrics
+ *
+ **************************************************************************************************/
+
+bool PanelMetrics::add(Metrics &metrics, const std::string &panel) {
+    const std::string label = "panel=\"" + panel + "\"";
+    messagesIn = metrics.addCounter("xpif_panel_messages_total{" + label + ",dir=\"in\"}");
+    messagesOut = metrics.addCounter("xpif_panel_messages_total{" + label + ",dir=\"out\"}");
+    bytesIn = metrics.addCounter("xpif_panel_bytes_total{" + label + ",dir=\"in\"}");
+    bytesOut = metrics.addCounter("xpif_panel_bytes_total{" + label + ",dir=\"out\"}");
+    dropped = metrics.addCounter("xpif_panel_dropped_total{" + label + "}");
+    parseErrors = metrics.addCounter("xpif_panel_errors_total{" + label + ",kind=\"parse\"}");
+    queueDepth = metrics.addGauge("xpif_panel_queue_depth{" + label + "}");
+    loopAverage = metrics.addGauge("xpif_panel_loop_seconds{" + label + ",stat=\"avg\"}");
+    loopMax = metrics.addGauge("xpif_panel_loop_seconds{" + label + ",stat=\"max\"}");
+    freeRam = metrics.addGauge("xpif_panel_free_ram_bytes{" + label + "}");
+    minFreeRam = metrics.addGauge("xpif_panel_min_free_ram_bytes{" + label + "}");
+    rtt = metrics.addHistogram("xpif_panel_rtt_seconds{" + label + "}");
+    return (messagesIn >= 0) && (messagesOut >= 0) && (bytesIn >= 0) && (bytesOut >= 0) && (dropped >= 0) &&
+           (parseErrors >= 0) && (queueDepth >= 0) && (loopAverage >= 0) && (loopMax >= 0) && (freeRam >= 0) &&
+           (minFreeRam >= 0) && (rtt >= 0);
+}
+
+
+/// Zwei ganze Zahlen "<a>;<b>" mit optionalem Zeilenende lesen.
+static bool parsePair(const char *text, long &first, long &second) {
+    char *end;
+    first = strtol(text, &end, 10);
+    if ((end == text) || (*end != ';')) {
+        return false;
+    }
+    text = end + 1;
+    second = strtol(text, &end, 10);
+    return (end != text) && ((*end == '\0') || (*end == '\r') || (*end == '\n'));
+}
+
+
+bool PanelMetrics::parseStats(Metrics &metrics, const char *line) const {
+    long first, second;
+    if ((strncmp(line, "SYS;LOOP;", 9) == 0) && parsePair(line + 9, first, second)) {
+        metrics.setGauge(static_cast<size_t>(loopAverage), first / 1e6);
+        metrics.setGauge(static_cast<size_t>(loopMax), second / 1e6);
+        return true;
+    }
+    if ((strncmp(line, "SYS;RAM;", 8) == 0) && parsePair(line + 8, first, second)) {
+        metrics.setGauge(static_cast<size_t>(freeRam), static_cast<double>(first));
+        metrics.setGauge(static_cast<size_t>(minFreeRam), static_cast<double>(second));
+        return true;
+    }
+    return false;
+}
+
+
+/**************************************************************************************************
+ * MetricsServer
+ *
+ **************************************************************************************************/
+
+bool MetricsServer::listenUnix(const std::string &path) {
+    sockaddr_un address;
+    if ((listener >= 0) || (path.size() >= sizeof(address.sun_path))) {
+        return false;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if ((listener < 0) || (bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) ||
+        (listen(listener, 4) != 0)) {
+        if (listener >= 0) {
+            close(listener);
+        }
+        listener = -1;
+        return false;
+    }
+    unixPath = path;
+    return true;
+}
+
+
+bool MetricsServer::listenTcp(const uint16_t requestedPort) {
+    if (listener >= 0) {
+        return false;
+    }
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(requestedPort);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    const int yes = 1;
+    listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if ((listener < 0) || (setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0) ||
+        (bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) ||
+        (listen(listener, 4) != 0) || (getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0)) {
+        if (listener >= 0) {
+            close(listener);
+        }
+        listener = -1;
+        return false;
+    }
+    port = ntohs(address.sin_port);
+    return true;
+}
+
+
+bool MetricsServer::start() {
+    if ((listener < 0) || thread.joinable() || (pipe2(wakeUp, O_CLOEXEC) != 0)) {
+        return false;
+    }
+    thread = std::thread(&MetricsServer::run, this);
+    return true;
+}
+
+
+void MetricsServer::stop() {
+    if (thread.joinable()) {
+        const char stop = 0;
+        if (write(wakeUp[1], &stop, 1) != 1) {
+            perror("MetricsServer::stop");
+        }
+        thread.join();
+    }
+    for (int &fd : wakeUp) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (listener >= 0) {
+        close(listener);
+        listener = -1;
+    }
+    if (! unixPath.empty()) {
+        unlink(unixPath.c_str());
+        unixPath.clear();
+    }
+}
+
+
+void MetricsServer::run() {
+    pollfd fds[2] = {{listener, POLLIN, 0}, {wakeUp[0], POLLIN, 0}};
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            const int client = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                serve(client);
+                close(client);
+            }
+        }
+    }
+}
+
+
+/// Anfrage lesen (höchstens 100 ms warten, Inhalt egal), Seite senden.
+void MetricsServer::serve(const int client) {
+    char request[1024];
+    pollfd readable = {client, POLLIN, 0};
+    if ((poll(&readable, 1, 100) == 1) && (read(client, request, sizeof(request)) < 0)) {
+        return;
+    }
+    const std::string body = metrics.render();
+    char header[128];
+    const int length = snprintf(header, sizeof(header),
+                                "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+                                body.size());
+    const std::string response = std::string(header, static_cast<size_t>(length)) + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    scrapes.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,193 @@
+/***************************************************************************************************
+ * @file metrics.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Zähler von XPIf und der Panels als Textseite im Prometheus-Format.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Jeder Thread zählt in seinen eigenen MetricsShard (nur dieser Thread schreibt, `relaxed`, ohne
+ * atomare Addition). Erst beim Abruf der Seite summiert Metrics::render() alle Shards und berechnet
+ * die Quantile der Histogramme. MetricsServer liefert die Seite in einem eigenen Thread über einen
+ * Unix-Domain-Socket oder 127.0.0.1 aus. Vgl. Doku/xpif.md, Abschnitt "Metriken".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+const size_t METRICS_MAX_COUNTERS = 256;
+const size_t METRICS_MAX_GAUGES = 128;
+const size_t METRICS_MAX_HISTOGRAMS = 32;
+const size_t METRICS_MAX_THREADS = 4;
+const size_t HISTOGRAM_BUCKETS = 48;    ///< Halbe Oktaven ab 1 µs (bis etwa 16 s)
+
+
+/***************************************************************************************************
+ * @brief Zähler und Histogramme eines Threads.
+ *
+ * Die Klassen eines Histogramms sind halbe Oktaven: [0, 1 µs), [1, 2 µs), [2, 3 µs), [3, 4 µs),
+ * [4, 6 µs), [6, 8 µs) ...; ein Quantil ist damit auf etwa ±20 % genau.
+ **************************************************************************************************/
+struct alignas(64) MetricsShard {
+    std::atomic<uint64_t> counters[METRICS_MAX_COUNTERS];
+    std::atomic<uint64_t> buckets[METRICS_MAX_HISTOGRAMS][HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> sumsNs[METRICS_MAX_HISTOGRAMS];
+
+    MetricsShard();
+
+    /// @brief Zähler @em counter um @em n erhöhen. Nur vom eigenen Thread aufrufen.
+    void add(const size_t counter, const uint64_t n = 1) {
+        counters[counter].store(counters[counter].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /// @brief Dauer @em ns im Histogramm @em histogram zählen. Nur vom eigenen Thread aufrufen.
+    void observe(const size_t histogram, const uint64_t ns) {
+        std::atomic<uint64_t> &bucket = buckets[histogram][bucketOf(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sumsNs[histogram].store(sumsNs[histogram].load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    }
+
+    /// @brief Klasse einer Dauer in ns.
+    static size_t bucketOf(const uint64_t ns) {
+        const uint64_t us = ns / 1000;
+        if (us == 0) {
+            return 0;
+        }
+        const int octave = 63 - __builtin_clzll(us);
+        const size_t half = (octave > 0) ? (us >> (octave - 1)) & 1 : 0;
+        const size_t bucket = 1 + 2 * static_cast<size_t>(octave) + half;
+        return (bucket < HISTOGRAM_BUCKETS) ? bucket : HISTOGRAM_BUCKETS - 1;
+    }
+
+    /// @brief Untere Grenze der Klasse @em bucket in ns.
+    static uint64_t bucketStartNs(size_t bucket);
+};
+
+
+/***************************************************************************************************
+ * @brief Alle Metriken eines Prozesses.
+ *
+ * Die Namen enthalten die Labels, z.B. `xpif_panel_bytes_total{panel="m803",dir="out"}`. Metriken
+ * mit demselben Namen vor '{' sollten nacheinander angelegt werden, damit die Seite je Name nur eine
+ * `# TYPE`-Zeile hat. Anlegen (add...) nur vor dem Start der Threads; die Werte dürfen danach aus
+ * beliebigen Threads gelesen werden.
+ **************************************************************************************************/
+class Metrics {
+public:
+    Metrics();
+
+    /// @return Nummer des Zählers; -1, falls METRICS_MAX_COUNTERS erreicht ist.
+    int addCounter(const std::string &name);
+
+    /// @return Nummer des Werts; -1, falls METRICS_MAX_GAUGES erreicht ist.
+    int addGauge(const std::string &name);
+
+    /// @brief Histogramm einer Dauer; auf der Seite als Summary (Quantile 0.5, 0.9, 0.99, _sum, _count).
+    /// @return Nummer des Histogramms; -1, falls METRICS_MAX_HISTOGRAMS erreicht ist.
+    int addHistogram(const std::string &name);
+
+    /// @brief Shard für den aufrufenden Thread anlegen. @return nullptr, falls METRICS_MAX_THREADS erreicht ist.
+    MetricsShard *addThread();
+
+    /// @brief Wert setzen (z.B. Länge einer Warteschlange); aus beliebigen Threads.
+    void setGauge(const size_t gauge, const double value) { gauges[gauge].store(value, std::memory_order_relaxed); }
+
+    /// @brief Summe eines Zählers über alle Shards.
+    uint64_t getCounter(size_t counter) const;
+
+    /// @brief Quantil @em q (0 .. 1) eines Histogramms über alle Shards in ns; 0 ohne Werte.
+    uint64_t getQuantileNs(size_t histogram, double q) const;
+
+    /// @brief Die Seite im Prometheus-Textformat.
+    std::string render() const;
+
+private:
+    void sumBuckets(size_t histogram, uint64_t *buckets, uint64_t &count, uint64_t &sumNs) const;
+
+    std::vector<std::string> counterNames;
+    std::vector<std::string> gaugeNames;
+    std::vector<std::string> histogramNames;
+    std::unique_ptr<std::atomic<double>[]> gauges;
+    std::unique_ptr<MetricsShard[]> shards;
+    std::atomic<size_t> shardCount;
+};
+
+
+/***************************************************************************************************
+ * @brief Die Metriken eines Panels, alle mit dem Label `panel="<Name>"`.
+ *
+ * Zähler schreibt der I/O-Thread; Umlaufzeit, Dauer des loop() und freies RAM stammen aus den
+ * Antworten auf `SYS;PING` und `SYS;STAT` (siehe Doku/kommunikation.md, Abschnitt Diagnose).
+ **************************************************************************************************/
+struct PanelMetrics {
+    int messagesIn = -1, messagesOut = -1;      ///< Zähler
+    int bytesIn = -1, bytesOut = -1;
+    int dropped = -1;                           ///< Verworfene Nachrichten (Warteschlange voll)
+    int parseErrors = -1;                       ///< Vom Parser verworfene Zeilen (statt CRC-Fehlern)
+    int queueDepth = -1;                        ///< Werte
+    int loopAverage = -1, loopMax = -1;
+    int freeRam = -1, minFreeRam = -1;
+    int rtt = -1;                               ///< Histogramm
+
+    /// @return false Eine der Metriken konnte nicht angelegt werden.
+    bool add(Metrics &metrics, const std::string &panel);
+
+    /**
+     * @brief `SYS;LOOP;<Mittel>;<Max>` oder `SYS;RAM;<frei>;<min>` in die Werte übernehmen.
+     *
+     * @return false Keine dieser Zeilen.
+     */
+    bool parseStats(Metrics &metrics, const char *line) const;
+};
+
+
+/***************************************************************************************************
+ * @brief Liefert Metrics::render() an jeden, der sich verbindet (HTTP/1.0, danach wird getrennt).
+ *
+ * Ein eigener Thread wartet mit poll() auf Verbindungen; eine Anfrage wird nicht ausgewertet, jede
+ * bekommt die Seite. Nur lokal: Unix-Domain-Socket oder 127.0.0.1.
+ **************************************************************************************************/
+class MetricsServer {
+public:
+    explicit MetricsServer(const Metrics &metrics) : metrics(metrics) {}
+    ~MetricsServer() { stop(); }
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    /// @brief Auf dem Unix-Domain-Socket @em path lauschen (eine alte Datei wird ersetzt).
+    bool listenUnix(const std::string &path);
+
+    /// @brief Auf 127.0.0.1:@em port lauschen; 0 wählt einen freien Port (getPort()).
+    bool listenTcp(uint16_t port);
+
+    uint16_t getPort() const { return port; }
+
+    /// @brief Thread starten. @return false Es wird noch nicht gelauscht oder die Pipe fehlt.
+    bool start();
+
+    /// @brief Thread anhalten und den Socket schließen.
+    void stop();
+
+    uint64_t getScrapes() const { return scrapes.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve(int client);
+
+    const Metrics &metrics;
+    int listener = -1;
+    int wakeUp[2] = {-1, -1};
+    uint16_t port = 0;
+    std::string unixPath;
+    std::atomic<uint64_t> scrapes{0};
+    std::thread thread;
+};
@@ -0,0 +1,173 @@
+/***************************************************************************************************
+ * @file navindex.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em NavIndex, @em NavStations und @em NavIdentTracker.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <navindex.hpp>
+#include <messagewriter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const double EARTH_RADIUS_NM = 3440.065;
+const double NM_PER_DEGREE = 60.0;          ///< Breitengrad
+const double PI = 3.14159265358979323846;
+const double MAX_RANGE_NAV = 200.0;         ///< Größte Reichweite je Gruppe (VOR bzw. NDB)
+const double MAX_RANGE_ADF = 75.0;
+
+
+double rangeOf(const NavType type) {
+    switch (type) {
+    case NavType::VOR:
+    case NavType::DME:
+        return 200.0;
+    case NavType::NDB:
+        return 75.0;
+    case NavType::ILS:
+    case NavType::LOC:
+        return 25.0;
+    }
+    return 0.0;
+}
+
+
+double distanceNm(const double lat1, const double lon1, const double lat2, const double lon2) {
+    const double toRad = PI / 180.0;
+    const double sinLat = std::sin((lat2 - lat1) * toRad / 2);
+    const double sinLon = std::sin((lon2 - lon1) * toRad / 2);
+    const double a = sinLat * sinLat + std::cos(lat1 * toRad) * std::cos(lat2 * toRad) * sinLon * sinLon;
+    return 2 * EARTH_RADIUS_NM * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+
+/**************************************************************************************************
+ * NavIndex
+ *
+ **************************************************************************************************/
+
+NavIndex::NavIndex(std::vector<NavEntry> entries) : entries(std::move(entries)) {
+    std::vector<NavEntry> &sorted = this->entries;
+    std::sort(sorted.begin(), sorted.end(), [](const NavEntry &a, const NavEntry &b) {
+        const uint32_t keyA = keyOf(groupOf(a.type), a.frequency);
+        const uint32_t keyB = keyOf(groupOf(b.type), b.frequency);
+        return (keyA != keyB) ? keyA < keyB : a.lat < b.lat;
+    });
+    size_t ranges = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        ranges += ((i == 0) || (keyOf(groupOf(sorted[i].type), sorted[i].frequency) !=
+                                keyOf(groupOf(sorted[i - 1].type), sorted[i - 1].frequency))) ? 1 : 0;
+    }
+    size_t capacity = 16;
+    while (capacity < 2 * ranges) {
+        capacity *= 2;
+    }
+    slots.assign(capacity, Slot{0, 0, 0});
+    for (size_t begin = 0; begin < sorted.size();) {
+        const uint32_t key = keyOf(groupOf(sorted[begin].type), sorted[begin].frequency);
+        size_t end = begin + 1;
+        while ((end < sorted.size()) && (keyOf(groupOf(sorted[end].type), sorted[end].frequency) == key)) {
+            ++end;
+        }
+        size_t slot = slotOf(key);
+        while (slots[slot].key != 0) {
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+        slots[slot] = Slot{key, static_cast<uint32_t>(begin), static_cast<uint32_t>(end)};
+        begin = end;
+    }
+}
+
+
+const NavEntry *NavIndex::findNearest(const NavGroup group, const uint16_t frequency, const double lat,
+                                      const double lon) const {
+    const uint32_t key = keyOf(group, frequency);
+    size_t slot = slotOf(key);
+    while ((slots[slot].key != key) && (slots[slot].key != 0)) {
+        slot = (slot + 1) & (slots.size() - 1);
+    }
+    if (slots[slot].key == 0) {
+        return nullptr;
+    }
+    const double band = ((group == NavGroup::ADF) ? MAX_RANGE_ADF : MAX_RANGE_NAV) / NM_PER_DEGREE;
+    const NavEntry *const end = entries.data() + slots[slot].end;
+    const NavEntry *entry = std::lower_bound(entries.data() + slots[slot].begin, end, lat - band,
+                                             [](const NavEntry &e, const double value) { return e.lat < value; });
+    const NavEntry *nearest = nullptr;
+    double nearestNm = 0.0;
+    for (; (entry != end) && (entry->lat <= lat + band); ++entry) {
+        const double nm = distanceNm(lat, lon, entry->lat, entry->lon);
+        if ((nm <= rangeOf(entry->type)) && ((nearest == nullptr) || (nm < nearestNm))) {
+            nearest = entry;
+            nearestNm = nm;
+        }
+    }
+    return nearest;
+}
+
+
+/**************************************************************************************************
+ * NavStations
+ *
+ **************************************************************************************************/
+
+NavStations::~NavStations() {
+    if (builder.joinable()) {
+        builder.join();
+    }
+    delete published.load(std::memory_order_acquire);
+}
+
+
+void NavStations::build() {
+    if (builder.joinable()) {
+        builder.join();
+    }
+    delete published.exchange(nullptr, std::memory_order_acq_rel);
+    std::vector<NavEntry> entries;
+    entries.swap(collected);
+    builder = std::thread([this](std::vector<NavEntry> entries) {
+        NavIndex *index = new NavIndex(std::move(entries));
+        published.store(index, std::memory_order_release);
+    }, std::move(entries));
+}
+
+
+const NavEntry *NavStations::findNearest(const NavGroup group, const uint16_t frequency, const double lat,
+                                         const double lon) const {
+    const NavIndex *index = published.load(std::memory_order_acquire);
+    return (index != nullptr) ? index->findNearest(group, frequency, lat, lon) : nullptr;
+}
+
+
+/**************************************************************************************************
+ * NavIdentTracker
+ *
+ **************************************************************************************************/
+
+size_t NavIdentTracker::update(const NavStations &stations, const uint16_t frequency, const double lat,
+                               const double lon, char *message, const size_t size) {
+    const bool isReady = stations.isReady();
+    if (isQueried && isReady && (frequency == lastFrequency) && (distanceNm(lat, lon, lastLat, lastLon) < NAV_REQUERY_NM)) {
+        return 0;
+    }
+    isQueried = isReady;
+    lastFrequency = frequency;
+    lastLat = lat;
+    lastLon = lon;
+    char current[NAV_IDENT_LENGTH + 1] = "";
+    const NavEntry *station = stations.findNearest(group, frequency, lat, lon);
+    if (station != nullptr) {
+        memcpy(current, station->ident, NAV_IDENT_LENGTH);
+    }
+    if (strcmp(current, ident) == 0) {
+        return 0;
+    }
+    memcpy(ident, current, sizeof(ident));
+    return MessageWriter(message, size).text(device).text("IDNT").text(ident).finish();
+}
@@ -0,0 +1,160 @@
+/***************************************************************************************************
+ * @file navindex.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Index der Navigationsdatenbank: Kennung der nächsten Station zur eingestellten Frequenz.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Der Flight-Loop übernimmt je Frame höchstens NAV_READ_PER_FRAME Navaids aus `XPLMGetNextNavAid`/
+ * `XPLMGetNavAidInfo` mit NavStations::add(). NavStations::build() sortiert sie in einem
+ * Hintergrund-Thread zu einem NavIndex und veröffentlicht ihn per Zeigertausch; bis dahin bleibt die
+ * Kennung leer. NavIdentTracker fragt bei einer Frequenzänderung oder nach NAV_REQUERY_NM Flugstrecke
+ * neu ab und meldet nur eine geänderte Kennung. Vgl. Doku/xpif.md, Abschnitt "Stationskennung".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+const size_t NAV_READ_PER_FRAME = 2000;     ///< Navaids je Frame beim Einlesen
+const size_t NAV_IDENT_LENGTH = 5;          ///< Längste Kennung (ohne '\0')
+const double NAV_REQUERY_NM = 5.0;          ///< Neue Abfrage nach dieser Flugstrecke
+
+
+/// Typ eines Navaids; das Plugin bildet die Typen von `XPLMNavType` darauf ab.
+enum class NavType : uint8_t { VOR, DME, ILS, LOC, NDB };
+
+/// Typ-Gruppe: NAV-Empfänger (VOR, DME, ILS, LOC) oder ADF (NDB).
+enum class NavGroup : uint8_t { NAV, ADF };
+
+inline NavGroup groupOf(const NavType type) { return (type == NavType::NDB) ? NavGroup::ADF : NavGroup::NAV; }
+
+/// Reichweite eines Navaids in NM.
+double rangeOf(NavType type);
+
+/// Großkreisentfernung in NM.
+double distanceNm(double lat1, double lon1, double lat2, double lon2);
+
+
+/// Ein Navaid, 16 Byte.
+struct NavEntry {
+    float lat;
+    float lon;
+    uint16_t frequency;                     ///< Wie im SDK: NAV in 10 kHz (11030), NDB in kHz (350)
+    char ident[NAV_IDENT_LENGTH];           ///< Ohne '\0', falls 5 Zeichen lang
+    NavType type;
+};
+
+static_assert(sizeof(NavEntry) == 16, "NavEntry soll 16 Byte groß sein");
+
+
+/***************************************************************************************************
+ * @brief Unveränderlicher Index, sortiert nach (Typ-Gruppe, Frequenz, Breite).
+ *
+ * Eine Hashtabelle (offene Adressierung) liefert zu Typ-Gruppe und Frequenz den Bereich im
+ * sortierten Array. Darin begrenzt eine binäre Suche den Breitenstreifen um das Flugzeug
+ * (± größte Reichweite der Gruppe); nur für ihn wird die Entfernung berechnet. Je Frequenz gibt es
+ * weltweit nur wenige hundert Stationen, ein Gitter oder k-d-Baum bringt deshalb nichts.
+ **************************************************************************************************/
+class NavIndex {
+public:
+    /// @brief Index aus den Einträgen aufbauen (sortiert sie; fordert Speicher an).
+    explicit NavIndex(std::vector<NavEntry> entries);
+
+    /**
+     * @brief Nächste Station in Reichweite; fordert keinen Speicher an.
+     *
+     * @return nullptr, falls keine Station der Gruppe auf dieser Frequenz in Reichweite ist.
+     */
+    const NavEntry *findNearest(NavGroup group, uint16_t frequency, double lat, double lon) const;
+
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Slot {
+        uint32_t key;                       ///< 0: frei
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    static uint32_t keyOf(NavGroup group, uint16_t frequency) {
+        return ((static_cast<uint32_t>(group) + 1) << 16) | frequency;
+    }
+
+    size_t slotOf(uint32_t key) const { return (key * 2654435761U) & (slots.size() - 1); }
+
+    std::vector<NavEntry> entries;
+    std::vector<Slot> slots;                ///< Größe: Zweierpotenz, höchstens halb belegt
+};
+
+
+/***************************************************************************************************
+ * @brief Einlesen im Sim-Thread, Aufbau im Hintergrund, Abfrage im Sim-Thread.
+ *
+ * add(), build() und findNearest() nur aus dem Sim-Thread aufrufen. Der Hintergrund-Thread
+ * veröffentlicht den fertigen Index über @em published; der alte Index wird erst beim nächsten
+ * build() bzw. im Destruktor freigegeben, also im Sim-Thread, der als einziger liest.
+ **************************************************************************************************/
+class NavStations {
+public:
+    NavStations() : published(nullptr) {}
+    ~NavStations();
+
+    NavStations(const NavStations &) = delete;
+    NavStations &operator=(const NavStations &) = delete;
+
+    /// @brief Ein Navaid aus der Datenbank übernehmen.
+    void add(const NavEntry &entry) { collected.push_back(entry); }
+
+    /// @brief Einlesen abgeschlossen: Index im Hintergrund aufbauen (ersetzt einen vorhandenen).
+    void build();
+
+    /// @brief true Der Index ist aufgebaut.
+    bool isReady() const { return published.load(std::memory_order_acquire) != nullptr; }
+
+    /// @brief Wie NavIndex::findNearest(); nullptr, solange der Index noch nicht aufgebaut ist.
+    const NavEntry *findNearest(NavGroup group, uint16_t frequency, double lat, double lon) const;
+
+private:
+    std::vector<NavEntry> collected;
+    std::atomic<NavIndex *> published;
+    std::thread builder;
+};
+
+
+/***************************************************************************************************
+ * @brief Kennung der Station eines Empfängers (z.B. NAV1) zum Panel, nur bei Änderungen.
+ *
+ * Abgefragt wird bei einer Änderung der Frequenz, nach NAV_REQUERY_NM Flugstrecke seit der letzten
+ * Abfrage und sobald der Index fertig ist. Die Nachricht ist `<Gerät>;IDNT;<Kennung>`, mit leerer
+ * Kennung, wenn keine Station in Reichweite ist.
+ **************************************************************************************************/
+class NavIdentTracker {
+public:
+    NavIdentTracker(const char *device, NavGroup group) : device(device), group(group) {}
+
+    /**
+     * @brief Je Frame aufrufen.
+     *
+     * @param message Puffer für die Nachricht.
+     * @return Länge der Nachricht; 0, falls sich die Kennung nicht geändert hat.
+     */
+    size_t update(const NavStations &stations, uint16_t frequency, double lat, double lon, char *message,
+                  size_t size);
+
+private:
+    const char *device;
+    NavGroup group;
+    bool isQueried = false;                 ///< Mit fertigem Index abgefragt
+    uint16_t lastFrequency = 0;
+    double lastLat = 0.0;
+    double lastLon = 0.0;
+    char ident[NAV_IDENT_LENGTH + 1] = "";  ///< Zuletzt gesendete Kennung
+};
@@ -0,0 +1,81 @@
+/***************************************************************************************************
+ * @file snapshotdiff.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Geänderte Werte eines Snapshots gegenüber den zuletzt gesendeten ermitteln.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+/***************************************************************************************************
+ * @brief Vergleicht je Frame einen Snapshot (vgl. SnapshotRing) mit den zuletzt gesendeten Werten.
+ *
+ * Ein Wert gilt als geändert, wenn er um mehr als seine Schwelle vom zuletzt gesendeten abweicht
+ * (Schwelle 0: jede Änderung). Nur die geänderten Werte gelten danach als gesendet; ein Wert, der
+ * langsam wandert, wird also gesendet, sobald er sich insgesamt um mehr als die Schwelle bewegt hat.
+ * Vor dem ersten update() und nach invalidate() gelten alle Werte als geändert.
+ *
+ * Die Schleife ist ohne Verzweigung je Wert geschrieben (Index schreiben, Zähler bedingt erhöhen),
+ * damit der Compiler sie vektorisieren kann. Nur von einem Thread benutzen.
+ *
+ * @tparam VALUE_COUNT Anzahl Werte je Snapshot; höchstens 65536.
+ **************************************************************************************************/
+template <size_t VALUE_COUNT>
+class SnapshotDiff {
+public:
+    static_assert(VALUE_COUNT <= 65536, "Die Indizes der geänderten Werte sind 16 Bit breit");
+
+    SnapshotDiff() {
+        for (float &threshold : thresholds) {
+            threshold = 0.0f;
+        }
+        invalidate();
+    }
+
+    /// @brief Schwelle eines Werts setzen, z.B. 0,5 ft für die Höhe.
+    void setThreshold(const size_t index, const float threshold) { thresholds[index] = threshold; }
+
+    /// @brief Alle Werte beim nächsten update() als geändert melden (z.B. nach dem Verbinden eines Panels).
+    void invalidate() {
+        for (float &value : sent) {
+            value = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+
+    /**
+     * @brief Snapshot vergleichen und die geänderten Werte als gesendet übernehmen.
+     *
+     * @param values  @em VALUE_COUNT Werte.
+     * @param changed Platz für @em VALUE_COUNT Indizes; erhält die geänderten Werte aufsteigend.
+     * @return Anzahl der geänderten Werte.
+     */
+    size_t update(const float *values, uint16_t *changed) {
+        size_t count = 0;
+        for (size_t i = 0; i < VALUE_COUNT; ++i) {
+            // NaN (noch nie gesendet) ist nie <= Schwelle
+            const bool isChanged = ! (std::fabs(values[i] - sent[i]) <= thresholds[i]);
+            changed[count] = static_cast<uint16_t>(i);
+            count += isChanged ? 1 : 0;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            sent[changed[i]] = values[changed[i]];
+        }
+        return count;
+    }
+
+    /// @brief Zuletzt gesendeter Wert; NaN, falls noch keiner.
+    float getSent(const size_t index) const { return sent[index]; }
+
+private:
+    float thresholds[VALUE_COUNT];
+    float sent[VALUE_COUNT];        ///< Zuletzt gesendete Werte; NaN = noch nicht gesendet
+};
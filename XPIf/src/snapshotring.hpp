@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * @file snapshotring.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Seqlock-Ring für die Snapshots der Datarefs (Plugin → Daemon).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Die Ringe brauchen lock-freie 32-Bit-Atomics");
+
+
+/***************************************************************************************************
+ * @brief Ring mit den zuletzt geschriebenen Snapshots, z.B.\ im Shared Memory zwischen Plugin und Daemon.
+ *
+ * Genau ein Schreiber (das Plugin im Sim-Thread) und beliebig viele Leser (der Daemon). Der Schreiber
+ * wartet nie: je Snapshot ein @em memcpy und zwei atomare Stores auf @em sequence sowie einer auf
+ * @em head. Ein Leser erkennt an @em sequence, ob ein Slot während des Kopierens überschrieben wurde,
+ * und nimmt dann den vorigen Slot (Seqlock).
+ *
+ * Die Struktur enthält keine Zeiger und kann deshalb direkt in ein mit @em mmap eingeblendetes
+ * Shared Memory gelegt werden; der Besitzer legt sie dort mit Placement-new an, die anderen Prozesse
+ * prüfen mit isCompatible(), ob sie mit denselben Größen übersetzt wurden.
+ *
+ * @tparam VALUE_COUNT Anzahl Werte je Snapshot (Anzahl Datarefs in der Konfiguration).
+ * @tparam SLOT_COUNT  Anzahl Slots; mindestens 2, damit ein Leser immer auf einen fertigen Slot
+ *                     ausweichen kann.
+ **************************************************************************************************/
+template <size_t VALUE_COUNT, size_t SLOT_COUNT>
+class SnapshotRing {
+public:
+    static_assert(SLOT_COUNT >= 2, "SnapshotRing braucht mindestens zwei Slots");
+
+    /// @param version Kennung dieses Laufs (z.B. Startzeit des Simulators); ein Leser erkennt daran einen Neustart.
+    explicit SnapshotRing(const uint32_t version)
+        : version(version), slotCount(SLOT_COUNT), valueCount(VALUE_COUNT), head(0) {
+        for (Slot &slot : slots) {
+            slot.sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief @em true, wenn der Ring mit denselben Größen angelegt wurde.
+    bool isCompatible() const { return (slotCount == SLOT_COUNT) && (valueCount == VALUE_COUNT); }
+
+    /// @brief Kennung des Laufs, mit der der Ring angelegt wurde.
+    uint32_t getVersion() const { return version; }
+
+    /**
+     * @brief Einen Snapshot schreiben. Nur vom Schreiber aufrufen.
+     *
+     * @param simTime Simulationszeit des Snapshots in Sekunden.
+     * @param values  @em VALUE_COUNT Werte.
+     */
+    void write(const double simTime, const float *values) {
+        const uint32_t frame = head.load(std::memory_order_relaxed) + 1;
+        Slot &slot = slots[frame % SLOT_COUNT];
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);   // ungerade: wird geschrieben
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.frame = frame;
+        slot.simTime = simTime;
+        memcpy(slot.values, values, sizeof(slot.values));
+        slot.sequence.store(sequence + 2, std::memory_order_release);   // gerade: fertig
+        head.store(frame, std::memory_order_release);
+    }
+
+    /**
+     * @brief Den neuesten vollständigen Snapshot kopieren.
+     *
+     * @param simTime Simulationszeit des Snapshots.
+     * @param values  Puffer für @em VALUE_COUNT Werte.
+     * @return Laufende Nummer des kopierten Snapshots (ab 1); 0, falls noch keiner geschrieben wurde
+     *         oder alle Slots während des Kopierens überschrieben wurden. Musste auf einen vorigen Slot
+     *         ausgewichen werden, kann die Nummer kleiner sein als beim letzten Aufruf. Bleibt die
+     *         Nummer stehen, schreibt das Plugin nicht mehr.
+     */
+    uint32_t readLatest(double &simTime, float *values) const {
+        const uint32_t latest = head.load(std::memory_order_acquire);
+        for (uint32_t back = 0; (back < SLOT_COUNT) && (back < latest); ++back) {
+            const uint32_t frame = latest - back;
+            const Slot &slot = slots[frame % SLOT_COUNT];
+            const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if ((before % 2) != 0) {
+                continue;
+            }
+            // Der Slot kann inzwischen einen neueren Snapshot enthalten; maßgeblich ist slot.frame.
+            const uint32_t copied = slot.frame;
+            const double time = slot.simTime;
+            memcpy(values, slot.values, sizeof(slot.values));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                simTime = time;
+                return copied;
+            }
+        }
+        return 0;
+    }
+
+    /// @brief Laufende Nummer des zuletzt geschriebenen Snapshots; 0 = noch keiner.
+    uint32_t getHead() const { return head.load(std::memory_order_acquire); }
+
+private:
+    /// Ein Snapshot mit laufender Nummer und Sequenzzähler (ungerade = wird gerade geschrieben).
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        uint32_t frame;
+        double simTime;
+        float values[VALUE_COUNT];
+    };
+
+    uint32_t version;               ///< Kennung des Laufs
+    uint32_t slotCount;             ///< SLOT_COUNT des Besitzers
+    uint32_t valueCount;            ///< VALUE_COUNT des Besitzers
+    std::atomic<uint32_t> head;     ///< Laufende Nummer des zuletzt vollständig geschriebenen Snapshots
+    Slot slots[SLOT_COUNT];         ///< Die Snapshots; Snapshot n liegt in slots[n % SLOT_COUNT]
+};
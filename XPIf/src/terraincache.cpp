@@ -0,0 +1,261 @@
+/***************************************************************************************************
+ * @file terraincache.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em TerrainCache.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <terraincache.hpp>
+#include <messagewriter.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+const double METERS_PER_DEGREE = 111320.0;  ///< Breitengrad
+const float FEET_PER_METER = 3.28084f;
+const double PI = 3.14159265358979323846;
+const float CENTER = (TERRAIN_GRID - 1) / 2.0f;
+const int RAY_DIRECTIONS = 8;               ///< Stützstellen je Ring im Strahlkegel
+const int32_t INT16_LIMIT = 32767;          ///< Wert und Rate sind int16_t in der Firmware
+
+
+TerrainCache::TerrainCache(const TerrainProbe probe, const uint8_t valueId) : probe(probe), valueId(valueId) {
+    for (auto &row : nodes) {
+        for (Node &node : row) {
+            node = Node{std::numeric_limits<float>::quiet_NaN(), -1.0};
+        }
+    }
+}
+
+
+size_t TerrainCache::update(const AircraftPosition &aircraft, const float dt, char *message, const size_t size) {
+    now += dt;
+    const float agl = std::max(0.0f, aircraft.yAgl);
+    if (agl * FEET_PER_METER > TERRAIN_MAX_AGL_FT) {
+        raw = std::numeric_limits<float>::quiet_NaN();
+        isMeasured = false;
+        if (isBlank) {
+            return 0;
+        }
+        // Rate und Wert 0: Mit READOUT_BLANK_ZERO bleibt die Anzeige dunkel.
+        const size_t length = MessageWriter(message, size).text("RD").text("R").number(valueId).number(0).finish();
+        const size_t added = (length == 0) ? 0 : MessageWriter(message + length, size - length).text("RD").text("V")
+                                                     .number(valueId).number(0).finish();
+        if (added == 0) {
+            return 0;
+        }
+        isBlank = isSent = true;
+        sentValue = 0.0f;
+        sentRate = 0;
+        sentAt = now;
+        return length + added;
+    }
+    isBlank = false;
+
+    // Gitter anlegen bzw. so verschieben, dass der Punkt TERRAIN_SPACING_S voraus in der Mitte liegt
+    const float radius = agl * static_cast<float>(std::tan(TERRAIN_BEAM_DEG * PI / 180.0));
+    const float wanted = std::min(std::max({aircraft.groundSpeed * TERRAIN_SPACING_S, radius / 1.2f,
+                                            TERRAIN_MIN_SPACING_M}), TERRAIN_MAX_SPACING_M);
+    const double track = aircraft.track * PI / 180.0;
+    const double aheadNorth = aircraft.groundSpeed * TERRAIN_SPACING_S * std::cos(track);
+    const double aheadEast = aircraft.groundSpeed * TERRAIN_SPACING_S * std::sin(track);
+    // Der Kegel muss ins Gitter passen (höchstens 1,5 Abstände, das Flugzeug ist bis zu 2 von der Mitte entfernt)
+    const bool isTooSmall = (radius > 1.5f * spacing) && (spacing < TERRAIN_MAX_SPACING_M);
+    if ((! isPlaced) || isTooSmall || (wanted > spacing * 1.5f) || (wanted * 1.5f < spacing)) {
+        metersPerDegreeLon = METERS_PER_DEGREE * std::cos(aircraft.lat * PI / 180.0);
+        place(aircraft.lat + aheadNorth / METERS_PER_DEGREE, aircraft.lon + aheadEast / metersPerDegreeLon, wanted);
+    }
+    float targetRow = rowOf(aircraft.lat + aheadNorth / METERS_PER_DEGREE);
+    float targetCol = colOf(aircraft.lon + aheadEast / metersPerDegreeLon);
+    const int rows = (std::fabs(targetRow - CENTER) > 1.0f) ? static_cast<int>(std::lround(targetRow - CENTER)) : 0;
+    const int cols = (std::fabs(targetCol - CENTER) > 1.0f) ? static_cast<int>(std::lround(targetCol - CENTER)) : 0;
+    if ((rows != 0) || (cols != 0)) {
+        shift(rows, cols);
+        targetRow -= static_cast<float>(rows);
+        targetCol -= static_cast<float>(cols);
+    }
+
+    const float maxAge = std::min(std::max(TERRAIN_MAX_AGE_S * agl * FEET_PER_METER / TERRAIN_MAX_AGL_FT,
+                                           TERRAIN_MIN_AGE_S), TERRAIN_MAX_AGE_S);
+    probeNodes(targetRow, targetCol, maxAge);
+
+    const float terrain = highestTerrain(rowOf(aircraft.lat), colOf(aircraft.lon), radius / spacing);
+    raw = std::isnan(terrain) ? terrain : std::max(0.0f, (aircraft.elevation - terrain) * FEET_PER_METER);
+    if (std::isnan(raw)) {
+        return 0;                           // Punkte unter dem Flugzeug noch nicht abgefragt: Wert halten
+    }
+    if (! isMeasured) {
+        filtered = raw;
+        rate = 0.0f;
+        isMeasured = true;
+    } else if (dt > 0.0f) {
+        const float alpha = dt / (TERRAIN_FILTER_S + dt);
+        const float previous = filtered;
+        filtered += alpha * (raw - filtered);
+        rate += alpha * ((filtered - previous) / dt * 60.0f - rate);
+    }
+    return report(message, size);
+}
+
+
+void TerrainCache::place(const double lat, const double lon, const float spacing) {
+    this->spacing = spacing;
+    originLat = lat - CENTER * spacing / METERS_PER_DEGREE;
+    originLon = lon - CENTER * spacing / metersPerDegreeLon;
+    for (auto &row : nodes) {
+        for (Node &node : row) {
+            node = Node{std::numeric_limits<float>::quiet_NaN(), -1.0};
+        }
+    }
+    isPlaced = true;
+}
+
+
+/// Um ganze Punkte verschieben; was im Gitter bleibt, behält Höhe und Alter.
+void TerrainCache::shift(const int rows, const int cols) {
+    Node shifted[TERRAIN_GRID][TERRAIN_GRID];
+    for (int row = 0; row < TERRAIN_GRID; ++row) {
+        for (int col = 0; col < TERRAIN_GRID; ++col) {
+            const int fromRow = row + rows;
+            const int fromCol = col + cols;
+            const bool isInside = (fromRow >= 0) && (fromRow < TERRAIN_GRID) && (fromCol >= 0) && (fromCol < TERRAIN_GRID);
+            shifted[row][col] = isInside ? nodes[fromRow][fromCol] : Node{std::numeric_limits<float>::quiet_NaN(), -1.0};
+        }
+    }
+    std::copy(&shifted[0][0], &shifted[0][0] + TERRAIN_GRID * TERRAIN_GRID, &nodes[0][0]);
+    originLat += rows * spacing / METERS_PER_DEGREE;
+    originLon += cols * spacing / metersPerDegreeLon;
+}
+
+
+/// Höchstens TERRAIN_PROBES_PER_FRAME Punkte abfragen: nie abgefragte vor veralteten, jeweils die nächsten zum Ziel.
+void TerrainCache::probeNodes(const float targetRow, const float targetCol, const float maxAge) {
+    for (int count = 0; count < TERRAIN_PROBES_PER_FRAME; ++count) {
+        Node *best = nullptr;
+        int bestRow = 0, bestCol = 0;
+        float bestScore = 0.0f;
+        for (int row = 0; row < TERRAIN_GRID; ++row) {
+            for (int col = 0; col < TERRAIN_GRID; ++col) {
+                Node &node = nodes[row][col];
+                const bool isNew = (node.probedAt < 0.0);
+                if ((! isNew) && (now - node.probedAt < maxAge)) {
+                    continue;
+                }
+                const float score = (row - targetRow) * (row - targetRow) + (col - targetCol) * (col - targetCol) +
+                                    (isNew ? 0.0f : 2.0f * TERRAIN_GRID * TERRAIN_GRID);
+                if ((best == nullptr) || (score < bestScore)) {
+                    best = &node;
+                    bestRow = row;
+                    bestCol = col;
+                    bestScore = score;
+                }
+            }
+        }
+        if (best == nullptr) {
+            return;
+        }
+        best->height = probe(originLat + bestRow * spacing / METERS_PER_DEGREE,
+                             originLon + bestCol * spacing / metersPerDegreeLon);
+        best->probedAt = now;
+        ++probeCount;
+    }
+}
+
+
+/// Bilinear interpolierte Höhe; NaN außerhalb des Gitters oder falls ein Eckpunkt fehlt.
+float TerrainCache::interpolate(const float row, const float col) const {
+    if ((row < 0.0f) || (col < 0.0f) || (row > TERRAIN_GRID - 1) || (col > TERRAIN_GRID - 1)) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    const int row0 = std::min(static_cast<int>(row), TERRAIN_GRID - 2);
+    const int col0 = std::min(static_cast<int>(col), TERRAIN_GRID - 2);
+    const float fractionRow = row - row0;
+    const float fractionCol = col - col0;
+    const float south = nodes[row0][col0].height + (nodes[row0][col0 + 1].height - nodes[row0][col0].height) * fractionCol;
+    const float north = nodes[row0 + 1][col0].height +
+                        (nodes[row0 + 1][col0 + 1].height - nodes[row0 + 1][col0].height) * fractionCol;
+    return south + (north - south) * fractionRow;
+}
+
+
+/**
+ * Höchstes Gelände im Strahlkegel (Radius in Gitterabständen), also das nächste Echo: Mitte, je zwei
+ * Ringe mit RAY_DIRECTIONS Stützstellen und die Gitterpunkte im Kegel. NaN, solange einer dieser
+ * Punkte fehlt; sonst könnte ein noch nicht abgefragter Hügel übersehen werden.
+ */
+float TerrainCache::highestTerrain(const float row, const float col, const float radius) {
+    float highest = interpolate(row, col);
+    bool isMissing = std::isnan(highest);
+    for (const float ring : {0.5f, 1.0f}) {
+        for (int direction = 0; direction < RAY_DIRECTIONS; ++direction) {
+            const double angle = 2.0 * PI * direction / RAY_DIRECTIONS;
+            const float height = interpolate(row + ring * radius * static_cast<float>(std::cos(angle)),
+                                             col + ring * radius * static_cast<float>(std::sin(angle)));
+            isMissing = isMissing || std::isnan(height);
+            highest = std::max(highest, height);
+        }
+    }
+    sampleCount += 1 + 2 * RAY_DIRECTIONS;
+    const int firstRow = std::max(0, static_cast<int>(std::ceil(row - radius)));
+    const int lastRow = std::min(TERRAIN_GRID - 1, static_cast<int>(std::floor(row + radius)));
+    const int firstCol = std::max(0, static_cast<int>(std::ceil(col - radius)));
+    const int lastCol = std::min(TERRAIN_GRID - 1, static_cast<int>(std::floor(col + radius)));
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            if ((r - row) * (r - row) + (c - col) * (c - col) <= radius * radius) {
+                isMissing = isMissing || std::isnan(nodes[r][c].height);
+                highest = std::max(highest, nodes[r][c].height);
+            }
+        }
+    }
+    return isMissing ? std::numeric_limits<float>::quiet_NaN() : highest;
+}
+
+
+float TerrainCache::rowOf(const double lat) const {
+    return static_cast<float>((lat - originLat) * METERS_PER_DEGREE / spacing);
+}
+
+
+float TerrainCache::colOf(const double lon) const {
+    return static_cast<float>((lon - originLon) * metersPerDegreeLon / spacing);
+}
+
+
+/**
+ * Wie in Doku/xpif.md, "Extrapolation": RD;R, wenn sich die Rate deutlich geändert hat, RD;V, wenn der
+ * Wert vom auf dem Arduino extrapolierten abweicht oder die Extrapolation dort abgelaufen ist.
+ */
+size_t TerrainCache::report(char *message, const size_t size) {
+    size_t length = 0;
+    const int32_t newRate = std::max(-INT16_LIMIT, std::min(INT16_LIMIT, static_cast<int32_t>(std::lround(rate))));
+    double elapsed = std::min(now - sentAt, static_cast<double>(TERRAIN_EXTRAPOLATION_S));
+    if ((! isSent) || (std::fabs(rate - static_cast<float>(sentRate)) >= TERRAIN_SEND_RATE)) {
+        length = MessageWriter(message, size).text("RD").text("R").number(valueId).number(newRate).finish();
+        if (length == 0) {
+            return 0;
+        }
+        // Der Arduino rechnet ab dem angezeigten Wert mit der neuen Rate weiter
+        sentValue += static_cast<float>(sentRate * elapsed / 60.0);
+        sentRate = newRate;
+        sentAt = now;
+        elapsed = 0.0;
+    }
+    const float shown = sentValue + static_cast<float>(sentRate * elapsed / 60.0);
+    const bool isExpired = (sentRate != 0) && (now - sentAt >= TERRAIN_EXTRAPOLATION_S);
+    if ((! isSent) || (std::fabs(filtered - shown) > TERRAIN_SEND_FT) || isExpired) {
+        const int32_t value = std::min(INT16_LIMIT, static_cast<int32_t>(std::lround(filtered)));
+        const size_t added = MessageWriter(message + length, size - length).text("RD").text("V").number(valueId)
+                                 .number(value).finish();
+        if (added != 0) {
+            sentValue = static_cast<float>(value);
+            sentAt = now;
+            isSent = true;
+            length += added;
+        }
+    }
+    return length;
+}
@@ -0,0 +1,125 @@
+/***************************************************************************************************
+ * @file terraincache.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Radarhöhe aus gecachten Geländeabfragen mit fester Obergrenze der Abfragen je Frame.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * TerrainCache hält die Geländehöhen eines Gitters mit TERRAIN_GRID × TERRAIN_GRID Punkten um das
+ * Flugzeug in Lat/Lon, fragt je Frame höchstens TERRAIN_PROBES_PER_FRAME Punkte ab (zuerst fehlende,
+ * dann veraltete, jeweils die in Flugrichtung zuerst) und liefert das Minimum der bilinear
+ * interpolierten Höhe über dem Gelände im Strahlkegel als gefilterte Radarhöhe. Die Abfrage selbst ist eine
+ * TerrainProbe, im Plugin probeTerrain() aus terrainprobe.hpp. Vgl. Doku/xpif.md, Abschnitt
+ * "Radarhöhe aus gecachten Geländeabfragen".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+const int TERRAIN_GRID = 8;                     ///< Punkte je Richtung
+const int TERRAIN_PROBES_PER_FRAME = 2;
+const float TERRAIN_MAX_AGL_FT = 2500.0f;       ///< Darüber keine Anzeige und keine Abfragen
+const float TERRAIN_BEAM_DEG = 20.0f;           ///< Halber Öffnungswinkel des Strahlkegels
+const float TERRAIN_SPACING_S = 2.0f;           ///< Gitterabstand: Flugstrecke in dieser Zeit ...
+const float TERRAIN_MIN_SPACING_M = 50.0f;      ///< ... aber mindestens
+const float TERRAIN_MAX_SPACING_M = 500.0f;     ///< ... und höchstens
+const float TERRAIN_MAX_AGE_S = 10.0f;          ///< Alter, ab dem ein Punkt neu abgefragt wird, bei 2500 ft;
+const float TERRAIN_MIN_AGE_S = 1.0f;           ///< darunter proportional zur Höhe, mindestens
+const float TERRAIN_FILTER_S = 0.3f;            ///< Zeitkonstante des Tiefpasses
+const float TERRAIN_SEND_FT = 5.0f;             ///< Abweichung vom extrapolierten Wert für ein neues RD;V
+const float TERRAIN_SEND_RATE = 100.0f;         ///< Änderung der Sinkrate in ft/min für ein neues RD;R
+const float TERRAIN_EXTRAPOLATION_S = 10.0f;    ///< Wie READOUT_MAX_EXTRAPOLATION der Firmware
+
+/// Geländehöhe in m über NN; NaN: kein Gelände getroffen.
+using TerrainProbe = float (*)(double lat, double lon);
+
+
+/// Position und Bewegung des eigenen Flugzeugs aus den Datarefs sim/flightmodel/position/...
+struct AircraftPosition {
+    double lat;                                 ///< latitude
+    double lon;                                 ///< longitude
+    float elevation;                            ///< elevation, m über NN
+    float yAgl;                                 ///< y_agl, m über Grund direkt unter dem Flugzeug
+    float groundSpeed;                          ///< groundspeed, m/s
+    float track;                                ///< hpath, Grad rechtweisend
+};
+
+
+/***************************************************************************************************
+ * @brief Geländedienst für ein Anzeigeinstrument `RD` (siehe Doku/kommunikation.md).
+ *
+ * Nur aus dem Sim-Thread aufrufen; update() fordert keinen Speicher an. Das Gitter liegt in Lat/Lon,
+ * damit es gültig bleibt, wenn X-Plane den Ursprung der lokalen Koordinaten verschiebt. Es wird um
+ * ganze Punkte verschoben, sobald der Punkt TERRAIN_SPACING_S voraus mehr als einen Gitterabstand
+ * von der Mitte entfernt ist; ändert sich der passende Gitterabstand um mehr als den Faktor 1,5, wird
+ * es neu angelegt.
+ **************************************************************************************************/
+class TerrainCache {
+public:
+    TerrainCache(TerrainProbe probe, uint8_t valueId);
+
+    /**
+     * @brief Je Frame aufrufen.
+     *
+     * @param dt Zeit seit dem letzten Aufruf in s.
+     * @param message Puffer für bis zu zwei Nachrichten (`RD;R;<Id>;<ft/min>` und `RD;V;<Id>;<ft>`).
+     * @return Länge der Nachrichten; 0, falls nichts zu senden ist.
+     */
+    size_t update(const AircraftPosition &aircraft, float dt, char *message, size_t size);
+
+    /// @brief Gefilterte Radarhöhe in ft; NaN, solange es keinen Wert gibt oder über TERRAIN_MAX_AGL_FT.
+    float getAltitude() const { return isMeasured ? filtered : std::numeric_limits<float>::quiet_NaN(); }
+
+    /// @brief Ungefilterte Radarhöhe des letzten Frames in ft; NaN, falls sie nicht bestimmt werden konnte.
+    float getRawAltitude() const { return raw; }
+
+    /// @brief Anzahl der Geländeabfragen.
+    uint32_t getProbeCount() const { return probeCount; }
+
+    /// @brief Anzahl der aus dem Gitter interpolierten Höhen; ohne Cache wäre jede eine Abfrage.
+    uint32_t getSampleCount() const { return sampleCount; }
+
+private:
+    struct Node {
+        float height;                           ///< m über NN; NaN: nicht abgefragt oder nicht getroffen
+        double probedAt;                        ///< Zeitpunkt der letzten Abfrage; -1: nie
+    };
+
+    void place(double lat, double lon, float spacing);
+    void shift(int rows, int cols);
+    void probeNodes(float targetRow, float targetCol, float maxAge);
+    float interpolate(float row, float col) const;
+    float highestTerrain(float row, float col, float radius);
+    float rowOf(double lat) const;
+    float colOf(double lon) const;
+    size_t report(char *message, size_t size);
+
+    TerrainProbe probe;
+    uint8_t valueId;
+    Node nodes[TERRAIN_GRID][TERRAIN_GRID];
+    bool isPlaced = false;
+    double originLat = 0.0;                     ///< Punkt [0][0] (Südwesten)
+    double originLon = 0.0;
+    double metersPerDegreeLon = 0.0;            ///< Beim Anlegen des Gitters festgelegt
+    float spacing = 0.0f;                       ///< Gitterabstand in m
+    double now = 0.0;                           ///< Summe der dt
+    uint32_t probeCount = 0;
+    uint32_t sampleCount = 0;
+
+    float raw = std::numeric_limits<float>::quiet_NaN();
+    float filtered = 0.0f;
+    float rate = 0.0f;                          ///< ft/min, gefiltert
+    bool isMeasured = false;
+    bool isBlank = false;                       ///< Über TERRAIN_MAX_AGL_FT dunkel geschaltet
+
+    // Modell des Arduino wie ReadoutDevice::currentValue()
+    bool isSent = false;
+    float sentValue = 0.0f;
+    int32_t sentRate = 0;
+    double sentAt = 0.0;
+};
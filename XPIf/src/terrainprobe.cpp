@@ -0,0 +1,52 @@
+/***************************************************************************************************
+ * @file terrainprobe.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Geländeabfrage über das SDK.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <terrainprobe.hpp>
+
+#include <XPLMGraphics.h>
+#include <XPLMScenery.h>
+
+#include <limits>
+
+static XPLMProbeRef probe = nullptr;
+
+
+void createTerrainProbe() {
+    if (probe == nullptr) {
+        probe = XPLMCreateProbe(xplm_ProbeY);
+    }
+}
+
+
+void destroyTerrainProbe() {
+    if (probe != nullptr) {
+        XPLMDestroyProbe(probe);
+        probe = nullptr;
+    }
+}
+
+
+float probeTerrain(const double lat, const double lon) {
+    if (probe == nullptr) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    // Die Probe sucht lotrecht; die Höhe des Startpunkts spielt keine Rolle.
+    double x, y, z;
+    XPLMWorldToLocal(lat, lon, 0.0, &x, &y, &z);
+    XPLMProbeInfo_t info;
+    info.structSize = sizeof(info);
+    if (XPLMProbeTerrainXYZ(probe, static_cast<float>(x), static_cast<float>(y), static_cast<float>(z), &info) !=
+        xplm_ProbeHitTerrain) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    double hitLat, hitLon, elevation;
+    XPLMLocalToWorld(info.locationX, info.locationY, info.locationZ, &hitLat, &hitLon, &elevation);
+    return static_cast<float>(elevation);
+}
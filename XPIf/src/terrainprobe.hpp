@@ -0,0 +1,27 @@
+/***************************************************************************************************
+ * @file terrainprobe.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Geländeabfrage über `XPLMProbeTerrainXYZ` als TerrainProbe für TerrainCache.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Eine einzige Probe wird in `XPluginEnable` mit createTerrainProbe() angelegt und in
+ * `XPluginDisable` mit destroyTerrainProbe() freigegeben. Nur aus dem Sim-Thread aufrufen.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+/// @brief Probe anlegen (`XPLMCreateProbe(xplm_ProbeY)`); eine vorhandene bleibt bestehen.
+void createTerrainProbe();
+
+/// @brief Probe freigeben.
+void destroyTerrainProbe();
+
+/**
+ * @brief Geländehöhe unter einem Punkt: `XPLMWorldToLocal`, `XPLMProbeTerrainXYZ`, `XPLMLocalToWorld`.
+ *
+ * @return m über NN; NaN ohne Probe oder falls kein Gelände getroffen wurde.
+ */
+float probeTerrain(double lat, double lon);
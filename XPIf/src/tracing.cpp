@@ -0,0 +1,208 @@
+/***************************************************************************************************
+ * @file tracing.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em ClockAlignment, @em TraceExporter und dem Zerlegen der SYS-Zeilen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <tracing.hpp>
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+std::atomic<bool> tracingEnabled(false);
+
+/// Phasen des loop() der Firmware (TRACE_PHASE_NAMES in diagnostics.cpp).
+static const char *const FIRMWARE_PHASES[] = {"SCAN", "DISP", "SHOW", "LEDS"};
+
+
+/**************************************************************************************************
+ * ClockAlignment
+ *
+ **************************************************************************************************/
+
+uint32_t ClockAlignment::ping(const uint64_t nowNs) {
+    const uint32_t id = nextId;
+    nextId = (nextId == UINT32_MAX) ? 1 : nextId + 1;
+    pending[id % MAX_PENDING] = {id, nowNs};
+    return id;
+}
+
+
+bool ClockAlignment::pong(const uint32_t id, const uint32_t micros, const uint64_t nowNs) {
+    Pending &request = pending[id % MAX_PENDING];
+    if ((id == 0) || (request.id != id) || (nowNs < request.sentNs)) {
+        return false;
+    }
+    request.id = 0;
+
+    Sample sample;
+    sample.rttNs = (nowNs > request.sentNs) ? nowNs - request.sentNs : 1;
+    sample.hostNs = request.sentNs + sample.rttNs / 2;
+    sample.micros = micros;
+    sample.arduinoUs = micros;
+    if (last.rttNs != 0) {
+        const int32_t elapsed = static_cast<int32_t>(micros - last.micros);
+        if (elapsed < 0) {
+            return false;
+        }
+        sample.arduinoUs = last.arduinoUs + static_cast<uint64_t>(elapsed);
+    }
+    last = sample;
+
+    if (best.rttNs == 0) {
+        best = sample;
+        windowStartNs = sample.hostNs;
+    } else if (sample.hostNs - windowStartNs >= WINDOW_NS) {
+        previous = anchor;
+        anchor = best;
+        best = sample;
+        windowStartNs = sample.hostNs;
+        if (previous.rttNs != 0) {
+            const double hostElapsed = static_cast<double>(anchor.hostNs - previous.hostNs);
+            const double arduinoElapsed = 1000.0 * static_cast<double>(anchor.arduinoUs - previous.arduinoUs);
+            rate = (arduinoElapsed > 0) ? hostElapsed / arduinoElapsed : 1.0;
+            rate = (rate < 1.0 - MAX_DRIFT) ? 1.0 - MAX_DRIFT : ((rate > 1.0 + MAX_DRIFT) ? 1.0 + MAX_DRIFT : rate);
+        }
+    } else if (sample.rttNs < best.rttNs) {
+        best = sample;
+    }
+    return true;
+}
+
+
+uint64_t ClockAlignment::toHostNs(const uint32_t micros) const {
+    const Sample &base = reference();
+    const int32_t elapsedUs = static_cast<int32_t>(micros - base.micros);
+    return base.hostNs + static_cast<uint64_t>(std::llround(1000.0 * elapsedUs * rate));
+}
+
+
+/**************************************************************************************************
+ * SYS-Zeilen
+ *
+ **************************************************************************************************/
+
+/// Zahl bis zum nächsten ';' oder Zeilenende lesen; @em text zeigt danach hinter das ';'.
+static bool parseNumber(const char *&text, uint32_t &value) {
+    char *end;
+    const unsigned long number = strtoul(text, &end, 10);
+    if ((end == text) || ! isdigit(static_cast<unsigned char>(*text)) || (number > UINT32_MAX)) {
+        return false;
+    }
+    value = static_cast<uint32_t>(number);
+    text = (*end == ';') ? end + 1 : end;
+    return (*end == ';') || (*end == '\0') || (*end == '\r') || (*end == '\n');
+}
+
+
+bool parsePong(const char *line, uint32_t &id, uint32_t &micros) {
+    if (strncmp(line, "SYS;PONG;", 9) != 0) {
+        return false;
+    }
+    const char *text = line + 9;
+    return parseNumber(text, id) && parseNumber(text, micros);
+}
+
+
+bool parseFirmwareSpan(const char *line, const ClockAlignment &clock, Span &span) {
+    if ((strncmp(line, "SYS;", 4) != 0) || (strlen(line) < 10) || (line[8] != ';') || ! clock.isValid()) {
+        return false;
+    }
+    span.name = nullptr;
+    for (const char *phase : FIRMWARE_PHASES) {
+        if (strncmp(line + 4, phase, 4) == 0) {
+            span.name = phase;
+        }
+    }
+    const char *text = line + 9;
+    uint32_t start, duration;
+    if ((span.name == nullptr) || ! parseNumber(text, start) || ! parseNumber(text, duration)) {
+        return false;
+    }
+    span.startNs = clock.toHostNs(start);
+    span.durationNs = clock.toHostNs(start + duration) - span.startNs;
+    return true;
+}
+
+
+/**************************************************************************************************
+ * TraceExporter
+ *
+ **************************************************************************************************/
+
+bool TraceExporter::addThread(const SpanRing &ring, const char *threadName) { return add(ring, threadName, false); }
+
+bool TraceExporter::addPanel(const SpanRing &ring, const char *panelName) { return add(ring, panelName, true); }
+
+
+bool TraceExporter::add(const SpanRing &ring, const char *name, const bool isPanel) {
+    if (sourceCount == MAX_SOURCES) {
+        return false;
+    }
+    sources[sourceCount++] = {&ring, name, isPanel};
+    return true;
+}
+
+
+/// Text als JSON-String mit Anführungszeichen schreiben.
+static void writeJsonString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *c = text; *c != '\0'; ++c) {
+        if ((*c == '"') || (*c == '\\')) {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+
+/// Metadaten-Ereignis (`process_name` bzw. `thread_name`) schreiben.
+static void writeName(FILE *file, const char *kind, const int pid, const int tid, const char *name) {
+    fprintf(file, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", kind, pid, tid);
+    writeJsonString(file, name);
+    fputs("}},\n", file);
+}
+
+
+size_t TraceExporter::write(FILE *file) const {
+    std::vector<Span> spans(TRACE_RING_SIZE);
+    size_t written = 0;
+    fputs("{\"traceEvents\":[\n", file);
+    writeName(file, "process_name", 1, 0, "XPIf");
+    int thread = 0, panel = 0;
+    for (size_t source = 0; source < sourceCount; ++source) {
+        const bool isPanel = sources[source].isPanel;
+        const int pid = isPanel ? 2 + panel++ : 1;
+        const int tid = isPanel ? 1 : ++thread;
+        if (isPanel) {
+            writeName(file, "process_name", pid, 0, sources[source].name);
+            writeName(file, "thread_name", pid, tid, "loop()");
+        } else {
+            writeName(file, "thread_name", pid, tid, sources[source].name);
+        }
+        const size_t count = sources[source].ring->snapshot(spans.data());
+        for (size_t i = 0; i < count; ++i) {
+            fputs("{\"name\":", file);
+            writeJsonString(file, spans[i].name);
+            fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d},\n",
+                    spans[i].startNs / 1e3, spans[i].durationNs / 1e3, pid, tid);
+        }
+        written += count;
+    }
+    // Ein letztes Metadaten-Ereignis, damit vor ']' kein Komma steht
+    fputs("{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"sort_index\":0}}\n", file);
+    fputs("],\"displayTimeUnit\":\"ms\"}\n", file);
+    return written;
+}
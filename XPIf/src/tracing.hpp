@@ -0,0 +1,268 @@
+/***************************************************************************************************
+ * @file tracing.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Spans der Threads von XPIf und der Arduinos auf einer Zeitachse, Export als Chrome-Trace.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Jeder Thread schreibt seine Spans in einen eigenen SpanRing (z.B. mit ScopedSpan). Die Phasen des
+ * loop() der Arduinos (`SYS;<Phase>;<Beginn>;<Dauer>`) rechnet der I/O-Thread mit ClockAlignment auf
+ * steady_clock um und legt sie in einen Ring je Panel. TraceExporter schreibt auf Anforderung alle
+ * Ringe als Chrome-Trace-Event-JSON, das auch Perfetto öffnet. Vgl. Doku/xpif.md, Abschnitt "Tracing".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+const size_t TRACE_RING_SIZE = 4096;    ///< Spans je Ring; die ältesten werden überschrieben
+
+/// Tracing ein- oder ausgeschaltet (für alle Threads); nur über setTracing()/isTracing() verwenden.
+extern std::atomic<bool> tracingEnabled;
+
+inline void setTracing(const bool isEnabled) { tracingEnabled.store(isEnabled, std::memory_order_relaxed); }
+
+inline bool isTracing() { return tracingEnabled.load(std::memory_order_relaxed); }
+
+/// @brief steady_clock in ns, die Zeitachse aller Spans.
+inline uint64_t traceNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+/// Ein Span, so wie ihn SpanRing::snapshot() liefert.
+struct Span {
+    const char *name;               ///< Literal (statische Lebensdauer)
+    uint64_t startNs;               ///< steady_clock
+    uint64_t durationNs;
+};
+
+
+/***************************************************************************************************
+ * @brief Ring der Spans eines Threads (ein Schreiber, beliebig viele Leser).
+ *
+ * add() wartet nie und überschreibt den ältesten Span, der Ring hält also immer die letzten
+ * TRACE_RING_SIZE Spans (wie ein Flugschreiber). Ein Leser kopiert mit snapshot() und verwirft
+ * danach die Spans, die der Schreiber währenddessen überschrieben haben kann (wie beim Seqlock:
+ * @em started wird vor den Daten, @em published danach geschrieben).
+ **************************************************************************************************/
+class SpanRing {
+public:
+    SpanRing() : started(0), published(0) {}
+
+    SpanRing(const SpanRing &) = delete;
+    SpanRing &operator=(const SpanRing &) = delete;
+
+    /// @brief Span anhängen. Nur vom eigenen Thread aufrufen.
+    void add(const char *name, const uint64_t startNs, const uint64_t durationNs) {
+        const uint64_t position = published.load(std::memory_order_relaxed);
+        started.store(position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot &slot = slots[position % TRACE_RING_SIZE];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.startNs.store(startNs, std::memory_order_relaxed);
+        slot.durationNs.store(durationNs, std::memory_order_relaxed);
+        published.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Die vorhandenen Spans kopieren, den ältesten zuerst.
+     *
+     * @param spans Platz für TRACE_RING_SIZE Spans.
+     * @return Anzahl der kopierten Spans.
+     */
+    size_t snapshot(Span *spans) const {
+        const uint64_t end = published.load(std::memory_order_acquire);
+        uint64_t begin = (end > TRACE_RING_SIZE) ? end - TRACE_RING_SIZE : 0;
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot &slot = slots[i % TRACE_RING_SIZE];
+            Span &span = spans[i - begin];
+            span.name = slot.name.load(std::memory_order_relaxed);
+            span.startNs = slot.startNs.load(std::memory_order_relaxed);
+            span.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Span i wird erst vom Span i + TRACE_RING_SIZE überschrieben, der @em started vorher erhöht.
+        const uint64_t overwritten = started.load(std::memory_order_relaxed);
+        const uint64_t valid = (overwritten > TRACE_RING_SIZE) ? overwritten - TRACE_RING_SIZE : 0;
+        if (valid <= begin) {
+            return static_cast<size_t>(end - begin);
+        }
+        const uint64_t skip = (valid < end) ? valid - begin : end - begin;
+        for (uint64_t i = skip; i < end - begin; ++i) {
+            spans[i - skip] = spans[i];
+        }
+        return static_cast<size_t>(end - begin - skip);
+    }
+
+    /// @brief Anzahl der Spans seit dem Anlegen (auch der überschriebenen).
+    uint64_t getCount() const { return published.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<const char *> name;
+        std::atomic<uint64_t> startNs;
+        std::atomic<uint64_t> durationNs;
+    };
+
+    std::atomic<uint64_t> started;      ///< Begonnene add(); vor den Daten geschrieben
+    std::atomic<uint64_t> published;    ///< Abgeschlossene add()
+    Slot slots[TRACE_RING_SIZE];
+};
+
+
+/***************************************************************************************************
+ * @brief Span über die Lebensdauer des Objekts.
+ *
+ * Ist das Tracing ausgeschaltet, kostet der Span das Lesen von @em tracingEnabled und eine Abfrage
+ * im Destruktor. Wird es während des Spans eingeschaltet, zählt der Span noch nicht.
+ **************************************************************************************************/
+class ScopedSpan {
+public:
+    ScopedSpan(SpanRing &ring, const char *name) : ring(ring), name(name), startNs(isTracing() ? traceNow() : 0) {}
+
+    ~ScopedSpan() {
+        if (startNs != 0) {
+            ring.add(name, startNs, traceNow() - startNs);
+        }
+    }
+
+    ScopedSpan(const ScopedSpan &) = delete;
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+private:
+    SpanRing &ring;
+    const char *name;
+    const uint64_t startNs;             ///< 0: Tracing war beim Anlegen ausgeschaltet
+};
+
+
+/***************************************************************************************************
+ * @brief Umrechnung der Arduino-Zeit (micros()) auf steady_clock eines Panels.
+ *
+ * XPIf sendet regelmäßig `SYS;PING;<Id>` mit der Id aus ping(); die Antwort
+ * `SYS;PONG;<Id>;<micros>` geht an pong(). Die Arduino-Zeit entspricht der Mitte zwischen Senden und
+ * Empfang; das ist umso genauer, je kürzer die Umlaufzeit ist. Je Fenster von WINDOW_NS zählt deshalb
+ * nur die Antwort mit der kürzesten Umlaufzeit. Am Ende eines Fensters wird sie zum Bezugspunkt; aus
+ * den letzten beiden Bezugspunkten ergibt sich die Drift des Quarzes bzw. Resonators. Bis zum Ende
+ * des ersten Fensters gilt die bis dahin beste Antwort ohne Drift.
+ *
+ * micros() läuft etwa alle 71 Minuten über. Die Antworten werden fortgezählt; umgerechnet wird
+ * relativ zum Bezugspunkt (höchstens ±35 Minuten entfernt).
+ **************************************************************************************************/
+class ClockAlignment {
+public:
+    static const uint64_t WINDOW_NS = 10000000000ULL;  ///< 10 s
+    static const size_t MAX_PENDING = 8;                ///< Gleichzeitig offene PINGs
+    static constexpr double MAX_DRIFT = 0.01;           ///< Resonator des Uno: ±0,5 %, mit Reserve
+
+    /// @brief Sendezeitpunkt eines PING merken. @return Id für `SYS;PING;<Id>`.
+    uint32_t ping(uint64_t nowNs);
+
+    /**
+     * @brief Antwort auf einen PING auswerten.
+     *
+     * @return false Id unbekannt (zu alt oder schon beantwortet) oder Zeitstempel älter als der letzte.
+     */
+    bool pong(uint32_t id, uint32_t micros, uint64_t nowNs);
+
+    /// @brief false Noch keine Antwort; toHostNs() ist dann nicht möglich.
+    bool isValid() const { return reference().rttNs != 0; }
+
+    /// @brief Zeitstempel des Arduino in steady_clock ns umrechnen.
+    uint64_t toHostNs(uint32_t micros) const;
+
+    /// @brief Umlaufzeit der Antwort, die als Bezugspunkt dient.
+    uint64_t getRttNs() const { return reference().rttNs; }
+
+    /// @brief Umlaufzeit der letzten Antwort (z.B. für die Metriken).
+    uint64_t getLastRttNs() const { return last.rttNs; }
+
+    /// @brief Geschätzte Abweichung der Arduino-Uhr in ppm (positiv: sie geht vor).
+    double getDriftPpm() const { return (1.0 / rate - 1.0) * 1e6; }
+
+private:
+    struct Sample {
+        uint64_t hostNs;            ///< Mitte zwischen PING und PONG
+        uint64_t arduinoUs;         ///< micros(), fortgezählt
+        uint64_t rttNs;             ///< 0: kein Sample
+        uint32_t micros;            ///< micros() wie empfangen
+    };
+
+    struct Pending {
+        uint32_t id;
+        uint64_t sentNs;
+    };
+
+    const Sample &reference() const { return (anchor.rttNs != 0) ? anchor : best; }
+
+    Pending pending[MAX_PENDING] = {};
+    uint32_t nextId = 1;
+    Sample last = {};               ///< Letzte Antwort (zum Fortzählen)
+    Sample best = {};               ///< Beste Antwort des laufenden Fensters
+    Sample anchor = {};             ///< Bezugspunkt: beste Antwort des letzten Fensters
+    Sample previous = {};           ///< Bezugspunkt davor
+    uint64_t windowStartNs = 0;
+    double rate = 1.0;              ///< ns des PC je 1000 ns des Arduino
+};
+
+
+/**
+ * @brief Zeile `SYS;PONG;<Id>;<micros>` zerlegen (Zeilenende erlaubt).
+ *
+ * @return false Keine solche Zeile.
+ */
+bool parsePong(const char *line, uint32_t &id, uint32_t &micros);
+
+/**
+ * @brief Phase des loop() `SYS;<Phase>;<Beginn>;<Dauer>` als Span auf steady_clock umrechnen.
+ *
+ * Bekannte Phasen sind SCAN, DISP, SHOW und LEDS (vgl. diagnostics.cpp der Firmware).
+ *
+ * @return false Keine solche Zeile oder @em clock hat noch keine Antwort.
+ */
+bool parseFirmwareSpan(const char *line, const ClockAlignment &clock, Span &span);
+
+
+/***************************************************************************************************
+ * @brief Schreibt die Spans aller Ringe als Chrome-Trace-Event-JSON.
+ *
+ * XPIf ist der Prozess 1 mit je einem Thread je Ring aus addThread(); jedes Panel aus addPanel() ist
+ * ein eigener Prozess. Die Namen werden als Metadaten (`process_name`, `thread_name`) geschrieben.
+ **************************************************************************************************/
+class TraceExporter {
+public:
+    static const size_t MAX_SOURCES = 16;
+
+    /// @brief Ring eines Threads von XPIf. @return false Es gibt schon MAX_SOURCES Ringe.
+    bool addThread(const SpanRing &ring, const char *threadName);
+
+    /// @brief Ring der Phasen eines Arduino. @return false Es gibt schon MAX_SOURCES Ringe.
+    bool addPanel(const SpanRing &ring, const char *panelName);
+
+    /**
+     * @brief Alle Ringe nach @em file schreiben (fordert Speicher für eine Kopie eines Rings an).
+     *
+     * @return Anzahl der geschriebenen Spans.
+     */
+    size_t write(FILE *file) const;
+
+private:
+    struct Source {
+        const SpanRing *ring;
+        const char *name;
+        bool isPanel;
+    };
+
+    bool add(const SpanRing &ring, const char *name, bool isPanel);
+
+    Source sources[MAX_SOURCES] = {};
+    size_t sourceCount = 0;
+};
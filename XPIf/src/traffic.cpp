@@ -0,0 +1,188 @@
+/***************************************************************************************************
+ * @file traffic.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em TrafficAdvisor und @em TrafficMonitor.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <traffic.hpp>
+#include <messagewriter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const float METERS_PER_FOOT = 0.3048f;
+const float METERS_PER_NM = 1852.0f;
+const float RA_M2 = (TRAFFIC_RA_NM * METERS_PER_NM) * (TRAFFIC_RA_NM * METERS_PER_NM);
+const float RA_M = TRAFFIC_RA_FT * METERS_PER_FOOT;
+const float TA_M2 = (TRAFFIC_TA_NM * METERS_PER_NM) * (TRAFFIC_TA_NM * METERS_PER_NM);
+const float TA_M = TRAFFIC_TA_FT * METERS_PER_FOOT;
+const float PROX_M2 = (TRAFFIC_PROX_NM * METERS_PER_NM) * (TRAFFIC_PROX_NM * METERS_PER_NM);
+const float PROX_M = TRAFFIC_PROX_FT * METERS_PER_FOOT;
+const float MIN_SPEED2 = 1e-4f;             ///< (m/s)²; darunter gilt die aktuelle Position als größte Annäherung
+const double PI = 3.14159265358979323846;
+
+
+/**************************************************************************************************
+ * TrafficAdvisor
+ *
+ **************************************************************************************************/
+
+/// Je Flugzeug die Stufe und die Priorität; ohne Verzweigungen, damit der Compiler die Schleife vektorisiert.
+void TrafficAdvisor::classify(const float *values, const uint32_t count) {
+    const float *x = values + TRAFFIC_X;
+    const float *y = values + TRAFFIC_Y;
+    const float *z = values + TRAFFIC_Z;
+    const float *vx = values + TRAFFIC_VX;
+    const float *vy = values + TRAFFIC_VY;
+    const float *vz = values + TRAFFIC_VZ;
+    const float ownX = x[0], ownY = y[0], ownZ = z[0];
+    const float ownVx = vx[0], ownVy = vy[0], ownVz = vz[0];
+    for (uint32_t i = 1; i < count; ++i) {
+        const float rx = x[i] - ownX;
+        const float ry = y[i] - ownY;
+        const float rz = z[i] - ownZ;
+        const float rvx = vx[i] - ownVx;
+        const float rvy = vy[i] - ownVy;
+        const float rvz = vz[i] - ownVz;
+        // Größte Annäherung horizontal: t = max(0, -(r·v)/(v·v))
+        const float closing = rx * rvx + rz * rvz;
+        const float speed2 = rvx * rvx + rvz * rvz;
+        const float ratio = -closing / (speed2 + MIN_SPEED2);
+        const float t = static_cast<float>(ratio > 0.0f) * ratio;
+        const float missX = rx + rvx * t;
+        const float missZ = rz + rvz * t;
+        const float miss2 = missX * missX + missZ * missZ;
+        const float missY = std::fabs(ry + rvy * t);
+        const float range2 = rx * rx + rz * rz;
+        const int32_t isResolution = static_cast<int32_t>(t < TRAFFIC_RA_S) & static_cast<int32_t>(miss2 < RA_M2) &
+                                     static_cast<int32_t>(missY < RA_M);
+        const int32_t isTraffic = static_cast<int32_t>(t < TRAFFIC_TA_S) & static_cast<int32_t>(miss2 < TA_M2) &
+                                  static_cast<int32_t>(missY < TA_M);
+        const int32_t isProximate = static_cast<int32_t>(range2 < PROX_M2) & static_cast<int32_t>(std::fabs(ry) < PROX_M);
+        const int32_t level = (isResolution != 0) ? 3 : ((isTraffic != 0) ? 2 : isProximate);
+        levels[i] = level;
+        // Bei gleicher Stufe ist das nähere Flugzeug gefährlicher; ohne Stufe 0
+        const float closeness = PROX_M2 / (PROX_M2 + range2);
+        priorities[i] = static_cast<float>(level != 0) * (static_cast<float>(level) + closeness);
+    }
+}
+
+
+size_t TrafficAdvisor::update(const float *values, const double simTime, char *message, const size_t size) {
+    const uint32_t count = std::min(static_cast<uint32_t>(std::max(values[TRAFFIC_COUNT], 0.0f)),
+                                    static_cast<uint32_t>(TRAFFIC_MAX_AIRCRAFT));
+    classify(values, count);
+    uint32_t best = 0;
+    float bestPriority = 0.0f;
+    for (uint32_t i = 1; i < count; ++i) {
+        if (priorities[i] > bestPriority) {
+            best = i;
+            bestPriority = priorities[i];
+        }
+    }
+    threat = best;
+
+    // Eine Stufe gilt bis TRAFFIC_HOLD_S nach der letzten Bedrohung dieser oder einer höheren Stufe
+    const int32_t computed = (best != 0) ? levels[best] : 0;
+    for (int32_t i = 1; i <= computed; ++i) {
+        lastThreatAt[i] = simTime;
+    }
+    int32_t shown = computed;
+    for (int32_t i = 3; i > computed; --i) {
+        if (simTime - lastThreatAt[i] < TRAFFIC_HOLD_S) {
+            shown = i;
+            break;
+        }
+    }
+
+    int32_t currentBearing = bearing;
+    int32_t currentRange = range;
+    if (best != 0) {
+        const float dx = values[TRAFFIC_X + best] - values[TRAFFIC_X];
+        const float dz = values[TRAFFIC_Z + best] - values[TRAFFIC_Z];
+        const double trueBearing = std::atan2(dx, -dz) * 180.0 / PI;
+        const int32_t relative = static_cast<int32_t>(std::lround(trueBearing - values[TRAFFIC_HEADING])) % 360;
+        currentBearing = (relative <= 0) ? relative + 360 : relative;
+        currentRange = std::max(1L, std::lround(std::sqrt(dx * dx + dz * dz) / (METERS_PER_NM / 10.0f)));
+    } else if (shown == 0) {
+        currentBearing = currentRange = 0;      // 0 schaltet die Anzeige dunkel (READOUT_BLANK_ZERO)
+    }
+
+    size_t length = 0;
+    if (shown != static_cast<int32_t>(level)) {
+        level = static_cast<ThreatLevel>(shown);
+        length += MessageWriter(message + length, size - length).text("TC").text("LVL").number(shown).finish();
+    }
+    if ((currentBearing != bearing) && (bearingId != 0)) {
+        length += MessageWriter(message + length, size - length).text("RD").text("V").number(bearingId).number(currentBearing).finish();
+    }
+    if ((currentRange != range) && (rangeId != 0)) {
+        length += MessageWriter(message + length, size - length).text("RD").text("V").number(rangeId).number(currentRange).finish();
+    }
+    bearing = currentBearing;
+    range = currentRange;
+    return length;
+}
+
+
+/**************************************************************************************************
+ * TrafficMonitor
+ *
+ **************************************************************************************************/
+
+TrafficMonitor::TrafficMonitor(const uint8_t bearingId, const uint8_t rangeId, const Sink sink, void *context)
+    : advisor(bearingId, rangeId), sink(sink), context(context), worker(&TrafficMonitor::run, this) {}
+
+
+TrafficMonitor::~TrafficMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    wakeup.notify_one();
+    worker.join();
+}
+
+
+void TrafficMonitor::publish(const double simTime, const float *values) {
+    ring.write(simTime, values);
+    // Der Worker prüft den Ring unter mutex; so geht kein Wecken verloren
+    { std::lock_guard<std::mutex> lock(mutex); }
+    wakeup.notify_one();
+}
+
+
+void TrafficMonitor::run() {
+    char message[96];
+    uint32_t last = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this, last] { return isStopping || (ring.getHead() != last); });
+            if (isStopping) {
+                return;
+            }
+        }
+        const auto start = std::chrono::steady_clock::now();
+        double simTime;
+        const uint32_t frame = ring.readLatest(simTime, values);
+        if (frame <= last) {
+            continue;                           // Alle Slots überschrieben oder ausgewichen: gleich noch einmal
+        }
+        last = frame;
+        const size_t length = advisor.update(values, simTime, message, sizeof(message));
+        if (length > 0) {
+            sink(message, length, context);
+            messageCount.fetch_add(static_cast<uint32_t>(std::count(message, message + length, '\n')),
+                                   std::memory_order_relaxed);
+        }
+        workerNanos.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+        processed.store(frame, std::memory_order_release);
+    }
+}
@@ -0,0 +1,162 @@
+/***************************************************************************************************
+ * @file traffic.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Verkehrswarnung (TCAS-ähnlich): größte Annäherung aller Flugzeuge im Worker-Thread.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Der Sim-Thread liest alle 0,5 s die Positionen und Geschwindigkeiten aller Flugzeuge als Arrays
+ * (TrafficReader in trafficreader.hpp) und übergibt sie mit TrafficMonitor::publish() über einen
+ * SnapshotRing an den Worker-Thread. Dort stuft TrafficAdvisor jedes Flugzeug ein und meldet dem Panel
+ * nur Änderungen der Warnstufe (`TC;LVL;<Stufe>`) sowie Richtung und Entfernung des gefährlichsten
+ * Flugzeugs (`RD;V`). Vgl. Doku/xpif.md, Abschnitt "Verkehrswarnung (TCAS-ähnlich)".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <snapshotring.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+const size_t TRAFFIC_MAX_AIRCRAFT = 256;        ///< Einschließlich des eigenen; X-Plane meldet höchstens 64
+const float TRAFFIC_CYCLE_S = 0.5f;             ///< Abstand der Snapshots
+const float TRAFFIC_RA_S = 25.0f;               ///< Resolution Advisory: Zeit bis zur größten Annäherung,
+const float TRAFFIC_RA_NM = 0.55f;              ///< horizontaler Abstand dann (DMOD, TCAS II Sensitivity Level 5)
+const float TRAFFIC_RA_FT = 600.0f;             ///< und vertikaler Abstand dann
+const float TRAFFIC_TA_S = 40.0f;               ///< Traffic Advisory, ebenso
+const float TRAFFIC_TA_NM = 0.75f;
+const float TRAFFIC_TA_FT = 850.0f;
+const float TRAFFIC_PROX_NM = 6.0f;             ///< Proximate Traffic: aktueller Abstand horizontal
+const float TRAFFIC_PROX_FT = 1200.0f;          ///< und vertikal
+const float TRAFFIC_HOLD_S = 2.0f;              ///< Eine Stufe gilt noch so lange nach der letzten Bedrohung
+
+/// Aufbau eines Snapshots: Anzahl und Steuerkurs, dann je Komponente ein Array (Structure of Arrays).
+/// Index 0 der Arrays ist das eigene Flugzeug, wie bei `sim/cockpit2/tcas/targets/position/...`.
+const size_t TRAFFIC_COUNT = 0;                 ///< Anzahl der Flugzeuge einschließlich des eigenen
+const size_t TRAFFIC_HEADING = 1;               ///< Steuerkurs des eigenen Flugzeugs, Grad rechtweisend
+const size_t TRAFFIC_X = 2;                     ///< Lokale Koordinaten in m: x nach Osten,
+const size_t TRAFFIC_Y = TRAFFIC_X + TRAFFIC_MAX_AIRCRAFT;  ///< y nach oben,
+const size_t TRAFFIC_Z = TRAFFIC_Y + TRAFFIC_MAX_AIRCRAFT;  ///< z nach Süden
+const size_t TRAFFIC_VX = TRAFFIC_Z + TRAFFIC_MAX_AIRCRAFT; ///< Geschwindigkeiten in m/s
+const size_t TRAFFIC_VY = TRAFFIC_VX + TRAFFIC_MAX_AIRCRAFT;
+const size_t TRAFFIC_VZ = TRAFFIC_VY + TRAFFIC_MAX_AIRCRAFT;
+const size_t TRAFFIC_VALUES = TRAFFIC_VZ + TRAFFIC_MAX_AIRCRAFT;
+
+/// Warnstufe wie bei TCAS, aufsteigend; der Wert ist der Parameter von `TC;LVL`.
+enum class ThreatLevel : uint8_t {
+    NONE = 0,
+    PROXIMATE = 1,                              ///< Proximate Traffic
+    TRAFFIC = 2,                                ///< Traffic Advisory
+    RESOLUTION = 3,                             ///< Resolution Advisory
+};
+
+
+/***************************************************************************************************
+ * @brief Einstufung aller Flugzeuge eines Snapshots und die Nachrichten an das Panel.
+ *
+ * Nur aus einem Thread aufrufen (im Plugin der Worker-Thread von TrafficMonitor); update() fordert
+ * keinen Speicher an. Die Schleife über die Flugzeuge ist ohne Verzweigungen geschrieben und liest
+ * getrennte Arrays je Komponente, damit der Compiler sie vektorisiert.
+ **************************************************************************************************/
+class TrafficAdvisor {
+public:
+    /// @param bearingId, rangeId valueId der Anzeigeinstrumente `RD` für Richtung und Entfernung; 0: keine Anzeige.
+    TrafficAdvisor(uint8_t bearingId, uint8_t rangeId) : bearingId(bearingId), rangeId(rangeId) {}
+
+    /**
+     * @brief Einen Snapshot auswerten.
+     *
+     * @param values Snapshot mit TRAFFIC_VALUES Werten.
+     * @param simTime Simulationszeit des Snapshots in s.
+     * @param message Puffer für bis zu drei Nachrichten (`TC;LVL;<Stufe>`, `RD;V;<Id>;<Grad>` und
+     *                `RD;V;<Id>;<0,1 NM>`).
+     * @return Länge der Nachrichten; 0, falls sich nichts geändert hat.
+     */
+    size_t update(const float *values, double simTime, char *message, size_t size);
+
+    /// @brief Angezeigte Warnstufe (mit Haltezeit).
+    ThreatLevel getLevel() const { return level; }
+
+    /// @brief Index des gefährlichsten Flugzeugs im letzten Snapshot; 0: keins.
+    uint32_t getThreat() const { return threat; }
+
+    /// @brief Richtung des gefährlichsten Flugzeugs in Grad relativ zum Steuerkurs (1 bis 360); 0: keins.
+    int32_t getBearing() const { return bearing; }
+
+    /// @brief Entfernung des gefährlichsten Flugzeugs in 0,1 NM; 0: keins.
+    int32_t getRange() const { return range; }
+
+    /// @brief Stufe von Flugzeug @em index im letzten Snapshot, ohne Haltezeit.
+    ThreatLevel getLevelOf(uint32_t index) const { return static_cast<ThreatLevel>(levels[index]); }
+
+private:
+    void classify(const float *values, uint32_t count);
+
+    uint8_t bearingId;
+    uint8_t rangeId;
+    int32_t levels[TRAFFIC_MAX_AIRCRAFT] = {};      ///< Je Flugzeug, als int32_t für die vektorisierte Schleife
+    float priorities[TRAFFIC_MAX_AIRCRAFT] = {};    ///< Stufe + Nähe in (0, 1]; das Maximum ist das gefährlichste
+    double lastThreatAt[4] = {-1e9, -1e9, -1e9, -1e9}; ///< Je Stufe die letzte Bedrohung mindestens dieser Stufe
+    ThreatLevel level = ThreatLevel::NONE;
+    uint32_t threat = 0;
+    int32_t bearing = 0;
+    int32_t range = 0;
+};
+
+
+/***************************************************************************************************
+ * @brief Worker-Thread der Verkehrswarnung.
+ *
+ * publish() ist der einzige Schreiber des Rings und wird aus dem Sim-Thread aufgerufen: ein @em memcpy
+ * des Snapshots und das Wecken des Workers. Der Worker liest jeweils den neuesten Snapshot (ein zu
+ * langsamer Worker überspringt Snapshots) und übergibt die Nachrichten von TrafficAdvisor an @em sink;
+ * @em sink wird im Worker-Thread aufgerufen.
+ **************************************************************************************************/
+class TrafficMonitor {
+public:
+    using Sink = void (*)(const char *message, size_t length, void *context);
+
+    TrafficMonitor(uint8_t bearingId, uint8_t rangeId, Sink sink, void *context);
+    ~TrafficMonitor();
+
+    TrafficMonitor(const TrafficMonitor &) = delete;
+    TrafficMonitor &operator=(const TrafficMonitor &) = delete;
+
+    /// @brief Snapshot übergeben. Nur aus dem Sim-Thread.
+    void publish(double simTime, const float *values);
+
+    /// @brief Laufende Nummer des zuletzt übergebenen Snapshots.
+    uint32_t getPublished() const { return ring.getHead(); }
+
+    /// @brief Laufende Nummer des zuletzt ausgewerteten Snapshots.
+    uint32_t getProcessed() const { return processed.load(std::memory_order_acquire); }
+
+    /// @brief Summe der Rechenzeit des Workers in ns (Lesen, Auswerten, @em sink).
+    uint64_t getWorkerNanos() const { return workerNanos.load(std::memory_order_relaxed); }
+
+    /// @brief Anzahl der an @em sink übergebenen Nachrichten (Zeilen).
+    uint32_t getMessageCount() const { return messageCount.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    SnapshotRing<TRAFFIC_VALUES, 3> ring{1};
+    TrafficAdvisor advisor;
+    Sink sink;
+    void *context;
+    float values[TRAFFIC_VALUES];                   ///< Kopie des Snapshots, nur im Worker
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool isStopping = false;                        ///< Unter @em mutex
+    std::atomic<uint32_t> processed{0};
+    std::atomic<uint64_t> workerNanos{0};
+    std::atomic<uint32_t> messageCount{0};
+    std::thread worker;
+};
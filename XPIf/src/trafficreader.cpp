@@ -0,0 +1,44 @@
+/***************************************************************************************************
+ * @file trafficreader.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung von @em TrafficReader über das SDK.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <trafficreader.hpp>
+
+#include <XPLMPlanes.h>
+
+#include <algorithm>
+
+static const char *const COMPONENT_NAMES[6] = {
+    "sim/cockpit2/tcas/targets/position/x",  "sim/cockpit2/tcas/targets/position/y",
+    "sim/cockpit2/tcas/targets/position/z",  "sim/cockpit2/tcas/targets/position/vx",
+    "sim/cockpit2/tcas/targets/position/vy", "sim/cockpit2/tcas/targets/position/vz",
+};
+static const size_t COMPONENT_OFFSETS[6] = {TRAFFIC_X, TRAFFIC_Y, TRAFFIC_Z, TRAFFIC_VX, TRAFFIC_VY, TRAFFIC_VZ};
+
+
+TrafficReader::TrafficReader() : heading(XPLMFindDataRef("sim/flightmodel/position/psi")) {
+    for (size_t i = 0; i < 6; ++i) {
+        components[i] = XPLMFindDataRef(COMPONENT_NAMES[i]);
+    }
+}
+
+
+uint32_t TrafficReader::read(float *values) const {
+    int total = 0, active = 0;
+    XPLMPluginID controller;
+    XPLMCountAircraft(&total, &active, &controller);
+    int count = std::min(active, static_cast<int>(TRAFFIC_MAX_AIRCRAFT));
+    for (size_t i = 0; (i < 6) && (count > 0); ++i) {
+        // Liefert ein Array weniger Elemente, gilt die kleinere Anzahl für alle
+        count = (components[i] == nullptr) ? 0 : XPLMGetDatavf(components[i], values + COMPONENT_OFFSETS[i], 0, count);
+    }
+    values[TRAFFIC_COUNT] = static_cast<float>(count);
+    values[TRAFFIC_HEADING] = (heading == nullptr) ? 0.0f : XPLMGetDataf(heading);
+    return static_cast<uint32_t>(count);
+}
@@ -0,0 +1,46 @@
+/***************************************************************************************************
+ * @file trafficreader.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Snapshot der Verkehrswarnung aus den Array-Datarefs `sim/cockpit2/tcas/targets/position/...`.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Im Plugin ruft ein Flight-Loop mit dem Intervall TRAFFIC_CYCLE_S read() auf und übergibt den
+ * Snapshot mit TrafficMonitor::publish() an den Worker-Thread. Nur aus dem Sim-Thread aufrufen.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <traffic.hpp>
+
+#include <XPLMDataAccess.h>
+
+#include <cstdint>
+
+
+/***************************************************************************************************
+ * @brief Liest je Zyklus `XPLMCountAircraft`, den Steuerkurs und 6 Arrays mit je einem `XPLMGetDatavf`.
+ *
+ * Die Array-Datarefs gibt es ab X-Plane 11.50. Fehlen sie, liefert read() 0 Flugzeuge und die
+ * Verkehrswarnung bleibt aus.
+ **************************************************************************************************/
+class TrafficReader {
+public:
+    /// @brief Datarefs suchen; in `XPluginEnable` anlegen.
+    TrafficReader();
+
+    /**
+     * @brief Snapshot lesen.
+     *
+     * @param values Puffer mit TRAFFIC_VALUES Werten; gefüllt werden TRAFFIC_COUNT, TRAFFIC_HEADING und
+     *               die ersten Elemente der Arrays.
+     * @return Anzahl der Flugzeuge einschließlich des eigenen; 0 ohne die Datarefs.
+     */
+    uint32_t read(float *values) const;
+
+private:
+    XPLMDataRef heading;
+    XPLMDataRef components[6];                  ///< x, y, z, vx, vy, vz in der Reihenfolge des Snapshots
+};
@@ -0,0 +1,407 @@
+/***************************************************************************************************
+ * @file transport.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Transporte zu den Panels.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <transport.hpp>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+uint64_t monotonicMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+static bool setNonBlocking(const int fd) {
+    const int flags = fcntl(fd, F_GETFL);
+    return (flags >= 0) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+
+bool makeAddress(const char *host, const uint16_t port, sockaddr_in &address) {
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    return inet_pton(AF_INET, host, &address.sin_addr) == 1;
+}
+
+
+/// Socket vom Typ @em type öffnen und mit @em host:@em port verbinden; -1 bei einem Fehler.
+static int connectSocket(const int type, const char *host, const uint16_t port) {
+    sockaddr_in address;
+    if (! makeAddress(host, port, address)) {
+        return -1;
+    }
+    const int fd = socket(AF_INET, type | SOCK_CLOEXEC, 0);
+    if ((fd >= 0) && (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+/**************************************************************************************************
+ * Transport
+ **************************************************************************************************/
+
+Transport::~Transport() = default;
+
+void Transport::resend(uint64_t) {}
+
+
+/**************************************************************************************************
+ * StreamTransport
+ **************************************************************************************************/
+
+StreamTransport::StreamTransport(const int fd) : descriptor(fd) {
+    struct stat status;
+    isSocket = (fstat(fd, &status) == 0) && S_ISSOCK(status.st_mode);
+    broken = (fd < 0) || ! setNonBlocking(fd);
+}
+
+
+StreamTransport::~StreamTransport() {
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+}
+
+
+bool StreamTransport::send(const char *message, size_t length) {
+    while (! broken && (length != 0)) {
+        // MSG_NOSIGNAL: eine getrennte TCP-Verbindung soll kein SIGPIPE auslösen
+        const ssize_t written = isSocket ? ::send(descriptor, message, length, MSG_NOSIGNAL)
+                                         : write(descriptor, message, length);
+        if (written > 0) {
+            message += written;
+            length -= static_cast<size_t>(written);
+        } else if ((written < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            pollfd writable = {descriptor, POLLOUT, 0};
+            if (poll(&writable, 1, STREAM_SEND_TIMEOUT_MS) <= 0) {
+                return false;
+            }
+        } else if ((written < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            broken = true;
+        }
+    }
+    return ! broken;
+}
+
+
+size_t StreamTransport::receive(char *buffer, const size_t size) {
+    if (broken || (size == 0)) {
+        return 0;
+    }
+    const ssize_t received = read(descriptor, buffer, size);
+    if (received > 0) {
+        return static_cast<size_t>(received);
+    }
+    if ((received == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+        broken = true;                  // Gegenstelle geschlossen bzw. tty verschwunden (EIO)
+    }
+    return 0;
+}
+
+
+/**************************************************************************************************
+ * SerialTransport
+ **************************************************************************************************/
+
+std::unique_ptr<SerialTransport> SerialTransport::open(const char *path) {
+    const int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<SerialTransport> transport(new SerialTransport(fd));
+    return transport->isBroken() ? nullptr : std::move(transport);
+}
+
+
+SerialTransport::SerialTransport(const int fd) : StreamTransport(fd) {
+    termios settings;
+    if (broken || (tcgetattr(fd, &settings) != 0)) {
+        broken = true;
+        return;
+    }
+    cfmakeraw(&settings);
+    settings.c_cflag |= CLOCAL | CREAD;
+    cfsetispeed(&settings, B115200);
+    cfsetospeed(&settings, B115200);
+    broken = (tcsetattr(fd, TCSANOW, &settings) != 0);
+}
+
+
+/**************************************************************************************************
+ * TcpTransport
+ **************************************************************************************************/
+
+std::unique_ptr<TcpTransport> TcpTransport::connect(const char *host, const uint16_t port) {
+    const int fd = connectSocket(SOCK_STREAM, host, port);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<TcpTransport> transport(new TcpTransport(fd));
+    return transport->isBroken() ? nullptr : std::move(transport);
+}
+
+
+TcpTransport::TcpTransport(const int fd) : StreamTransport(fd) {
+    const int noDelay = 1;
+    broken = broken || (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)) != 0);
+}
+
+
+/**************************************************************************************************
+ * UdpTransport
+ **************************************************************************************************/
+
+std::unique_ptr<UdpTransport> UdpTransport::connect(const char *host, const uint16_t port) {
+    const int fd = connectSocket(SOCK_DGRAM, host, port);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<UdpTransport> transport(new UdpTransport(fd));
+    return transport->isBroken() ? nullptr : std::move(transport);
+}
+
+
+UdpTransport::UdpTransport(const int fd) : descriptor(fd) {
+    broken = (fd < 0) || ! setNonBlocking(fd);
+}
+
+
+UdpTransport::~UdpTransport() {
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+}
+
+
+bool UdpTransport::send(const char *message, const size_t length) {
+    bool isSent = ! broken;
+    const char *end = message + length;
+    while (message < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(message, '\n', static_cast<size_t>(end - message)));
+        const size_t lineLength = static_cast<size_t>(((lineEnd == nullptr) ? end : lineEnd) - message);
+        if (lineLength != 0) {
+            isSent = sendMessage(message, lineLength) && isSent;
+        }
+        message += lineLength + 1;
+    }
+    return isSent;
+}
+
+
+bool UdpTransport::sendMessage(const char *message, const size_t length) {
+    if (broken || (length > UDP_MAX_MESSAGE)) {
+        return false;
+    }
+    char datagram[sizeof(Pending::datagram)];
+    const uint32_t sequence = repeat ? nextSequence : 0;
+    const int prefix = snprintf(datagram, sizeof(datagram), "%u;", sequence);
+    memcpy(datagram + prefix, message, length);
+    const size_t datagramLength = static_cast<size_t>(prefix) + length;
+
+    if (repeat) {
+        Pending *slot = nullptr;
+        for (Pending &entry : pending) {
+            if (entry.sequence == 0) {
+                slot = &entry;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            ++overflows;
+            return false;
+        }
+        nextSequence = (nextSequence == UINT32_MAX) ? 1 : nextSequence + 1;
+        slot->sequence = sequence;
+        slot->resends = 0;
+        slot->length = static_cast<uint8_t>(datagramLength);
+        slot->sentMicros = monotonicMicros();
+        memcpy(slot->datagram, datagram, datagramLength);
+    }
+    // Ein Fehler (z.B. ECONNREFUSED, solange das Panel nicht läuft) wird durch resend() ausgeglichen.
+    ::send(descriptor, datagram, datagramLength, MSG_NOSIGNAL);
+    return true;
+}
+
+
+size_t UdpTransport::receive(char *buffer, const size_t size) {
+    size_t received = 0;
+    char datagram[sizeof(Pending::datagram)];
+    while (! broken && (size - received > UDP_MAX_MESSAGE)) {
+        const ssize_t length = recv(descriptor, datagram, sizeof(datagram) - 1, 0);
+        if (length < 0) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                break;
+            }
+            continue;                   // ECONNREFUSED einer früheren Sendung, EINTR
+        }
+        datagram[length] = '\0';
+        char *payload = nullptr;
+        if (strncmp(datagram, "ACK;", 4) == 0) {
+            const unsigned long sequence = strtoul(datagram + 4, &payload, 10);
+            for (Pending &entry : pending) {
+                if ((entry.sequence != 0) && (entry.sequence == sequence)) {
+                    entry.sequence = 0;
+                }
+            }
+            continue;
+        }
+        const unsigned long sequence = strtoul(datagram, &payload, 10);
+        if ((payload == datagram) || (*payload != ';') || (sequence > UINT32_MAX)) {
+            continue;                   // keine Sequenznummer: kein Datagramm von XPIf/Panel
+        }
+        ++payload;
+        if (sequence != 0) {
+            acknowledge(static_cast<uint32_t>(sequence));
+            if (isDuplicate(static_cast<uint32_t>(sequence))) {
+                ++duplicates;
+                continue;
+            }
+        }
+        const size_t payloadLength = static_cast<size_t>(datagram + length - payload);
+        if ((payloadLength == 0) || (payloadLength > UDP_MAX_MESSAGE)) {
+            continue;
+        }
+        memcpy(buffer + received, payload, payloadLength);
+        received += payloadLength;
+        buffer[received++] = '\n';
+    }
+    return received;
+}
+
+
+void UdpTransport::acknowledge(const uint32_t sequence) {
+    char ack[16];
+    const int length = snprintf(ack, sizeof(ack), "ACK;%u", sequence);
+    ::send(descriptor, ack, static_cast<size_t>(length), MSG_NOSIGNAL);
+}
+
+
+/**
+ * Fenster der letzten 64 Sequenznummern. Liegt eine Nummer weiter als das Fenster zurück, hat die
+ * Gegenstelle neu gestartet; das Fenster beginnt dann bei ihr neu.
+ */
+bool UdpTransport::isDuplicate(const uint32_t sequence) {
+    if (sequence > highestReceived) {
+        const uint32_t shift = sequence - highestReceived;
+        receivedWindow = (shift >= 64) ? 1 : ((receivedWindow << shift) | 1);
+        highestReceived = sequence;
+        return false;
+    }
+    const uint32_t age = highestReceived - sequence;
+    if (age >= 64) {
+        highestReceived = sequence;
+        receivedWindow = 1;
+        return false;
+    }
+    const uint64_t bit = uint64_t(1) << age;
+    const bool isSeen = (receivedWindow & bit) != 0;
+    receivedWindow |= bit;
+    return isSeen;
+}
+
+
+void UdpTransport::resend(const uint64_t nowMicros) {
+    for (Pending &entry : pending) {
+        if ((entry.sequence == 0) || (nowMicros - entry.sentMicros < UDP_RESEND_MICROS)) {
+            continue;
+        }
+        if (entry.resends == UDP_MAX_RESENDS) {
+            entry.sequence = 0;
+            ++lost;
+            continue;
+        }
+        ++entry.resends;
+        ++resent;
+        entry.sentMicros = nowMicros;
+        ::send(descriptor, entry.datagram, entry.length, MSG_NOSIGNAL);
+    }
+}
+
+
+size_t UdpTransport::getPendingCount() const {
+    size_t count = 0;
+    for (const Pending &entry : pending) {
+        count += (entry.sequence != 0) ? 1 : 0;
+    }
+    return count;
+}
+
+
+/**************************************************************************************************
+ * openTransport
+ **************************************************************************************************/
+
+/// `host:port` zerlegen.
+static bool splitHostPort(const std::string &address, std::string &host, uint16_t &port) {
+    const size_t colon = address.rfind(':');
+    if ((colon == std::string::npos) || (colon == 0) || (colon + 1 == address.size())) {
+        return false;
+    }
+    char *end = nullptr;
+    const unsigned long number = strtoul(address.c_str() + colon + 1, &end, 10);
+    if ((*end != '\0') || (number == 0) || (number > 65535)) {
+        return false;
+    }
+    host = address.substr(0, colon);
+    port = static_cast<uint16_t>(number);
+    return true;
+}
+
+
+std::unique_ptr<Transport> openTransport(const std::string &url, std::string &error) {
+    const bool isTcp = (url.compare(0, 6, "tcp://") == 0);
+    const bool isUdp = (url.compare(0, 6, "udp://") == 0);
+    std::unique_ptr<Transport> transport;
+    if (isTcp || isUdp) {
+        std::string host;
+        uint16_t port = 0;
+        if (! splitHostPort(url.substr(6), host, port)) {
+            error = "Adresse ungültig (erwartet: IPv4-Adresse:Port): " + url;
+            return nullptr;
+        }
+        if (isTcp) {
+            transport = TcpTransport::connect(host.c_str(), port);
+        } else {
+            transport = UdpTransport::connect(host.c_str(), port);
+        }
+    } else {
+        std::string path = url;
+        if (url.compare(0, 9, "serial://") == 0) {
+            path = url.substr(9);
+        } else if (url.compare(0, 7, "serial:") == 0) {
+            path = url.substr(7);
+        }
+        transport = SerialTransport::open(path.c_str());
+    }
+    if (transport == nullptr) {
+        error = std::string("Öffnen fehlgeschlagen (") + strerror(errno) + "): " + url;
+    }
+    return transport;
+}
@@ -0,0 +1,192 @@
+/***************************************************************************************************
+ * @file transport.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Transporte zu den Panels: USB-Seriell, TCP und UDP mit Bestätigung.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Der Daemon spricht mit jedem Panel über einen Transport. Alle Transporte arbeiten mit nicht
+ * blockierenden Deskriptoren, damit eine Ereignisschleife (epoll) alle Panels gemeinsam bedient.
+ * Nachrichten sind Zeilen wie auf der seriellen Schnittstelle (`Device;Event;P1;P2`, durch `\n`
+ * getrennt); UDP setzt sie in Datagramme mit Sequenznummer um. Vgl. Doku/xpif.md, Abschnitt
+ * "Panels über das Netzwerk".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+const uint32_t SERIAL_BAUD = 115200;                ///< Baudrate der Arduinos
+const uint64_t UDP_RESEND_MICROS = 50000;           ///< Wartezeit bis zur Wiederholung einer Nachricht
+const uint8_t UDP_MAX_RESENDS = 3;                  ///< Wiederholungen, danach gilt die Nachricht als verloren
+const size_t UDP_MAX_MESSAGE = 64;                  ///< Längste Nachricht (ohne Sequenznummer)
+const size_t UDP_PENDING_SLOTS = 32;                ///< Unbestätigte Nachrichten je Panel
+
+
+/// Monotone Zeit in µs für die Wiederholungen.
+uint64_t monotonicMicros();
+
+
+/***************************************************************************************************
+ * @brief Schnittstelle eines Transports.
+ **************************************************************************************************/
+class Transport {
+public:
+    virtual ~Transport();
+
+    /// @brief Deskriptor für die Ereignisschleife (lesbar = receive() aufrufen).
+    virtual int fd() const = 0;
+
+    /**
+     * @brief Eine oder mehrere durch `\n` abgeschlossene Nachrichten senden.
+     *
+     * @return false Der Transport ist gestört oder kann die Nachrichten nicht aufnehmen.
+     */
+    virtual bool send(const char *message, size_t length) = 0;
+
+    /**
+     * @brief Empfangene Zeichen (Zeilen mit `\n`) nach @em buffer kopieren; blockiert nicht.
+     *
+     * @return Anzahl der Zeichen; 0, falls nichts vorliegt.
+     */
+    virtual size_t receive(char *buffer, size_t size) = 0;
+
+    /// @brief Regelmäßig aufrufen: wiederholt unbestätigte Nachrichten (nur UDP).
+    virtual void resend(uint64_t nowMicros);
+
+    /// @brief Verbindung getrennt oder Deskriptor gestört; der Transport muss neu geöffnet werden.
+    bool isBroken() const { return broken; }
+
+protected:
+    bool broken = false;
+};
+
+
+/***************************************************************************************************
+ * @brief Transport über einen Bytestrom (tty oder TCP-Socket); der Deskriptor gehört dem Transport.
+ *
+ * send() schreibt vollständig: Ist der Sendepuffer des Kernels voll, wird höchstens
+ * STREAM_SEND_TIMEOUT_MS gewartet.
+ **************************************************************************************************/
+class StreamTransport : public Transport {
+public:
+    static const int STREAM_SEND_TIMEOUT_MS = 100;
+
+    explicit StreamTransport(int fd);
+    ~StreamTransport() override;
+
+    int fd() const override { return descriptor; }
+    bool send(const char *message, size_t length) override;
+    size_t receive(char *buffer, size_t size) override;
+
+private:
+    int descriptor;
+    bool isSocket;          ///< send() statt write(), damit kein SIGPIPE ausgelöst wird
+};
+
+
+/***************************************************************************************************
+ * @brief USB-Seriell (oder Pseudo-Terminal): raw, 8N1, SERIAL_BAUD.
+ **************************************************************************************************/
+class SerialTransport : public StreamTransport {
+public:
+    /// @brief tty @em path öffnen. @return nullptr bei einem Fehler.
+    static std::unique_ptr<SerialTransport> open(const char *path);
+
+    /// @brief Bereits geöffnetes tty übernehmen und einstellen (z.B. von openpty()).
+    explicit SerialTransport(int fd);
+};
+
+
+/***************************************************************************************************
+ * @brief TCP-Verbindung mit `TCP_NODELAY` (kein Nagle).
+ **************************************************************************************************/
+class TcpTransport : public StreamTransport {
+public:
+    /// @brief Verbindung zu @em host:@em port aufbauen. @return nullptr bei einem Fehler.
+    static std::unique_ptr<TcpTransport> connect(const char *host, uint16_t port);
+
+    /// @brief Verbundenen Socket übernehmen (z.B. von accept()).
+    explicit TcpTransport(int fd);
+};
+
+
+/***************************************************************************************************
+ * @brief UDP: ein Datagramm je Nachricht, `Seq;Device;Event;P1;P2`, bestätigt mit `ACK;Seq`.
+ *
+ * * send() teilt den Text an `\n` und sendet jede Nachricht mit der nächsten Sequenznummer (ab 1).
+ *   Sie bleibt in einer festen Tabelle, bis `ACK;Seq` kommt; resend() wiederholt sie nach
+ *   UDP_RESEND_MICROS, höchstens UDP_MAX_RESENDS Mal.
+ * * Mit setRepeat(false) gehen Nachrichten mit der Sequenznummer 0 hinaus: ohne Bestätigung und
+ *   Wiederholung (Anzeigen, die ohnehin jeden Frame neu kommen).
+ * * receive() bestätigt jede Nachricht mit Sequenznummer, verwirft Duplikate (Fenster der letzten
+ *   64 Sequenznummern) und liefert die Nachrichten ohne Sequenznummer mit `\n` ab. @em size muss
+ *   mindestens UDP_MAX_MESSAGE + 1 sein.
+ **************************************************************************************************/
+class UdpTransport : public Transport {
+public:
+    /// @brief Socket für @em host:@em port öffnen (lokaler Port beliebig). @return nullptr bei einem Fehler.
+    static std::unique_ptr<UdpTransport> connect(const char *host, uint16_t port);
+
+    /// @brief Gebundenen und mit dem Panel verbundenen UDP-Socket übernehmen.
+    explicit UdpTransport(int fd);
+    ~UdpTransport() override;
+
+    int fd() const override { return descriptor; }
+    bool send(const char *message, size_t length) override;
+    size_t receive(char *buffer, size_t size) override;
+    void resend(uint64_t nowMicros) override;
+
+    void setRepeat(bool isRepeat) { repeat = isRepeat; }
+    size_t getPendingCount() const;
+    uint32_t getResent() const { return resent; }
+    uint32_t getLost() const { return lost; }               ///< Nach allen Wiederholungen unbestätigt
+    uint32_t getDuplicates() const { return duplicates; }   ///< Verworfene doppelte Nachrichten
+    uint32_t getOverflows() const { return overflows; }     ///< Abgewiesen, weil die Tabelle voll war
+
+private:
+    struct Pending {
+        uint32_t sequence;                  ///< 0 = frei
+        uint8_t resends;
+        uint8_t length;
+        uint64_t sentMicros;
+        char datagram[UDP_MAX_MESSAGE + 12];
+    };
+
+    int descriptor;
+    bool repeat = true;
+    uint32_t nextSequence = 1;
+    Pending pending[UDP_PENDING_SLOTS] = {};
+    uint32_t highestReceived = 0;           ///< Höchste empfangene Sequenznummer
+    uint64_t receivedWindow = 0;            ///< Bit n: highestReceived - n wurde empfangen
+    uint32_t resent = 0;
+    uint32_t lost = 0;
+    uint32_t duplicates = 0;
+    uint32_t overflows = 0;
+
+    bool sendMessage(const char *message, size_t length);
+    void acknowledge(uint32_t sequence);
+    bool isDuplicate(uint32_t sequence);
+};
+
+
+/**
+ * @brief Transport nach der Angabe der Konfiguration öffnen.
+ *
+ * `udp://192.168.1.40:4900`, `tcp://192.168.1.41:4900`, `serial:///dev/ttyACM0` oder nur ein Pfad.
+ * Hostnamen müssen numerische IPv4-Adressen sein.
+ *
+ * @return nullptr bei einem Fehler; die Ursache steht in @em error.
+ */
+std::unique_ptr<Transport> openTransport(const std::string &url, std::string &error);
+
+
+/// @brief IPv4-Adresse aus @em host (numerisch) und @em port. @return false Keine gültige Adresse.
+bool makeAddress(const char *host, uint16_t port, sockaddr_in &address);
@@ -0,0 +1,256 @@
+/***************************************************************************************************
+ * @file txscheduler.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Verteilt die Bandbreite eines Panels auf die zu sendenden Werte (Weighted Fair Queueing).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Vgl. Doku/xpif.md, Abschnitt "Bandbreite je Panel verteilen".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+const size_t TX_MAX_CLASSES = 4;        ///< Klassen je Panel
+const size_t TX_MAX_VALUES = 128;       ///< Abonnierte Werte je Panel
+const size_t TX_MESSAGE_SIZE = 64;      ///< Größte Nachricht (ein USB-Paket des 16U2)
+const uint32_t TX_LINK_BACKLOG = 64;    ///< Byte, die der Scheduler dem Link vorauseilen darf
+
+
+/***************************************************************************************************
+ * @brief Scheduler der ausgehenden Werte eines Panels.
+ *
+ * * Jeder Wert (Abonnement) gehört zu einer Klasse mit Gewicht, max. Rate und max. Latenz; Rate und
+ *   Latenz können je Wert überschrieben werden. Die max. Rate begrenzt ein Token-Bucket je Wert.
+ * * Je Klasse gibt es eine Warteschlange (FIFO) mit höchstens einem Eintrag je Wert. update() eines
+ *   wartenden Werts ersetzt nur die Nachricht (der neueste Wert gewinnt); die Wartezeit zählt ab der
+ *   ersten noch nicht gesendeten Änderung.
+ * * next() wählt unter den Einträgen, deren Token-Bucket ein Token hat:
+ *   1. den Eintrag mit der frühesten Frist, wenn er drei Viertel seiner max. Latenz gewartet hat;
+ *   2. sonst den ältesten Eintrag der Klasse mit der kleinsten virtuellen Endzeit (Self-Clocked Fair
+ *      Queueing: `max(V, F_Klasse) + Länge / Gewicht`; die Startzeit `max(V, F_Klasse)` wird
+ *      festgehalten, sobald die Klasse einen sendbaren Eintrag hat, V ist die Endzeit der zuletzt
+ *      gesendeten Nachricht).
+ * * Die Byterate des Links wird mitgerechnet; next() liefert nichts, solange der Link mehr als
+ *   @em backlogBytes im Rückstand ist.
+ *
+ * Alle Zeiten in µs. Es wird kein Speicher angefordert; next() durchsucht die Warteschlangen linear
+ * (höchstens TX_MAX_VALUES Einträge).
+ **************************************************************************************************/
+class TxScheduler {
+public:
+    /**
+     * @param bytesPerSecond Rate des Links abzüglich der Reserve für Antworten auf Schalter, z.B.
+     *                       90 % von 11520 Byte/s bei 115200 Baud.
+     * @param backlogBytes   So viele Byte darf der Link im Rückstand sein (Puffer von tty und 16U2).
+     */
+    explicit TxScheduler(const uint32_t bytesPerSecond, const uint32_t backlogBytes = TX_LINK_BACKLOG)
+        : bytesPerSecond(bytesPerSecond), backlogUs(static_cast<uint64_t>(backlogBytes) * 1000000 / bytesPerSecond) {}
+
+    /**
+     * @brief Klasse anlegen.
+     *
+     * @param weight       Gewicht beim Weighted Fair Queueing; mindestens 1.
+     * @param maxRate      Nachrichten je Sekunde und Wert; 0 = unbegrenzt.
+     * @param maxLatencyMs Vorgabe der Wartezeit je Wert. Sie sollte größer als 1 / @em maxRate sein,
+     *                     denn ein Wert, der sich schneller ändert, wartet auf sein Token.
+     * @return Nummer der Klasse; -1, falls @em weight 0 ist oder es schon TX_MAX_CLASSES Klassen gibt.
+     */
+    int addClass(const uint32_t weight, const uint32_t maxRate, const uint32_t maxLatencyMs) {
+        if ((weight == 0) || (classCount == TX_MAX_CLASSES)) {
+            return -1;
+        }
+        Class &entry = classes[classCount];
+        entry.weight = weight;
+        entry.intervalUs = rateToInterval(maxRate);
+        entry.latencyUs = maxLatencyMs * 1000;
+        entry.finish = 0;
+        entry.isBacklogged = false;
+        entry.head = entry.tail = NONE;
+        return static_cast<int>(classCount++);
+    }
+
+    /**
+     * @brief Wert anlegen.
+     *
+     * @param maxRate, maxLatencyMs Überschreiben die Vorgabe der Klasse; negativ: Vorgabe der Klasse.
+     * @return Nummer des Werts; -1, falls die Klasse unbekannt ist oder es schon TX_MAX_VALUES Werte gibt.
+     */
+    int addValue(const size_t classId, const int32_t maxRate = -1, const int32_t maxLatencyMs = -1) {
+        if ((classId >= classCount) || (valueCount == TX_MAX_VALUES)) {
+            return -1;
+        }
+        Value &value = values[valueCount];
+        value.classId = static_cast<uint8_t>(classId);
+        value.isQueued = false;
+        value.next = NONE;
+        value.intervalUs = (maxRate < 0) ? classes[classId].intervalUs : rateToInterval(static_cast<uint32_t>(maxRate));
+        value.latencyUs = (maxLatencyMs < 0) ? classes[classId].latencyUs : static_cast<uint32_t>(maxLatencyMs) * 1000;
+        value.nextTokenUs = 0;
+        return static_cast<int>(valueCount++);
+    }
+
+    /**
+     * @brief Neue Nachricht für Wert @em value; ersetzt eine noch wartende.
+     *
+     * @return false Wert unbekannt oder Nachricht länger als TX_MESSAGE_SIZE.
+     */
+    bool update(const size_t value, const char *message, const size_t length, const uint64_t nowUs) {
+        if ((value >= valueCount) || (length == 0) || (length > TX_MESSAGE_SIZE)) {
+            return false;
+        }
+        Value &entry = values[value];
+        memcpy(entry.message, message, length);
+        entry.length = static_cast<uint8_t>(length);
+        if (entry.isQueued) {
+            ++replaced;
+            return true;
+        }
+        entry.isQueued = true;
+        entry.queuedUs = nowUs;
+        entry.next = NONE;
+        Class &queue = classes[entry.classId];
+        if (queue.tail == NONE) {
+            queue.head = static_cast<uint16_t>(value);
+        } else {
+            values[queue.tail].next = static_cast<uint16_t>(value);
+        }
+        queue.tail = static_cast<uint16_t>(value);
+        return true;
+    }
+
+    /**
+     * @brief Nächste zu sendende Nachricht entnehmen.
+     *
+     * @param out Puffer für TX_MESSAGE_SIZE Zeichen.
+     * @return Länge der Nachricht; 0, falls der Link im Rückstand ist oder kein Eintrag ein Token hat.
+     */
+    size_t next(const uint64_t nowUs, char *out) {
+        if (linkBusyUs > nowUs + backlogUs) {
+            return 0;
+        }
+        uint16_t urgent = NONE, urgentPrevious = NONE;
+        uint64_t urgentDeadline = UINT64_MAX;
+        uint16_t chosen[TX_MAX_CLASSES], previous[TX_MAX_CLASSES];
+        for (size_t c = 0; c < classCount; ++c) {
+            chosen[c] = NONE;
+            uint16_t before = NONE;
+            for (uint16_t v = classes[c].head; v != NONE; before = v, v = values[v].next) {
+                const Value &entry = values[v];
+                if (entry.nextTokenUs > nowUs) {
+                    continue;
+                }
+                if (chosen[c] == NONE) {
+                    chosen[c] = v;
+                    previous[c] = before;
+                    if (! classes[c].isBacklogged) {
+                        classes[c].start = (classes[c].finish > virtualTime) ? classes[c].finish : virtualTime;
+                        classes[c].isBacklogged = true;
+                    }
+                }
+                const uint64_t deadline = entry.queuedUs + entry.latencyUs;
+                if ((nowUs + entry.latencyUs / 4 >= deadline) && (deadline < urgentDeadline)) {
+                    urgent = v;
+                    urgentPrevious = before;
+                    urgentDeadline = deadline;
+                }
+            }
+        }
+
+        uint16_t send = urgent, sendPrevious = urgentPrevious;
+        if (send == NONE) {
+            uint64_t smallestFinish = UINT64_MAX;
+            for (size_t c = 0; c < classCount; ++c) {
+                if ((chosen[c] != NONE) && (finishTime(c, values[chosen[c]].length) < smallestFinish)) {
+                    smallestFinish = finishTime(c, values[chosen[c]].length);
+                    send = chosen[c];
+                    sendPrevious = previous[c];
+                }
+            }
+            if (send == NONE) {
+                return 0;
+            }
+        } else {
+            ++urgentSent;
+        }
+
+        Value &entry = values[send];
+        Class &queue = classes[entry.classId];
+        if (sendPrevious == NONE) {
+            queue.head = entry.next;
+        } else {
+            values[sendPrevious].next = entry.next;
+        }
+        if (queue.tail == send) {
+            queue.tail = sendPrevious;
+        }
+        entry.isQueued = false;
+        queue.finish = virtualTime = finishTime(entry.classId, entry.length);
+        queue.isBacklogged = false;
+        if (entry.intervalUs > 0) {
+            entry.nextTokenUs = nowUs + entry.intervalUs;
+        }
+        if (nowUs > entry.queuedUs + entry.latencyUs) {
+            ++late;
+        }
+        linkBusyUs = ((linkBusyUs > nowUs) ? linkBusyUs : nowUs) + entry.length * 1000000ULL / bytesPerSecond;
+        ++sent;
+        memcpy(out, entry.message, entry.length);
+        return entry.length;
+    }
+
+    /// @brief Wartet ein Eintrag für Wert @em value?
+    bool isQueued(const size_t value) const { return (value < valueCount) && values[value].isQueued; }
+
+    uint32_t getSent() const { return sent; }               ///< Gesendete Nachrichten
+    uint32_t getReplaced() const { return replaced; }       ///< Durch einen neueren Wert ersetzte Nachrichten
+    uint32_t getUrgent() const { return urgentSent; }       ///< Wegen ihrer Frist vorgezogene Nachrichten
+    uint32_t getLate() const { return late; }               ///< Nach Ablauf der max. Latenz entnommene Nachrichten
+
+private:
+    static const uint16_t NONE = 0xffff;
+    static const uint64_t WEIGHT_SCALE = 1 << 16;   ///< Festkomma der virtuellen Zeit
+
+    struct Class {
+        uint32_t weight;
+        uint32_t intervalUs;        ///< Vorgaben der Werte
+        uint32_t latencyUs;
+        uint64_t start;             ///< Virtuelle Startzeit der nächsten Nachricht
+        uint64_t finish;            ///< Virtuelle Endzeit der zuletzt gesendeten Nachricht
+        bool isBacklogged;          ///< @em start gilt; gesetzt, sobald die Klasse einen sendbaren Eintrag hat
+        uint16_t head, tail;        ///< Warteschlange, verkettet über Value::next
+    };
+
+    struct Value {
+        uint8_t classId;
+        bool isQueued;
+        uint8_t length;
+        uint16_t next;
+        uint32_t intervalUs;        ///< Abstand der Tokens; 0 = unbegrenzt
+        uint32_t latencyUs;
+        uint64_t nextTokenUs;       ///< Ab hier hat der Token-Bucket wieder ein Token
+        uint64_t queuedUs;          ///< Erste noch nicht gesendete Änderung
+        char message[TX_MESSAGE_SIZE];
+    };
+
+    static uint32_t rateToInterval(const uint32_t rate) { return (rate == 0) ? 0 : 1000000 / rate; }
+
+    uint64_t finishTime(const size_t c, const size_t length) const {
+        return classes[c].start + length * WEIGHT_SCALE / classes[c].weight;
+    }
+
+    const uint32_t bytesPerSecond;
+    const uint64_t backlogUs;
+    uint64_t linkBusyUs = 0;        ///< Bis hierhin ist der Link mit den entnommenen Nachrichten belegt
+    uint64_t virtualTime = 0;       ///< Endzeit der zuletzt gesendeten Nachricht
+    size_t classCount = 0;
+    size_t valueCount = 0;
+    uint32_t sent = 0, replaced = 0, urgentSent = 0, late = 0;
+    Class classes[TX_MAX_CLASSES];
+    Value values[TX_MAX_VALUES];
+};
@@ -0,0 +1,287 @@
+/***************************************************************************************************
+ * @file xplaneudp.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Pakete der UDP-Schnittstelle von X-Plane (RREF, DREF, CMND) kodieren und dekodieren.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufbau der Pakete (alle Zahlen little-endian, wie X-Plane sie auf x86-64 und ARM sendet):
+ *
+ * | Paket          | Aufbau                                                          | Länge      |
+ * | -------------- | --------------------------------------------------------------- | ---------- |
+ * | RREF-Anfrage   | `"RREF\0"`, int32 Frequenz, int32 Index, char[400] Dataref       | 413        |
+ * | RREF-Antwort   | `"RREF,"`, n × {int32 Index, float Wert}                         | 5 + 8 n    |
+ * | DREF           | `"DREF\0"`, float Wert, char[500] Dataref                        | 509        |
+ * | CMND           | `"CMND\0"`, Command                                             | 5 + Länge  |
+ *
+ * Die Funktionen fordern keinen Speicher an; die Pakete liegen in Puffern des Aufrufers. Die
+ * Dekodierfunktionen für RREF-Anfrage, DREF und CMND braucht nur der UDP-Stellvertreter in den Tests.
+ * Vgl. Doku/xpif.md, Abschnitt "Betrieb ohne Plugin über UDP".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+const uint16_t XPLANE_UDP_PORT = 49000;         ///< Port, auf dem X-Plane die Pakete annimmt
+const size_t XPLANE_UDP_HEADER_SIZE = 5;        ///< Kennung aus vier Buchstaben und ein Trennzeichen
+const size_t RREF_NAME_SIZE = 400;              ///< Platz für den Namen des Datarefs einer RREF-Anfrage
+const size_t RREF_REQUEST_SIZE = XPLANE_UDP_HEADER_SIZE + 8 + RREF_NAME_SIZE;
+const size_t RREF_VALUE_SIZE = 8;               ///< Ein Wert einer RREF-Antwort: Index und Wert
+const size_t DREF_NAME_SIZE = 500;              ///< Platz für den Namen des Datarefs eines DREF-Pakets
+const size_t DREF_PACKET_SIZE = XPLANE_UDP_HEADER_SIZE + 4 + DREF_NAME_SIZE;
+const size_t XPLANE_UDP_MAX_PACKET = 1472;      ///< Nutzdaten eines UDP-Pakets ohne Fragmentierung (MTU 1500)
+
+
+/// Eine RREF-Anfrage; Frequenz 0 meldet das Abonnement ab.
+struct RrefRequest {
+    int32_t frequency;          ///< Antworten je Sekunde
+    int32_t index;              ///< Index, mit dem die Werte zurückkommen (= Index im Snapshot)
+    const char *dataRef;        ///< Zeigt in das Paket
+};
+
+
+/// Ein Wert einer RREF-Antwort.
+struct RrefValue {
+    int32_t index;
+    float value;
+};
+
+
+/// @name Zahlen little-endian lesen und schreiben, unabhängig von Ausrichtung und Byte-Reihenfolge
+/// @{
+inline void putLe32(char *out, const uint32_t value) {
+    for (int byte = 0; byte < 4; ++byte) {
+        out[byte] = static_cast<char>((value >> (8 * byte)) & 0xff);
+    }
+}
+
+inline uint32_t getLe32(const char *in) {
+    uint32_t value = 0;
+    for (int byte = 3; byte >= 0; --byte) {
+        value = (value << 8) | static_cast<uint8_t>(in[byte]);
+    }
+    return value;
+}
+
+inline void putLeFloat(char *out, const float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putLe32(out, bits);
+}
+
+inline float getLeFloat(const char *in) {
+    const uint32_t bits = getLe32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+/// @}
+
+
+/// Beginnt das Paket mit der Kennung @em tag (4 Buchstaben) und dem Trennzeichen @em separator?
+inline bool hasXplaneHeader(const char *packet, const size_t length, const char *tag, const char separator) {
+    return (length >= XPLANE_UDP_HEADER_SIZE) && (memcmp(packet, tag, 4) == 0) && (packet[4] == separator);
+}
+
+
+/**
+ * @brief RREF-Anfrage kodieren.
+ *
+ * @return Länge des Pakets; 0, falls @em size zu klein oder der Name zu lang ist.
+ */
+inline size_t encodeRrefRequest(char *packet, const size_t size, const int32_t frequency, const int32_t index,
+                                const char *dataRef) {
+    const size_t nameLength = strlen(dataRef);
+    if ((size < RREF_REQUEST_SIZE) || (nameLength >= RREF_NAME_SIZE)) {
+        return 0;
+    }
+    memcpy(packet, "RREF", 5);
+    putLe32(packet + 5, static_cast<uint32_t>(frequency));
+    putLe32(packet + 9, static_cast<uint32_t>(index));
+    memset(packet + 13, 0, RREF_NAME_SIZE);
+    memcpy(packet + 13, dataRef, nameLength);
+    return RREF_REQUEST_SIZE;
+}
+
+
+/// @brief RREF-Anfrage dekodieren. @return false Kein gültiges Paket.
+inline bool decodeRrefRequest(const char *packet, const size_t length, RrefRequest &request) {
+    if ((length != RREF_REQUEST_SIZE) || ! hasXplaneHeader(packet, length, "RREF", '\0')
+            || (memchr(packet + 13, '\0', RREF_NAME_SIZE) == nullptr)) {
+        return false;
+    }
+    request.frequency = static_cast<int32_t>(getLe32(packet + 5));
+    request.index = static_cast<int32_t>(getLe32(packet + 9));
+    request.dataRef = packet + 13;
+    return true;
+}
+
+
+/**
+ * @brief RREF-Antwort mit @em count Werten kodieren (UDP-Stellvertreter).
+ *
+ * @return Länge des Pakets; 0, falls @em size zu klein ist.
+ */
+inline size_t encodeRrefValues(char *packet, const size_t size, const RrefValue *values, const size_t count) {
+    const size_t length = XPLANE_UDP_HEADER_SIZE + count * RREF_VALUE_SIZE;
+    if (size < length) {
+        return 0;
+    }
+    memcpy(packet, "RREF,", XPLANE_UDP_HEADER_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        char *out = packet + XPLANE_UDP_HEADER_SIZE + i * RREF_VALUE_SIZE;
+        putLe32(out, static_cast<uint32_t>(values[i].index));
+        putLeFloat(out + 4, values[i].value);
+    }
+    return length;
+}
+
+
+/**
+ * @brief RREF-Antwort dekodieren und für jeden Wert @em onValue(index, value) aufrufen.
+ *
+ * X-Plane kennzeichnet Antworten mit `"RREF,"`; ältere Versionen senden `"RREFO"`. Ein Rest von
+ * weniger als 8 Byte am Ende macht das ganze Paket ungültig; dann wird kein Wert gemeldet.
+ *
+ * @return false Kein gültiges Paket.
+ */
+template <class OnValue>
+bool decodeRrefValues(const char *packet, const size_t length, OnValue onValue) {
+    if (! (hasXplaneHeader(packet, length, "RREF", ',') || hasXplaneHeader(packet, length, "RREF", 'O'))
+            || ((length - XPLANE_UDP_HEADER_SIZE) % RREF_VALUE_SIZE != 0)) {
+        return false;
+    }
+    for (const char *in = packet + XPLANE_UDP_HEADER_SIZE; in < packet + length; in += RREF_VALUE_SIZE) {
+        onValue(static_cast<int32_t>(getLe32(in)), getLeFloat(in + 4));
+    }
+    return true;
+}
+
+
+/**
+ * @brief DREF-Paket (Dataref schreiben) kodieren.
+ *
+ * @return Länge des Pakets; 0, falls @em size zu klein oder der Name zu lang ist.
+ */
+inline size_t encodeDref(char *packet, const size_t size, const float value, const char *dataRef) {
+    const size_t nameLength = strlen(dataRef);
+    if ((size < DREF_PACKET_SIZE) || (nameLength >= DREF_NAME_SIZE)) {
+        return 0;
+    }
+    memcpy(packet, "DREF", 5);
+    putLeFloat(packet + 5, value);
+    memset(packet + 9, 0, DREF_NAME_SIZE);
+    memcpy(packet + 9, dataRef, nameLength);
+    return DREF_PACKET_SIZE;
+}
+
+
+/// @brief DREF-Paket dekodieren; @em dataRef zeigt danach in das Paket. @return false Kein gültiges Paket.
+inline bool decodeDref(const char *packet, const size_t length, float &value, const char *&dataRef) {
+    if ((length != DREF_PACKET_SIZE) || ! hasXplaneHeader(packet, length, "DREF", '\0')
+            || (memchr(packet + 9, '\0', DREF_NAME_SIZE) == nullptr)) {
+        return false;
+    }
+    value = getLeFloat(packet + 5);
+    dataRef = packet + 9;
+    return true;
+}
+
+
+/**
+ * @brief CMND-Paket kodieren. Das Command wird ohne abschließendes '\\0' übertragen.
+ *
+ * @return Länge des Pakets; 0, falls @em size zu klein oder das Command leer ist.
+ */
+inline size_t encodeCmnd(char *packet, const size_t size, const char *command) {
+    const size_t commandLength = strlen(command);
+    const size_t length = XPLANE_UDP_HEADER_SIZE + commandLength;
+    if ((commandLength == 0) || (size < length)) {
+        return 0;
+    }
+    memcpy(packet, "CMND", 5);
+    memcpy(packet + XPLANE_UDP_HEADER_SIZE, command, commandLength);
+    return length;
+}
+
+
+/**
+ * @brief CMND-Paket dekodieren. Ein abschließendes '\\0' im Paket zählt nicht zum Command.
+ *
+ * @param command       Zeigt danach in das Paket; nicht mit '\\0' abgeschlossen.
+ * @param commandLength Länge des Commands.
+ * @return false Kein gültiges Paket.
+ */
+inline bool decodeCmnd(const char *packet, const size_t length, const char *&command, size_t &commandLength) {
+    if (! hasXplaneHeader(packet, length, "CMND", '\0')) {
+        return false;
+    }
+    command = packet + XPLANE_UDP_HEADER_SIZE;
+    const void *end = memchr(command, '\0', length - XPLANE_UDP_HEADER_SIZE);
+    commandLength = (end == nullptr) ? length - XPLANE_UDP_HEADER_SIZE
+                                     : static_cast<size_t>(static_cast<const char *>(end) - command);
+    return commandLength != 0;
+}
+
+
+/***************************************************************************************************
+ * @brief Sammelt die Commands eines Durchlaufs; gleiche Commands werden nur einmal gesendet.
+ *
+ * Die Commands werden nicht kopiert, sondern als Zeiger gemerkt; sie müssen bis zum Senden gültig
+ * bleiben (in der Regel Literale oder Strings der Konfiguration). Passen nicht alle Commands in die
+ * feste Tabelle, werden die überzähligen verworfen und gezählt.
+ *
+ * @tparam CAPACITY Maximale Anzahl verschiedener Commands je Durchlauf.
+ **************************************************************************************************/
+template <size_t CAPACITY>
+class CommandBatch {
+public:
+    /// @brief Command vormerken. @return false Die Tabelle ist voll; das Command wurde verworfen.
+    bool add(const char *command) {
+        for (size_t i = 0; i < count; ++i) {
+            if ((commands[i] == command) || (strcmp(commands[i], command) == 0)) {
+                return true;
+            }
+        }
+        if (count == CAPACITY) {
+            ++dropped;
+            return false;
+        }
+        commands[count++] = command;
+        return true;
+    }
+
+    /**
+     * @brief Am Ende des Durchlaufs je Command ein CMND-Paket kodieren und an @em send(packet, length)
+     *        übergeben; danach ist die Sammlung leer.
+     *
+     * @return Anzahl der gesendeten Commands.
+     */
+    template <class Send>
+    size_t flush(Send send) {
+        char packet[XPLANE_UDP_MAX_PACKET];
+        size_t sent = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t length = encodeCmnd(packet, sizeof(packet), commands[i]);
+            if (length != 0) {
+                send(packet, length);
+                ++sent;
+            }
+        }
+        count = 0;
+        return sent;
+    }
+
+    size_t size() const { return count; }
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    const char *commands[CAPACITY];
+    size_t count = 0;
+    uint32_t dropped = 0;
+};
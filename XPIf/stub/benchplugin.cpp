@@ -0,0 +1,159 @@
+/***************************************************************************************************
+ * @file benchplugin.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Kleines Plugin für den Benchmark mit der Stub-XPLM.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Solange es das eigentliche Plugin von XPIf noch nicht gibt, belastet dieses Plugin die Stub-XPLM so,
+ * wie es XPIf im Flight-Loop tun soll: Es liest je Frame die Datarefs für die Uhr und den Transponder,
+ * formatiert bei jeder Änderung eine Nachricht in einer FrameArena und schreibt sie an das Panel.
+ * Die Panels (Pfade der seriellen Schnittstellen bzw. Pseudo-Terminals) stehen durch Kommas getrennt
+ * in der Umgebungsvariablen XPIF_PANELS; die Uhr geht an das erste, der Transponder an das letzte.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <XPLMDataAccess.h>
+#include <XPLMMenus.h>
+#include <XPLMProcessing.h>
+#include <XPLMUtilities.h>
+
+#include <framearena.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+const size_t MAX_PANELS = 4;
+const size_t MESSAGE_LENGTH = 32;               ///< Platz für eine Nachricht "DEV;EVENT;P1;P2\n"
+const float STANDARD_PRESSURE_INHG = 29.92f;
+const float FEET_PER_INHG = 1000.0f;            ///< Näherung für die Druckhöhe in Bodennähe
+
+static int panels[MAX_PANELS];
+static size_t panelCount = 0;
+static FrameArena *arena = nullptr;
+
+static XPLMDataRef localTime;                   // s seit Mitternacht
+static XPLMDataRef zuluTime;
+static XPLMDataRef altitude;                    // ft
+static XPLMDataRef barometer;                   // Luftdruck in inHg
+static XPLMDataRef transponderCode;
+
+static int lastTime = -1;
+static int lastFlightLevel = -1;
+static int lastCode = -1;
+
+
+/// Panels aus XPIF_PANELS öffnen.
+static void openPanels() {
+    for (size_t i = 0; i < panelCount; ++i) {
+        close(panels[i]);
+    }
+    panelCount = 0;
+    const char *paths = getenv("XPIF_PANELS");
+    char path[256];
+    while ((paths != nullptr) && (*paths != '\0') && (panelCount < MAX_PANELS)) {
+        const size_t length = strcspn(paths, ",");
+        snprintf(path, sizeof(path), "%.*s", static_cast<int>(length), paths);
+        const int fd = open(path, O_WRONLY | O_NOCTTY | O_NONBLOCK);
+        if (fd >= 0) {
+            panels[panelCount++] = fd;
+        } else {
+            XPLMDebugString("XPIf: Panel lässt sich nicht öffnen\n");
+        }
+        paths += length + ((paths[length] == ',') ? 1 : 0);
+    }
+}
+
+
+/// Nachricht in der Arena formatieren und an ein Panel schicken.
+static void sendMessage(const size_t panel, const char *format, const int p1, const int p2 = 0) {
+    char *message = arena->allocateArray<char>(MESSAGE_LENGTH);
+    if ((message == nullptr) || (panel >= panelCount)) {
+        return;
+    }
+    const int length = snprintf(message, MESSAGE_LENGTH, format, p1, p2);
+    if (write(panels[panel], message, static_cast<size_t>(length)) < 0) {
+        // Panel voll oder getrennt: die Nachricht geht verloren, die nächste Änderung kommt wieder
+    }
+}
+
+
+/// HHMMSS aus Sekunden seit Mitternacht.
+static int toHhmmss(const int seconds) {
+    return (seconds / 3600 % 24) * 10000 + (seconds / 60 % 60) * 100 + seconds % 60;
+}
+
+
+static float flightLoop(float, float, int, void *) {
+    FrameArena::Scope frame(*arena);
+    const size_t clockPanel = 0;
+    const size_t xpdrPanel = (panelCount > 0) ? panelCount - 1 : 0;
+
+    const int time = static_cast<int>(XPLMGetDataf(zuluTime));
+    if (time != lastTime) {
+        lastTime = time;
+        sendMessage(clockPanel, "M803;TIME;%06d;%06d\n", toHhmmss(static_cast<int>(XPLMGetDataf(localTime))),
+                    toHhmmss(time));
+    }
+    const float pressureAltitude =
+        XPLMGetDataf(altitude) + (STANDARD_PRESSURE_INHG - XPLMGetDataf(barometer)) * FEET_PER_INHG;
+    const int flightLevel = static_cast<int>(pressureAltitude / 100.0f + 0.5f);
+    if (flightLevel != lastFlightLevel) {
+        lastFlightLevel = flightLevel;
+        sendMessage(xpdrPanel, "XPDR;F;%03d\n", flightLevel);
+    }
+    const int code = XPLMGetDatai(transponderCode);
+    if (code != lastCode) {
+        lastCode = code;
+        sendMessage(xpdrPanel, "XPDR;CODE;%04d\n", code);
+    }
+    return -1.0f;       // jeden Frame
+}
+
+
+static void menuHandler(void *, void *) { openPanels(); }
+
+
+PLUGIN_API int XPluginStart(char *outName, char *outSig, char *outDesc) {
+    strcpy(outName, "XPIf Benchmark");
+    strcpy(outSig, "de.harraeus.xpif.bench");
+    strcpy(outDesc, "Last für die Messung mit der Stub-XPLM");
+    arena = new FrameArena(4096);
+    localTime = XPLMFindDataRef("sim/time/local_time_sec");
+    zuluTime = XPLMFindDataRef("sim/time/zulu_time_sec");
+    altitude = XPLMFindDataRef("sim/cockpit2/gauges/indicators/altitude_ft_pilot");
+    barometer = XPLMFindDataRef("sim/weather/barometer_current_inhg");
+    transponderCode = XPLMFindDataRef("sim/cockpit2/radios/actuators/transponder_code");
+    XPLMMenuID menu = XPLMCreateMenu("XPIf", XPLMFindPluginsMenu(), 0, menuHandler, nullptr);
+    XPLMAppendMenuItem(menu, "Panels neu verbinden", nullptr, 0);
+    return 1;
+}
+
+
+PLUGIN_API int XPluginEnable() {
+    openPanels();
+    XPLMRegisterFlightLoopCallback(flightLoop, -1.0f, nullptr);
+    return 1;
+}
+
+
+PLUGIN_API void XPluginDisable() {
+    XPLMUnregisterFlightLoopCallback(flightLoop, nullptr);
+    for (size_t i = 0; i < panelCount; ++i) {
+        close(panels[i]);
+    }
+    panelCount = 0;
+}
+
+
+PLUGIN_API void XPluginStop() {
+    delete arena;
+    arena = nullptr;
+}
+
+
+PLUGIN_API void XPluginReceiveMessage(XPLMPluginID, int, void *) {}
@@ -0,0 +1,166 @@
+/***************************************************************************************************
+ * @file xplmrunner.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Benchmark-Programm: ein Plugin mit der Stub-XPLM N simulierte Minuten laufen lassen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufruf: xplmrunner <Plugin.so> <Minuten> <Profil> [Panels]
+ *
+ * Legt je Panel (Standard 2) ein Pseudo-Terminal an und übergibt deren Pfade in XPIF_PANELS, lädt das
+ * Plugin mit dlopen, ruft XPluginStart und XPluginEnable auf und simuliert dann so schnell wie möglich
+ * Frame für Frame. Gemessen wird die CPU-Zeit des Threads je Frame; die Pseudo-Terminals werden nach
+ * jedem Frame außerhalb der Messung gelesen und die Nachrichten (Zeilen) je Panel gezählt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <xplmstub.hpp>
+
+#include <XPLMDefs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+const float FRAMES_PER_SECOND = 60.0f;
+const size_t MAX_PANELS = 4;
+
+using StartFunction = int (*)(char *, char *, char *);
+using EnableFunction = int (*)();
+using StopFunction = void (*)();
+
+
+/// CPU-Zeit des aktuellen Threads in ns.
+static uint64_t threadCpuNanos() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+/// Echtzeit in s.
+static double wallSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+/// Pseudo-Terminal anlegen. @return Master-Seite; @em path erhält den Pfad der Slave-Seite.
+static int openPanel(std::string &path) {
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) {
+        return -1;
+    }
+    path = ptsname(master);
+    // Slave einmal offen halten, damit der Master bei fehlendem Leser kein EIO liefert
+    const int slave = open(path.c_str(), O_RDWR | O_NOCTTY);
+    termios settings;
+    tcgetattr(slave, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(slave, TCSANOW, &settings);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return master;
+}
+
+
+/// Alles Gesendete von einem Panel lesen. @return Anzahl der Zeilen.
+static unsigned long drainPanel(const int master) {
+    char buffer[4096];
+    unsigned long lines = 0;
+    ssize_t count;
+    while ((count = read(master, buffer, sizeof(buffer))) > 0) {
+        lines += static_cast<unsigned long>(std::count(buffer, buffer + count, '\n'));
+    }
+    return lines;
+}
+
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Aufruf: %s <Plugin.so> <Minuten> <Profil> [Panels]\n", argv[0]);
+        return 2;
+    }
+    const double minutes = atof(argv[2]);
+    const size_t panelCount = std::min(MAX_PANELS, static_cast<size_t>((argc > 4) ? atoi(argv[4]) : 2));
+
+    int panels[MAX_PANELS];
+    unsigned long messages[MAX_PANELS] = {};
+    std::string paths;
+    for (size_t i = 0; i < panelCount; ++i) {
+        std::string path;
+        panels[i] = openPanel(path);
+        if (panels[i] < 0) {
+            perror("Pseudo-Terminal");
+            return 1;
+        }
+        paths += (i > 0) ? "," + path : path;
+    }
+    setenv("XPIF_PANELS", paths.c_str(), 1);
+
+    stubSetFrameRate(FRAMES_PER_SECOND);
+    if (! stubLoadProfile(argv[3])) {
+        return 1;
+    }
+    void *plugin = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+    if (plugin == nullptr) {
+        fprintf(stderr, "%s\n", dlerror());
+        return 1;
+    }
+    const StartFunction start = reinterpret_cast<StartFunction>(dlsym(plugin, "XPluginStart"));
+    const EnableFunction enable = reinterpret_cast<EnableFunction>(dlsym(plugin, "XPluginEnable"));
+    const StopFunction disable = reinterpret_cast<StopFunction>(dlsym(plugin, "XPluginDisable"));
+    const StopFunction stop = reinterpret_cast<StopFunction>(dlsym(plugin, "XPluginStop"));
+    if ((start == nullptr) || (enable == nullptr) || (disable == nullptr) || (stop == nullptr)) {
+        fprintf(stderr, "%s: XPluginStart/Enable/Disable/Stop fehlt\n", argv[1]);
+        return 1;
+    }
+    char name[256] = "", signature[256] = "", description[256] = "";
+    if (! start(name, signature, description) || ! enable()) {
+        fprintf(stderr, "%s: Plugin lässt sich nicht starten\n", argv[1]);
+        return 1;
+    }
+
+    const uint32_t frames = static_cast<uint32_t>(minutes * 60 * FRAMES_PER_SECOND);
+    std::vector<uint32_t> frameNanos(frames);
+    const double wallStart = wallSeconds();
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        const uint64_t before = threadCpuNanos();
+        stubRunFrames(1);
+        frameNanos[frame] = static_cast<uint32_t>(threadCpuNanos() - before);
+        for (size_t i = 0; i < panelCount; ++i) {
+            messages[i] += drainPanel(panels[i]);
+        }
+    }
+    const double wall = wallSeconds() - wallStart;
+    disable();
+    stop();
+    dlclose(plugin);
+
+    uint64_t total = 0;
+    for (const uint32_t nanos : frameNanos) {
+        total += nanos;
+    }
+    std::sort(frameNanos.begin(), frameNanos.end());
+    const double simSeconds = frames / FRAMES_PER_SECOND;
+    printf("%s, Profil %s: %.0f simulierte Minuten, %u Frames in %.2f s\n", name, argv[3], minutes, frames, wall);
+    if (frames > 0) {
+        printf("  CPU je Frame: Mittel %.2f µs, p50 %.2f µs, p99 %.2f µs, max %.2f µs\n",
+               total / 1000.0 / frames, frameNanos[frames / 2] / 1000.0, frameNanos[frames * 99 / 100] / 1000.0,
+               frameNanos[frames - 1] / 1000.0);
+    }
+    for (size_t i = 0; i < panelCount; ++i) {
+        printf("  Panel %zu: %lu Nachrichten, %.2f je simulierter Sekunde\n", i, messages[i],
+               messages[i] / simSeconds);
+    }
+    printf("  Unbekannte Datarefs: %u\n", stubGetUnknownDataRefCount());
+    return 0;
+}
@@ -0,0 +1,623 @@
+/***************************************************************************************************
+ * @file xplmstub.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Stub-XPLM: Ersatz für die von XPIf benutzten Funktionen des X-Plane-SDK.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Wird mit den Headern aus lib/XP-SDK-301 als libXPLM.so gebaut (siehe XPIf/Makefile); dadurch prüft
+ * der Compiler die Signaturen gegen das SDK. Beschreibung siehe xplmstub.hpp und Doku
+ * "XPIf - Betrieb ohne X-Plane".
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <xplmstub.hpp>
+
+#include <XPLMDataAccess.h>
+#include <XPLMGraphics.h>
+#include <XPLMMenus.h>
+#include <XPLMPlanes.h>
+#include <XPLMPlugin.h>
+#include <XPLMProcessing.h>
+#include <XPLMScenery.h>
+#include <XPLMUtilities.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+const XPLMPluginID STUB_PLUGIN_ID = 1;  ///< Id des (einzigen) geladenen Plugins
+const double METERS_PER_DEGREE = 111320.0;  ///< Breitengrad; lokale Koordinaten als ebene Näherung
+const double PI = 3.14159265358979323846;
+
+
+/// Stützpunkte eines Werts: Zeit in s und Wert, nach der Zeit sortiert.
+using Series = std::vector<std::pair<double, float>>;
+
+/// Ein Dataref; die Adresse ist die XPLMDataRef.
+struct DataRefEntry {
+    std::string name;
+    std::vector<Series> elements;       ///< Je Element eines Arrays; Skalare haben ein Element
+    std::vector<float> values;          ///< Mit XPLMSetData* gesetzte Werte
+    std::vector<bool> isSet;            ///< true: values[i] gilt statt des Profils
+    bool isArray;
+    bool isKnown;                       ///< Kommt in einem Profil vor
+    bool isReported;                    ///< Als unbekannt gemeldet
+};
+
+/// Ein Flight-Loop-Callback; die Adresse ist die XPLMFlightLoopID.
+struct FlightLoop {
+    XPLMFlightLoop_f callback;
+    void *refcon;
+    double nextTime;                    ///< Fällig ab dieser Zeit in s (Intervall > 0)
+    int64_t nextCycle;                  ///< Fällig ab diesem Frame (Intervall < 0); sonst 0
+    double lastCall;                    ///< Zeit des letzten Aufrufs
+    bool isScheduled;
+    bool isRemoved;                     ///< Wird nach dem aktuellen Frame entfernt
+};
+
+/// Ein Menü; die Adresse ist die XPLMMenuID.
+struct Menu {
+    std::string name;
+    XPLMMenuHandler_f handler;
+    void *menuRef;
+    std::vector<std::pair<std::string, void *>> items;
+};
+
+/// Ein Kommando; die Adresse ist die XPLMCommandRef.
+struct Command {
+    std::string name;
+    uint32_t count;
+};
+
+static std::deque<DataRefEntry> dataRefs;                   // deque: Adressen bleiben gültig
+static std::map<std::string, DataRefEntry *> dataRefsByName;
+static std::list<FlightLoop> flightLoops;
+static std::deque<Menu> menus;
+static std::deque<Command> commands;
+static Menu pluginsMenu = {"Plugins", nullptr, nullptr, {}};
+static float framesPerSecond = 60.0f;
+static int64_t cycle = 0;                                   ///< Aktueller Frame
+static double simTime = 0;                                  ///< Aktuelle Zeit in s
+static double lastFrameTime = 0;                            ///< Zeit des vorigen Frames
+static uint32_t unknownDataRefs = 0;
+static void (*debugHandler)(const char *) = nullptr;
+static std::list<XPLMProbeType> probes;                     ///< Adresse eines Elements: XPLMProbeRef
+static uint32_t probeCount = 0;                             ///< Aufrufe von XPLMProbeTerrainXYZ
+static float (*terrainElevation)(double, double) = nullptr;
+static double originLat = 0;                                ///< Ursprung der lokalen Koordinaten
+static double originLon = 0;
+static int aircraftCount = 1;                               ///< XPLMCountAircraft, einschließlich des eigenen
+
+
+/// Meldung wie XPLMDebugString ausgeben.
+static void report(const char *format, const char *text, const unsigned number = 0) {
+    char line[512];
+    snprintf(line, sizeof(line), format, text, number);
+    XPLMDebugString(line);
+}
+
+
+/// Dataref suchen oder anlegen; @em name ohne Index.
+static DataRefEntry *findOrCreate(const std::string &name) {
+    auto found = dataRefsByName.find(name);
+    if (found != dataRefsByName.end()) {
+        return found->second;
+    }
+    dataRefs.push_back({name, {Series()}, {0.0f}, {false}, false, false, false});
+    dataRefsByName[name] = &dataRefs.back();
+    return &dataRefs.back();
+}
+
+
+/// Wert eines Elements zur aktuellen Zeit.
+static float valueAt(const DataRefEntry &dataRef, const size_t element) {
+    if (element >= dataRef.elements.size()) {
+        return 0.0f;
+    }
+    if (dataRef.isSet[element]) {
+        return dataRef.values[element];
+    }
+    const Series &series = dataRef.elements[element];
+    if (series.empty()) {
+        return 0.0f;
+    }
+    const auto next = std::upper_bound(series.begin(), series.end(), std::make_pair(simTime, 0.0f),
+                                       [](const std::pair<double, float> &a, const std::pair<double, float> &b) {
+                                           return a.first < b.first;
+                                       });
+    if (next == series.begin()) {
+        return series.front().second;
+    }
+    if (next == series.end()) {
+        return series.back().second;
+    }
+    const auto previous = next - 1;
+    const double fraction = (simTime - previous->first) / (next->first - previous->first);
+    return static_cast<float>(previous->second + fraction * (next->second - previous->second));
+}
+
+
+/// Mit XPLMSetData* gesetzten Wert speichern.
+static void setValue(XPLMDataRef inDataRef, const size_t element, const float value) {
+    DataRefEntry *dataRef = static_cast<DataRefEntry *>(inDataRef);
+    if (dataRef == nullptr) {
+        return;
+    }
+    if (element >= dataRef->elements.size()) {
+        dataRef->elements.resize(element + 1);
+        dataRef->values.resize(element + 1, 0.0f);
+        dataRef->isSet.resize(element + 1, false);
+    }
+    dataRef->values[element] = value;
+    dataRef->isSet[element] = true;
+}
+
+
+/// Flight-Loop relativ zur aktuellen Zeit einplanen.
+static void schedule(FlightLoop &loop, const float interval) {
+    loop.isScheduled = (interval != 0.0f);
+    loop.nextTime = simTime + interval;
+    loop.nextCycle = (interval < 0.0f) ? cycle - static_cast<int64_t>(interval) : 0;
+}
+
+
+static FlightLoop *findFlightLoop(XPLMFlightLoop_f callback, void *refcon) {
+    for (FlightLoop &loop : flightLoops) {
+        if ((loop.callback == callback) && (loop.refcon == refcon) && ! loop.isRemoved) {
+            return &loop;
+        }
+    }
+    return nullptr;
+}
+
+
+/**************************************************************************************************
+ * Steuerung (xplmstub.hpp)
+ **************************************************************************************************/
+
+void stubReset() {
+    dataRefs.clear();
+    dataRefsByName.clear();
+    flightLoops.clear();
+    menus.clear();
+    commands.clear();
+    pluginsMenu.items.clear();
+    framesPerSecond = 60.0f;
+    cycle = 0;
+    simTime = lastFrameTime = 0;
+    unknownDataRefs = 0;
+    probes.clear();
+    probeCount = 0;
+    terrainElevation = nullptr;
+    originLat = originLon = 0;
+    aircraftCount = 1;
+}
+
+
+bool stubLoadProfile(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        report("Stub-XPLM: Profil %s nicht gefunden\n", path);
+        return false;
+    }
+    for (DataRefEntry &dataRef : dataRefs) {
+        for (size_t i = 0; i < dataRef.elements.size(); ++i) {
+            dataRef.elements[i].clear();
+            dataRef.isSet[i] = false;
+        }
+    }
+
+    bool isOk = true;
+    char line[512];
+    unsigned lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        ++lineNumber;
+        char *comment = strchr(line, '#');
+        if (comment != nullptr) {
+            *comment = '\0';
+        }
+        double time;
+        char name[256];
+        float value;
+        int fields = sscanf(line, "%lf %255s %f", &time, name, &value);
+        if (fields <= 0) {
+            continue;       // Leerzeile bzw. nur Kommentar
+        }
+        if (fields != 3) {
+            report("Stub-XPLM: %s, Zeile %u fehlerhaft\n", path, lineNumber);
+            isOk = false;
+            continue;
+        }
+        size_t element = 0;
+        char *bracket = strchr(name, '[');
+        if (bracket != nullptr) {
+            element = strtoul(bracket + 1, nullptr, 10);
+            *bracket = '\0';
+        }
+        DataRefEntry *dataRef = findOrCreate(name);
+        dataRef->isArray = dataRef->isArray || (bracket != nullptr);
+        dataRef->isKnown = true;
+        if (element >= dataRef->elements.size()) {
+            dataRef->elements.resize(element + 1);
+            dataRef->values.resize(element + 1, 0.0f);
+            dataRef->isSet.resize(element + 1, false);
+        }
+        dataRef->elements[element].push_back(std::make_pair(time, value));
+    }
+    fclose(file);
+
+    for (DataRefEntry &dataRef : dataRefs) {
+        for (Series &series : dataRef.elements) {
+            std::stable_sort(series.begin(), series.end(),
+                             [](const std::pair<double, float> &a, const std::pair<double, float> &b) {
+                                 return a.first < b.first;
+                             });
+        }
+    }
+    return isOk;
+}
+
+
+void stubSetFrameRate(const float rate) { framesPerSecond = rate; }
+
+
+void stubRunFrames(const uint32_t count) {
+    for (uint32_t frame = 0; frame < count; ++frame) {
+        ++cycle;
+        simTime = cycle / static_cast<double>(framesPerSecond);
+        const double sinceLastFrame = simTime - lastFrameTime;
+        for (FlightLoop &loop : flightLoops) {
+            const bool isDue = loop.isScheduled && ! loop.isRemoved &&
+                               (((loop.nextCycle > 0) && (cycle >= loop.nextCycle)) ||
+                                ((loop.nextCycle <= 0) && (simTime + 1e-6 >= loop.nextTime)));
+            if (isDue) {
+                const float interval = loop.callback(static_cast<float>(simTime - loop.lastCall),
+                                                     static_cast<float>(sinceLastFrame),
+                                                     static_cast<int>(cycle), loop.refcon);
+                loop.lastCall = simTime;
+                schedule(loop, interval);
+            }
+        }
+        flightLoops.remove_if([](const FlightLoop &loop) { return loop.isRemoved; });
+        lastFrameTime = simTime;
+    }
+}
+
+
+uint32_t stubGetCommandCount(const char *name) {
+    for (const Command &command : commands) {
+        if (command.name == name) {
+            return command.count;
+        }
+    }
+    return 0;
+}
+
+
+uint32_t stubGetUnknownDataRefCount() { return unknownDataRefs; }
+
+
+bool stubSelectMenuItem(const char *menuName, const int item) {
+    for (const Menu &menu : menus) {
+        if ((menu.name == menuName) && (item >= 0) && (static_cast<size_t>(item) < menu.items.size())) {
+            if (menu.handler != nullptr) {
+                menu.handler(menu.menuRef, menu.items[item].second);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void stubSetDebugHandler(void (*handler)(const char *)) { debugHandler = handler; }
+
+
+void stubSetTerrain(float (*elevation)(double lat, double lon)) { terrainElevation = elevation; }
+
+
+void stubSetLocalOrigin(const double lat, const double lon) {
+    originLat = lat;
+    originLon = lon;
+}
+
+
+uint32_t stubGetProbeCount() { return probeCount; }
+
+
+uint32_t stubGetOpenProbeCount() { return static_cast<uint32_t>(probes.size()); }
+
+
+void stubSetAircraftCount(const int count) { aircraftCount = count; }
+
+
+/**************************************************************************************************
+ * XPLMDataAccess.h
+ **************************************************************************************************/
+
+XPLMDataRef XPLMFindDataRef(const char *inDataRefName) {
+    DataRefEntry *dataRef = findOrCreate(inDataRefName);
+    if (! dataRef->isKnown && ! dataRef->isReported) {
+        dataRef->isReported = true;
+        ++unknownDataRefs;
+        report("Stub-XPLM: Dataref %s kommt in keinem Profil vor und liefert 0\n", inDataRefName);
+    }
+    return dataRef;
+}
+
+
+int XPLMCanWriteDataRef(XPLMDataRef inDataRef) { return inDataRef != nullptr; }
+int XPLMIsDataRefGood(XPLMDataRef inDataRef) { return inDataRef != nullptr; }
+
+
+XPLMDataTypeID XPLMGetDataRefTypes(XPLMDataRef inDataRef) {
+    const DataRefEntry *dataRef = static_cast<const DataRefEntry *>(inDataRef);
+    if (dataRef == nullptr) {
+        return xplmType_Unknown;
+    }
+    return dataRef->isArray ? (xplmType_FloatArray | xplmType_IntArray)
+                            : (xplmType_Int | xplmType_Float | xplmType_Double);
+}
+
+
+int XPLMGetDatai(XPLMDataRef inDataRef) {
+    return (inDataRef == nullptr) ? 0 : static_cast<int>(valueAt(*static_cast<DataRefEntry *>(inDataRef), 0));
+}
+
+float XPLMGetDataf(XPLMDataRef inDataRef) {
+    return (inDataRef == nullptr) ? 0.0f : valueAt(*static_cast<DataRefEntry *>(inDataRef), 0);
+}
+
+double XPLMGetDatad(XPLMDataRef inDataRef) { return XPLMGetDataf(inDataRef); }
+
+void XPLMSetDatai(XPLMDataRef inDataRef, int inValue) { setValue(inDataRef, 0, static_cast<float>(inValue)); }
+void XPLMSetDataf(XPLMDataRef inDataRef, float inValue) { setValue(inDataRef, 0, inValue); }
+void XPLMSetDatad(XPLMDataRef inDataRef, double inValue) { setValue(inDataRef, 0, static_cast<float>(inValue)); }
+
+
+/// Gemeinsamer Teil von XPLMGetDatavi/vf: ohne Puffer die Größe, sonst die Anzahl kopierter Werte.
+template <class T>
+static int getArray(XPLMDataRef inDataRef, T *outValues, const int inOffset, const int inMax) {
+    const DataRefEntry *dataRef = static_cast<const DataRefEntry *>(inDataRef);
+    if (dataRef == nullptr) {
+        return 0;
+    }
+    const int size = static_cast<int>(dataRef->elements.size());
+    if (outValues == nullptr) {
+        return size;
+    }
+    int count = 0;
+    for (int i = inOffset; (i < size) && (count < inMax); ++i) {
+        outValues[count++] = static_cast<T>(valueAt(*dataRef, static_cast<size_t>(i)));
+    }
+    return count;
+}
+
+int XPLMGetDatavi(XPLMDataRef inDataRef, int *outValues, int inOffset, int inMax) {
+    return getArray(inDataRef, outValues, inOffset, inMax);
+}
+
+int XPLMGetDatavf(XPLMDataRef inDataRef, float *outValues, int inOffset, int inMax) {
+    return getArray(inDataRef, outValues, inOffset, inMax);
+}
+
+void XPLMSetDatavi(XPLMDataRef inDataRef, int *inValues, int inOffset, int inCount) {
+    for (int i = 0; i < inCount; ++i) {
+        setValue(inDataRef, static_cast<size_t>(inOffset + i), static_cast<float>(inValues[i]));
+    }
+}
+
+void XPLMSetDatavf(XPLMDataRef inDataRef, float *inValues, int inOffset, int inCount) {
+    for (int i = 0; i < inCount; ++i) {
+        setValue(inDataRef, static_cast<size_t>(inOffset + i), inValues[i]);
+    }
+}
+
+
+/**************************************************************************************************
+ * XPLMProcessing.h
+ **************************************************************************************************/
+
+float XPLMGetElapsedTime(void) { return static_cast<float>(simTime); }
+int XPLMGetCycleNumber(void) { return static_cast<int>(cycle); }
+
+
+void XPLMRegisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, float inInterval, void *inRefcon) {
+    flightLoops.push_back({inFlightLoop, inRefcon, 0, 0, simTime, false, false});
+    schedule(flightLoops.back(), inInterval);
+}
+
+
+void XPLMUnregisterFlightLoopCallback(XPLMFlightLoop_f inFlightLoop, void *inRefcon) {
+    FlightLoop *loop = findFlightLoop(inFlightLoop, inRefcon);
+    if (loop != nullptr) {
+        loop->isRemoved = true;
+    }
+}
+
+
+void XPLMSetFlightLoopCallbackInterval(XPLMFlightLoop_f inFlightLoop, float inInterval, int inRelativeToNow,
+                                       void *inRefcon) {
+    FlightLoop *loop = findFlightLoop(inFlightLoop, inRefcon);
+    if (loop != nullptr) {
+        const double now = simTime;
+        if (! inRelativeToNow) {
+            simTime = loop->lastCall;   // relativ zum letzten Aufruf einplanen
+        }
+        schedule(*loop, inInterval);
+        simTime = now;
+    }
+}
+
+
+XPLMFlightLoopID XPLMCreateFlightLoop(XPLMCreateFlightLoop_t *inParams) {
+    flightLoops.push_back({inParams->callbackFunc, inParams->refcon, 0, 0, simTime, false, false});
+    return &flightLoops.back();
+}
+
+
+void XPLMDestroyFlightLoop(XPLMFlightLoopID inFlightLoopID) {
+    static_cast<FlightLoop *>(inFlightLoopID)->isRemoved = true;
+}
+
+
+void XPLMScheduleFlightLoop(XPLMFlightLoopID inFlightLoopID, float inInterval, int inRelativeToNow) {
+    FlightLoop *loop = static_cast<FlightLoop *>(inFlightLoopID);
+    const double now = simTime;
+    if (! inRelativeToNow) {
+        simTime = loop->lastCall;
+    }
+    schedule(*loop, inInterval);
+    simTime = now;
+}
+
+
+/**************************************************************************************************
+ * XPLMUtilities.h
+ **************************************************************************************************/
+
+void XPLMDebugString(const char *inString) {
+    if (debugHandler != nullptr) {
+        debugHandler(inString);
+    } else {
+        fputs(inString, stderr);
+    }
+}
+
+
+void XPLMGetSystemPath(char *outSystemPath) {
+    // Wie bei X-Plane höchstens 512 Zeichen einschließlich des abschließenden '/'
+    if (getcwd(outSystemPath, 510) == nullptr) {
+        strcpy(outSystemPath, ".");
+    }
+    strcat(outSystemPath, "/");
+}
+
+
+XPLMCommandRef XPLMFindCommand(const char *inName) {
+    for (Command &command : commands) {
+        if (command.name == inName) {
+            return &command;
+        }
+    }
+    commands.push_back({inName, 0});
+    return &commands.back();
+}
+
+
+void XPLMCommandOnce(XPLMCommandRef inCommand) {
+    if (inCommand != nullptr) {
+        ++static_cast<Command *>(inCommand)->count;
+    }
+}
+
+
+/**************************************************************************************************
+ * XPLMScenery.h
+ **************************************************************************************************/
+
+XPLMProbeRef XPLMCreateProbe(XPLMProbeType inProbeType) {
+    probes.push_back(inProbeType);
+    return &probes.back();
+}
+
+
+void XPLMDestroyProbe(XPLMProbeRef inProbe) {
+    probes.remove_if([inProbe](const XPLMProbeType &probe) { return &probe == inProbe; });
+}
+
+
+/// Lotrecht wie xplm_ProbeY: Die Höhe des Startpunkts spielt keine Rolle.
+XPLMProbeResult XPLMProbeTerrainXYZ(XPLMProbeRef inProbe, float inX, float, float inZ, XPLMProbeInfo_t *outInfo) {
+    if ((inProbe == nullptr) || (outInfo == nullptr) || (outInfo->structSize != sizeof(XPLMProbeInfo_t))) {
+        return xplm_ProbeError;
+    }
+    ++probeCount;
+    double lat, lon, alt;
+    XPLMLocalToWorld(inX, 0.0, inZ, &lat, &lon, &alt);
+    const float elevation = (terrainElevation != nullptr) ? terrainElevation(lat, lon) : 0.0f;
+    if (std::isnan(elevation)) {
+        return xplm_ProbeMissed;
+    }
+    outInfo->locationX = inX;
+    outInfo->locationY = elevation;
+    outInfo->locationZ = inZ;
+    outInfo->normalX = outInfo->normalZ = 0.0f;
+    outInfo->normalY = 1.0f;
+    outInfo->velocityX = outInfo->velocityY = outInfo->velocityZ = 0.0f;
+    outInfo->is_wet = (elevation <= 0.0f) ? 1 : 0;
+    return xplm_ProbeHitTerrain;
+}
+
+
+/**************************************************************************************************
+ * XPLMGraphics.h
+ **************************************************************************************************/
+
+// x nach Osten, y nach oben (Höhe über NN), z nach Süden, in m ab dem Ursprung
+void XPLMWorldToLocal(double inLatitude, double inLongitude, double inAltitude, double *outX, double *outY,
+                      double *outZ) {
+    *outX = (inLongitude - originLon) * METERS_PER_DEGREE * std::cos(originLat * PI / 180.0);
+    *outY = inAltitude;
+    *outZ = (originLat - inLatitude) * METERS_PER_DEGREE;
+}
+
+
+void XPLMLocalToWorld(double inX, double inY, double inZ, double *outLatitude, double *outLongitude,
+                      double *outAltitude) {
+    *outLatitude = originLat - inZ / METERS_PER_DEGREE;
+    *outLongitude = originLon + inX / (METERS_PER_DEGREE * std::cos(originLat * PI / 180.0));
+    *outAltitude = inY;
+}
+
+
+/**************************************************************************************************
+ * XPLMPlanes.h
+ **************************************************************************************************/
+
+// Alle Flugzeuge sind aktiv; kein Plugin steuert sie
+void XPLMCountAircraft(int *outTotalAircraft, int *outActiveAircraft, XPLMPluginID *outController) {
+    *outTotalAircraft = aircraftCount;
+    *outActiveAircraft = aircraftCount;
+    *outController = XPLM_NO_PLUGIN_ID;
+}
+
+
+/**************************************************************************************************
+ * XPLMPlugin.h
+ **************************************************************************************************/
+
+XPLMPluginID XPLMGetMyID(void) { return STUB_PLUGIN_ID; }
+
+
+/**************************************************************************************************
+ * XPLMMenus.h
+ **************************************************************************************************/
+
+XPLMMenuID XPLMFindPluginsMenu(void) { return &pluginsMenu; }
+
+
+XPLMMenuID XPLMCreateMenu(const char *inName, XPLMMenuID, int, XPLMMenuHandler_f inHandler, void *inMenuRef) {
+    menus.push_back({inName, inHandler, inMenuRef, {}});
+    return &menus.back();
+}
+
+
+int XPLMAppendMenuItem(XPLMMenuID inMenu, const char *inItemName, void *inItemRef, int) {
+    Menu *menu = static_cast<Menu *>(inMenu);
+    if (menu == nullptr) {
+        return -1;
+    }
+    menu->items.push_back(std::make_pair(std::string(inItemName), inItemRef));
+    return static_cast<int>(menu->items.size()) - 1;
+}
@@ -0,0 +1,78 @@
+/***************************************************************************************************
+ * @file xplmstub.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Steuerung der Stub-XPLM: Profile laden und die virtuelle Uhr weiterstellen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Die Stub-XPLM (xplmstub.cpp, gebaut als libXPLM.so) ersetzt X-Plane für Messungen und Tests auf dem
+ * PC. Sie implementiert die von XPIf benutzten Funktionen aus XPLMDataAccess.h, XPLMProcessing.h,
+ * XPLMUtilities.h, XPLMPlugin.h, XPLMMenus.h, XPLMScenery.h, XPLMGraphics.h und XPLMPlanes.h mit den Signaturen aus
+ * dem SDK. Diese Datei enthält
+ * die zusätzlichen Funktionen, mit denen ein Benchmark-Programm oder ein Test die Stub-XPLM steuert.
+ *
+ * Ein Profil ist eine Textdatei mit einem Stützpunkt `Zeit Dataref Wert` je Zeile (Zeit in
+ * simulierten Sekunden, Elemente eines Array-Datarefs als `Name[Index]`, `#` leitet einen Kommentar
+ * ein). Zwischen zwei Stützpunkten wird linear interpoliert, vor dem ersten und nach dem letzten gilt
+ * der erste bzw. letzte Wert.
+ *
+ * Das Gelände ist eine Funktion der Position, die der Test mit stubSetTerrain() vorgibt. Die lokalen
+ * Koordinaten sind eine ebene Näherung um einen Ursprung, den stubSetLocalOrigin() wie X-Plane beim
+ * Nachladen der Szenerie verschieben kann.
+ *
+ * Die Anzahl der Flugzeuge für XPLMCountAircraft gibt stubSetAircraftCount() vor; ihre Positionen und
+ * Geschwindigkeiten kommen wie alle Datarefs aus einem Profil (`sim/cockpit2/tcas/targets/position/x[1]`).
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+/// @brief Stub-XPLM in den Anfangszustand setzen: Uhr auf 0, keine Callbacks, Menüs, Profile, Zähler.
+void stubReset();
+
+/**
+ * @brief Profil laden; ersetzt die Stützpunkte aller Datarefs und die mit XPLMSetData* gesetzten Werte.
+ *
+ * @return false Die Datei fehlt oder eine Zeile ist fehlerhaft (wird gemeldet).
+ */
+bool stubLoadProfile(const char *path);
+
+/// @brief Frames je simulierter Sekunde der virtuellen Uhr (Standard 60).
+void stubSetFrameRate(float framesPerSecond);
+
+/// @brief @em count Frames simulieren: je Frame die Uhr weiterstellen und die fälligen Flight-Loops aufrufen.
+void stubRunFrames(uint32_t count);
+
+/// @brief Wie oft das Kommando @em name mit XPLMCommandOnce ausgeführt wurde.
+uint32_t stubGetCommandCount(const char *name);
+
+/// @brief Anzahl der gesuchten Datarefs, die in keinem Profil vorkommen.
+uint32_t stubGetUnknownDataRefCount();
+
+/**
+ * @brief Menüpunkt auswählen, als hätte ihn der Benutzer angeklickt.
+ *
+ * @return false Das Menü oder der Menüpunkt existiert nicht.
+ */
+bool stubSelectMenuItem(const char *menuName, int item);
+
+/// @brief Ausgabe von XPLMDebugString umleiten; @em nullptr: stderr.
+void stubSetDebugHandler(void (*handler)(const char *text));
+
+/// @brief Geländehöhe in m über NN für XPLMProbeTerrainXYZ; NaN: keine Szenerie. @em nullptr: überall 0 (Wasser).
+void stubSetTerrain(float (*elevation)(double lat, double lon));
+
+/// @brief Ursprung der lokalen Koordinaten (XPLMWorldToLocal) verschieben; Standard 0° N, 0° E.
+void stubSetLocalOrigin(double lat, double lon);
+
+/// @brief Anzahl der Aufrufe von XPLMProbeTerrainXYZ.
+uint32_t stubGetProbeCount();
+
+/// @brief Anzahl der mit XPLMCreateProbe angelegten und noch nicht freigegebenen Probes.
+uint32_t stubGetOpenProbeCount();
+
+/// @brief Anzahl der Flugzeuge einschließlich des eigenen für XPLMCountAircraft; Standard 1.
+void stubSetAircraftCount(int count);
@@ -0,0 +1,127 @@
+/***************************************************************************************************
+ * @file bench_eventloop.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Benchmark: Systemaufrufe und CPU je Nachricht der Ereignisschleifen epoll und io_uring.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * 1, 8 und 32 Panels auf Pseudo-Terminals. Je Runde sendet jedes Panel eine Nachricht; die Schleife
+ * empfängt sie und merkt je Nachricht eine Antwort vor, die mit dem nächsten run() hinausgeht. Eine
+ * Nachricht heißt hier: eine empfangene und eine gesendete Zeile.
+ *
+ * Gezählt werden die Systemaufrufe der Schleife. Die CPU-Zeit ist die des ganzen Prozesses, enthält
+ * also auch die Panel-Seite (ein write() und ein read() je Panel und Runde), die für beide Schleifen
+ * gleich ist.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <eventloop.hpp>
+
+#include <fcntl.h>
+#include <pty.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const size_t MESSAGES = 40000;                  ///< Nachrichten je Messung
+static const char REQUEST[] = "M803;BTN;OAT;0\n";
+static const char REPLY[] = "M803;OAT;15;0\r\n";
+
+
+/// Beantwortet jede empfangene Zeile.
+class Echo : public EventHandler {
+public:
+    explicit Echo(EventLoop &loop) : loop(loop) {}
+
+    size_t received = 0;
+
+    void onReceive(const size_t panel, const char *data, const size_t length) override {
+        for (size_t i = 0; i < length; ++i) {
+            if (data[i] == '\n') {
+                ++received;
+                loop.queueWrite(panel, REPLY, sizeof(REPLY) - 1);
+            }
+        }
+    }
+
+private:
+    EventLoop &loop;
+};
+
+
+static double processSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + 1e-9 * static_cast<double>(now.tv_nsec);
+}
+
+
+static void measure(EventLoop &loop, const size_t panelCount) {
+    std::vector<int> masters(panelCount), slaves(panelCount);
+    for (size_t i = 0; i < panelCount; ++i) {
+        openpty(&masters[i], &slaves[i], nullptr, nullptr, nullptr);
+        termios settings;
+        tcgetattr(slaves[i], &settings);
+        cfmakeraw(&settings);
+        tcsetattr(slaves[i], TCSANOW, &settings);
+        fcntl(masters[i], F_SETFL, fcntl(masters[i], F_GETFL) | O_NONBLOCK);
+        loop.addPanel(slaves[i]);
+    }
+    Echo echo(loop);
+    char buffer[4096];
+    const size_t rounds = MESSAGES / panelCount;
+
+    const uint64_t syscallsBefore = loop.getSyscalls();
+    const double cpuBefore = processSeconds();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < panelCount; ++i) {
+            if (write(masters[i], REQUEST, sizeof(REQUEST) - 1) < 0) {
+                printf("write fehlgeschlagen\n");
+                return;
+            }
+        }
+        const size_t expected = (round + 1) * panelCount;
+        for (int attempt = 0; (echo.received < expected) && (attempt < 1000); ++attempt) {
+            loop.run(100, echo);
+        }
+        // Antworten der vorigen Runde abholen (die Panel-Seite liest nicht blockierend)
+        for (size_t i = 0; i < panelCount; ++i) {
+            while (read(masters[i], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+    }
+    loop.flush();
+    const double cpu = processSeconds() - cpuBefore;
+    const uint64_t syscalls = loop.getSyscalls() - syscallsBefore;
+    const double messages = static_cast<double>(rounds * panelCount);
+    printf("%-8s %2zu Panels: %5.2f Systemaufrufe und %5.2f µs CPU je Nachricht (%zu von %zu empfangen, %lu Schreibfehler)\n",
+           loop.name(), panelCount, static_cast<double>(syscalls) / messages, 1e6 * cpu / messages, echo.received,
+           rounds * panelCount, static_cast<unsigned long>(loop.getWriteErrors()));
+    for (size_t i = 0; i < panelCount; ++i) {
+        close(masters[i]);
+        close(slaves[i]);
+    }
+}
+
+
+int main() {
+    const size_t panelCounts[] = {1, 8, 32};
+    for (const size_t panelCount : panelCounts) {
+        EpollLoop epoll;
+        measure(epoll, panelCount);
+        UringLoop uring;
+        if (uring.isValid()) {
+            measure(uring, panelCount);
+        } else {
+            printf("io_uring nicht verfügbar: %s\n", strerror(uring.getSetupError()));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+/***************************************************************************************************
+ * @file bench_expr.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Microbenchmark: Bytecode der abgeleiteten Werte gegen handgeschriebenes C++.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Beide Varianten berechnen QNH, FL und OAT für dieselben 1024 Snapshots; gemessen wird die Zeit je
+ * Frame (alle drei Werte) in ns. Die Summe der Ergebnisse wird ausgegeben, damit der Compiler die
+ * handgeschriebene Variante nicht wegoptimiert.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <expression.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+const int SNAPSHOTS = 1024;
+const int ROUNDS = 2000;                ///< Durchläufe über alle Snapshots
+
+enum : uint16_t { BARO, ALT, OAT_METRIC, OAT_C, OAT_F, SNAPSHOT_SIZE };
+
+static float snapshots[SNAPSHOTS][SNAPSHOT_SIZE];
+
+
+/// Die drei Werte wie sie ohne Ausdrücke im Plugin ausprogrammiert würden.
+static void handWritten(const float *snapshot, float *qnh, float *fl, float *oat) {
+    *qnh = snapshot[BARO] * 33.8637526f;
+    *fl = std::round((snapshot[ALT] + (29.92f - snapshot[BARO]) * 1000.0f) / 100.0f);
+    *oat = (snapshot[OAT_METRIC] != 0.0f) ? snapshot[OAT_C] : snapshot[OAT_F];
+}
+
+
+/// Mittlere Dauer eines Frames in ns; @em frame wird für jeden Snapshot aufgerufen.
+template <class Frame>
+static double nsPerFrame(Frame frame) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (int i = 0; i < SNAPSHOTS; ++i) {
+            frame(snapshots[i]);
+        }
+    }
+    const auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count() / (static_cast<double>(ROUNDS) * SNAPSHOTS);
+}
+
+
+int main() {
+    for (int i = 0; i < SNAPSHOTS; ++i) {
+        snapshots[i][BARO] = 28.5f + 0.002f * static_cast<float>(i);
+        snapshots[i][ALT] = 10.0f * static_cast<float>(i);
+        snapshots[i][OAT_METRIC] = static_cast<float>((i / 7) % 2);
+        snapshots[i][OAT_C] = 15.0f - 0.01f * static_cast<float>(i);
+        snapshots[i][OAT_F] = 59.0f - 0.018f * static_cast<float>(i);
+    }
+
+    ExpressionCompiler compiler;
+    compiler.addDataRef("baro", BARO);
+    compiler.addDataRef("alt", ALT);
+    compiler.addDataRef("oat_metric", OAT_METRIC);
+    compiler.addDataRef("oat_c", OAT_C);
+    compiler.addDataRef("oat_f", OAT_F);
+    compiler.addText("QNH = baro * 33.8637526\n"
+                     "FL  = round((alt + (29.92 - baro) * 1000) / 100)\n"
+                     "OAT = oat_metric ? oat_c : oat_f\n");
+    ExpressionProgram program = compiler.finish();
+
+    double handSum = 0.0;
+    const double hand = nsPerFrame([&](const float *snapshot) {
+        float qnh, fl, oat;
+        handWritten(snapshot, &qnh, &fl, &oat);
+        handSum += qnh + fl + oat;
+    });
+    double vmSum = 0.0;
+    const double vm = nsPerFrame([&](const float *snapshot) {
+        program.run(snapshot);
+        vmSum += program.value(0) + program.value(1) + program.value(2);
+    });
+
+    const size_t instructions = program.instructions().size();
+    printf("Ausdrücke QNH, FL, OAT je Frame: handgeschrieben %.1f ns, Bytecode %.1f ns "
+           "(%zu Befehle, %.2f ns je Befehl), Prüfsumme %s\n",
+           hand, vm, instructions, vm / static_cast<double>(instructions),
+           (handSum == vmSum) ? "gleich" : "VERSCHIEDEN");
+    return (handSum == vmSum) ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+/***************************************************************************************************
+ * @file bench_hotpaths.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Benchmark der heißen Pfade von XPIf im Format des Firmware-Benchmarks, für compare.py.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufruf: bench_hotpaths [Mindestdauer je Fall in ms] [Pfad von pty_bridge]
+ *
+ * Wie der Benchmark der Firmware (benchmark.hpp) läuft jeder Fall in Stapeln mit doppelter Größe,
+ * bis er mindestens die Mindestdauer (Standard 20 ms) gedauert hat; das Ergebnis geht als
+ * "SYS;<Fall>;<Durchläufe>;<µs>" auf stdout:
+ *
+ * | Fall   | Gemessen                                                                           |
+ * | ------ | ---------------------------------------------------------------------------------- |
+ * | `XDIF` | SnapshotRing::write(), readLatest() und SnapshotDiff::update() eines Snapshots mit  |
+ * |        | 256 Werten, von denen sich je Frame 8 über die Schwelle hinaus ändern               |
+ * | `XSER` | MessageWriter: eine Nachricht mit zwei Zahlen, z.B. `M803;TIME;093000;073000`       |
+ * | `XPTY` | Umlauf `SYS;PING` → `SYS;PONG` mit SerialTransport über ein Pseudo-Terminal zur     |
+ * |        | Firmware in pty_bridge (XPanino/test/host), ohne Bündeln                            |
+ *
+ * XPTY enthält die Drosselung von pty_bridge (ein USB-Frame je Paket und 87 µs je Zeichen); ohne den
+ * Pfad von pty_bridge fehlt der Fall. Wird von XPanino/benchmarks/compare.py benutzt.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <messagewriter.hpp>
+#include <snapshotdiff.hpp>
+#include <snapshotring.hpp>
+#include <transport.hpp>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+const size_t VALUES = 256;                  ///< Werte je Snapshot, etwa eine volle Konfiguration
+const size_t CHANGES_PER_FRAME = 8;
+const size_t FRAMES = 64;                   ///< Vorbereitete Snapshots, reihum geschrieben
+const float THRESHOLD = 0.5f;
+const int PONG_TIMEOUT_MS = 1000;
+
+static volatile size_t sink;                ///< Ergebnisse, damit der Compiler nichts wegoptimiert
+
+
+/// @em batch(n) in Stapeln 1, 2, 4, ... ausführen, bis @em minDurationUs vergangen sind, und das Ergebnis ausgeben.
+/// @return false @em batch ist fehlgeschlagen.
+template <class Batch>
+static bool measure(const char *name, const uint64_t minDurationUs, Batch batch) {
+    uint64_t iterations = 0;
+    uint64_t durationUs;
+    uint32_t count = 1;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        if (! batch(count)) {
+            fprintf(stderr, "%s: fehlgeschlagen\n", name);
+            return false;
+        }
+        iterations += count;
+        count = (count < (1U << 30)) ? count * 2 : count;
+        durationUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    } while (durationUs < minDurationUs);
+    printf("SYS;%s;%" PRIu64 ";%" PRIu64 "\n", name, iterations, durationUs);
+    fflush(stdout);
+    return true;
+}
+
+
+/// Daten des Sim-Threads und des Daemons für XDIF.
+struct DiffBench {
+    SnapshotRing<VALUES, 4> ring{1};
+    SnapshotDiff<VALUES> diff;
+    std::vector<float> frames = std::vector<float>(FRAMES * VALUES);
+    float values[VALUES];
+    uint16_t changed[VALUES];
+
+    /// Je Frame wandern alle Werte innerhalb der Schwelle, CHANGES_PER_FRAME springen darüber hinaus.
+    DiffBench() {
+        uint32_t random = 4711;
+        for (size_t i = 0; i < VALUES; ++i) {
+            diff.setThreshold(i, THRESHOLD);
+        }
+        for (size_t frame = 0; frame < FRAMES; ++frame) {
+            for (size_t i = 0; i < VALUES; ++i) {
+                random = random * 1103515245 + 12345;
+                frames[frame * VALUES + i] = 1000.0f + static_cast<float>(i) + static_cast<float>((random >> 16) % 100) / 1000.0f;
+            }
+            for (size_t n = 0; n < CHANGES_PER_FRAME; ++n) {
+                frames[frame * VALUES + (frame * 7 + n * 31) % VALUES] += static_cast<float>(frame % 2) * 10.0f + 5.0f;
+            }
+        }
+    }
+
+    bool run(const uint32_t count) {
+        size_t total = 0;
+        for (uint32_t n = 0; n < count; ++n) {
+            ring.write(n, &frames[(n % FRAMES) * VALUES]);
+            double simTime;
+            ring.readLatest(simTime, values);
+            total += diff.update(values, changed);
+        }
+        sink = total;
+        return true;
+    }
+};
+
+
+/// Eine Nachricht wie im Flight-Loop; Gerät und Event wechseln, damit nichts konstant gefaltet wird.
+static bool serialize(const uint32_t count) {
+    static const char *const devices[] = {"M803", "XPDR", "COM1", "NAV1"};
+    static const char *const events[] = {"TIME", "CODE", "ACT", "STBY"};
+    char buffer[64];
+    size_t total = 0;
+    for (uint32_t n = 0; n < count; ++n) {
+        MessageWriter writer(buffer, sizeof(buffer));
+        total += writer.text(devices[n % 4]).text(events[(n / 4) % 4]).number(static_cast<int32_t>(n % 240000), 6)
+                     .number(static_cast<int32_t>(n % 7777), 4).finish();
+    }
+    sink = total;
+    return true;
+}
+
+
+/// Firmware in pty_bridge, angebunden über ein Pseudo-Terminal.
+struct PtyBench {
+    std::unique_ptr<SerialTransport> panel;
+    pid_t bridge = -1;
+    uint32_t nextId = 1;
+    char line[256];
+    size_t lineLength = 0;
+
+    /// pty_bridge starten und die Ausgaben von setup() abwarten. @return false Start fehlgeschlagen.
+    bool start(const char *path) {
+        int master, slave;
+        if (openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+            return false;
+        }
+        termios attributes;
+        tcgetattr(slave, &attributes);
+        cfmakeraw(&attributes);
+        tcsetattr(slave, TCSANOW, &attributes);
+        bridge = fork();
+        if (bridge == 0) {
+            dup2(slave, STDIN_FILENO);
+            dup2(slave, STDOUT_FILENO);
+            freopen("/dev/null", "w", stderr);      // Zähler von pty_bridge
+            close(master);
+            close(slave);
+            execl(path, path, "0", static_cast<char *>(nullptr));
+            _exit(127);
+        }
+        close(slave);
+        panel.reset(new SerialTransport(master));
+        if (bridge < 0) {
+            return false;
+        }
+        char buffer[256];
+        pollfd readable = {panel->fd(), POLLIN, 0};
+        while (poll(&readable, 1, 300) == 1) {
+            if (panel->receive(buffer, sizeof(buffer)) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ~PtyBench() {
+        panel.reset();      // pty_bridge bekommt EIO und beendet sich
+        if (bridge > 0) {
+            waitpid(bridge, nullptr, 0);
+        }
+    }
+
+    /// Eine Zeile lesen; @return false Zeitüberschreitung oder Verbindung getrennt.
+    bool readLine() {
+        pollfd readable = {panel->fd(), POLLIN, 0};
+        for (;;) {
+            char *end = static_cast<char *>(memchr(line, '\n', lineLength));
+            if (end != nullptr) {
+                return true;
+            }
+            if ((poll(&readable, 1, PONG_TIMEOUT_MS) != 1) || (lineLength == sizeof(line))) {
+                return false;
+            }
+            const size_t count = panel->receive(line + lineLength, sizeof(line) - lineLength);
+            if (count == 0) {
+                return false;
+            }
+            lineLength += count;
+        }
+    }
+
+    /// Erste Zeile aus dem Puffer entfernen.
+    void dropLine() {
+        char *end = static_cast<char *>(memchr(line, '\n', lineLength));
+        const size_t length = static_cast<size_t>(end + 1 - line);
+        memmove(line, end + 1, lineLength - length);
+        lineLength -= length;
+    }
+
+    bool run(const uint32_t count) {
+        for (uint32_t n = 0; n < count; ++n) {
+            char message[32];
+            const size_t length = MessageWriter(message, sizeof(message)).text("SYS").text("PING")
+                                      .number(static_cast<int32_t>(nextId)).finish();
+            char expected[32];
+            const int expectedLength = snprintf(expected, sizeof(expected), "SYS;PONG;%u;", nextId++);
+            if (! panel->send(message, length)) {
+                return false;
+            }
+            bool isAnswered = false;
+            while (! isAnswered) {
+                if (! readLine()) {
+                    return false;
+                }
+                isAnswered = (strncmp(line, expected, static_cast<size_t>(expectedLength)) == 0);
+                dropLine();
+            }
+        }
+        return true;
+    }
+};
+
+
+int main(int argc, char *argv[]) {
+    const unsigned long minDuration = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 20;
+    if (minDuration == 0) {
+        fprintf(stderr, "Aufruf: %s [Mindestdauer je Fall in ms] [Pfad von pty_bridge]\n", argv[0]);
+        return 2;
+    }
+    const uint64_t minDurationUs = minDuration * 1000;
+    signal(SIGPIPE, SIG_IGN);
+
+    std::unique_ptr<DiffBench> diff(new DiffBench);
+    bool isOk = measure("XDIF", minDurationUs, [&](uint32_t count) { return diff->run(count); });
+    isOk = measure("XSER", minDurationUs, serialize) && isOk;
+    if (argc > 2) {
+        PtyBench pty;
+        if (! pty.start(argv[2])) {
+            fprintf(stderr, "XPTY: %s lässt sich nicht starten\n", argv[2]);
+            return 1;
+        }
+        isOk = measure("XPTY", minDurationUs, [&](uint32_t count) { return pty.run(count); }) && isOk;
+    } else {
+        fprintf(stderr, "XPTY übersprungen: Pfad von pty_bridge fehlt\n");
+    }
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+/***************************************************************************************************
+ * @file bench_logring.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Microbenchmark: Kosten eines Log-Aufrufs im Sim-Thread.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Gemessen werden je Log-Aufruf in ns:
+ *  - angenommen: der Eintrag landet im Ring; einmal mit log() (liest steady_clock), einmal mit
+ *    logAt() (Zeitstempel vorgegeben). Der Ring wird außerhalb der Messung geleert.
+ *  - unterdrückt: der Token-Bucket der Message-Id ist leer;
+ *  - verworfen: der Ring ist voll.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <logring.hpp>
+
+#include <memory>
+
+const int CALLS = 1000000;
+const int BATCH = 4000;       ///< Aufrufe zwischen zwei Leerungen des Rings; kleiner als der Ring
+
+using BenchLogRing = LogRing<4096, 16>;
+
+
+/// Mittlere Dauer eines Aufrufs von @em call in ns; alle @em BATCH Aufrufe wird @em ring ungemessen
+/// geleert, falls nicht @em nullptr.
+template <class Call>
+static double nsPerCall(BenchLogRing *ring, Call call) {
+    std::chrono::steady_clock::duration duration(0);
+    LogRecord record;
+    for (int i = 0; i < CALLS; i += BATCH) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int j = i; j < i + BATCH; ++j) {
+            call(j);
+        }
+        duration += std::chrono::steady_clock::now() - start;
+        while ((ring != nullptr) && ring->pop(record)) {
+        }
+    }
+    return std::chrono::duration<double, std::nano>(duration).count() / CALLS;
+}
+
+
+int main() {
+    std::unique_ptr<BenchLogRing> ring(new BenchLogRing(1000000000));
+    const double accept = nsPerCall(ring.get(), [&](int i) {
+        ring->log(LogLevel::INFO, 1, "Frame %d, %.1f ft", i, 1000.0f + i);
+    });
+    const double acceptAt = nsPerCall(ring.get(), [&](int i) {
+        ring->logAt(static_cast<uint64_t>(i) * 1000, LogLevel::INFO, 1, "Frame %d, %.1f ft", i, 1000.0f + i);
+    });
+
+    std::unique_ptr<BenchLogRing> limited(new BenchLogRing(1));
+    const double suppress = nsPerCall(limited.get(), [&](int i) {
+        limited->logAt(1000, LogLevel::INFO, 1, "Frame %d", i);
+    });
+
+    std::unique_ptr<BenchLogRing> full(new BenchLogRing(1000000000));
+    for (uint32_t i = 0; i < 4096; ++i) {
+        full->logAt(i, LogLevel::INFO, 1, "Frame %d", i);
+    }
+    const double drop = nsPerCall(nullptr, [&](int i) { full->logAt(5000, LogLevel::INFO, 1, "Frame %d", i); });
+
+    printf("Log-Aufruf: angenommen %.1f ns (log) bzw. %.1f ns (logAt), unterdrückt %.1f ns, verworfen %.1f ns\n",
+           accept, acceptAt, suppress, drop);
+    return 0;
+}
@@ -0,0 +1,184 @@
+/***************************************************************************************************
+ * @file bench_traffic.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Benchmark: Verkehrswarnung mit 64 und 200 Flugzeugen über die Stub-XPLM.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Die Flugzeuge fliegen auf geraden Bahnen (fester Startwert des Zufallsgenerators), anfangs im
+ * Umkreis von 40 NM um das eigene; etwa jedes sechzehnte fliegt so, dass es das eigene in den ersten
+ * 5 Minuten beinahe trifft. Die Bahnen stehen als Profil mit zwei Stützpunkten je Element in den Array-Datarefs
+ * `sim/cockpit2/tcas/targets/position/...`. Ein Flight-Loop liest alle TRAFFIC_CYCLE_S den Snapshot
+ * (TrafficReader) und übergibt ihn an den Worker (TrafficMonitor::publish()); danach wartet er, bis der
+ * Worker fertig ist, damit kein Snapshot übersprungen wird.
+ *
+ * Gemessen werden die CPU-Zeit des Sim-Threads je Zyklus (Lesen und Übergeben; Ziel < 10 µs), die
+ * Zeit des Workers je Zyklus und die Nachrichten je Minute an das Panel. Das Lesen enthält die
+ * Interpolation der Profile in der Stub-XPLM, die in X-Plane entfällt.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <traffic.hpp>
+#include <trafficreader.hpp>
+#include <xplmstub.hpp>
+
+#include <XPLMProcessing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+const int MINUTES = 10;
+const float DURATION_S = MINUTES * 60.0f;
+const float NM = 1852.0f;
+const float RADIUS_M = 40 * NM;
+const float OWN_SPEED = 120.0f;             ///< m/s nach Osten
+const float OWN_ALTITUDE = 3000.0f;         ///< m
+const float PI = 3.14159265f;
+static const char *const COMPONENTS[6] = {"x", "y", "z", "vx", "vy", "vz"};
+
+
+/// Einfacher, reproduzierbarer Zufallsgenerator.
+struct Random {
+    uint32_t state = 4711;
+
+    uint32_t next() {
+        state = state * 1103515245 + 12345;
+        return state >> 8;
+    }
+
+    float uniform(const float low, const float high) { return low + (high - low) * static_cast<float>(next() % 1000000) / 1e6f; }
+};
+
+
+/// Profil mit dem eigenen Flugzeug (Index 0) und @em count weiteren schreiben. @return Pfad oder leer.
+static std::string writeProfile(const size_t count) {
+    char path[] = "/tmp/benchtrafficXXXXXX";
+    const int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "w");
+    if (file == nullptr) {
+        return "";
+    }
+    Random random;
+    fprintf(file, "0 sim/flightmodel/position/psi 90\n");
+    for (size_t i = 0; i <= count; ++i) {
+        float start[3], velocity[3];
+        if (i == 0) {
+            start[0] = start[2] = 0.0f;
+            start[1] = OWN_ALTITUDE;
+            velocity[0] = OWN_SPEED;
+            velocity[1] = velocity[2] = 0.0f;
+        } else {
+            const float speed = random.uniform(60, 130);
+            const float track = random.uniform(0, 2 * PI);
+            velocity[0] = speed * std::sin(track);
+            velocity[2] = -speed * std::cos(track);
+            if (random.next() % 16 == 0) {
+                // Beinahe-Treffer nach tc Sekunden, rückwärts bis zum Start
+                const float tc = random.uniform(60, 300);
+                start[0] = OWN_SPEED * tc + random.uniform(-1000, 1000) - velocity[0] * tc;
+                start[2] = random.uniform(-1000, 1000) - velocity[2] * tc;
+                start[1] = OWN_ALTITUDE + random.uniform(-300, 300);
+                velocity[1] = random.uniform(-1, 1);
+            } else {
+                const float radius = RADIUS_M * std::sqrt(random.uniform(0, 1));
+                const float angle = random.uniform(0, 2 * PI);
+                start[0] = radius * std::sin(angle);
+                start[2] = -radius * std::cos(angle);
+                start[1] = OWN_ALTITUDE + random.uniform(-900, 900);
+                velocity[1] = random.uniform(-3, 3);
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            fprintf(file, "0 sim/cockpit2/tcas/targets/position/%s[%zu] %.2f\n", COMPONENTS[c], i, start[c]);
+            fprintf(file, "%.0f sim/cockpit2/tcas/targets/position/%s[%zu] %.2f\n", DURATION_S, COMPONENTS[c], i,
+                    start[c] + velocity[c] * DURATION_S);
+            fprintf(file, "0 sim/cockpit2/tcas/targets/position/%s[%zu] %.3f\n", COMPONENTS[c + 3], i, velocity[c]);
+        }
+    }
+    fclose(file);
+    return path;
+}
+
+
+static uint64_t threadCpuNanos() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+
+/// Zählt die Nachrichten mit der Warnstufe.
+static void countLevels(const char *message, const size_t length, void *context) {
+    for (size_t i = 0; i + 3 <= length; ++i) {
+        if (((i == 0) || (message[i - 1] == '\n')) && (strncmp(message + i, "TC;", 3) == 0)) {
+            ++*static_cast<uint32_t *>(context);
+        }
+    }
+}
+
+
+struct Cycle {
+    const TrafficReader *reader = nullptr;
+    TrafficMonitor *monitor = nullptr;
+    std::vector<float> values = std::vector<float>(TRAFFIC_VALUES, 0.0f);
+    std::vector<double> simUs;
+    uint32_t aircraft = 0;
+};
+
+
+static float onCycle(float, float, int, void *refcon) {
+    Cycle *cycle = static_cast<Cycle *>(refcon);
+    const uint64_t start = threadCpuNanos();
+    cycle->aircraft = cycle->reader->read(cycle->values.data());
+    cycle->monitor->publish(XPLMGetElapsedTime(), cycle->values.data());
+    cycle->simUs.push_back((threadCpuNanos() - start) / 1000.0);
+    while (cycle->monitor->getProcessed() != cycle->monitor->getPublished()) {
+        std::this_thread::yield();
+    }
+    return TRAFFIC_CYCLE_S;
+}
+
+
+static bool measure(const size_t count) {
+    stubReset();
+    const std::string path = writeProfile(count);
+    const bool isLoaded = ! path.empty() && stubLoadProfile(path.c_str());
+    remove(path.c_str());
+    if (! isLoaded) {
+        return false;
+    }
+    stubSetAircraftCount(static_cast<int>(count + 1));
+    uint32_t levelMessages = 0;
+    const TrafficReader reader;
+    TrafficMonitor monitor(5, 6, countLevels, &levelMessages);
+    Cycle cycle;
+    cycle.reader = &reader;
+    cycle.monitor = &monitor;
+    XPLMRegisterFlightLoopCallback(onCycle, TRAFFIC_CYCLE_S, &cycle);
+    stubRunFrames(static_cast<uint32_t>(DURATION_S * 60));
+    XPLMUnregisterFlightLoopCallback(onCycle, &cycle);
+
+    std::vector<double> sorted = cycle.simUs;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t cycles = sorted.size();
+    printf("Verkehr, %zu Flugzeuge, %zu Zyklen: Sim-Thread je Zyklus Median %.1f µs, 99 %% %.1f µs, max. %.1f µs; "
+           "Worker je Zyklus %.1f µs; %.1f Nachrichten je Minute, davon %.1f Warnstufen\n",
+           static_cast<size_t>(cycle.aircraft) - 1, cycles, sorted[cycles / 2], sorted[cycles * 99 / 100], sorted.back(),
+           monitor.getWorkerNanos() / 1000.0 / monitor.getProcessed(), monitor.getMessageCount() / static_cast<double>(MINUTES),
+           levelMessages / static_cast<double>(MINUTES));
+    return cycle.aircraft == count + 1;
+}
+
+
+int main() {
+    return (measure(63) && measure(200)) ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * @file bench_transport.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Benchmark: Latenz (Round Trip) und Durchsatz je Transport auf dem eigenen Rechner.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Beide Seiten laufen im selben Thread: XPIf sendet eine Nachricht, die Panel-Seite empfängt sie und
+ * schickt sie zurück. Gemessen wird damit der Weg durch den Kernel (tty-Schicht, TCP bzw. UDP mit
+ * Bestätigung), nicht die Baudrate einer echten seriellen Verbindung. Der Durchsatz wird mit
+ * Bündeln von 32 Nachrichten gemessen.
+ *
+ *     make -C XPIf bench
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <transport.hpp>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const int ROUND_TRIPS = 5000;
+const int THROUGHPUT_MESSAGES = 50000;
+const int BURST = 32;
+static const char MESSAGE[] = "XPDR;SQUAWK;7000;0\n";
+const size_t MESSAGE_LENGTH = sizeof(MESSAGE) - 1;
+
+
+static double secondsSince(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/// Empfangen, bis @em expected Zeichen da sind; false bei Zeitüberschreitung.
+static bool receiveExactly(Transport &transport, const size_t expected) {
+    char buffer[4096];
+    size_t received = 0;
+    while (received < expected) {
+        pollfd readable = {transport.fd(), POLLIN, 0};
+        if (poll(&readable, 1, 1000) != 1) {
+            return false;
+        }
+        received += transport.receive(buffer, std::min(sizeof(buffer), expected - received + UDP_MAX_MESSAGE + 1));
+    }
+    return true;
+}
+
+
+/// Bestätigungen der Panel-Seite abholen (nur UDP), ohne zu warten.
+static void drain(Transport &transport) {
+    char buffer[256];
+    while (transport.receive(buffer, sizeof(buffer)) != 0) {
+    }
+}
+
+
+static void measure(const char *name, Transport &xpif, Transport &panel) {
+    std::vector<double> rtt;
+    rtt.reserve(ROUND_TRIPS);
+    for (int i = 0; i < ROUND_TRIPS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        xpif.send(MESSAGE, MESSAGE_LENGTH);
+        if (! receiveExactly(panel, MESSAGE_LENGTH)) {
+            printf("%s: Zeitüberschreitung\n", name);
+            return;
+        }
+        panel.send(MESSAGE, MESSAGE_LENGTH);
+        if (! receiveExactly(xpif, MESSAGE_LENGTH)) {
+            printf("%s: Zeitüberschreitung\n", name);
+            return;
+        }
+        rtt.push_back(secondsSince(start) * 1e6);
+    }
+    std::sort(rtt.begin(), rtt.end());
+
+    char burst[BURST * MESSAGE_LENGTH];
+    for (int i = 0; i < BURST; ++i) {
+        memcpy(burst + i * MESSAGE_LENGTH, MESSAGE, MESSAGE_LENGTH);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int sent = 0; sent < THROUGHPUT_MESSAGES; sent += BURST) {
+        xpif.send(burst, sizeof(burst));
+        if (! receiveExactly(panel, sizeof(burst))) {
+            printf("%s: Zeitüberschreitung\n", name);
+            return;
+        }
+        drain(xpif);
+    }
+    const double seconds = secondsSince(start);
+    printf("Transport %-6s Round Trip p50 %5.1f µs, p99 %5.1f µs; Durchsatz %7.0f Nachrichten/s\n", name,
+           rtt[rtt.size() / 2], rtt[rtt.size() * 99 / 100], THROUGHPUT_MESSAGES / seconds);
+}
+
+
+static void benchSerial() {
+    int master, slave;
+    if (openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+        printf("serial: openpty fehlgeschlagen\n");
+        return;
+    }
+    SerialTransport xpif(slave);
+    SerialTransport panel(master);
+    measure("serial", xpif, panel);
+}
+
+
+static void benchTcp() {
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    makeAddress("127.0.0.1", 0, address);
+    socklen_t length = sizeof(address);
+    bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length);
+    listen(listener, 1);
+    std::unique_ptr<TcpTransport> xpif = TcpTransport::connect("127.0.0.1", ntohs(address.sin_port));
+    TcpTransport panel(accept(listener, nullptr, nullptr));
+    close(listener);
+    if (xpif != nullptr) {
+        measure("tcp", *xpif, panel);
+    }
+}
+
+
+static void benchUdp() {
+    int fds[2];
+    sockaddr_in addresses[2];
+    for (int i = 0; i < 2; ++i) {
+        fds[i] = socket(AF_INET, SOCK_DGRAM, 0);
+        makeAddress("127.0.0.1", 0, addresses[i]);
+        socklen_t length = sizeof(addresses[i]);
+        bind(fds[i], reinterpret_cast<sockaddr *>(&addresses[i]), sizeof(addresses[i]));
+        getsockname(fds[i], reinterpret_cast<sockaddr *>(&addresses[i]), &length);
+    }
+    connect(fds[0], reinterpret_cast<sockaddr *>(&addresses[1]), sizeof(addresses[1]));
+    connect(fds[1], reinterpret_cast<sockaddr *>(&addresses[0]), sizeof(addresses[0]));
+    UdpTransport xpif(fds[0]);
+    UdpTransport panel(fds[1]);
+    measure("udp", xpif, panel);
+}
+
+
+int main() {
+    benchSerial();
+    benchTcp();
+    benchUdp();
+    return 0;
+}
@@ -0,0 +1,173 @@
+/***************************************************************************************************
+ * @file test_arena.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: FrameArena und die Prüfung auf Speicheranforderungen im Flight-Loop.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Der letzte Test spielt einen aufgezeichneten Flug Frame für Frame so ab, wie es der Flight-Loop-
+ * Callback des Plugins tun soll, und prüft, dass dabei nach dem Start kein einziges Mal operator new
+ * aufgerufen wird.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <allocationaudit.hpp>
+#include <framearena.hpp>
+#include <snapshotring.hpp>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+const size_t DATAREFS = 64;             ///< Werte je Snapshot im aufgezeichneten Flug
+const uint32_t FLIGHT_FRAMES = 36000;   ///< 10 Minuten mit 60 Frames/s
+const size_t MESSAGE_LENGTH = 32;       ///< Platz für eine Nachricht "DEV;EVENT;P1"
+const size_t ARENA_CAPACITY = 4096;
+
+
+static void testAllocateAlignment() {
+    FrameArena arena(256);
+    char *c = arena.allocateArray<char>(1);
+    double *d = arena.allocateArray<double>(2);
+    CHECK(c != nullptr);
+    CHECK(d != nullptr);
+    CHECK(reinterpret_cast<uintptr_t>(d) % alignof(double) == 0);
+    CHECK(reinterpret_cast<char *>(d) >= c + 1);
+    CHECK(arena.getUsed() == static_cast<size_t>(reinterpret_cast<char *>(d + 2) - c));
+    void *page = arena.allocate(16, 64);
+    CHECK(reinterpret_cast<uintptr_t>(page) % 64 == 0);
+}
+
+
+static void testFullArena() {
+    FrameArena arena(64);
+    CHECK(arena.allocate(48, 1) != nullptr);
+    CHECK(arena.allocate(32, 1) == nullptr);
+    CHECK(arena.allocate(static_cast<size_t>(-1), 1) == nullptr);
+    CHECK(arena.getFailures() == 2);
+    CHECK(arena.getUsed() == 48);
+    arena.reset();
+    CHECK(arena.allocate(64, 1) != nullptr);
+    CHECK(arena.getHighWater() == 64);
+}
+
+
+static void testScopeResets() {
+    FrameArena arena(128);
+    {
+        FrameArena::Scope frame(arena);
+        CHECK(arena.allocate(100, 1) != nullptr);
+        CHECK(arena.getUsed() == 100);
+    }
+    CHECK(arena.getUsed() == 0);
+    CHECK(arena.getHighWater() == 100);
+}
+
+
+/// Die Prüfung zählt Anforderungen nur innerhalb eines AllocationAudit::Scope.
+static void testAuditDetectsAllocation() {
+    const uint32_t before = AllocationAudit::getViolations();
+    std::string outside(100, 'x');
+    CHECK(AllocationAudit::getViolations() == before);
+    CHECK(! AllocationAudit::isInFlightLoop());
+    {
+        AllocationAudit::Scope flightLoop;
+        CHECK(AllocationAudit::isInFlightLoop());
+        std::string inside(100, 'y');
+        std::unique_ptr<int[]> array(new int[10]);
+        CHECK(AllocationAudit::getViolations() == before + 2);
+    }
+    CHECK(! AllocationAudit::isInFlightLoop());
+}
+
+
+/// Wert eines Datarefs im aufgezeichneten Flug: Steigflug, Kurven, Frequenz- und Squawk-Wechsel.
+static float recordedValue(const uint32_t frame, const size_t dataref) {
+    const float seconds = static_cast<float>(frame) / 60.0f;
+    switch (dataref) {
+        case 0: return std::round(1000.0f + seconds * 8.0f);                    // Höhe in ft
+        case 1: return std::round(90.0f + 30.0f * std::sin(seconds / 60.0f));   // Kurs
+        case 2: return (frame < FLIGHT_FRAMES / 2) ? 122.800f : 119.100f;       // COM1
+        case 3: return (frame < FLIGHT_FRAMES / 3) ? 7000.0f : 4711.0f;         // Squawk
+        case 4: return static_cast<float>((frame / 600) % 2);                   // Lampe blinkt alle 10 s
+        default: return static_cast<float>(dataref);
+    }
+}
+
+
+/***************************************************************************************************
+ * Der Flight-Loop des Plugins im Kleinen: Snapshot in den Ring schreiben, geänderte Werte als
+ * Nachrichten formatieren. Alle temporären Daten kommen aus der Arena.
+ *
+ * @return Anzahl der formatierten Nachrichten.
+ **************************************************************************************************/
+static size_t flightLoop(FrameArena &arena, SnapshotRing<DATAREFS, 4> &ring, const float *previous,
+                         const float *current, const double simTime) {
+    FrameArena::Scope frame(arena);
+    AllocationAudit::Scope audit;
+
+    ring.write(simTime, current);
+    size_t *changed = arena.allocateArray<size_t>(DATAREFS);
+    size_t changedCount = 0;
+    for (size_t i = 0; i < DATAREFS; ++i) {
+        if (current[i] != previous[i]) {
+            changed[changedCount++] = i;
+        }
+    }
+    char **messages = arena.allocateArray<char *>(changedCount);
+    for (size_t i = 0; i < changedCount; ++i) {
+        messages[i] = arena.allocateArray<char>(MESSAGE_LENGTH);
+        if (messages[i] != nullptr) {
+            snprintf(messages[i], MESSAGE_LENGTH, "DR;%zu;%.3f", changed[i], current[changed[i]]);
+        }
+    }
+    return changedCount;
+}
+
+
+static void testReplayedFlightWithoutAllocation() {
+    // Start: alles, was Speicher vom Heap braucht, entsteht hier.
+    std::vector<float> recording(static_cast<size_t>(FLIGHT_FRAMES) * DATAREFS);
+    size_t expectedMessages = 0;
+    for (uint32_t frame = 0; frame < FLIGHT_FRAMES; ++frame) {
+        for (size_t i = 0; i < DATAREFS; ++i) {
+            recording[frame * DATAREFS + i] = recordedValue(frame, i);
+            expectedMessages += ((frame > 0) && (recordedValue(frame - 1, i) != recordedValue(frame, i))) ? 1 : 0;
+        }
+    }
+    std::unique_ptr<SnapshotRing<DATAREFS, 4>> ring(new SnapshotRing<DATAREFS, 4>(1));
+    FrameArena arena(ARENA_CAPACITY);
+    AllocationAudit::setAbortOnAllocation(false);
+    const uint32_t before = AllocationAudit::getViolations();
+
+    size_t messages = 0;
+    for (uint32_t frame = 1; frame < FLIGHT_FRAMES; ++frame) {
+        messages += flightLoop(arena, *ring, &recording[(frame - 1) * DATAREFS], &recording[frame * DATAREFS],
+                               frame / 60.0);
+    }
+
+    CHECK(AllocationAudit::getViolations() == before);
+    CHECK(arena.getFailures() == 0);
+    CHECK(arena.getUsed() == 0);
+    CHECK(arena.getHighWater() > 0);
+    CHECK(messages == expectedMessages);
+    CHECK(ring->getHead() == FLIGHT_FRAMES - 1);
+    AllocationAudit::setAbortOnAllocation(true);
+    printf("Aufgezeichneter Flug: %u Frames, %zu Nachrichten, Arena höchstens %zu von %zu Byte\n",
+           FLIGHT_FRAMES - 1, messages, arena.getHighWater(), ARENA_CAPACITY);
+}
+
+
+int main() {
+    AllocationAudit::setAbortOnAllocation(false);
+    testAllocateAlignment();
+    testFullArena();
+    testScopeResets();
+    testAuditDetectsAllocation();
+    AllocationAudit::setAbortOnAllocation(true);
+    testReplayedFlightWithoutAllocation();
+    return checkResult("test_arena");
+}
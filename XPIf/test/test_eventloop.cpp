@@ -0,0 +1,204 @@
+/***************************************************************************************************
+ * @file test_eventloop.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Ereignisschleifen epoll und io_uring mit Panels auf Pseudo-Terminals.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Wird mit -DXPIF_IO_URING gebaut; beide Schleifen durchlaufen dieselben Prüfungen. Der Rückfall
+ * auf epoll wird in einem Kindprozess geprüft, in dem io_uring_setup per seccomp gesperrt ist.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <eventloop.hpp>
+
+#include <fcntl.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <poll.h>
+#include <pty.h>
+#include <stddef.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <string>
+
+const size_t PANELS = 4;
+
+
+/// Merkt sich alles, was die Schleife meldet.
+class Recorder : public EventHandler {
+public:
+    std::string received[PANELS];
+    bool closed[PANELS] = {};
+
+    void onReceive(size_t panel, const char *data, size_t length) override { received[panel].append(data, length); }
+    void onClosed(size_t panel) override { closed[panel] = true; }
+};
+
+
+/// Pseudo-Terminals wie beim Arduino: raw, die Schleife bekommt die tty-Seite.
+struct Panels {
+    int master[PANELS];
+    int slave[PANELS];
+
+    explicit Panels(const bool isNonBlocking) {
+        for (size_t i = 0; i < PANELS; ++i) {
+            openpty(&master[i], &slave[i], nullptr, nullptr, nullptr);
+            termios settings;
+            tcgetattr(slave[i], &settings);
+            cfmakeraw(&settings);
+            tcsetattr(slave[i], TCSANOW, &settings);
+            if (isNonBlocking) {
+                fcntl(slave[i], F_SETFL, fcntl(slave[i], F_GETFL) | O_NONBLOCK);
+            }
+        }
+    }
+
+    ~Panels() {
+        for (size_t i = 0; i < PANELS; ++i) {
+            close(master[i]);
+            close(slave[i]);
+        }
+    }
+
+    /// Von der Panel-Seite lesen, bis @em expected Zeichen da sind (höchstens 1 s).
+    std::string read(const size_t panel, const size_t expected) {
+        std::string text;
+        char buffer[256];
+        pollfd readable = {master[panel], POLLIN, 0};
+        while ((text.size() < expected) && (poll(&readable, 1, 1000) == 1)) {
+            const ssize_t length = ::read(master[panel], buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            text.append(buffer, static_cast<size_t>(length));
+        }
+        return text;
+    }
+};
+
+
+/// Schleife laufen lassen, bis @em done erfüllt ist (höchstens 50 Durchläufe).
+template <class Done>
+static void runUntil(EventLoop &loop, Recorder &recorder, Done done) {
+    for (int i = 0; (i < 50) && ! done(); ++i) {
+        loop.run(20, recorder);
+    }
+}
+
+
+static void testLoop(EventLoop &loop, const bool isNonBlocking) {
+    Panels panels(isNonBlocking);
+    Recorder recorder;
+    for (size_t i = 0; i < PANELS; ++i) {
+        CHECK(loop.addPanel(panels.slave[i]) == static_cast<int>(i));
+    }
+
+    // Empfang von allen Panels
+    for (size_t i = 0; i < PANELS; ++i) {
+        const std::string message = "M803;BTN;" + std::to_string(i) + ";0\n";
+        CHECK(write(panels.master[i], message.data(), message.size()) == static_cast<ssize_t>(message.size()));
+    }
+    runUntil(loop, recorder, [&]() { return recorder.received[PANELS - 1].size() == 13; });
+    for (size_t i = 0; i < PANELS; ++i) {
+        CHECK(recorder.received[i] == "M803;BTN;" + std::to_string(i) + ";0\n");
+    }
+
+    // Mehrere Nachrichten je Panel kommen in Reihenfolge an
+    for (size_t i = 0; i < PANELS; ++i) {
+        CHECK(loop.queueWrite(i, "XPDR;MODE;ALT\r\n", 15));
+        CHECK(loop.queueWrite(i, "XPDR;SQUAWK;7000\r\n", 18));
+        CHECK(loop.queueWrite(i, "TIME;UTC;1234\r\n", 15));
+    }
+    loop.flush();
+    for (size_t i = 0; i < PANELS; ++i) {
+        CHECK(panels.read(i, 48) == "XPDR;MODE;ALT\r\nXPDR;SQUAWK;7000\r\nTIME;UTC;1234\r\n");
+    }
+
+    // Antworten aus dem Handler gehen mit dem nächsten run() hinaus; danach wird weiter empfangen
+    CHECK(write(panels.master[1], "SYS;PING;1\n", 11) == 11);
+    runUntil(loop, recorder, [&]() { return recorder.received[1].size() == 13 + 11; });
+    CHECK(loop.queueWrite(1, "SYS;PONG;1\r\n", 12));
+    loop.run(0, recorder);
+    CHECK(panels.read(1, 12) == "SYS;PONG;1\r\n");
+    CHECK(write(panels.master[1], "SYS;PING;2\n", 11) == 11);
+    runUntil(loop, recorder, [&]() { return recorder.received[1].size() == 13 + 22; });
+    CHECK(recorder.received[1] == "M803;BTN;1;0\nSYS;PING;1\nSYS;PING;2\n");
+
+    // Grenzen: zu lange Nachricht, alle Sendepuffer belegt, unbekanntes Panel
+    const std::string tooLong(LOOP_TX_SLOT_SIZE + 1, 'x');
+    CHECK(! loop.queueWrite(0, tooLong.data(), tooLong.size()));
+    CHECK(! loop.queueWrite(PANELS, "X\n", 2));
+    for (size_t slot = 0; slot < LOOP_TX_SLOTS; ++slot) {
+        CHECK(loop.queueWrite(2, "READOUT;SET;0;0\r\n", 17));
+    }
+    CHECK(! loop.queueWrite(2, "READOUT;SET;0;0\r\n", 17));
+    loop.flush();
+    CHECK(panels.read(2, 17 * LOOP_TX_SLOTS).size() == 17 * LOOP_TX_SLOTS);
+    runUntil(loop, recorder, [&]() { return loop.queueWrite(2, "X\r\n", 3); });
+    loop.flush();
+    CHECK(panels.read(2, 3) == "X\r\n");
+
+    // Panel abgesteckt
+    close(panels.master[3]);
+    panels.master[3] = open("/dev/null", O_RDONLY);
+    runUntil(loop, recorder, [&]() { return recorder.closed[3]; });
+    CHECK(recorder.closed[3]);
+    CHECK(! recorder.closed[0]);
+    CHECK(! loop.queueWrite(3, "X\r\n", 3));
+    CHECK(loop.getWriteErrors() == 0);
+}
+
+
+/// Ohne io_uring (hier per seccomp gesperrt) liefert createEventLoop() die epoll-Schleife.
+static void testFallback() {
+    const pid_t child = fork();
+    if (child == 0) {
+        sock_filter filter[] = {
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_setup, 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+            BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+        };
+        sock_fprog program = {static_cast<unsigned short>(sizeof(filter) / sizeof(filter[0])), filter};
+        if ((prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0) || (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) != 0)) {
+            _exit(2);
+        }
+        std::unique_ptr<EventLoop> loop = createEventLoop();
+        _exit(strcmp(loop->name(), "epoll") == 0 ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+}
+
+
+int main() {
+    EpollLoop epoll;
+    CHECK(epoll.isValid());
+    testLoop(epoll, false);
+    EpollLoop epollNonBlocking;
+    testLoop(epollNonBlocking, true);
+
+#ifdef XPIF_IO_URING
+    UringLoop uring;
+    if (uring.isValid()) {
+        testLoop(uring, false);
+        UringLoop uringNonBlocking;
+        testLoop(uringNonBlocking, true);
+        CHECK_STR("io_uring", createEventLoop()->name());
+    } else {
+        printf("test_eventloop: io_uring nicht verfügbar (%s), nur epoll geprüft\n", strerror(uring.getSetupError()));
+    }
+    testFallback();
+#else
+    CHECK_STR("epoll", createEventLoop()->name());
+#endif
+    return checkResult("test_eventloop");
+}
@@ -0,0 +1,194 @@
+/***************************************************************************************************
+ * @file test_expr.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Übersetzen und Auswerten der Ausdrücke für abgeleitete Werte.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <allocationaudit.hpp>
+#include <expression.hpp>
+
+#include <cmath>
+
+/// Indizes der Datarefs im Snapshot
+enum : uint16_t { BARO, ALT, OAT_METRIC, OAT_C, OAT_F, SNAPSHOT_SIZE };
+
+/// Die Ausdrücke aus Doku/xpif.md
+static const char *const PANEL_CONFIG =
+    "# Abgeleitete Werte des Transponders und der Uhr\n"
+    "QNH  = baro * 33.8637526\n"
+    "OAT  = oat_metric ? oat_c : oat_f\n"
+    "FL   = round((alt + (29.92 - baro) * 1000) / 100)\n";
+
+
+/// Compiler mit den Namen der Datarefs des Snapshots.
+static ExpressionCompiler makeCompiler() {
+    ExpressionCompiler compiler;
+    compiler.addDataRef("baro", BARO);
+    compiler.addDataRef("alt", ALT);
+    compiler.addDataRef("oat_metric", OAT_METRIC);
+    compiler.addDataRef("oat_c", OAT_C);
+    compiler.addDataRef("oat_f", OAT_F);
+    return compiler;
+}
+
+
+/// Anzahl der Befehle mit @em opcode.
+static size_t countOpcode(const ExpressionProgram &program, const Opcode opcode) {
+    size_t count = 0;
+    for (const Instruction &instruction : program.instructions()) {
+        count += (instruction.opcode == opcode) ? 1 : 0;
+    }
+    return count;
+}
+
+
+/// Übersetzen einer einzelnen Definition und Auswerten auf @em snapshot.
+static float evaluate(const char *line, const float *snapshot) {
+    ExpressionCompiler compiler = makeCompiler();
+    ExpressionError error;
+    CHECK(compiler.addLine(line, 1, error));
+    ExpressionProgram program = compiler.finish();
+    program.run(snapshot);
+    return (program.valueCount() == 1) ? program.value(0) : NAN;
+}
+
+
+/// QNH, OAT und FL liefern dasselbe wie handgeschriebenes C++.
+static void testPanelValues() {
+    ExpressionCompiler compiler = makeCompiler();
+    CHECK(compiler.addText(PANEL_CONFIG).empty());
+    ExpressionProgram program = compiler.finish();
+    const int qnh = program.find("QNH");
+    const int oat = program.find("OAT");
+    const int fl = program.find("FL");
+    CHECK((qnh == 0) && (oat == 1) && (fl == 2));
+
+    float snapshot[SNAPSHOT_SIZE];
+    for (int step = 0; step < 1000; ++step) {
+        snapshot[BARO] = 28.5f + 0.003f * static_cast<float>(step);
+        snapshot[ALT] = 37.5f * static_cast<float>(step);
+        snapshot[OAT_METRIC] = static_cast<float>(step % 2);
+        snapshot[OAT_C] = 15.0f - 0.01f * static_cast<float>(step);
+        snapshot[OAT_F] = 59.0f - 0.018f * static_cast<float>(step);
+        program.run(snapshot);
+        CHECK(program.value(qnh) == snapshot[BARO] * 33.8637526f);
+        CHECK(program.value(oat) == ((snapshot[OAT_METRIC] != 0.0f) ? snapshot[OAT_C] : snapshot[OAT_F]));
+        CHECK(program.value(fl) == std::round((snapshot[ALT] + (29.92f - snapshot[BARO]) * 1000.0f) / 100.0f));
+    }
+}
+
+
+/// Konstante Teilausdrücke werden gefaltet; Datarefs und Konstanten werden nur einmal geladen.
+static void testFoldingAndLoadOnce() {
+    ExpressionCompiler compiler = makeCompiler();
+    CHECK(compiler.addText("K = 29.92 * 1000\n"
+                           "A = alt + 2 * 3 - -1\n"
+                           "B = alt * 7 + baro * 7\n"
+                           "C = K / 1000 + baro\n").empty());
+    ExpressionProgram program = compiler.finish();
+    CHECK(countOpcode(program, Opcode::MUL) == 2);      // nur die beiden aus B
+    CHECK(countOpcode(program, Opcode::NEG) == 0);
+    CHECK(countOpcode(program, Opcode::LOAD) == 2);     // alt und baro je einmal
+    CHECK(countOpcode(program, Opcode::CONST) == 5);    // 29920, 6, -1, 7 und 29.92
+    const float snapshot[SNAPSHOT_SIZE] = {29.0f, 1000.0f, 0.0f, 0.0f, 0.0f};
+    program.run(snapshot);
+    CHECK(program.value(program.find("K")) == 29920.0f);
+    CHECK(program.value(program.find("A")) == 1007.0f);
+    CHECK(program.value(program.find("B")) == 1000.0f * 7.0f + 29.0f * 7.0f);
+    CHECK(program.value(program.find("C")) == 29920.0f / 1000.0f + 29.0f);
+}
+
+
+/// Operatoren, Vorrang und Funktionen.
+static void testOperatorsAndFunctions() {
+    const float snapshot[SNAPSHOT_SIZE] = {29.92f, -1234.5f, 1.0f, 20.0f, 68.0f};
+    CHECK(evaluate("X = 2 + 3 * 4 - 10 / 4", snapshot) == 11.5f);
+    CHECK(evaluate("X = -(alt) / 2", snapshot) == 617.25f);
+    CHECK(evaluate("X = alt < 0 ? 1 : alt > 0 ? 2 : 3", snapshot) == 1.0f);
+    CHECK(evaluate("X = oat_c <= 20", snapshot) == 1.0f);
+    CHECK(evaluate("X = oat_c >= 21", snapshot) == 0.0f);
+    CHECK(evaluate("X = (oat_c == 20) + (oat_c != 20)", snapshot) == 1.0f);
+    CHECK(evaluate("X = round(alt)", snapshot) == -1235.0f);
+    CHECK(evaluate("X = floor(alt / 1000)", snapshot) == -2.0f);
+    CHECK(evaluate("X = abs(alt)", snapshot) == 1234.5f);
+    CHECK(evaluate("X = min(oat_c, oat_f) + max(oat_c, oat_f)", snapshot) == 88.0f);
+    CHECK(evaluate("X = clamp(alt, 0, 100) + clamp(oat_f, 0, 50) + clamp(oat_c, 0, 50)", snapshot) == 70.0f);
+    CHECK(evaluate("X = clamp(5, 10, 20)", snapshot) == 10.0f);
+    CHECK(evaluate("X = 1 ? oat_c : oat_f", snapshot) == 20.0f);
+    CHECK(evaluate("X = baro", snapshot) == 29.92f);
+}
+
+
+/// Fehler melden Zeile und Spalte; die fehlerhafte Definition erzeugt keinen Code, die übrigen schon.
+static void testErrors() {
+    ExpressionCompiler compiler = makeCompiler();
+    const std::vector<ExpressionError> errors = compiler.addText(
+        "QNH = baro * 33.8637526\n"
+        "X = foo + 1\n"
+        "\n"
+        "Y = (baro + 1\n"
+        "Z = W + 1\n"
+        "W = 2 *\n"
+        "QNH = 1\n"
+        "V = max(baro)\n"
+        "U = baro 3\n"
+        "T = sqrt(baro)\n"
+        "OK = QNH + 1   # Kommentar\n");
+    CHECK(errors.size() == 8);
+    if (errors.size() == 8) {
+        CHECK((errors[0].line == 2) && (errors[0].column == 5));
+        CHECK_STR("Unbekannter Name 'foo'", errors[0].message.c_str());
+        CHECK((errors[1].line == 4) && (errors[1].column == 14));
+        CHECK_STR("')' erwartet", errors[1].message.c_str());
+        CHECK((errors[2].line == 5) && (errors[2].column == 5));    // nur vorher definierte Werte
+        CHECK((errors[3].line == 6) && (errors[3].column == 8));
+        CHECK_STR("Ausdruck unvollständig", errors[3].message.c_str());
+        CHECK((errors[4].line == 7) && (errors[4].column == 1));
+        CHECK((errors[5].line == 8) && (errors[5].column == 13));
+        CHECK((errors[6].line == 9) && (errors[6].column == 10));
+        CHECK((errors[7].line == 10) && (errors[7].column == 5));
+        CHECK_STR("Unbekannte Funktion 'sqrt'", errors[7].message.c_str());
+    }
+    ExpressionProgram program = compiler.finish();
+    CHECK(program.valueCount() == 2);
+    CHECK(program.find("X") == -1);
+    CHECK(program.find("W") == -1);
+    // baro laden, Konstante, MUL, Konstante 1, ADD: von den fehlerhaften Zeilen ist nichts übrig.
+    CHECK(program.instructions().size() == 5);
+    const float snapshot[SNAPSHOT_SIZE] = {30.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    program.run(snapshot);
+    CHECK(program.value(program.find("OK")) == 30.0f * 33.8637526f + 1.0f);
+}
+
+
+/// Beim Auswerten wird kein Speicher angefordert.
+static void testRunWithoutAllocation() {
+    ExpressionCompiler compiler = makeCompiler();
+    compiler.addText(PANEL_CONFIG);
+    ExpressionProgram program = compiler.finish();
+    const float snapshot[SNAPSHOT_SIZE] = {29.92f, 3500.0f, 1.0f, 10.0f, 50.0f};
+    AllocationAudit::setAbortOnAllocation(false);
+    const uint32_t before = AllocationAudit::getViolations();
+    {
+        AllocationAudit::Scope flightLoop;
+        for (int frame = 0; frame < 100; ++frame) {
+            program.run(snapshot);
+        }
+    }
+    CHECK(AllocationAudit::getViolations() == before);
+}
+
+
+int main() {
+    testPanelValues();
+    testFoldingAndLoadOnce();
+    testOperatorsAndFunctions();
+    testErrors();
+    testRunWithoutAllocation();
+    return checkResult("test_expr");
+}
@@ -0,0 +1,169 @@
+/***************************************************************************************************
+ * @file test_logring.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Log-Ring mit Token-Bucket je Message-Id und Hintergrund-Thread zum Schreiben.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <logring.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+const uint64_t SECOND = 1000000000ULL;      ///< Eine Sekunde in ns
+
+using TestLogRing = LogRing<256, 8>;
+using TestLogWriter = LogWriter<256, 8>;
+
+static std::string debugOutput;             ///< Alles, was an die Ausgabefunktion ging
+static int debugCalls = 0;                  ///< Anzahl der Aufrufe der Ausgabefunktion
+
+
+/// Ersatz für XPLMDebugString.
+static void debugString(const char *text) {
+    debugOutput += text;
+    ++debugCalls;
+}
+
+
+/// Den nächsten Eintrag aus @em ring formatieren; ohne Zeitstempel und Message-Id.
+template <class Ring>
+static const char *popLine(Ring &ring) {
+    static char line[LOG_LINE_LENGTH];
+    LogRecord record;
+    if (! ring.pop(record)) {
+        return "<leer>";
+    }
+    formatLogRecord(record, line, sizeof(line));
+    return strchr(line, ']') + 2;
+}
+
+
+static void testFormat() {
+    TestLogRing ring;
+    ring.logAt(SECOND, LogLevel::INFO, 1, "Panel %d verbunden, %.1f V", 3, 4.5f);
+    CHECK_STR("Panel 3 verbunden, 4.5 V\n", popLine(ring));
+    ring.logAt(SECOND, LogLevel::INFO, 2, "%d%% %ld %5.2f %x", 2.9f, 7, 1, 255U);
+    CHECK_STR("2% 7  1.00 ff\n", popLine(ring));
+    ring.logAt(SECOND, LogLevel::INFO, 3, "ohne Argument %d");
+    CHECK_STR("ohne Argument %d\n", popLine(ring));
+
+    LogRecord record;
+    ring.logAt(1500 * SECOND / 1000, LogLevel::INFO, 4, "Text");
+    CHECK(ring.pop(record));
+    char line[LOG_LINE_LENGTH];
+    formatLogRecord(record, line, sizeof(line));
+    CHECK_STR("     1.500 [4] Text\n", line);
+    CHECK(formatLogRecord(record, line, 8) == 7);
+    CHECK_STR("     1\n", line);
+}
+
+
+/// Höchstens 5 Einträge je Message-Id und Sekunde; die übrigen werden beim nächsten mitgezählt.
+static void testRateLimit() {
+    TestLogRing ring(5);
+    int accepted = 0;
+    for (int i = 0; i < 20; ++i) {
+        accepted += ring.logAt(SECOND, LogLevel::INFO, 1, "Neuverbindung %d", i) ? 1 : 0;
+    }
+    CHECK(accepted == 5);
+    CHECK(ring.logAt(SECOND, LogLevel::INFO, 2, "andere Id"));
+    for (int i = 0; i < 5; ++i) {
+        CHECK_STR(("Neuverbindung " + std::to_string(i) + "\n").c_str(), popLine(ring));
+    }
+    CHECK_STR("andere Id\n", popLine(ring));
+
+    CHECK(! ring.logAt(SECOND + SECOND / 10, LogLevel::INFO, 1, "zu früh"));
+    CHECK(ring.logAt(SECOND + SECOND / 5, LogLevel::INFO, 1, "Neuverbindung %d", 99));
+    CHECK_STR("Neuverbindung 99 (16 unterdrückt)\n", popLine(ring));
+    CHECK_STR("<leer>", popLine(ring));
+
+    // Nach einer ruhigen Sekunde ist der Bucket wieder voll.
+    for (int i = 0; i < 5; ++i) {
+        CHECK(ring.logAt(3 * SECOND, LogLevel::INFO, 1, "ruhig"));
+    }
+    CHECK(! ring.logAt(3 * SECOND, LogLevel::INFO, 1, "ruhig"));
+}
+
+
+static void testFullRing() {
+    LogRing<4, 8> ring(1000);
+    for (int i = 0; i < 6; ++i) {
+        ring.logAt(SECOND, LogLevel::INFO, 0, "Eintrag %d", i);
+    }
+    CHECK(ring.getDropped() == 2);
+    CHECK_STR("Eintrag 0\n", popLine(ring));
+    CHECK(ring.logAt(SECOND, LogLevel::INFO, 0, "Eintrag %d", 6));
+    CHECK(ring.getDropped() == 2);
+}
+
+
+/// Zwei Threads loggen, der LogWriter schreibt alles in eine Datei; wichtige Meldungen gebündelt.
+static void testWriter() {
+    const int LOGS = 20000;
+    FILE *file = tmpfile();
+    std::unique_ptr<TestLogRing> simRing(new TestLogRing(1000000));
+    std::unique_ptr<TestLogRing> ioRing(new TestLogRing(1000000));
+    debugOutput.clear();
+    debugCalls = 0;
+    {
+        TestLogWriter writer(file, debugString);
+        CHECK(writer.addSource(*simRing));
+        CHECK(writer.addSource(*ioRing));
+        writer.start();
+        std::thread io([&ioRing]() {
+            for (int i = 0; i < LOGS; ++i) {
+                ioRing->log(LogLevel::INFO, 1, "Panel %d", i);
+                if (i % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            }
+        });
+        simRing->log(LogLevel::IMPORTANT, 0, "Start");
+        for (int i = 0; i < LOGS; ++i) {
+            simRing->log(LogLevel::INFO, 2, "Frame %d", i);
+            if (i % 100 == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));     // Ring leeren lassen
+        simRing->log(LogLevel::IMPORTANT, 0, "Stopp %d", 1);
+        io.join();
+    }
+
+    rewind(file);
+    char line[LOG_LINE_LENGTH];
+    int lines = 0;
+    int droppedReported = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        unsigned ring, dropped;
+        if (sscanf(line, "Log-Ring %u: %u", &ring, &dropped) == 2) {
+            droppedReported += static_cast<int>(dropped);
+        } else {
+            ++lines;
+        }
+    }
+    fclose(file);
+    const int dropped = static_cast<int>(simRing->getDropped() + ioRing->getDropped());
+    CHECK(lines + dropped == 2 * LOGS + 2);
+    CHECK(droppedReported == dropped);
+    CHECK(debugCalls == 1);
+    CHECK_CONTAINS("[0] Start\n", debugOutput.c_str());
+    CHECK_CONTAINS("[0] Stopp 1\n", debugOutput.c_str());
+    CHECK(strstr(debugOutput.c_str(), "Frame") == nullptr);
+    printf("LogWriter: %d Zeilen geschrieben, %d verworfen\n", lines, dropped);
+}
+
+
+int main() {
+    testFormat();
+    testRateLimit();
+    testFullRing();
+    testWriter();
+    return checkResult("test_logring");
+}
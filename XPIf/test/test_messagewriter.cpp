@@ -0,0 +1,55 @@
+/***************************************************************************************************
+ * @file test_messagewriter.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Nachrichten an die Panels zusammensetzen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <messagewriter.hpp>
+
+#include <cstdint>
+#include <string>
+
+
+static void testFormat() {
+    char buffer[32];
+    std::string message;
+    MessageWriter code(buffer, sizeof(buffer));
+    message.assign(buffer, code.text("XPDR").text("CODE").number(700, 4).finish());
+    CHECK_STR("XPDR;CODE;0700\n", message.c_str());
+    MessageWriter time(buffer, sizeof(buffer));
+    message.assign(buffer, time.text("M803").text("TIME").number(93000, 6).number(0, 6).finish());
+    CHECK_STR("M803;TIME;093000;000000\n", message.c_str());
+    MessageWriter level(buffer, sizeof(buffer));
+    message.assign(buffer, level.text("XPDR").text("F").number(-5, 2).number(350).finish());
+    CHECK_STR("XPDR;F;-05;350\n", message.c_str());
+    MessageWriter limits(buffer, sizeof(buffer));
+    message.assign(buffer, limits.number(INT32_MIN).number(INT32_MAX).finish());
+    CHECK_STR("-2147483648;2147483647\n", message.c_str());
+    MessageWriter empty(buffer, sizeof(buffer));
+    message.assign(buffer, empty.text("").text("SYS").text("STAT").finish());
+    CHECK_STR(";SYS;STAT\n", message.c_str());
+}
+
+
+/// Passt die Nachricht nicht, liefert finish() 0 und schreibt nicht über den Puffer hinaus.
+static void testOverflow() {
+    char buffer[16] = {};
+    buffer[15] = 'x';
+    MessageWriter exact(buffer, 15);
+    CHECK(exact.text("XPDR").text("CODE").number(7000).finish() == 15);
+    MessageWriter tooLong(buffer, 15);
+    CHECK(tooLong.text("XPDR").text("CODE").number(70000).finish() == 0);
+    CHECK(buffer[15] == 'x');
+}
+
+
+int main() {
+    testFormat();
+    testOverflow();
+    return checkResult("test_messagewriter");
+}
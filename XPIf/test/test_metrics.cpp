@@ -0,0 +1,222 @@
+/***************************************************************************************************
+ * @file test_metrics.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Zähler je Thread, Histogramme, Prometheus-Seite und Endpunkt über TCP und Unix-Socket.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <metrics.hpp>
+#include <tracing.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+
+static void testBuckets() {
+    CHECK(MetricsShard::bucketOf(0) == 0);
+    CHECK(MetricsShard::bucketOf(999) == 0);
+    CHECK(MetricsShard::bucketOf(1000) == 1);
+    CHECK(MetricsShard::bucketOf(2000) == 3);
+    CHECK(MetricsShard::bucketOf(3000) == 4);
+    CHECK(MetricsShard::bucketOf(4999) == 5);
+    CHECK(MetricsShard::bucketOf(6000) == 6);
+    CHECK(MetricsShard::bucketOf(UINT64_MAX) == HISTOGRAM_BUCKETS - 1);
+    for (size_t bucket = 4; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        const uint64_t start = MetricsShard::bucketStartNs(bucket);
+        CHECK(MetricsShard::bucketOf(start) == bucket);
+        CHECK(MetricsShard::bucketOf(start - 1000) == bucket - 1);
+    }
+}
+
+
+/// Drei Threads zählen gleichzeitig; die Seite wird währenddessen abgerufen und am Ende stimmt die Summe.
+static void testShardedCounters() {
+    Metrics metrics;
+    const int frames = metrics.addCounter("xpif_frames_total");
+    const int histogram = metrics.addHistogram("xpif_frame_seconds");
+    const uint64_t perThread = 1000000;
+    MetricsShard *shards[3];
+    for (MetricsShard *&shard : shards) {
+        shard = metrics.addThread();
+        CHECK(shard != nullptr);
+    }
+    std::thread threads[3];
+    for (int t = 0; t < 3; ++t) {
+        threads[t] = std::thread([&, t]() {
+            for (uint64_t i = 0; i < perThread; ++i) {
+                shards[t]->add(static_cast<size_t>(frames));
+                shards[t]->observe(static_cast<size_t>(histogram), 20000);
+            }
+        });
+    }
+    uint64_t previous = 0;
+    bool isMonotonic = true;
+    for (int scrape = 0; scrape < 50; ++scrape) {
+        const uint64_t now = metrics.getCounter(static_cast<size_t>(frames));
+        isMonotonic = isMonotonic && (now >= previous);
+        previous = now;
+        metrics.render();
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    CHECK(isMonotonic);
+    CHECK(metrics.getCounter(static_cast<size_t>(frames)) == 3 * perThread);
+    CHECK(metrics.getQuantileNs(static_cast<size_t>(histogram), 0.5) >= 16000);
+    CHECK(metrics.getQuantileNs(static_cast<size_t>(histogram), 0.5) < 24000);
+    CHECK(metrics.addThread() != nullptr);
+    CHECK(metrics.addThread() == nullptr);
+}
+
+
+/// Quantile einer Gleichverteilung von 1 bis 1000 µs auf ±20 % genau.
+static void testQuantiles() {
+    Metrics metrics;
+    const size_t rtt = static_cast<size_t>(metrics.addHistogram("xpif_rtt_seconds"));
+    CHECK(metrics.getQuantileNs(rtt, 0.5) == 0);
+    MetricsShard *shard = metrics.addThread();
+    for (uint64_t us = 1; us <= 1000; ++us) {
+        shard->observe(rtt, us * 1000);
+    }
+    const double quantiles[] = {0.5, 0.9, 0.99};
+    for (const double q : quantiles) {
+        const double expected = q * 1000000;
+        const double actual = static_cast<double>(metrics.getQuantileNs(rtt, q));
+        CHECK(std::fabs(actual - expected) < 0.2 * expected);
+    }
+}
+
+
+static void testRender() {
+    Metrics metrics;
+    PanelMetrics m803;
+    CHECK(m803.add(metrics, "m803"));
+    const int frame = metrics.addHistogram("xpif_frame_seconds");
+    MetricsShard *io = metrics.addThread();
+    MetricsShard *sim = metrics.addThread();
+    io->add(static_cast<size_t>(m803.messagesIn), 1234);
+    io->add(static_cast<size_t>(m803.bytesOut), 56789);
+    metrics.setGauge(static_cast<size_t>(m803.queueDepth), 3);
+    for (int i = 0; i < 100; ++i) {
+        io->observe(static_cast<size_t>(m803.rtt), 4000000);
+        sim->observe(static_cast<size_t>(frame), 31000);
+    }
+    CHECK(m803.parseStats(metrics, "SYS;LOOP;812;1930\r\n"));
+    CHECK(m803.parseStats(metrics, "SYS;RAM;612;540"));
+    CHECK(! m803.parseStats(metrics, "SYS;RAM;612"));
+    CHECK(! m803.parseStats(metrics, "SYS;LOOP;x;1930"));
+    CHECK(! m803.parseStats(metrics, "SYS;PONG;42;3011000"));
+
+    const std::string page = metrics.render();
+    CHECK_CONTAINS("# TYPE xpif_panel_messages_total counter\n"
+                   "xpif_panel_messages_total{panel=\"m803\",dir=\"in\"} 1234\n"
+                   "xpif_panel_messages_total{panel=\"m803\",dir=\"out\"} 0\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_bytes_total{panel=\"m803\",dir=\"out\"} 56789\n", page.c_str());
+    CHECK_CONTAINS("# TYPE xpif_panel_queue_depth gauge\nxpif_panel_queue_depth{panel=\"m803\"} 3\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_loop_seconds{panel=\"m803\",stat=\"avg\"} 0.000812\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_loop_seconds{panel=\"m803\",stat=\"max\"} 0.00193\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_free_ram_bytes{panel=\"m803\"} 612\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_min_free_ram_bytes{panel=\"m803\"} 540\n", page.c_str());
+    CHECK_CONTAINS("# TYPE xpif_panel_rtt_seconds summary\nxpif_panel_rtt_seconds{panel=\"m803\",quantile=\"0.5\"} 0.00",
+                   page.c_str());
+    CHECK_CONTAINS("xpif_panel_rtt_seconds_count{panel=\"m803\"} 100\n", page.c_str());
+    CHECK_CONTAINS("xpif_panel_rtt_seconds_sum{panel=\"m803\"} 0.4\n", page.c_str());
+    CHECK_CONTAINS("xpif_frame_seconds{quantile=\"0.99\"} 3", page.c_str());   // 24 .. 32 µs
+    CHECK_CONTAINS("xpif_frame_seconds_count 100\n", page.c_str());
+
+    // Die Umlaufzeit stammt aus dem Zeitabgleich
+    ClockAlignment clock;
+    uint32_t id, micros;
+    const uint32_t ping = clock.ping(1000000000);
+    CHECK(parsePong("SYS;PONG;1;3011000\r\n", id, micros) && (id == ping));
+    CHECK(clock.pong(id, micros, 1004200000));
+    CHECK(clock.getLastRttNs() == 4200000);
+}
+
+
+/// Seite über einen verbundenen Socket abrufen.
+static std::string scrape(const int fd) {
+    const char request[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    std::string response;
+    if (send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(request) - 1)) {
+        return response;
+    }
+    char buffer[4096];
+    pollfd readable = {fd, POLLIN, 0};
+    while (poll(&readable, 1, 1000) == 1) {
+        const ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        response.append(buffer, static_cast<size_t>(length));
+    }
+    close(fd);
+    return response;
+}
+
+
+static void testServer() {
+    Metrics metrics;
+    PanelMetrics m803;
+    CHECK(m803.add(metrics, "m803"));
+    MetricsShard *io = metrics.addThread();
+    io->add(static_cast<size_t>(m803.dropped), 7);
+
+    MetricsServer tcp(metrics);
+    CHECK(! tcp.start());
+    CHECK(tcp.listenTcp(0));
+    CHECK(tcp.getPort() != 0);
+    CHECK(tcp.start());
+    for (int i = 0; i < 3; ++i) {
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(tcp.getPort());
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0);
+        const std::string response = scrape(fd);
+        CHECK(response.compare(0, 17, "HTTP/1.0 200 OK\r\n") == 0);
+        CHECK_CONTAINS("Content-Type: text/plain; version=0.0.4\r\n", response.c_str());
+        CHECK_CONTAINS("\r\n\r\n# TYPE xpif_panel_messages_total counter\n", response.c_str());
+        CHECK_CONTAINS("xpif_panel_dropped_total{panel=\"m803\"} 7\n", response.c_str());
+        const size_t body = response.find("\r\n\r\n") + 4;
+        CHECK_CONTAINS(("Content-Length: " + std::to_string(response.size() - body) + "\r\n").c_str(), response.c_str());
+    }
+    tcp.stop();
+    CHECK(tcp.getScrapes() == 3);
+
+    const std::string path = "/tmp/xpif-test-metrics-" + std::to_string(getpid()) + ".sock";
+    MetricsServer local(metrics);
+    CHECK(local.listenUnix(path));
+    CHECK(local.start());
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    CHECK(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0);
+    CHECK_CONTAINS("xpif_panel_dropped_total{panel=\"m803\"} 7\n", scrape(fd).c_str());
+    local.stop();
+    CHECK(access(path.c_str(), F_OK) != 0);
+}
+
+
+int main() {
+    testBuckets();
+    testShardedCounters();
+    testQuantiles();
+    testRender();
+    testServer();
+    return checkResult("test_metrics");
+}
@@ -0,0 +1,234 @@
+/***************************************************************************************************
+ * @file test_navindex.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Index der Navigationsdatenbank gegen eine vollständige Suche, Aufbau im Hintergrund
+ *        und Meldung der Kennung.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Die synthetische Datenbank hat etwa so viele Einträge wie die von X-Plane (40 000), verteilt auf
+ * die echten Kanäle (NAV 108,00 bis 117,95 MHz, NDB 190 bis 1750 kHz).
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <navindex.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+const size_t DATABASE_SIZE = 40000;
+const int QUERIES = 20000;
+
+
+/// Einfacher, reproduzierbarer Zufallsgenerator.
+struct Random {
+    uint32_t state = 4711;
+
+    uint32_t next() {
+        state = state * 1103515245 + 12345;
+        return state >> 8;
+    }
+
+    double uniform(const double low, const double high) { return low + (high - low) * (next() % 1000000) / 1e6; }
+};
+
+
+static NavEntry makeEntry(const NavType type, const uint16_t frequency, const double lat, const double lon,
+                          const char *ident) {
+    NavEntry entry = {};
+    entry.type = type;
+    entry.frequency = frequency;
+    entry.lat = static_cast<float>(lat);
+    entry.lon = static_cast<float>(lon);
+    memcpy(entry.ident, ident, strnlen(ident, NAV_IDENT_LENGTH));
+    return entry;
+}
+
+
+static std::vector<NavEntry> makeDatabase(Random &random) {
+    static const NavType types[] = {NavType::VOR, NavType::DME, NavType::ILS, NavType::LOC, NavType::NDB};
+    std::vector<NavEntry> entries;
+    for (size_t i = 0; i < DATABASE_SIZE; ++i) {
+        const NavType type = types[random.next() % 5];
+        const uint16_t frequency = (type == NavType::NDB) ? static_cast<uint16_t>(190 + random.next() % 1561)
+                                                          : static_cast<uint16_t>(10800 + 5 * (random.next() % 200));
+        char ident[8];
+        snprintf(ident, sizeof(ident), "%c%c%c", static_cast<int>('A' + i % 26), static_cast<int>('A' + i / 26 % 26),
+                 static_cast<int>('A' + i / 676 % 26));
+        entries.push_back(makeEntry(type, frequency, random.uniform(-60, 75), random.uniform(-180, 180), ident));
+    }
+    return entries;
+}
+
+
+/// Vollständige Suche als Referenz.
+static const NavEntry *bruteForce(const std::vector<NavEntry> &entries, const NavGroup group, const uint16_t frequency,
+                                  const double lat, const double lon) {
+    const NavEntry *nearest = nullptr;
+    double nearestNm = 0.0;
+    for (const NavEntry &entry : entries) {
+        if ((groupOf(entry.type) != group) || (entry.frequency != frequency)) {
+            continue;
+        }
+        const double nm = distanceNm(lat, lon, entry.lat, entry.lon);
+        if ((nm <= rangeOf(entry.type)) && ((nearest == nullptr) || (nm < nearestNm))) {
+            nearest = &entry;
+            nearestNm = nm;
+        }
+    }
+    return nearest;
+}
+
+
+static void testDistance() {
+    // Frankfurt (FFM) nach München (MUN) etwa 164 NM
+    const double nm = distanceNm(50.0533, 8.6375, 48.3564, 11.7939);
+    CHECK((nm > 160) && (nm < 168));
+    CHECK(distanceNm(10, 179.9, 10, -179.9) < 12);      // über die Datumsgrenze
+    CHECK(distanceNm(47, 8, 47, 8) == 0);
+}
+
+
+/// Jede Abfrage liefert dieselbe Station wie die vollständige Suche.
+static void testMatchesBruteForce() {
+    Random random;
+    const std::vector<NavEntry> entries = makeDatabase(random);
+    const auto built = std::chrono::steady_clock::now();
+    const NavIndex index(entries);
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - built).count();
+    CHECK(index.size() == DATABASE_SIZE);
+    int mismatches = 0, found = 0;
+    std::vector<double> lats, lons;
+    std::vector<uint16_t> frequencies;
+    std::vector<NavGroup> groups;
+    for (int i = 0; i < QUERIES; ++i) {
+        // Meist in der Nähe einer Station, damit es auch Treffer gibt
+        const NavEntry &near = entries[random.next() % entries.size()];
+        const NavGroup group = groupOf(near.type);
+        const uint16_t frequency = ((i % 4) == 0) ? static_cast<uint16_t>(10800 + 5 * (random.next() % 200)) : near.frequency;
+        const double lat = near.lat + random.uniform(-3, 3);
+        const double lon = near.lon + random.uniform(-3, 3);
+        const NavEntry *expected = bruteForce(entries, group, frequency, lat, lon);
+        const NavEntry *actual = index.findNearest(group, frequency, lat, lon);
+        const bool isSame = (expected == nullptr) ? (actual == nullptr)
+                                                  : ((actual != nullptr) && (memcmp(expected, actual, sizeof(NavEntry)) == 0));
+        mismatches += isSame ? 0 : 1;
+        found += (actual != nullptr) ? 1 : 0;
+        lats.push_back(lat);
+        lons.push_back(lon);
+        frequencies.push_back(frequency);
+        groups.push_back(group);
+    }
+    CHECK(mismatches == 0);
+    CHECK(found > QUERIES / 4);
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for (int i = 0; i < QUERIES; ++i) {
+        hits += (index.findNearest(groups[i], frequencies[i], lats[i], lons[i]) != nullptr) ? 1 : 0;
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / QUERIES;
+    printf("Navaid-Index: %zu Einträge in %.1f ms aufgebaut, %d von %d Abfragen mit Station, %.2f µs je Abfrage\n",
+           index.size(), buildMs, found, QUERIES, us);
+    CHECK(hits == static_cast<size_t>(found));
+    CHECK(us < 50);
+}
+
+
+/// Reichweite je Typ; NDB und VOR mit gleicher Zahl stören sich nicht.
+static void testRangesAndGroups() {
+    std::vector<NavEntry> entries;
+    entries.push_back(makeEntry(NavType::VOR, 11430, 50.0533, 8.6375, "FFM"));
+    entries.push_back(makeEntry(NavType::ILS, 11155, 50.0300, 8.5000, "IFRW"));
+    entries.push_back(makeEntry(NavType::NDB, 11430, 50.0000, 8.0000, "XYZ"));
+    entries.push_back(makeEntry(NavType::NDB, 400, 49.0000, 8.0000, "ABCDE"));
+    const NavIndex index(entries);
+
+    const NavEntry *vor = index.findNearest(NavGroup::NAV, 11430, 48.5, 8.6375);      // 93 NM
+    CHECK((vor != nullptr) && (strncmp(vor->ident, "FFM", NAV_IDENT_LENGTH) == 0));
+    CHECK(index.findNearest(NavGroup::NAV, 11430, 46.5, 8.6375) == nullptr);          // 213 NM
+    CHECK(index.findNearest(NavGroup::NAV, 11155, 50.3, 8.5) != nullptr);             // 16 NM
+    CHECK(index.findNearest(NavGroup::NAV, 11155, 50.5, 8.5) == nullptr);             // 28 NM
+    const NavEntry *ndb = index.findNearest(NavGroup::ADF, 11430, 50.0, 8.1);
+    CHECK((ndb != nullptr) && (ndb->type == NavType::NDB));
+    const NavEntry *five = index.findNearest(NavGroup::ADF, 400, 49.0, 9.0);         // 39 NM
+    CHECK((five != nullptr) && (strncmp(five->ident, "ABCDE", NAV_IDENT_LENGTH) == 0));
+    CHECK(index.findNearest(NavGroup::ADF, 400, 49.0, 10.0) == nullptr);              // 79 NM
+    CHECK(index.findNearest(NavGroup::NAV, 400, 49.0, 8.0) == nullptr);
+    CHECK(index.findNearest(NavGroup::NAV, 11000, 50.0, 8.6) == nullptr);
+
+    const NavIndex empty(std::vector<NavEntry>{});
+    CHECK(empty.findNearest(NavGroup::NAV, 11430, 50.0, 8.6) == nullptr);
+}
+
+
+/// Bis der Hintergrund-Thread fertig ist, gibt es keine Station; danach die richtige.
+static void testBuildInBackground() {
+    Random random;
+    NavStations stations;
+    CHECK(! stations.isReady());
+    CHECK(stations.findNearest(NavGroup::NAV, 11430, 50.0, 8.6) == nullptr);
+    for (const NavEntry &entry : makeDatabase(random)) {
+        stations.add(entry);
+    }
+    stations.add(makeEntry(NavType::VOR, 11430, 50.0533, 8.6375, "FFM"));
+    stations.build();
+    while (! stations.isReady()) {
+        std::this_thread::yield();
+    }
+    const NavEntry *ffm = stations.findNearest(NavGroup::NAV, 11430, 50.05, 8.64);
+    CHECK((ffm != nullptr) && (strncmp(ffm->ident, "FFM", NAV_IDENT_LENGTH) == 0));
+
+    // Neu einlesen (z.B. nach dem Laden anderer Szenerie) ersetzt den Index
+    stations.add(makeEntry(NavType::VOR, 11430, 50.0533, 8.6375, "NEW"));
+    stations.build();
+    while (! stations.isReady()) {
+        std::this_thread::yield();
+    }
+    const NavEntry *replaced = stations.findNearest(NavGroup::NAV, 11430, 50.05, 8.64);
+    CHECK((replaced != nullptr) && (strncmp(replaced->ident, "NEW", NAV_IDENT_LENGTH) == 0));
+}
+
+
+static void testTracker() {
+    NavStations stations;
+    stations.add(makeEntry(NavType::VOR, 11430, 50.0533, 8.6375, "FFM"));
+    stations.add(makeEntry(NavType::VOR, 11520, 48.3564, 11.7939, "MUN"));
+    NavIdentTracker nav1("NAV1", NavGroup::NAV);
+    char message[32];
+
+    // Vor dem Aufbau: nichts zu melden
+    CHECK(nav1.update(stations, 11430, 50.0, 8.6, message, sizeof(message)) == 0);
+    stations.build();
+    while (! stations.isReady()) {
+        std::this_thread::yield();
+    }
+    size_t length = nav1.update(stations, 11430, 50.0, 8.6, message, sizeof(message));
+    CHECK((length == 14) && (strncmp(message, "NAV1;IDNT;FFM\n", length) == 0));
+    CHECK(nav1.update(stations, 11430, 50.01, 8.6, message, sizeof(message)) == 0);
+    length = nav1.update(stations, 11520, 50.01, 8.6, message, sizeof(message));
+    CHECK((length == 14) && (strncmp(message, "NAV1;IDNT;MUN\n", length) == 0));
+    // Außer Reichweite: leere Kennung
+    length = nav1.update(stations, 11430, 55.0, 8.6, message, sizeof(message));
+    CHECK((length == 11) && (strncmp(message, "NAV1;IDNT;\n", length) == 0));
+    // Ohne Frequenzänderung erst nach 5 NM Flugstrecke neu abgefragt
+    CHECK(nav1.update(stations, 11430, 53.45, 8.6375, message, sizeof(message)) == 0);  // FFM 204 NM
+    CHECK(nav1.update(stations, 11430, 53.38, 8.6375, message, sizeof(message)) == 0);  // 200 NM, aber 4 NM geflogen
+    length = nav1.update(stations, 11430, 53.30, 8.6375, message, sizeof(message));
+    CHECK((length == 14) && (strncmp(message, "NAV1;IDNT;FFM\n", length) == 0));
+}
+
+
+int main() {
+    testDistance();
+    testMatchesBruteForce();
+    testRangesAndGroups();
+    testBuildInBackground();
+    testTracker();
+    return checkResult("test_navindex");
+}
@@ -0,0 +1,198 @@
+/***************************************************************************************************
+ * @file test_rings.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Snapshot- und Action-Ring mit zwei Threads und mit zwei Prozessen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <actionring.hpp>
+#include <snapshotring.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const size_t VALUES = 1024;             ///< Werte je Snapshot; groß, damit ein Leser oft beim Kopieren unterbrochen wird
+const uint32_t FRAMES = 1000000;        ///< Snapshots im Test mit zwei Threads bzw. Prozessen
+
+using TestSnapshotRing = SnapshotRing<VALUES, 2>;     // wenige Slots: der Schreiber überholt den Leser oft
+using TestActionRing = ActionRing<16>;
+
+
+/// Snapshot, dessen Werte alle gleich der Nummer des Frames sind.
+static void fillSnapshot(float *values, const uint32_t frame) {
+    for (size_t i = 0; i < VALUES; ++i) {
+        values[i] = static_cast<float>(frame);
+    }
+}
+
+
+/// @em true, wenn alle Werte zu @em simTime passen, d.h. der Snapshot nicht zerrissen ist.
+static bool isConsistent(const double simTime, const float *values) {
+    for (size_t i = 0; i < VALUES; ++i) {
+        if (values[i] != static_cast<float>(simTime)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/// Leser und Schreiber im selben Thread.
+static void testSnapshotRingSequential() {
+    TestSnapshotRing ring(1);
+    float values[VALUES];
+    double simTime = -1;
+    CHECK(ring.isCompatible());
+    CHECK(ring.readLatest(simTime, values) == 0);
+
+    for (uint32_t frame = 1; frame <= 10; ++frame) {
+        fillSnapshot(values, frame);
+        ring.write(frame, values);
+    }
+    fillSnapshot(values, 0);
+    CHECK(ring.readLatest(simTime, values) == 10);
+    CHECK(simTime == 10);
+    CHECK(isConsistent(simTime, values));
+}
+
+
+/// Ein Thread schreibt so schnell wie möglich, ein zweiter liest: nie ein zerrissener Snapshot.
+static void testSnapshotRingThreads() {
+    TestSnapshotRing ring(1);
+    std::thread writer([&ring] {
+        float values[VALUES];
+        for (uint32_t frame = 1; frame <= FRAMES; ++frame) {
+            fillSnapshot(values, frame);
+            ring.write(frame, values);
+        }
+    });
+
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t lastFrame = 0;
+    float values[VALUES];
+    double simTime;
+    while (lastFrame < FRAMES) {
+        const uint32_t frame = ring.readLatest(simTime, values);
+        if (frame == 0) {
+            continue;
+        }
+        ++reads;
+        torn += (isConsistent(simTime, values) && (simTime == frame)) ? 0 : 1;
+        lastFrame = frame;
+    }
+    writer.join();
+    CHECK(reads > 0);
+    CHECK(torn == 0);
+}
+
+
+/// Voller Ring verwirft und zählt; zu lange Actions werden ebenfalls verworfen.
+static void testActionRingFull() {
+    TestActionRing ring;
+    char action[ACTION_LENGTH];
+    CHECK(! ring.pop(action));
+    for (int i = 0; i < 16; ++i) {
+        CHECK(ring.push("XPDR;IDT"));
+    }
+    CHECK(! ring.push("XPDR;VFR"));
+    CHECK(! ring.push("M803;LT;1234567890123456789012345"));
+    CHECK(ring.getDropped() == 2);
+    CHECK(ring.pop(action));
+    CHECK_STR("XPDR;IDT", action);
+    CHECK(ring.push("XPDR;VFR"));
+}
+
+
+/// Erzeuger und Verbraucher in zwei Threads: Reihenfolge bleibt erhalten, Verlust nur bei vollem Ring.
+static void testActionRingThreads() {
+    TestActionRing ring;
+    std::atomic<bool> done(false);
+    uint32_t pushed = 0;
+    std::thread producer([&ring, &done, &pushed] {
+        char action[ACTION_LENGTH];
+        for (uint32_t i = 1; i <= FRAMES; ++i) {
+            snprintf(action, sizeof(action), "SW;ON;%u", static_cast<unsigned int>(i));
+            pushed += ring.push(action) ? 1 : 0;
+        }
+        done.store(true);
+    });
+
+    uint32_t popped = 0;
+    uint32_t last = 0;
+    uint32_t unordered = 0;
+    char action[ACTION_LENGTH];
+    bool isFinished = false;
+    while (! isFinished) {
+        isFinished = done.load();   // vor pop() lesen: danach kommt nichts mehr hinzu
+        while (ring.pop(action)) {
+            const uint32_t number = static_cast<uint32_t>(atol(action + 6));
+            unordered += (number <= last) ? 1 : 0;
+            last = number;
+            ++popped;
+        }
+    }
+    producer.join();
+    CHECK(unordered == 0);
+    CHECK(popped == pushed);
+    CHECK(pushed + ring.getDropped() == FRAMES);
+}
+
+
+/// Schreiber und Leser in zwei Prozessen über Shared Memory, wie Plugin und Daemon.
+static void testSnapshotRingProcesses() {
+    void *memory = mmap(nullptr, sizeof(TestSnapshotRing), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CHECK(memory != MAP_FAILED);
+    if (memory == MAP_FAILED) {
+        return;
+    }
+    TestSnapshotRing *ring = new (memory) TestSnapshotRing(7);
+
+    const pid_t child = fork();
+    if (child == 0) {
+        float values[VALUES];
+        for (uint32_t frame = 1; frame <= FRAMES; ++frame) {
+            fillSnapshot(values, frame);
+            ring->write(frame, values);
+        }
+        _exit(0);
+    }
+
+    // Der "Daemon" sieht den Ring nur über das Shared Memory.
+    const TestSnapshotRing *shared = static_cast<const TestSnapshotRing *>(memory);
+    CHECK(shared->isCompatible());
+    CHECK(shared->getVersion() == 7);
+    uint32_t torn = 0;
+    float values[VALUES];
+    double simTime;
+    while (shared->getHead() < FRAMES) {
+        const uint32_t frame = shared->readLatest(simTime, values);
+        if ((frame != 0) && ! (isConsistent(simTime, values) && (simTime == frame))) {
+            ++torn;
+        }
+    }
+    int status = -1;
+    waitpid(child, &status, 0);
+    CHECK(status == 0);
+    CHECK(torn == 0);
+    CHECK(shared->readLatest(simTime, values) == FRAMES);
+    munmap(memory, sizeof(TestSnapshotRing));
+}
+
+
+int main() {
+    testSnapshotRingSequential();
+    testSnapshotRingThreads();
+    testActionRingFull();
+    testActionRingThreads();
+    testSnapshotRingProcesses();
+    return checkResult("test_rings");
+}
@@ -0,0 +1,74 @@
+/***************************************************************************************************
+ * @file test_snapshotdiff.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Geänderte Werte eines Snapshots mit und ohne Schwelle.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <snapshotdiff.hpp>
+
+#include <cmath>
+
+
+static void testFirstUpdateSendsAll() {
+    SnapshotDiff<4> diff;
+    const float values[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    uint16_t changed[4];
+    CHECK(std::isnan(diff.getSent(0)));
+    CHECK(diff.update(values, changed) == 4);
+    CHECK((changed[0] == 0) && (changed[3] == 3));
+    CHECK(diff.getSent(2) == 3.0f);
+    CHECK(diff.update(values, changed) == 0);
+
+    diff.invalidate();
+    CHECK(diff.update(values, changed) == 4);
+}
+
+
+static void testChangedIndices() {
+    SnapshotDiff<8> diff;
+    float values[8] = {};
+    uint16_t changed[8];
+    diff.update(values, changed);
+    values[1] = 1.0f;
+    values[6] = -1.0f;
+    CHECK(diff.update(values, changed) == 2);
+    CHECK((changed[0] == 1) && (changed[1] == 6));
+    values[6] = NAN;                        // z.B. ein Dataref, den es nicht gibt
+    CHECK(diff.update(values, changed) == 1);
+    CHECK(diff.update(values, changed) == 1);
+}
+
+
+/// Ein langsam wandernder Wert wird gesendet, sobald er insgesamt um mehr als die Schwelle abweicht.
+static void testThreshold() {
+    SnapshotDiff<2> diff;
+    diff.setThreshold(0, 0.5f);
+    float values[2] = {1000.0f, 0.0f};
+    uint16_t changed[2];
+    CHECK(diff.update(values, changed) == 2);
+    int sent = 0;
+    for (int i = 1; i <= 10; ++i) {
+        values[0] = 1000.0f + 0.2f * static_cast<float>(i);
+        sent += static_cast<int>(diff.update(values, changed));
+    }
+    CHECK(sent == 3);                       // bei 1000,6, 1001,2 und 1001,8
+    CHECK(std::fabs(diff.getSent(0) - 1001.8f) < 0.01f);
+    values[0] = 1001.4f;
+    CHECK(diff.update(values, changed) == 0);
+    values[1] = 1e-6f;                      // Schwelle 0: jede Änderung
+    CHECK(diff.update(values, changed) == 1);
+    CHECK(changed[0] == 1);
+}
+
+
+int main() {
+    testFirstUpdateSendsAll();
+    testChangedIndices();
+    testThreshold();
+    return checkResult("test_snapshotdiff");
+}
@@ -0,0 +1,257 @@
+/***************************************************************************************************
+ * @file test_stub.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Stub-XPLM mit Profilen, virtueller Uhr, Kommandos, Menüs, Gelände und Flugzeugen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <xplmstub.hpp>
+
+#include <XPLMDataAccess.h>
+#include <XPLMGraphics.h>
+#include <XPLMMenus.h>
+#include <XPLMPlanes.h>
+#include <XPLMPlugin.h>
+#include <XPLMProcessing.h>
+#include <XPLMScenery.h>
+#include <XPLMUtilities.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+static std::string debugOutput;     ///< Alles, was mit XPLMDebugString ausgegeben wurde
+
+
+static void debugHandler(const char *text) { debugOutput += text; }
+
+
+/// Profil in eine temporäre Datei schreiben und laden.
+static bool loadProfile(const char *text) {
+    char path[] = "/tmp/xplmstubXXXXXX";
+    const int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "w");
+    fputs(text, file);
+    fclose(file);
+    const bool isOk = stubLoadProfile(path);
+    remove(path);
+    return isOk;
+}
+
+
+static bool isNear(const float a, const float b) { return std::fabs(a - b) < 1e-3f; }
+
+
+static void testProfile() {
+    stubReset();
+    CHECK(loadProfile("# Kommentar\n"
+                      "0    sim/test/altitude   1000\n"
+                      "10   sim/test/altitude   2000   # linear\n"
+                      "\n"
+                      "5    sim/test/code       7000\n"
+                      "5    sim/test/code       4711\n"
+                      "0    sim/test/volts[0]   24\n"
+                      "0    sim/test/volts[2]   12\n"));
+    XPLMDataRef altitude = XPLMFindDataRef("sim/test/altitude");
+    XPLMDataRef code = XPLMFindDataRef("sim/test/code");
+    XPLMDataRef volts = XPLMFindDataRef("sim/test/volts");
+    CHECK(isNear(XPLMGetDataf(altitude), 1000));
+    CHECK(XPLMGetDatai(code) == 7000);
+
+    stubRunFrames(150);     // 2,5 s
+    CHECK(isNear(XPLMGetElapsedTime(), 2.5f));
+    CHECK(XPLMGetCycleNumber() == 150);
+    CHECK(isNear(XPLMGetDataf(altitude), 1250));
+    CHECK(XPLMGetDatai(code) == 7000);
+    stubRunFrames(150);     // 5 s: Sprung
+    CHECK(XPLMGetDatai(code) == 4711);
+    stubRunFrames(600);     // 15 s: nach dem letzten Stützpunkt
+    CHECK(isNear(XPLMGetDataf(altitude), 2000));
+
+    CHECK(XPLMGetDatavf(volts, nullptr, 0, 0) == 3);
+    float values[4] = {-1, -1, -1, -1};
+    CHECK(XPLMGetDatavf(volts, values, 1, 4) == 2);
+    CHECK(isNear(values[0], 0) && isNear(values[1], 12) && isNear(values[2], -1));
+    CHECK((XPLMGetDataRefTypes(volts) & xplmType_FloatArray) != 0);
+    CHECK((XPLMGetDataRefTypes(altitude) & xplmType_Float) != 0);
+
+    // Gesetzte Werte gelten statt des Profils, bis ein Profil geladen wird.
+    XPLMSetDatai(code, 1200);
+    CHECK(XPLMGetDatai(code) == 1200);
+    CHECK(loadProfile("0 sim/test/code 2000\n"));
+    CHECK(XPLMGetDatai(code) == 2000);
+    CHECK(isNear(XPLMGetDataf(altitude), 0));
+}
+
+
+static void testUnknownDataRef() {
+    stubReset();
+    debugOutput.clear();
+    stubSetDebugHandler(debugHandler);
+    XPLMDataRef unknown = XPLMFindDataRef("sim/test/unknown");
+    CHECK(unknown != nullptr);
+    CHECK(XPLMGetDatai(unknown) == 0);
+    CHECK(XPLMFindDataRef("sim/test/unknown") == unknown);
+    CHECK(stubGetUnknownDataRefCount() == 1);
+    CHECK(debugOutput == "Stub-XPLM: Dataref sim/test/unknown kommt in keinem Profil vor und liefert 0\n");
+
+    debugOutput.clear();
+    CHECK(! loadProfile("0 sim/test/broken\n"));
+    CHECK_CONTAINS("Zeile 1 fehlerhaft", debugOutput.c_str());
+    CHECK(! stubLoadProfile("/tmp/gibt/es/nicht.txt"));
+    stubSetDebugHandler(nullptr);
+}
+
+
+static int everyFrameCalls = 0;
+static int halfSecondCalls = 0;
+static int onceCalls = 0;
+static float lastElapsed = 0;
+
+
+static float everyFrame(float, float, int, void *) {
+    ++everyFrameCalls;
+    return -1.0f;
+}
+
+static float everyHalfSecond(float elapsedSinceLastCall, float, int, void *refcon) {
+    ++halfSecondCalls;
+    lastElapsed = elapsedSinceLastCall;
+    CHECK(refcon == &halfSecondCalls);
+    return 0.5f;
+}
+
+static float once(float, float, int, void *) {
+    ++onceCalls;
+    return 0.0f;
+}
+
+
+static void testFlightLoops() {
+    stubReset();
+    XPLMRegisterFlightLoopCallback(everyFrame, -1.0f, nullptr);
+    XPLMRegisterFlightLoopCallback(everyHalfSecond, 0.5f, &halfSecondCalls);
+    XPLMRegisterFlightLoopCallback(once, -10.0f, nullptr);
+    stubRunFrames(60);
+    CHECK(everyFrameCalls == 60);
+    CHECK(halfSecondCalls == 2);
+    CHECK(isNear(lastElapsed, 0.5f));
+    CHECK(onceCalls == 1);
+
+    XPLMUnregisterFlightLoopCallback(everyFrame, nullptr);
+    XPLMSetFlightLoopCallbackInterval(once, -1.0f, 1, nullptr);
+    stubRunFrames(60);
+    CHECK(everyFrameCalls == 60);
+    CHECK(halfSecondCalls == 4);
+    CHECK(onceCalls == 2);
+
+    XPLMCreateFlightLoop_t params = {sizeof(XPLMCreateFlightLoop_t), xplm_FlightLoop_Phase_BeforeFlightModel,
+                                     everyFrame, nullptr};
+    XPLMFlightLoopID loop = XPLMCreateFlightLoop(&params);
+    stubRunFrames(10);
+    CHECK(everyFrameCalls == 60);
+    XPLMScheduleFlightLoop(loop, -1.0f, 1);
+    stubRunFrames(10);
+    CHECK(everyFrameCalls == 70);
+    XPLMDestroyFlightLoop(loop);
+    stubRunFrames(10);
+    CHECK(everyFrameCalls == 70);
+}
+
+
+static int menuSelections = 0;
+static void *selectedItem = nullptr;
+
+
+static void menuHandler(void *menuRef, void *itemRef) {
+    CHECK(menuRef == &menuSelections);
+    ++menuSelections;
+    selectedItem = itemRef;
+}
+
+
+static void testCommandsMenusUtilities() {
+    stubReset();
+    XPLMCommandRef ident = XPLMFindCommand("sim/transponder/transponder_ident");
+    CHECK(XPLMFindCommand("sim/transponder/transponder_ident") == ident);
+    XPLMCommandOnce(ident);
+    XPLMCommandOnce(ident);
+    CHECK(stubGetCommandCount("sim/transponder/transponder_ident") == 2);
+    CHECK(stubGetCommandCount("sim/none") == 0);
+
+    static int itemRef = 0;
+    XPLMMenuID menu = XPLMCreateMenu("XPIf", XPLMFindPluginsMenu(), 0, menuHandler, &menuSelections);
+    CHECK(XPLMAppendMenuItem(menu, "Panels neu verbinden", nullptr, 0) == 0);
+    CHECK(XPLMAppendMenuItem(menu, "Tracing", &itemRef, 0) == 1);
+    CHECK(stubSelectMenuItem("XPIf", 1));
+    CHECK(menuSelections == 1);
+    CHECK(selectedItem == &itemRef);
+    CHECK(! stubSelectMenuItem("XPIf", 2));
+    CHECK(! stubSelectMenuItem("Andere", 0));
+
+    CHECK(XPLMGetMyID() != XPLM_NO_PLUGIN_ID);
+    char path[512];
+    XPLMGetSystemPath(path);
+    CHECK(path[strlen(path) - 1] == '/');
+}
+
+
+static float hill(const double lat, const double lon) { return (lat > 50.0) ? 500.0f : (lon < 0.0) ? NAN : 0.0f; }
+
+
+static void testTerrain() {
+    stubReset();
+    stubSetLocalOrigin(50.0, 8.0);
+    double x, y, z, lat, lon, alt;
+    XPLMWorldToLocal(50.01, 8.02, 300.0, &x, &y, &z);
+    CHECK((std::fabs(x - 1431) < 1) && (y == 300.0) && (std::fabs(z + 1113) < 1));     // Osten, oben, Süden
+    XPLMLocalToWorld(x, y, z, &lat, &lon, &alt);
+    CHECK((std::fabs(lat - 50.01) < 1e-9) && (std::fabs(lon - 8.02) < 1e-9) && (alt == 300.0));
+
+    XPLMProbeRef probe = XPLMCreateProbe(xplm_ProbeY);
+    CHECK(stubGetOpenProbeCount() == 1);
+    XPLMProbeInfo_t info;
+    info.structSize = sizeof(info);
+    CHECK(XPLMProbeTerrainXYZ(probe, static_cast<float>(x), 0.0f, static_cast<float>(z), &info) == xplm_ProbeHitTerrain);
+    CHECK((info.locationY == 0.0f) && (info.is_wet == 1));                             // ohne Gelände: Wasser
+    stubSetTerrain(hill);
+    CHECK(XPLMProbeTerrainXYZ(probe, static_cast<float>(x), 0.0f, static_cast<float>(z), &info) == xplm_ProbeHitTerrain);
+    CHECK((info.locationY == 500.0f) && (info.is_wet == 0));
+    XPLMWorldToLocal(49.0, -1.0, 0.0, &x, &y, &z);
+    CHECK(XPLMProbeTerrainXYZ(probe, static_cast<float>(x), 0.0f, static_cast<float>(z), &info) == xplm_ProbeMissed);
+    info.structSize = 4;
+    CHECK(XPLMProbeTerrainXYZ(probe, 0.0f, 0.0f, 0.0f, &info) == xplm_ProbeError);
+    CHECK(stubGetProbeCount() == 3);
+    XPLMDestroyProbe(probe);
+    CHECK(stubGetOpenProbeCount() == 0);
+}
+
+
+static void testAircraft() {
+    stubReset();
+    int total = -1, active = -1;
+    XPLMPluginID controller = 0;
+    XPLMCountAircraft(&total, &active, &controller);
+    CHECK((total == 1) && (active == 1) && (controller == XPLM_NO_PLUGIN_ID));     // nur das eigene
+    stubSetAircraftCount(201);
+    XPLMCountAircraft(&total, &active, &controller);
+    CHECK((total == 201) && (active == 201));
+    stubReset();
+    XPLMCountAircraft(&total, &active, &controller);
+    CHECK(active == 1);
+}
+
+
+int main() {
+    testProfile();
+    testUnknownDataRef();
+    testFlightLoops();
+    testCommandsMenusUtilities();
+    testTerrain();
+    testAircraft();
+    return checkResult("test_stub");
+}
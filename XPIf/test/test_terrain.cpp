@@ -0,0 +1,286 @@
+/***************************************************************************************************
+ * @file test_terrain.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Radarhöhe aus gecachten Geländeabfragen, direkt und über die Stub-XPLM.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Das Gelände ist analytisch (Ebene, Rampe, Bergrücken); die exakte Radarhöhe ist die kleinste Höhe
+ * über dem Gelände im Strahlkegel, durch feines Abtasten bestimmt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <terraincache.hpp>
+#include <terrainprobe.hpp>
+#include <xplmstub.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+const double BASE_LAT = 50.0;
+const double BASE_LON = 8.0;
+const double METERS_PER_DEGREE = 111320.0;
+const double PI = 3.14159265358979323846;
+const float FEET_PER_METER = 3.28084f;
+const float FRAME = 1.0f / 60;
+const uint8_t VALUE_ID = 3;
+
+static uint32_t probes = 0;                 ///< Abfragen über countingProbe()
+static float (*terrain)(double north, double east) = nullptr;
+
+
+static double northOf(const double lat) { return (lat - BASE_LAT) * METERS_PER_DEGREE; }
+static double eastOf(const double lon) { return (lon - BASE_LON) * METERS_PER_DEGREE * std::cos(BASE_LAT * PI / 180); }
+static double latOf(const double north) { return BASE_LAT + north / METERS_PER_DEGREE; }
+static double lonOf(const double east) { return BASE_LON + east / (METERS_PER_DEGREE * std::cos(BASE_LAT * PI / 180)); }
+
+static float plane(double, double) { return 300.0f; }
+static float higherPlane(double, double) { return 330.0f; }
+static float ramp(double, double east) { return static_cast<float>(200.0 + 0.05 * east); }        // 5 % nach Osten
+static float ridge(double north, double) {                      // 2 km nördlich, 300 m hoch, Breite (Sigma) 500 m
+    return static_cast<float>(200.0 + 300.0 * std::exp(-(north - 2000.0) * (north - 2000.0) / (2 * 500.0 * 500.0)));
+}
+
+static float elevationAt(const double lat, const double lon) { return terrain(northOf(lat), eastOf(lon)); }
+
+static float countingProbe(const double lat, const double lon) {
+    ++probes;
+    return elevationAt(lat, lon);
+}
+
+
+/// Exakte Radarhöhe in ft: Abstand zum höchsten Gelände im Kegel.
+static float exactAltitude(const double north, const double east, const float elevation, const float agl) {
+    const double radius = agl * std::tan(TERRAIN_BEAM_DEG * PI / 180);
+    float highest = terrain(north, east);
+    for (int i = -40; i <= 40; ++i) {
+        for (int j = -40; j <= 40; ++j) {
+            if (i * i + j * j <= 1600) {
+                highest = std::max(highest, terrain(north + radius * i / 40, east + radius * j / 40));
+            }
+        }
+    }
+    return (elevation - highest) * FEET_PER_METER;
+}
+
+
+/// Position auf einem Flug mit gegebener Höhe über NN, über Grund und Richtung.
+static AircraftPosition positionAt(const double north, const double east, const float elevation, const float speed,
+                                   const float track) {
+    AircraftPosition aircraft;
+    aircraft.lat = latOf(north);
+    aircraft.lon = lonOf(east);
+    aircraft.elevation = elevation;
+    aircraft.yAgl = elevation - terrain(north, east);
+    aircraft.groundSpeed = speed;
+    aircraft.track = track;
+    return aircraft;
+}
+
+
+/**
+ * Geradeaus in 700 m über NN: Nach dem Füllen des Gitters stimmt der Wert auf 3 % (wie ein echter
+ * Radarhöhenmesser), mindestens 5 ft; am Bergrücken begrenzt die bilineare Interpolation die Genauigkeit.
+ */
+static void testAccuracy() {
+    struct Case {
+        const char *name;
+        float (*terrain)(double, double);
+        float track;
+    };
+    const Case cases[] = {{"Ebene", plane, 45}, {"Rampe", ramp, 90}, {"Bergrücken", ridge, 0}};
+    for (const Case &c : cases) {
+        terrain = c.terrain;
+        probes = 0;
+        TerrainCache cache(countingProbe, VALUE_ID);
+        char message[64];
+        float worst = 0.0f, worstPercent = 0.0f;
+        bool isTolerated = true;
+        int held = 0;
+        int maxProbes = 0;
+        const float speed = 60.0f;
+        for (int frame = 0; frame < 60 * 60; ++frame) {
+            const double distance = speed * FRAME * frame;
+            const double north = distance * std::cos(c.track * PI / 180);
+            const double east = distance * std::sin(c.track * PI / 180);
+            const AircraftPosition aircraft = positionAt(north, east, 700.0f, speed, c.track);
+            const uint32_t before = probes;
+            cache.update(aircraft, FRAME, message, sizeof(message));
+            maxProbes = std::max(maxProbes, static_cast<int>(probes - before));
+            if (frame >= 60) {
+                const float exact = exactAltitude(north, east, 700.0f, aircraft.yAgl);
+                if (std::isnan(cache.getRawAltitude())) {
+                    ++held;
+                    continue;
+                }
+                const float error = std::fabs(cache.getRawAltitude() - exact);
+                isTolerated = isTolerated && (error <= std::max(5.0f, 0.03f * exact));
+                worst = std::max(worst, error);
+                worstPercent = std::max(worstPercent, 100 * error / exact);
+            }
+        }
+        printf("Radarhöhe %s: größte Abweichung %.1f ft (%.1f %%), %d Frames ohne Wert, %u Abfragen in 3600 Frames\n",
+               c.name, worst, worstPercent, held, probes);
+        CHECK(isTolerated);
+        CHECK(held < 60);
+        CHECK(maxProbes <= TERRAIN_PROBES_PER_FRAME);
+        CHECK(cache.getProbeCount() == probes);
+    }
+}
+
+
+/// Über die Stub-XPLM: fast alle Höhen kommen aus dem Gitter, nie mehr als 2 Abfragen je Frame.
+static void testHitRate() {
+    stubReset();
+    stubSetLocalOrigin(BASE_LAT, BASE_LON);
+    stubSetTerrain(elevationAt);
+    terrain = ramp;
+    createTerrainProbe();
+    CHECK(stubGetOpenProbeCount() == 1);
+    TerrainCache cache(probeTerrain, VALUE_ID);
+    char message[64];
+    const float speed = 61.7f;              // 120 kt nach Osten, 1000 ft über Grund
+    const int frames = 5 * 60 * 60;
+    uint32_t maxProbes = 0;
+    float worst = 0.0f;
+    for (int frame = 0; frame < frames; ++frame) {
+        const double east = speed * FRAME * frame;
+        const float elevation = ramp(0, east) + 305.0f;
+        const uint32_t before = stubGetProbeCount();
+        cache.update(positionAt(0, east, elevation, speed, 90), FRAME, message, sizeof(message));
+        maxProbes = std::max(maxProbes, stubGetProbeCount() - before);
+        if (frame >= 60) {
+            worst = std::max(worst, std::fabs(cache.getRawAltitude() - exactAltitude(0, east, elevation, 305.0f)));
+        }
+    }
+    const double hitRate = 1.0 - static_cast<double>(stubGetProbeCount()) / cache.getSampleCount();
+    printf("Gelände über Stub-XPLM: %u Abfragen für %u interpolierte Höhen in %d Frames (Trefferquote %.2f %%), "
+           "größte Abweichung %.1f ft\n", stubGetProbeCount(), cache.getSampleCount(), frames, hitRate * 100, worst);
+    CHECK(stubGetProbeCount() == cache.getProbeCount());
+    CHECK(maxProbes <= static_cast<uint32_t>(TERRAIN_PROBES_PER_FRAME));
+    CHECK(stubGetProbeCount() < static_cast<uint32_t>(frames) / 2);
+    CHECK(hitRate > 0.98);
+    CHECK(worst < 10.0f);
+    destroyTerrainProbe();
+    CHECK(stubGetOpenProbeCount() == 0);
+}
+
+
+/// Im Schwebeflug wird erst nach dem höhenabhängigen Alter neu abgefragt; dann gilt neues Gelände.
+static void testStaleness() {
+    stubReset();
+    stubSetLocalOrigin(BASE_LAT, BASE_LON);
+    stubSetTerrain(elevationAt);
+    terrain = plane;
+    createTerrainProbe();
+    TerrainCache cache(probeTerrain, VALUE_ID);
+    char message[64];
+    const float elevation = 300.0f + 1000.0f / FEET_PER_METER;       // 1000 ft: neu nach 4 s
+    const float maxAge = TERRAIN_MAX_AGE_S * 1000.0f / TERRAIN_MAX_AGL_FT;
+    int frame = 0;
+    auto run = [&](const float seconds) {
+        for (const int end = frame + static_cast<int>(seconds * 60); frame < end; ++frame) {
+            cache.update(positionAt(0, 0, elevation, 0.0f, 0.0f), FRAME, message, sizeof(message));
+        }
+    };
+    run(1.0f);
+    const uint32_t filled = stubGetProbeCount();
+    CHECK(filled == TERRAIN_GRID * TERRAIN_GRID);
+    CHECK(std::fabs(cache.getAltitude() - 1000.0f) < 1.0f);
+
+    // Neue Szenerie mit anderem Ursprung: bis zum Ablauf des Alters bleibt der gecachte Wert
+    terrain = higherPlane;
+    stubSetLocalOrigin(BASE_LAT + 0.5, BASE_LON - 0.5);
+    run(maxAge - 1.5f);
+    CHECK(stubGetProbeCount() == filled);
+    CHECK(std::fabs(cache.getAltitude() - 1000.0f) < 1.0f);
+    run(1.5f);
+    const uint32_t refreshed = stubGetProbeCount() - filled;
+    CHECK(refreshed == TERRAIN_GRID * TERRAIN_GRID);
+    run(2.0f);
+    const float expected = 1000.0f - 30.0f * FEET_PER_METER;
+    printf("Veraltete Punkte: nach %.0f s %u Abfragen, danach %.1f ft (erwartet %.1f ft)\n", maxAge, refreshed,
+           cache.getAltitude(), expected);
+    CHECK(std::fabs(cache.getAltitude() - expected) < 1.0f);
+    destroyTerrainProbe();
+}
+
+
+/// Über 2500 ft: keine Abfragen, einmal Wert und Rate 0 (Anzeige dunkel).
+static void testAboveMaximum() {
+    terrain = plane;
+    probes = 0;
+    TerrainCache cache(countingProbe, VALUE_ID);
+    char message[64];
+    const AircraftPosition high = positionAt(0, 0, 300.0f + 3000.0f / FEET_PER_METER, 60.0f, 0.0f);
+    size_t length = cache.update(high, FRAME, message, sizeof(message));
+    const std::string blank(message, length);
+    CHECK_STR(blank.c_str(), "RD;R;3;0\nRD;V;3;0\n");
+    for (int frame = 0; frame < 600; ++frame) {
+        CHECK(cache.update(high, FRAME, message, sizeof(message)) == 0);
+    }
+    CHECK(probes == 0);
+    CHECK(std::isnan(cache.getAltitude()));
+    // Darunter erst, sobald die Punkte unter dem Flugzeug abgefragt sind
+    const AircraftPosition low = positionAt(0, 0, 300.0f + 2000.0f / FEET_PER_METER, 60.0f, 0.0f);
+    length = 0;
+    for (int frame = 0; (frame < 60) && (length == 0); ++frame) {
+        length = cache.update(low, FRAME, message, sizeof(message));
+    }
+    const std::string lowMessage(message, length);
+    CHECK_CONTAINS(lowMessage.c_str(), "RD;V;3;2000\n");
+}
+
+
+/// Sinkflug: Der Arduino rechnet mit der Rate weiter; es gehen nur wenige Nachrichten zum Panel.
+static void testMessages() {
+    terrain = plane;
+    TerrainCache cache(countingProbe, VALUE_ID);
+    char message[64];
+    float shownValue = 0.0f, shownRate = 0.0f, shownAt = 0.0f;       // Modell des Arduino
+    int messages = 0;
+    float worst = 0.0f;
+    const int frames = 90 * 60;
+    for (int frame = 0; frame < frames; ++frame) {
+        const float now = frame * FRAME;
+        const float agl = 2000.0f - 1000.0f * now / 60;              // 1000 ft/min
+        const double east = 60.0 * now;
+        const size_t length = cache.update(positionAt(0, east, 300.0f + agl / FEET_PER_METER, 60.0f, 90.0f), FRAME,
+                                           message, sizeof(message));
+        const float elapsed = std::min(now - shownAt, 10.0f);
+        for (const char *line = message; line < message + length; line = strchr(line, '\n') + 1) {
+            const int value = atoi(line + 7);
+            ++messages;
+            if (strncmp(line, "RD;R;3;", 7) == 0) {
+                shownValue += shownRate * elapsed / 60;
+                shownRate = static_cast<float>(value);
+            } else {
+                CHECK(strncmp(line, "RD;V;3;", 7) == 0);
+                shownValue = static_cast<float>(value);
+            }
+            shownAt = now;
+        }
+        if (frame >= 120) {
+            worst = std::max(worst, std::fabs(shownValue + shownRate * std::min(now - shownAt, 10.0f) / 60 - agl));
+        }
+    }
+    printf("Sinkflug 1000 ft/min: %d Nachrichten in %d Frames, Anzeige höchstens %.1f ft neben dem Wert\n", messages,
+           frames, worst);
+    CHECK(messages < frames / 50);
+    CHECK(worst < 15.0f);
+}
+
+
+int main() {
+    testAccuracy();
+    testHitRate();
+    testStaleness();
+    testAboveMaximum();
+    testMessages();
+    return checkResult("test_terrain");
+}
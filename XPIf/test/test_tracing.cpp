@@ -0,0 +1,235 @@
+/***************************************************************************************************
+ * @file test_tracing.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: SpanRing, ScopedSpan, Zeitabgleich mit dem Arduino und Export als Chrome-Trace.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Der Zeitabgleich wird gegen einen simulierten Arduino geprüft, dessen Uhr 500 ppm vorgeht, dessen
+ * micros() während der Messung überläuft und dessen Antworten zufällig verzögert ankommen.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <tracing.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+static void testScopedSpan() {
+    SpanRing ring;
+    setTracing(false);
+    {
+        ScopedSpan span(ring, "flightloop");
+    }
+    CHECK(ring.getCount() == 0);
+
+    setTracing(true);
+    const uint64_t before = traceNow();
+    {
+        ScopedSpan span(ring, "flightloop");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    setTracing(false);
+    std::vector<Span> spans(TRACE_RING_SIZE);
+    CHECK(ring.snapshot(spans.data()) == 1);
+    CHECK_STR("flightloop", spans[0].name);
+    CHECK(spans[0].startNs >= before);
+    CHECK(spans[0].durationNs >= 2000000);
+    CHECK(spans[0].durationNs < 1000000000);
+}
+
+
+/// Der Ring hält die letzten TRACE_RING_SIZE Spans, den ältesten zuerst.
+static void testRingOverwrites() {
+    SpanRing ring;
+    std::vector<Span> spans(TRACE_RING_SIZE);
+    CHECK(ring.snapshot(spans.data()) == 0);
+    for (uint64_t i = 0; i < TRACE_RING_SIZE + 10; ++i) {
+        ring.add("io", i, 2 * i);
+    }
+    CHECK(ring.getCount() == TRACE_RING_SIZE + 10);
+    CHECK(ring.snapshot(spans.data()) == TRACE_RING_SIZE);
+    CHECK(spans[0].startNs == 10);
+    CHECK(spans[TRACE_RING_SIZE - 1].startNs == TRACE_RING_SIZE + 9);
+    CHECK(spans[TRACE_RING_SIZE - 1].durationNs == 2 * (TRACE_RING_SIZE + 9));
+}
+
+
+/// Ein Leser bekommt nie einen halb geschriebenen oder überschriebenen Span, während der Schreiber läuft.
+static void testConcurrentSnapshot() {
+    SpanRing ring;
+    std::atomic<bool> isRunning(true);
+    std::thread writer([&]() {
+        for (uint64_t i = 1; isRunning.load(std::memory_order_relaxed); ++i) {
+            ring.add("sim", i, 3 * i);
+        }
+    });
+    std::vector<Span> spans(TRACE_RING_SIZE);
+    size_t torn = 0, snapshots = 0;
+    while ((snapshots < 2000) || (ring.getCount() < 10 * TRACE_RING_SIZE)) {
+        const size_t count = ring.snapshot(spans.data());
+        for (size_t i = 0; i < count; ++i) {
+            if ((spans[i].durationNs != 3 * spans[i].startNs) || ((i > 0) && (spans[i].startNs != spans[i - 1].startNs + 1))) {
+                ++torn;
+            }
+        }
+        ++snapshots;
+    }
+    isRunning = false;
+    writer.join();
+    CHECK(torn == 0);
+}
+
+
+/// Simulierter Arduino: Uhr mit Drift und Versatz, Antworten mit zufälliger Verzögerung je Richtung.
+struct SimulatedArduino {
+    static constexpr double DRIFT = 500e-6;
+    static const uint64_t START_NS = 5000000000ULL;
+    uint32_t microsAtStart = 0xffffffffU - 20000000;    ///< micros() läuft nach 20 s über
+    uint32_t random = 12345;
+
+    uint32_t micros(const uint64_t hostNs) const {
+        return microsAtStart + static_cast<uint32_t>(static_cast<uint64_t>((hostNs - START_NS) * (1 + DRIFT) / 1000));
+    }
+
+    /// USB und Firmware: 150 µs plus bis zu 2 ms
+    uint64_t delayNs() {
+        random = random * 1103515245 + 12345;
+        return 150000 + (random >> 8) % 2000000;
+    }
+};
+
+
+static void testClockAlignment() {
+    ClockAlignment clock;
+    SimulatedArduino arduino;
+    CHECK(! clock.isValid());
+    CHECK(! clock.pong(1, 0, 0));
+
+    uint64_t maxErrorNs = 0;
+    for (uint64_t now = SimulatedArduino::START_NS; now < SimulatedArduino::START_NS + 60000000000ULL; now += 100000000) {
+        const uint32_t id = clock.ping(now);
+        const uint64_t arrival = now + arduino.delayNs();
+        const uint64_t reply = arrival + arduino.delayNs();
+        CHECK(clock.pong(id, arduino.micros(arrival), reply));
+        CHECK(! clock.pong(id, arduino.micros(arrival), reply));
+        // Nach zwei Fenstern ist die Drift bekannt; Ereignisse der letzten Sekunde umrechnen
+        if (now > SimulatedArduino::START_NS + 25000000000ULL) {
+            const uint64_t event = now - 500000000;
+            const uint64_t error = static_cast<uint64_t>(std::llabs(static_cast<int64_t>(clock.toHostNs(arduino.micros(event)) - event)));
+            maxErrorNs = (error > maxErrorNs) ? error : maxErrorNs;
+        }
+    }
+    printf("Zeitabgleich: Drift %.1f ppm (simuliert 500), größter Fehler %.1f µs, Umlaufzeit %.0f µs\n",
+           clock.getDriftPpm(), maxErrorNs / 1e3, clock.getRttNs() / 1e3);
+    CHECK(std::fabs(clock.getDriftPpm() - 500) < 20);
+    CHECK(maxErrorNs < 500000);                     // genauer als ein USB-Frame (1 ms)
+    CHECK(clock.getRttNs() < 1000000);
+
+    // Antworten auf unbekannte oder zu alte PINGs zählen nicht
+    CHECK(! clock.pong(12345678, 0, 0));
+    uint32_t ids[ClockAlignment::MAX_PENDING + 1];
+    for (uint32_t &id : ids) {
+        id = clock.ping(70000000000ULL);
+    }
+    CHECK(! clock.pong(ids[0], 0, 70001000000ULL));
+    CHECK(clock.pong(ids[ClockAlignment::MAX_PENDING], arduino.micros(70000500000ULL), 70001000000ULL));
+}
+
+
+static void testParse() {
+    uint32_t id = 0, micros = 0;
+    CHECK(parsePong("SYS;PONG;42;3011000\r\n", id, micros));
+    CHECK((id == 42) && (micros == 3011000));
+    CHECK(parsePong("SYS;PONG;7;4294967295", id, micros));
+    CHECK(micros == 4294967295U);
+    CHECK(! parsePong("SYS;PONG;42", id, micros));
+    CHECK(! parsePong("SYS;PONG;;3011000", id, micros));
+    CHECK(! parsePong("SYS;PONG;4x;3011000", id, micros));
+    CHECK(! parsePong("SYS;PING;42;3011000", id, micros));
+    CHECK(! parsePong("SYS;PONG;42;99999999999", id, micros));
+
+    ClockAlignment clock;
+    Span span;
+    CHECK(! parseFirmwareSpan("SYS;SCAN;1000;250\r\n", clock, span));
+    const uint32_t ping = clock.ping(1000000000);
+    CHECK(clock.pong(ping, 5000, 1000200000));      // micros() 5000 entspricht 1,0001 s
+    CHECK(parseFirmwareSpan("SYS;SCAN;6000;250\r\n", clock, span));
+    CHECK_STR("SCAN", span.name);
+    CHECK(span.startNs == 1000100000 + 1000000);
+    CHECK(span.durationNs == 250000);
+    CHECK(parseFirmwareSpan("SYS;LEDS;6000;0", clock, span));
+    CHECK(! parseFirmwareSpan("SYS;LOOP;812;1930", clock, span));
+    CHECK(! parseFirmwareSpan("SYS;PONG;42;3011000", clock, span));
+    CHECK(! parseFirmwareSpan("SYS;SCAN;6000", clock, span));
+    CHECK(! parseFirmwareSpan("SYS;SCAN", clock, span));
+    CHECK(! parseFirmwareSpan("XPDR;SCAN;6000;250", clock, span));
+}
+
+
+static void testExport() {
+    SpanRing sim, io, m803;
+    sim.add("flightloop", 1000000, 31000);
+    io.add("poll", 1020000, 5000);
+    io.add("write \"M803\"", 1030000, 7000);
+    m803.add("SCAN", 1040000, 250000);
+    TraceExporter exporter;
+    CHECK(exporter.addThread(sim, "sim"));
+    CHECK(exporter.addThread(io, "io"));
+    CHECK(exporter.addPanel(m803, "M803"));
+
+    char *json = nullptr;
+    size_t size = 0;
+    FILE *file = open_memstream(&json, &size);
+    CHECK(exporter.write(file) == 4);
+    fclose(file);
+    CHECK_CONTAINS("{\"traceEvents\":[\n", json);
+    CHECK_CONTAINS("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"XPIf\"}}", json);
+    CHECK_CONTAINS("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"io\"}}", json);
+    CHECK_CONTAINS("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"M803\"}}", json);
+    CHECK_CONTAINS("{\"name\":\"flightloop\",\"ph\":\"X\",\"ts\":1000.000,\"dur\":31.000,\"pid\":1,\"tid\":1}", json);
+    CHECK_CONTAINS("{\"name\":\"write \\\"M803\\\"\",\"ph\":\"X\",\"ts\":1030.000,\"dur\":7.000,\"pid\":1,\"tid\":2}", json);
+    CHECK_CONTAINS("{\"name\":\"SCAN\",\"ph\":\"X\",\"ts\":1040.000,\"dur\":250.000,\"pid\":2,\"tid\":1}", json);
+    CHECK_CONTAINS("}\n],\"displayTimeUnit\":\"ms\"}\n", json);
+    // Klammern ausgeglichen und kein Komma vor einer schließenden Klammer
+    int depth = 0;
+    bool isInString = false;
+    char previous = ' ';
+    for (const char *c = json; *c != '\0'; ++c) {
+        if (isInString) {
+            isInString = ! ((*c == '"') && (previous != '\\'));
+        } else if (*c == '"') {
+            isInString = true;
+        } else if ((*c == '{') || (*c == '[')) {
+            ++depth;
+        } else if ((*c == '}') || (*c == ']')) {
+            --depth;
+            CHECK(previous != ',');
+        }
+        previous = (*c == '\n') ? previous : *c;
+    }
+    CHECK(depth == 0);
+    free(json);
+
+    for (size_t i = 3; i < TraceExporter::MAX_SOURCES; ++i) {
+        CHECK(exporter.addThread(sim, "sim"));
+    }
+    CHECK(! exporter.addPanel(m803, "M803"));
+}
+
+
+int main() {
+    testScopedSpan();
+    testRingOverwrites();
+    testConcurrentSnapshot();
+    testClockAlignment();
+    testParse();
+    testExport();
+    return checkResult("test_tracing");
+}
@@ -0,0 +1,297 @@
+/***************************************************************************************************
+ * @file test_traffic.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Verkehrswarnung gegen eine einfache Referenz, Warnstufen, Haltezeit, Nachrichten,
+ *        Worker-Thread und das Lesen über die Stub-XPLM.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <traffic.hpp>
+#include <trafficreader.hpp>
+#include <xplmstub.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const float KT = 1852.0f / 3600.0f;         ///< m/s je Knoten
+const float NM = 1852.0f;
+const float FT = 0.3048f;
+const int RANDOM_SNAPSHOTS = 200;
+
+
+/// Einfacher, reproduzierbarer Zufallsgenerator.
+struct Random {
+    uint32_t state = 4711;
+
+    uint32_t next() {
+        state = state * 1103515245 + 12345;
+        return state >> 8;
+    }
+
+    float uniform(const float low, const float high) { return low + (high - low) * static_cast<float>(next() % 1000000) / 1e6f; }
+};
+
+
+/// Snapshot mit dem eigenen Flugzeug im Ursprung, Steuerkurs @em heading.
+struct Snapshot {
+    std::vector<float> values = std::vector<float>(TRAFFIC_VALUES, 0.0f);
+
+    explicit Snapshot(const float heading = 0.0f) {
+        values[TRAFFIC_COUNT] = 1;
+        values[TRAFFIC_HEADING] = heading;
+    }
+
+    void set(const size_t index, const float x, const float y, const float z, const float vx, const float vy, const float vz) {
+        values[TRAFFIC_X + index] = x;
+        values[TRAFFIC_Y + index] = y;
+        values[TRAFFIC_Z + index] = z;
+        values[TRAFFIC_VX + index] = vx;
+        values[TRAFFIC_VY + index] = vy;
+        values[TRAFFIC_VZ + index] = vz;
+        values[TRAFFIC_COUNT] = std::max(values[TRAFFIC_COUNT], static_cast<float>(index + 1));
+    }
+
+    /// Alle Flugzeuge @em dt Sekunden weiterbewegen.
+    void advance(const float dt) {
+        for (size_t i = 0; i < TRAFFIC_MAX_AIRCRAFT; ++i) {
+            values[TRAFFIC_X + i] += values[TRAFFIC_VX + i] * dt;
+            values[TRAFFIC_Y + i] += values[TRAFFIC_VY + i] * dt;
+            values[TRAFFIC_Z + i] += values[TRAFFIC_VZ + i] * dt;
+        }
+    }
+};
+
+
+/// Referenz: dieselbe Rechnung für ein Flugzeug, geradeaus mit Verzweigungen.
+static ThreatLevel reference(const Snapshot &snapshot, const size_t i) {
+    const float *v = snapshot.values.data();
+    const float rx = v[TRAFFIC_X + i] - v[TRAFFIC_X], ry = v[TRAFFIC_Y + i] - v[TRAFFIC_Y], rz = v[TRAFFIC_Z + i] - v[TRAFFIC_Z];
+    const float vx = v[TRAFFIC_VX + i] - v[TRAFFIC_VX], vy = v[TRAFFIC_VY + i] - v[TRAFFIC_VY];
+    const float vz = v[TRAFFIC_VZ + i] - v[TRAFFIC_VZ];
+    float t = -(rx * vx + rz * vz) / (vx * vx + vz * vz + 1e-4f);
+    if (t < 0.0f) {
+        t = 0.0f;
+    }
+    const float missX = rx + vx * t, missZ = rz + vz * t;
+    const float miss2 = missX * missX + missZ * missZ;
+    const float vertical = std::fabs(ry + vy * t);
+    const float ra = TRAFFIC_RA_NM * NM, ta = TRAFFIC_TA_NM * NM, prox = TRAFFIC_PROX_NM * NM;
+    if ((t < TRAFFIC_RA_S) && (miss2 < ra * ra) && (vertical < TRAFFIC_RA_FT * FT)) {
+        return ThreatLevel::RESOLUTION;
+    }
+    if ((t < TRAFFIC_TA_S) && (miss2 < ta * ta) && (vertical < TRAFFIC_TA_FT * FT)) {
+        return ThreatLevel::TRAFFIC;
+    }
+    if ((rx * rx + rz * rz < prox * prox) && (std::fabs(ry) < TRAFFIC_PROX_FT * FT)) {
+        return ThreatLevel::PROXIMATE;
+    }
+    return ThreatLevel::NONE;
+}
+
+
+/// Viele Flugzeuge dicht um das eigene, etwa ein Drittel auf Kollisionskurs: alle Stufen kommen vor.
+static void testMatchesReference() {
+    Random random;
+    TrafficAdvisor advisor(0, 0);
+    char message[96];
+    int mismatches = 0, checked = 0;
+    int counts[4] = {};
+    for (int s = 0; s < RANDOM_SNAPSHOTS; ++s) {
+        Snapshot snapshot(random.uniform(0, 360));
+        snapshot.set(0, 0, 3000, 0, random.uniform(-130, 130), random.uniform(-5, 5), random.uniform(-130, 130));
+        const size_t count = 1 + random.next() % (TRAFFIC_MAX_AIRCRAFT - 1);
+        for (size_t i = 1; i < count; ++i) {
+            const float x = random.uniform(-8, 8) * NM, z = random.uniform(-8, 8) * NM;
+            const float y = 3000 + random.uniform(-600, 600);
+            const float tc = random.uniform(5, 60);
+            if (random.next() % 3 == 0) {
+                // Trifft das eigene Flugzeug nach tc Sekunden beinahe
+                const float *v = snapshot.values.data();
+                const float aimX = v[TRAFFIC_VX] * tc + random.uniform(-1500, 1500);
+                const float aimZ = v[TRAFFIC_VZ] * tc + random.uniform(-1500, 1500);
+                snapshot.set(i, x, y, z, (aimX - x) / tc, random.uniform(-5, 5), (aimZ - z) / tc);
+            } else {
+                snapshot.set(i, x, y, z, random.uniform(-130, 130), random.uniform(-5, 5), random.uniform(-130, 130));
+            }
+        }
+        advisor.update(snapshot.values.data(), s * 10.0, message, sizeof(message));
+        for (size_t i = 1; i < count; ++i) {
+            const ThreatLevel expected = reference(snapshot, i);
+            const bool isSame = advisor.getLevelOf(static_cast<uint32_t>(i)) == expected;
+            mismatches += isSame ? 0 : 1;
+            ++counts[static_cast<int>(expected)];
+            ++checked;
+        }
+        // Das gefährlichste hat die höchste Stufe
+        const uint32_t threat = advisor.getThreat();
+        int highest = 0;
+        for (size_t i = 1; i < count; ++i) {
+            highest = std::max(highest, static_cast<int>(advisor.getLevelOf(static_cast<uint32_t>(i))));
+        }
+        CHECK((threat == 0) ? (highest == 0) : (static_cast<int>(advisor.getLevelOf(threat)) == highest));
+    }
+    printf("Verkehr: %d Flugzeuge in %d Snapshots, ohne/PROX/TA/RA %d/%d/%d/%d, %d Abweichungen von der Referenz\n",
+           checked, RANDOM_SNAPSHOTS, counts[0], counts[1], counts[2], counts[3], mismatches);
+    CHECK(mismatches == 0);
+    CHECK((counts[1] > 0) && (counts[2] > 0) && (counts[3] > 0));
+}
+
+
+/// Gegenverkehr auf gleicher Höhe: erst PROX bzw. TA, dann RA; Abstände nach TCAS.
+static void testHeadOn() {
+    TrafficAdvisor advisor(0, 0);
+    char message[96];
+    Snapshot snapshot(90);
+    snapshot.set(0, 0, 3000, 0, 130 * KT, 0, 0);                    // nach Osten
+    snapshot.set(1, 12 * NM, 3000, 0, -130 * KT, 0, 0);             // nach Westen, 12 NM voraus
+    snapshot.set(2, 0, 3000 + 2000 * FT, -3 * NM, 0, 0, 130 * KT);  // kreuzt 2000 ft höher
+    snapshot.set(3, 0, 3000, 1 * NM, 130 * KT, 0, 0);               // parallel 1 NM rechts daneben
+    double taAt = -1, raAt = -1;
+    for (double t = 0; t < 200; t += TRAFFIC_CYCLE_S) {
+        advisor.update(snapshot.values.data(), t, message, sizeof(message));
+        CHECK(advisor.getLevelOf(2) == ThreatLevel::NONE);
+        CHECK(advisor.getLevelOf(3) == ThreatLevel::PROXIMATE);
+        if ((taAt < 0) && (advisor.getLevelOf(1) == ThreatLevel::TRAFFIC)) {
+            taAt = t;
+        }
+        if ((raAt < 0) && (advisor.getLevelOf(1) == ThreatLevel::RESOLUTION)) {
+            raAt = t;
+        }
+        snapshot.advance(TRAFFIC_CYCLE_S);
+    }
+    // Begegnung nach 12 NM / 260 kt = 166 s
+    const double meet = 12.0 / 260.0 * 3600.0;
+    CHECK((taAt > 0) && (std::fabs(meet - taAt - TRAFFIC_TA_S) <= TRAFFIC_CYCLE_S));
+    CHECK((raAt > 0) && (std::fabs(meet - raAt - TRAFFIC_RA_S) <= TRAFFIC_CYCLE_S));
+}
+
+
+/// Richtung relativ zum Steuerkurs, Entfernung in 0,1 NM, nur Änderungen; eine Stufe gilt noch 2 s.
+static void testMessagesAndHold() {
+    TrafficAdvisor advisor(5, 6);
+    char message[96];
+    Snapshot snapshot(90);
+    snapshot.set(0, 0, 3000, 0, 0, 0, 0);
+    CHECK(advisor.update(snapshot.values.data(), 0.0, message, sizeof(message)) == 0);
+
+    // 3 NM östlich: voraus
+    snapshot.set(1, 3 * NM, 3000 + 500 * FT, 0, 0, 0, 0);
+    size_t length = advisor.update(snapshot.values.data(), 0.5, message, sizeof(message));
+    CHECK_STR(std::string(message, length).c_str(), "TC;LVL;1\nRD;V;5;360\nRD;V;6;30\n");
+    CHECK(advisor.update(snapshot.values.data(), 1.0, message, sizeof(message)) == 0);
+
+    // Kommt von Süden (rechts) direkt auf uns zu: RA
+    snapshot.set(1, 0, 3000, 0.5f * NM, 0, 0, -100);
+    length = advisor.update(snapshot.values.data(), 1.5, message, sizeof(message));
+    CHECK_STR(std::string(message, length).c_str(), "TC;LVL;3\nRD;V;5;90\nRD;V;6;5\n");
+    CHECK(advisor.getLevel() == ThreatLevel::RESOLUTION);
+
+    // Dreht ab (weit über uns): Stufe bleibt 2 s
+    snapshot.set(1, 0, 3000 + 2000 * FT, 0.5f * NM, 0, 0, 100);
+    CHECK(advisor.update(snapshot.values.data(), 2.0, message, sizeof(message)) == 0);
+    CHECK(advisor.update(snapshot.values.data(), 3.0, message, sizeof(message)) == 0);
+    CHECK(advisor.getLevel() == ThreatLevel::RESOLUTION);
+    length = advisor.update(snapshot.values.data(), 3.5, message, sizeof(message));
+    CHECK_STR(std::string(message, length).c_str(), "TC;LVL;0\nRD;V;5;0\nRD;V;6;0\n");
+
+    // Ohne Anzeigeinstrumente nur die Stufe
+    TrafficAdvisor lights(0, 0);
+    snapshot.set(1, 3 * NM, 3000, 0, 0, 0, 0);
+    length = lights.update(snapshot.values.data(), 0.0, message, sizeof(message));
+    CHECK_STR(std::string(message, length).c_str(), "TC;LVL;1\n");
+}
+
+
+struct Collected {
+    std::mutex mutex;
+    std::string text;
+};
+
+
+static void collect(const char *message, const size_t length, void *context) {
+    Collected *collected = static_cast<Collected *>(context);
+    std::lock_guard<std::mutex> lock(collected->mutex);
+    collected->text.append(message, length);
+}
+
+
+/// Der Worker wertet jeden übergebenen Snapshot aus, solange er mitkommt.
+static void testMonitor() {
+    Collected collected;
+    {
+        TrafficMonitor monitor(5, 6, collect, &collected);
+        Snapshot snapshot(0);
+        snapshot.set(0, 0, 3000, 0, 0, 0, 0);
+        snapshot.set(1, 0, 3000, -2 * NM, 0, 0, 100);          // von Norden auf uns zu
+        for (int i = 0; i < 40; ++i) {
+            monitor.publish(i * TRAFFIC_CYCLE_S, snapshot.values.data());
+            while (monitor.getProcessed() != monitor.getPublished()) {
+                std::this_thread::yield();
+            }
+            snapshot.advance(TRAFFIC_CYCLE_S);
+        }
+        CHECK(monitor.getProcessed() == 40);
+        CHECK(monitor.getMessageCount() > 3);
+    }
+    std::lock_guard<std::mutex> lock(collected.mutex);
+    CHECK_CONTAINS("TC;LVL;2\n", collected.text.c_str());
+    CHECK_CONTAINS("TC;LVL;3\n", collected.text.c_str());
+    CHECK_CONTAINS("RD;V;5;360\n", collected.text.c_str());
+}
+
+
+/// Profil in eine temporäre Datei schreiben und laden.
+static bool loadProfile(const char *text) {
+    char path[] = "/tmp/xplmstubXXXXXX";
+    const int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "w");
+    fputs(text, file);
+    fclose(file);
+    const bool isOk = stubLoadProfile(path);
+    remove(path);
+    return isOk;
+}
+
+
+static void testReader() {
+    stubReset();
+    CHECK(loadProfile("0 sim/flightmodel/position/psi 270\n"
+                      "0 sim/cockpit2/tcas/targets/position/x[0] 10\n"
+                      "0 sim/cockpit2/tcas/targets/position/x[1] 20\n"
+                      "0 sim/cockpit2/tcas/targets/position/x[2] 30\n"
+                      "0 sim/cockpit2/tcas/targets/position/y[2] 1000\n"
+                      "0 sim/cockpit2/tcas/targets/position/z[2] -5\n"
+                      "0 sim/cockpit2/tcas/targets/position/vx[2] 1\n"
+                      "0 sim/cockpit2/tcas/targets/position/vy[2] 2\n"
+                      "0 sim/cockpit2/tcas/targets/position/vz[2] 3\n"));
+    const TrafficReader reader;
+    std::vector<float> values(TRAFFIC_VALUES, -1.0f);
+    CHECK(reader.read(values.data()) == 1);                         // nur das eigene
+    CHECK((values[TRAFFIC_COUNT] == 1) && (values[TRAFFIC_HEADING] == 270) && (values[TRAFFIC_X] == 10));
+    stubSetAircraftCount(3);
+    CHECK(reader.read(values.data()) == 3);
+    CHECK((values[TRAFFIC_X + 1] == 20) && (values[TRAFFIC_X + 2] == 30) && (values[TRAFFIC_Y + 2] == 1000));
+    CHECK((values[TRAFFIC_Z + 2] == -5) && (values[TRAFFIC_VX + 2] == 1) && (values[TRAFFIC_VZ + 2] == 3));
+    stubSetAircraftCount(300);
+    CHECK(reader.read(values.data()) == 3);                         // so viele Elemente hat das Array
+}
+
+
+int main() {
+    testMatchesReference();
+    testHeadOn();
+    testMessagesAndHold();
+    testMonitor();
+    testReader();
+    return checkResult("test_traffic");
+}
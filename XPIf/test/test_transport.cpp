@@ -0,0 +1,311 @@
+/***************************************************************************************************
+ * @file test_transport.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Transporte über Pseudo-Terminal, TCP und UDP (mit Verlust) auf dem eigenen Rechner.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Für UDP sitzt ein Relais zwischen den beiden Transporten, das einzelne Datagramme verwirft.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <transport.hpp>
+
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <string>
+
+
+/// Warten, bis @em fd lesbar ist (höchstens 1 s).
+static bool waitReadable(const int fd) {
+    pollfd readable = {fd, POLLIN, 0};
+    return poll(&readable, 1, 1000) == 1;
+}
+
+
+/// Alles empfangen, bis @em expected Zeichen da sind oder 1 s lang nichts mehr kommt.
+static std::string receiveAll(Transport &transport, const size_t expected) {
+    std::string text;
+    char buffer[256];
+    while ((text.size() < expected) && waitReadable(transport.fd())) {
+        const size_t length = transport.receive(buffer, sizeof(buffer));
+        text.append(buffer, length);
+        if ((length == 0) && transport.isBroken()) {
+            break;
+        }
+    }
+    return text;
+}
+
+
+/// Pseudo-Terminal: XPIf-Seite ist SerialTransport, die Panel-Seite der Master.
+static void testSerial() {
+    int master, slave;
+    CHECK(openpty(&master, &slave, nullptr, nullptr, nullptr) == 0);
+    SerialTransport serial(slave);
+    CHECK(! serial.isBroken());
+
+    CHECK(serial.send("XPDR;MODE;ALT\n", 14));
+    char buffer[64] = {};
+    CHECK(waitReadable(master));
+    CHECK((read(master, buffer, sizeof(buffer) - 1) == 14) && (strcmp(buffer, "XPDR;MODE;ALT\n") == 0));
+
+    // raw: kein Echo, kein CR/LF-Umsetzen
+    CHECK(write(master, "SYS;PONG;1;2\r\n", 14) == 14);
+    CHECK(receiveAll(serial, 14) == "SYS;PONG;1;2\r\n");
+    CHECK(serial.receive(buffer, sizeof(buffer)) == 0);
+    CHECK(! serial.isBroken());
+
+    // Panel abgesteckt: Lesen liefert EIO
+    close(master);
+    CHECK(serial.receive(buffer, sizeof(buffer)) == 0);
+    CHECK(serial.isBroken());
+
+    std::string error;
+    CHECK(openTransport("serial:///dev/gibt/es/nicht", error) == nullptr);
+    CHECK_CONTAINS("/dev/gibt/es/nicht", error.c_str());
+}
+
+
+/// Socket auf 127.0.0.1 mit beliebigem Port; @em port erhält den Port.
+static int openLoopback(const int type, uint16_t &port) {
+    const int fd = socket(AF_INET, type | SOCK_CLOEXEC, 0);
+    sockaddr_in address;
+    makeAddress("127.0.0.1", 0, address);
+    socklen_t length = sizeof(address);
+    if ((bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            || (getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+            || ((type == SOCK_STREAM) && (listen(fd, 4) != 0))) {
+        close(fd);
+        return -1;
+    }
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+
+/// TCP: Verbindung über openTransport(), Panel-Seite über accept(); Nagle ist abgeschaltet.
+static void testTcp() {
+    uint16_t port = 0;
+    const int listener = openLoopback(SOCK_STREAM, port);
+    CHECK(listener >= 0);
+    std::string error;
+    std::unique_ptr<Transport> xpif = openTransport("tcp://127.0.0.1:" + std::to_string(port), error);
+    CHECK(xpif != nullptr);
+    if (xpif == nullptr) {
+        close(listener);
+        return;
+    }
+    TcpTransport panel(accept(listener, nullptr, nullptr));
+    close(listener);
+
+    int noDelay = 0;
+    socklen_t length = sizeof(noDelay);
+    CHECK((getsockopt(xpif->fd(), IPPROTO_TCP, TCP_NODELAY, &noDelay, &length) == 0) && (noDelay == 1));
+
+    CHECK(xpif->send("XPDR;SQUAWK;7000;0\nTIME;UTC;1234;0\n", 35));
+    CHECK(receiveAll(panel, 35) == "XPDR;SQUAWK;7000;0\nTIME;UTC;1234;0\n");
+    CHECK(panel.send("M803;BTN;OAT;0\n", 15));
+    CHECK(receiveAll(*xpif, 15) == "M803;BTN;OAT;0\n");
+
+    // Größere Mengen kommen vollständig und in Reihenfolge an
+    std::string sent;
+    for (int i = 0; i < 2000; ++i) {
+        const std::string line = "READOUT;SET;" + std::to_string(i) + ";0\n";
+        CHECK(xpif->send(line.data(), line.size()));
+        sent += line;
+    }
+    CHECK(receiveAll(panel, sent.size()) == sent);
+
+    // Gegenstelle geschlossen: kein SIGPIPE, der Transport meldet sich als gestört
+    const int panelFd = dup(panel.fd());
+    shutdown(panelFd, SHUT_RDWR);
+    close(panelFd);
+    CHECK(receiveAll(*xpif, 1).empty());
+    CHECK(xpif->isBroken());
+    CHECK(! xpif->send("X;Y;0;0\n", 8));
+
+    CHECK(openTransport("tcp://127.0.0.1", error) == nullptr);
+    CHECK_CONTAINS("Adresse ungültig", error.c_str());
+    CHECK(openTransport("tcp://127.0.0.1:70000", error) == nullptr);
+    CHECK(openTransport("tcp://localhost:4900", error) == nullptr);
+}
+
+
+/***************************************************************************************************
+ * Relais zwischen zwei UDP-Transporten; @em drop entscheidet über jedes Datagramm.
+ **************************************************************************************************/
+struct UdpRelay {
+    int fd = -1;
+    uint16_t port = 0;
+    sockaddr_in a = {}, b = {};                 ///< Adressen der beiden Seiten
+    std::function<bool(const std::string &)> drop = [](const std::string &) { return false; };
+    int forwarded = 0;
+    int dropped = 0;
+
+    UdpRelay() { fd = openLoopback(SOCK_DGRAM, port); }
+    ~UdpRelay() { close(fd); }
+
+    /// UDP-Transport, der mit dem Relais verbunden ist; @em side erhält seine Adresse.
+    std::unique_ptr<UdpTransport> connectSide(sockaddr_in &side) {
+        std::unique_ptr<UdpTransport> transport = UdpTransport::connect("127.0.0.1", port);
+        socklen_t length = sizeof(side);
+        getsockname(transport->fd(), reinterpret_cast<sockaddr *>(&side), &length);
+        return transport;
+    }
+
+    /// Alle anstehenden Datagramme weiterleiten oder verwerfen.
+    void pump() {
+        char datagram[256];
+        pollfd readable = {fd, POLLIN, 0};
+        while (poll(&readable, 1, 10) == 1) {
+            sockaddr_in from;
+            socklen_t length = sizeof(from);
+            const ssize_t size = recvfrom(fd, datagram, sizeof(datagram), 0, reinterpret_cast<sockaddr *>(&from), &length);
+            if (size < 0) {
+                break;
+            }
+            const std::string text(datagram, static_cast<size_t>(size));
+            if (drop(text)) {
+                ++dropped;
+                continue;
+            }
+            const sockaddr_in &to = (from.sin_port == a.sin_port) ? b : a;
+            sendto(fd, datagram, static_cast<size_t>(size), 0, reinterpret_cast<const sockaddr *>(&to), sizeof(to));
+            ++forwarded;
+        }
+    }
+};
+
+
+/// Empfangen, ohne zu warten (die Datagramme hat das Relais schon zugestellt).
+static std::string receiveNow(Transport &transport) {
+    char buffer[256];
+    std::string text;
+    size_t length;
+    while ((length = transport.receive(buffer, sizeof(buffer))) != 0) {
+        text.append(buffer, length);
+    }
+    return text;
+}
+
+
+/// UDP: Aufteilen in Datagramme, Bestätigung, Wiederholung nach Verlust, Duplikate, Aufgabe nach drei Wiederholungen.
+static void testUdp() {
+    UdpRelay relay;
+    CHECK(relay.fd >= 0);
+    std::unique_ptr<UdpTransport> xpif = relay.connectSide(relay.a);
+    std::unique_ptr<UdpTransport> panel = relay.connectSide(relay.b);
+    CHECK((xpif != nullptr) && (panel != nullptr));
+    if ((xpif == nullptr) || (panel == nullptr)) {
+        return;
+    }
+
+    // Zwei Nachrichten, zwei Datagramme; das zweite geht einmal verloren.
+    bool isSecondDropped = false;
+    relay.drop = [&](const std::string &datagram) {
+        if ((datagram.compare(0, 2, "2;") == 0) && ! isSecondDropped) {
+            isSecondDropped = true;
+            return true;
+        }
+        return false;
+    };
+    CHECK(xpif->send("XPDR;SQUAWK;7000;0\nXPDR;MODE;ALT;0\n", 35));
+    CHECK(xpif->getPendingCount() == 2);
+    relay.pump();
+    CHECK(receiveNow(*panel) == "XPDR;SQUAWK;7000;0\n");
+    relay.pump();                               // ACK;1 zurück
+    CHECK(receiveNow(*xpif).empty());
+    CHECK(xpif->getPendingCount() == 1);
+
+    xpif->resend(monotonicMicros());            // noch keine 50 ms vergangen
+    CHECK(xpif->getResent() == 0);
+    xpif->resend(monotonicMicros() + UDP_RESEND_MICROS);
+    CHECK(xpif->getResent() == 1);
+    relay.pump();
+    CHECK(receiveNow(*panel) == "XPDR;MODE;ALT;0\n");
+    relay.pump();
+    receiveNow(*xpif);
+    CHECK(xpif->getPendingCount() == 0);
+
+    // Die Bestätigung geht verloren: die Wiederholung kommt doppelt an und wird verworfen.
+    bool isAckDropped = false;
+    relay.drop = [&](const std::string &datagram) {
+        if ((datagram == "ACK;3") && ! isAckDropped) {
+            isAckDropped = true;
+            return true;
+        }
+        return false;
+    };
+    CHECK(xpif->send("XPDR;IDENT;1;0\n", 15));
+    relay.pump();
+    CHECK(receiveNow(*panel) == "XPDR;IDENT;1;0\n");
+    relay.pump();
+    receiveNow(*xpif);
+    CHECK(xpif->getPendingCount() == 1);
+    xpif->resend(monotonicMicros() + UDP_RESEND_MICROS);
+    relay.pump();
+    CHECK(receiveNow(*panel).empty());
+    CHECK(panel->getDuplicates() == 1);
+    relay.pump();
+    receiveNow(*xpif);
+    CHECK(xpif->getPendingCount() == 0);
+
+    // Panel nicht erreichbar: nach drei Wiederholungen gilt die Nachricht als verloren.
+    relay.drop = [](const std::string &) { return true; };
+    const int droppedBefore = relay.dropped;
+    CHECK(xpif->send("XPDR;IDENT;0;0\n", 15));
+    uint64_t now = monotonicMicros();
+    for (int round = 0; round < UDP_MAX_RESENDS + 1; ++round) {
+        now += UDP_RESEND_MICROS;
+        xpif->resend(now);
+        relay.pump();
+    }
+    CHECK(xpif->getLost() == 1);
+    CHECK(xpif->getPendingCount() == 0);
+    CHECK(relay.dropped == droppedBefore + 1 + UDP_MAX_RESENDS);
+
+    // Ohne Wiederholung: Sequenznummer 0, keine Bestätigung
+    relay.drop = [](const std::string &) { return false; };
+    const int forwarded = relay.forwarded;
+    xpif->setRepeat(false);
+    CHECK(xpif->send("READOUT;SET;0;1234\n", 19));
+    CHECK(xpif->getPendingCount() == 0);
+    relay.pump();
+    CHECK(receiveNow(*panel) == "READOUT;SET;0;1234\n");
+    relay.pump();
+    CHECK(relay.forwarded == forwarded + 1);
+
+    // Panel-Seite sendet zurück; zu lange Nachrichten werden abgewiesen
+    CHECK(panel->send("M803;BTN;SEL;0\n", 15));
+    relay.pump();
+    CHECK(receiveNow(*xpif) == "M803;BTN;SEL;0\n");
+    relay.pump();
+    receiveNow(*panel);
+    CHECK(panel->getPendingCount() == 0);
+    const std::string tooLong(UDP_MAX_MESSAGE + 1, 'x');
+    CHECK(! panel->send(tooLong.data(), tooLong.size()));
+
+    // Volle Tabelle der unbestätigten Nachrichten
+    relay.drop = [](const std::string &) { return true; };
+    for (size_t i = 0; i < UDP_PENDING_SLOTS; ++i) {
+        CHECK(panel->send("X;Y;0;0\n", 8));
+    }
+    CHECK(! panel->send("X;Y;0;0\n", 8));
+    CHECK(panel->getOverflows() == 1);
+}
+
+
+int main() {
+    testSerial();
+    testTcp();
+    testUdp();
+    return checkResult("test_transport");
+}
@@ -0,0 +1,289 @@
+/***************************************************************************************************
+ * @file test_txscheduler.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: TxScheduler gegen einen in der Bandbreite begrenzten Stellvertreter des Panels.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * SlowLink überträgt wie eine serielle Verbindung mit 115200 Baud (8N1) 11520 Byte/s. Die Simulation
+ * läuft in Schritten von 1 ms: erst werden die geänderten Werte an den Scheduler gegeben, dann wird
+ * alles, was next() liefert, auf den Link gelegt. Die Latenz eines Werts reicht von seiner ersten
+ * noch nicht gesendeten Änderung bis zum letzten übertragenen Zeichen der Nachricht.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <txscheduler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+const uint32_t LINK_RATE = 11520;                   ///< Byte/s bei 115200 Baud
+const uint32_t SCHEDULER_RATE = LINK_RATE * 9 / 10; ///< 10 % Reserve für Antworten auf Schalter
+const uint64_t STEP_US = 1000;
+
+
+/// Stellvertreter des Panels: überträgt die Nachrichten nacheinander mit LINK_RATE.
+struct SlowLink {
+    uint64_t busyUntilUs = 0;
+    uint64_t maxBacklogUs = 0;
+
+    /// @return Zeitpunkt, zu dem das letzte Zeichen übertragen ist.
+    uint64_t transmit(const size_t length, const uint64_t nowUs) {
+        busyUntilUs = std::max(busyUntilUs, nowUs) + length * 1000000ULL / LINK_RATE;
+        maxBacklogUs = std::max(maxBacklogUs, busyUntilUs - nowUs);
+        return busyUntilUs;
+    }
+};
+
+
+/// Scheduler, Link und die Buchführung der Prüfungen.
+struct Simulation {
+    TxScheduler scheduler{SCHEDULER_RATE};
+    SlowLink link;
+    int valueClass[TX_MAX_VALUES];
+    uint32_t sequence[TX_MAX_VALUES] = {};
+    uint64_t changedUs[TX_MAX_VALUES] = {};     ///< Erste noch nicht entnommene Änderung; 0 = keine
+    uint64_t maxLatencyUs[TX_MAX_CLASSES] = {};
+    uint64_t bytes[TX_MAX_CLASSES] = {};
+    uint32_t stale = 0;                         ///< Entnommene Nachrichten mit veraltetem Wert
+    uint64_t nowUs = 1;
+
+    int addValue(const int classId, const int32_t maxRate = -1, const int32_t maxLatencyMs = -1) {
+        const int value = scheduler.addValue(static_cast<size_t>(classId), maxRate, maxLatencyMs);
+        valueClass[value] = classId;
+        return value;
+    }
+
+    /// Wert ändern; die Nachricht "V;<Wert>;<Nummer>" wird mit '.' auf @em length Zeichen aufgefüllt.
+    void change(const int value, const size_t length) {
+        char message[TX_MESSAGE_SIZE];
+        const int written = snprintf(message, sizeof(message), "V;%d;%u;", value, ++sequence[value]);
+        memset(message + written, '.', length - static_cast<size_t>(written) - 2);
+        memcpy(message + length - 2, "\r\n", 2);
+        CHECK(scheduler.update(static_cast<size_t>(value), message, length, nowUs));
+        if (changedUs[value] == 0) {
+            changedUs[value] = nowUs;
+        }
+    }
+
+    /// Alles entnehmen, was der Scheduler jetzt freigibt, und auf den Link legen.
+    void pump() {
+        char message[TX_MESSAGE_SIZE];
+        size_t length;
+        while ((length = scheduler.next(nowUs, message)) > 0) {
+            const int value = atoi(message + 2);
+            const uint32_t messageSequence = static_cast<uint32_t>(atol(strchr(message + 2, ';') + 1));
+            if (messageSequence != sequence[value]) {
+                ++stale;
+            }
+            const uint64_t doneUs = link.transmit(length, nowUs);
+            const int classId = valueClass[value];
+            maxLatencyUs[classId] = std::max(maxLatencyUs[classId], doneUs - changedUs[value]);
+            bytes[classId] += length;
+            changedUs[value] = 0;
+        }
+    }
+};
+
+
+static void testLimits() {
+    TxScheduler scheduler(SCHEDULER_RATE);
+    CHECK(scheduler.addClass(0, 0, 20) == -1);
+    for (size_t c = 0; c < TX_MAX_CLASSES; ++c) {
+        CHECK(scheduler.addClass(1, 0, 20) == static_cast<int>(c));
+    }
+    CHECK(scheduler.addClass(1, 0, 20) == -1);
+    CHECK(scheduler.addValue(TX_MAX_CLASSES) == -1);
+    for (size_t v = 0; v < TX_MAX_VALUES; ++v) {
+        CHECK(scheduler.addValue(0) == static_cast<int>(v));
+    }
+    CHECK(scheduler.addValue(0) == -1);
+
+    char message[TX_MESSAGE_SIZE + 1] = {};
+    CHECK(! scheduler.update(TX_MAX_VALUES, "X\n", 2, 0));
+    CHECK(! scheduler.update(0, message, TX_MESSAGE_SIZE + 1, 0));
+    CHECK(! scheduler.update(0, message, 0, 0));
+    CHECK(scheduler.next(0, message) == 0);
+}
+
+
+/// Ein wartender Wert wird ersetzt; gesendet wird nur der neueste.
+static void testLatestValueWins() {
+    TxScheduler scheduler(SCHEDULER_RATE);
+    const size_t gauge = static_cast<size_t>(scheduler.addValue(static_cast<size_t>(scheduler.addClass(1, 0, 500))));
+    CHECK(scheduler.update(gauge, "FL;310\n", 7, 0));
+    CHECK(scheduler.update(gauge, "FL;320\n", 7, 100));
+    CHECK(scheduler.update(gauge, "FL;330\n", 7, 200));
+    CHECK(scheduler.isQueued(gauge));
+    char message[TX_MESSAGE_SIZE + 1] = {};
+    CHECK(scheduler.next(300, message) == 7);
+    CHECK_STR("FL;330\n", message);
+    CHECK(scheduler.next(300, message) == 0);
+    CHECK(! scheduler.isQueued(gauge));
+    CHECK(scheduler.getReplaced() == 2);
+    CHECK(scheduler.getSent() == 1);
+}
+
+
+/// Der Scheduler eilt dem Link höchstens um TX_LINK_BACKLOG Byte plus eine Nachricht voraus.
+static void testLinkBudget() {
+    TxScheduler scheduler(1000);
+    const size_t classId = static_cast<size_t>(scheduler.addClass(1, 0, 10000));
+    for (int v = 0; v < 10; ++v) {
+        scheduler.addValue(classId);
+        CHECK(scheduler.update(static_cast<size_t>(v), "XPDR;SQUAWK;7000;0\r\n", 20, 0));
+    }
+    char message[TX_MESSAGE_SIZE];
+    int count = 0;
+    while (scheduler.next(0, message) > 0) {
+        ++count;
+    }
+    CHECK(count == 4);                          // 80 ms belegt, 64 ms Rückstand erlaubt
+    CHECK(scheduler.next(15999, message) == 0);
+    CHECK(scheduler.next(16000, message) == 20);
+}
+
+
+/// Ein Wert, der sich jede ms ändert, wird mit seiner max. Rate gesendet.
+static void testRateLimit() {
+    Simulation simulation;
+    const int gauge = simulation.scheduler.addClass(1, 5, 500);
+    const int value = simulation.addValue(gauge, 10);
+    for (; simulation.nowUs < 10000000; simulation.nowUs += STEP_US) {
+        simulation.change(value, 20);
+        simulation.pump();
+    }
+    CHECK(simulation.scheduler.getSent() >= 99);
+    CHECK(simulation.scheduler.getSent() <= 101);
+    CHECK(simulation.scheduler.getReplaced() > 9800);
+    CHECK(simulation.stale == 0);
+}
+
+
+/**
+ * Klassen wie in der Doku; mehr Last als der Link trägt: 80 Gauges ändern sich jeden Frame (20 ms)
+ * und dürfen je 5 /s senden (9,6 KB/s), dazu 16 Anzeigen alle 250 ms und 4 Status-Werte, die alle
+ * 500 ms gleichzeitig umschalten. Alle max. Latenzen müssen eingehalten werden.
+ */
+static void testLatencyBounds() {
+    Simulation simulation;
+    const int status = simulation.scheduler.addClass(4, 0, 20);
+    const int display = simulation.scheduler.addClass(2, 10, 100);
+    const int gauge = simulation.scheduler.addClass(1, 5, 500);
+    int statusValues[4], displayValues[16], gaugeValues[80];
+    for (int &value : statusValues) {
+        value = simulation.addValue(status);
+    }
+    for (int &value : displayValues) {
+        value = simulation.addValue(display);
+    }
+    for (int &value : gaugeValues) {
+        value = simulation.addValue(gauge);
+    }
+
+    for (; simulation.nowUs < 60000000; simulation.nowUs += STEP_US) {
+        const uint64_t ms = simulation.nowUs / 1000;
+        if (ms % 500 == 0) {
+            for (const int value : statusValues) {
+                simulation.change(value, 14);
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            if (ms % 250 == static_cast<uint64_t>(i) * 15) {
+                simulation.change(displayValues[i], 22);
+            }
+        }
+        if (ms % 20 == 0) {
+            for (const int value : gaugeValues) {
+                simulation.change(value, 24);
+            }
+        }
+        simulation.pump();
+    }
+    printf("Latenz höchstens: status %.1f ms, display %.1f ms, gauge %.1f ms; %u vorgezogen, %u ersetzt\n",
+           simulation.maxLatencyUs[status] / 1e3, simulation.maxLatencyUs[display] / 1e3,
+           simulation.maxLatencyUs[gauge] / 1e3, simulation.scheduler.getUrgent(), simulation.scheduler.getReplaced());
+    CHECK(simulation.maxLatencyUs[status] <= 20000);
+    CHECK(simulation.maxLatencyUs[display] <= 100000);
+    CHECK(simulation.maxLatencyUs[gauge] <= 500000);
+    CHECK(simulation.scheduler.getLate() == 0);
+    CHECK(simulation.stale == 0);
+    // Der Link ist ausgelastet, aber der Scheduler eilt ihm höchstens um ein paar Nachrichten voraus
+    const uint64_t linkBytes = simulation.bytes[status] + simulation.bytes[display] + simulation.bytes[gauge];
+    CHECK(linkBytes > uint64_t(SCHEDULER_RATE) * 59 * 95 / 100);
+    CHECK(simulation.link.maxBacklogUs <= (TX_LINK_BACKLOG + TX_MESSAGE_SIZE) * 1000000ULL / LINK_RATE);
+}
+
+
+/**
+ * Alle drei Klassen sind dauernd belegt (ohne Rate- und praktisch ohne Latenzgrenze) und haben
+ * unterschiedlich lange Nachrichten: Die übertragenen Byte verteilen sich wie die Gewichte 4:2:1.
+ */
+static void testWeightedFairness() {
+    Simulation simulation;
+    const int classes[3] = {simulation.scheduler.addClass(4, 0, 60000), simulation.scheduler.addClass(2, 0, 60000),
+                            simulation.scheduler.addClass(1, 0, 60000)};
+    const size_t lengths[3] = {14, 24, 40};
+    int values[3][8];
+    for (int c = 0; c < 3; ++c) {
+        for (int &value : values[c]) {
+            value = simulation.addValue(classes[c]);
+        }
+    }
+    for (; simulation.nowUs < 10000000; simulation.nowUs += STEP_US) {
+        for (int c = 0; c < 3; ++c) {
+            for (const int value : values[c]) {
+                simulation.change(value, lengths[c]);
+            }
+        }
+        simulation.pump();
+    }
+    const double total = static_cast<double>(simulation.bytes[0] + simulation.bytes[1] + simulation.bytes[2]);
+    const double weights[3] = {4.0 / 7, 2.0 / 7, 1.0 / 7};
+    for (int c = 0; c < 3; ++c) {
+        const double share = static_cast<double>(simulation.bytes[classes[c]]) / total;
+        printf("Klasse %d (Gewicht %d): %.1f %% der Byte\n", c, 4 >> c, 100 * share);
+        CHECK((share > weights[c] * 0.97) && (share < weights[c] * 1.03));
+    }
+    CHECK(simulation.scheduler.getUrgent() == 0);
+}
+
+
+/// Eine Klasse mit kleinem Gewicht, aber kurzer max. Latenz wird vor einer voll belegten Klasse vorgezogen.
+static void testDeadlinePreempts() {
+    Simulation simulation;
+    const int bulk = simulation.scheduler.addClass(64, 0, 60000);
+    const int alarm = simulation.scheduler.addClass(1, 0, 50);
+    int bulkValues[16];
+    for (int &value : bulkValues) {
+        value = simulation.addValue(bulk);
+    }
+    const int warning = simulation.addValue(alarm);
+    for (; simulation.nowUs < 10000000; simulation.nowUs += STEP_US) {
+        for (const int value : bulkValues) {
+            simulation.change(value, 24);
+        }
+        if (simulation.nowUs % 100000 == 1) {
+            simulation.change(warning, 24);
+        }
+        simulation.pump();
+    }
+    CHECK(simulation.maxLatencyUs[alarm] <= 50000);
+    CHECK(simulation.scheduler.getUrgent() >= 99);
+    CHECK(simulation.scheduler.getLate() == 0);
+}
+
+
+int main() {
+    testLimits();
+    testLatestValueWins();
+    testLinkBudget();
+    testRateLimit();
+    testLatencyBounds();
+    testWeightedFairness();
+    testDeadlinePreempts();
+    return checkResult("test_txscheduler");
+}
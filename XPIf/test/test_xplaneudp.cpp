@@ -0,0 +1,289 @@
+/***************************************************************************************************
+ * @file test_xplaneudp.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Test: Aufbau der RREF-, DREF- und CMND-Pakete, fehlerhafte Pakete und ein Austausch über UDP.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <xplaneudp.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cmath>
+
+static const char *const ALTITUDE = "sim/cockpit2/gauges/indicators/altitude_ft_pilot";
+
+
+/// Die RREF-Anfrage hat den Aufbau und die Länge, die X-Plane erwartet.
+static void testRrefRequestLayout() {
+    char packet[XPLANE_UDP_MAX_PACKET];
+    memset(packet, 0x55, sizeof(packet));
+    const size_t length = encodeRrefRequest(packet, sizeof(packet), 20, 0x01020304, ALTITUDE);
+    CHECK(length == 413);
+    CHECK(memcmp(packet, "RREF\0", 5) == 0);
+    CHECK(memcmp(packet + 5, "\x14\x00\x00\x00", 4) == 0);          // Frequenz 20, little-endian
+    CHECK(memcmp(packet + 9, "\x04\x03\x02\x01", 4) == 0);          // Index
+    CHECK_STR(ALTITUDE, packet + 13);
+    bool padded = true;
+    for (size_t i = 13 + strlen(ALTITUDE); i < length; ++i) {
+        padded = padded && (packet[i] == '\0');
+    }
+    CHECK(padded);
+
+    RrefRequest request;
+    CHECK(decodeRrefRequest(packet, length, request));
+    CHECK((request.frequency == 20) && (request.index == 0x01020304));
+    CHECK_STR(ALTITUDE, request.dataRef);
+
+    // Abmelden mit Frequenz 0, negativer Index bleibt erhalten
+    encodeRrefRequest(packet, sizeof(packet), 0, -1, ALTITUDE);
+    CHECK(decodeRrefRequest(packet, length, request));
+    CHECK((request.frequency == 0) && (request.index == -1));
+}
+
+
+/// Die RREF-Antwort enthält n × {Index, Wert} nach der Kennung "RREF,".
+static void testRrefValuesLayout() {
+    const RrefValue values[] = {{0, 1.0f}, {7, -2.5f}, {1000, 29.92f}};
+    char packet[XPLANE_UDP_MAX_PACKET];
+    const size_t length = encodeRrefValues(packet, sizeof(packet), values, 3);
+    CHECK(length == 5 + 3 * 8);
+    CHECK(memcmp(packet, "RREF,", 5) == 0);
+    CHECK(memcmp(packet + 5, "\x00\x00\x00\x00\x00\x00\x80\x3f", 8) == 0);     // 0, 1.0f
+    CHECK(memcmp(packet + 13, "\x07\x00\x00\x00\x00\x00\x20\xc0", 8) == 0);    // 7, -2.5f
+
+    RrefValue decoded[3];
+    size_t count = 0;
+    CHECK(decodeRrefValues(packet, length, [&](int32_t index, float value) {
+        if (count < 3) {
+            decoded[count] = {index, value};
+        }
+        ++count;
+    }));
+    CHECK(count == 3);
+    CHECK((decoded[2].index == 1000) && (decoded[2].value == 29.92f));
+
+    // Kennung älterer X-Plane-Versionen
+    packet[4] = 'O';
+    count = 0;
+    CHECK(decodeRrefValues(packet, length, [&](int32_t, float) { ++count; }));
+    CHECK(count == 3);
+
+    // Puffer zu klein
+    CHECK(encodeRrefValues(packet, 5 + 2 * 8, values, 3) == 0);
+}
+
+
+/// DREF mit Wert und 500 Byte Name; CMND mit dem Command ohne '\0'.
+static void testDrefAndCmndLayout() {
+    char packet[XPLANE_UDP_MAX_PACKET];
+    const size_t drefLength = encodeDref(packet, sizeof(packet), 29.92f, "sim/cockpit/misc/barometer_setting");
+    CHECK(drefLength == 509);
+    CHECK(memcmp(packet, "DREF\0", 5) == 0);
+    CHECK(memcmp(packet + 5, "\x29\x5c\xef\x41", 4) == 0);          // 29.92f
+    float value = 0.0f;
+    const char *dataRef = nullptr;
+    CHECK(decodeDref(packet, drefLength, value, dataRef));
+    CHECK(value == 29.92f);
+    CHECK_STR("sim/cockpit/misc/barometer_setting", dataRef);
+
+    const size_t cmndLength = encodeCmnd(packet, sizeof(packet), "sim/transponder/transponder_ident");
+    CHECK(cmndLength == 5 + strlen("sim/transponder/transponder_ident"));
+    CHECK(memcmp(packet, "CMND\0sim/transponder/", 21) == 0);
+    const char *command = nullptr;
+    size_t commandLength = 0;
+    CHECK(decodeCmnd(packet, cmndLength, command, commandLength));
+    CHECK((commandLength == cmndLength - 5) && (memcmp(command, "sim/transponder/transponder_ident", commandLength) == 0));
+
+    // Ein abschließendes '\0' (manche Sender schicken es mit) gehört nicht zum Command.
+    memcpy(packet + cmndLength, "\0", 1);
+    CHECK(decodeCmnd(packet, cmndLength + 1, command, commandLength));
+    CHECK(commandLength == cmndLength - 5);
+}
+
+
+/// Zu lange Namen, zu kleine Puffer und fehlerhafte Pakete werden abgewiesen.
+static void testMalformedPackets() {
+    char packet[XPLANE_UDP_MAX_PACKET];
+    char longName[DREF_NAME_SIZE + 1];
+    memset(longName, 'x', sizeof(longName) - 1);
+    longName[sizeof(longName) - 1] = '\0';
+    CHECK(encodeDref(packet, sizeof(packet), 1.0f, longName) == 0);
+    longName[RREF_NAME_SIZE] = '\0';
+    CHECK(encodeRrefRequest(packet, sizeof(packet), 1, 0, longName) == 0);
+    longName[RREF_NAME_SIZE - 1] = '\0';
+    CHECK(encodeRrefRequest(packet, sizeof(packet), 1, 0, longName) == RREF_REQUEST_SIZE);
+    CHECK(encodeRrefRequest(packet, RREF_REQUEST_SIZE - 1, 1, 0, ALTITUDE) == 0);
+    CHECK(encodeCmnd(packet, sizeof(packet), "") == 0);
+    CHECK(encodeCmnd(packet, 8, "sim/none") == 0);
+
+    int calls = 0;
+    auto count = [&](int32_t, float) { ++calls; };
+    CHECK(! decodeRrefValues("RREF", 4, count));                      // zu kurz
+    CHECK(! decodeRrefValues("RREF,\x01\x00\x00\x00\x00\x00", 11, count));  // unvollständiger Wert
+    CHECK(! decodeRrefValues("DREF,\x01\x00\x00\x00\x00\x00\x00\x00", 13, count));
+    CHECK(! decodeRrefValues("RREF\0\x01\x00\x00\x00\x00\x00\x00\x00", 13, count));  // Anfrage, keine Antwort
+    CHECK(decodeRrefValues("RREF,", 5, count));                       // leere Antwort ist gültig
+    CHECK(calls == 0);
+
+    RrefRequest request;
+    encodeRrefRequest(packet, sizeof(packet), 1, 0, ALTITUDE);
+    CHECK(! decodeRrefRequest(packet, RREF_REQUEST_SIZE - 1, request));
+    memset(packet + 13, 'x', RREF_NAME_SIZE);                          // Name ohne '\0'
+    CHECK(! decodeRrefRequest(packet, RREF_REQUEST_SIZE, request));
+
+    float value;
+    const char *dataRef;
+    encodeDref(packet, sizeof(packet), 1.0f, "sim/x");
+    CHECK(! decodeDref(packet, DREF_PACKET_SIZE + 1, value, dataRef));
+    packet[0] = 'X';
+    CHECK(! decodeDref(packet, DREF_PACKET_SIZE, value, dataRef));
+
+    const char *command;
+    size_t commandLength;
+    CHECK(! decodeCmnd("CMND\0", 5, command, commandLength));        // leeres Command
+    CHECK(! decodeCmnd("CMND,sim/x", 10, command, commandLength));
+    CHECK(! decodeCmnd("CMN", 3, command, commandLength));
+}
+
+
+/// Gleiche Commands eines Durchlaufs werden einmal gesendet; eine volle Tabelle verwirft und zählt.
+static void testCommandBatch() {
+    CommandBatch<3> batch;
+    char ident[] = "sim/transponder/transponder_ident";
+    CHECK(batch.add("sim/transponder/transponder_ident"));
+    CHECK(batch.add(ident));                    // anderer Zeiger, gleicher Inhalt
+    CHECK(batch.add("sim/transponder/transponder_up"));
+    CHECK(batch.add("sim/transponder/transponder_ident"));
+    CHECK(batch.size() == 2);
+    CHECK(batch.add("sim/instruments/timer_start_stop"));
+    CHECK(! batch.add("sim/instruments/timer_reset"));
+    CHECK(batch.getDropped() == 1);
+
+    int packets = 0;
+    bool valid = true;
+    CHECK(batch.flush([&](const char *packet, size_t length) {
+        const char *command;
+        size_t commandLength;
+        valid = valid && decodeCmnd(packet, length, command, commandLength);
+        ++packets;
+    }) == 3);
+    CHECK((packets == 3) && valid);
+    CHECK(batch.size() == 0);
+    CHECK(batch.flush([&](const char *, size_t) { ++packets; }) == 0);
+}
+
+
+/// UDP-Socket auf 127.0.0.1 mit beliebigem Port und 1 s Empfangs-Timeout.
+static int openLoopbackSocket(sockaddr_in &address) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    const timeval timeout = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if ((bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            || (getsockname(fd, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+/**
+ * Austausch über echte UDP-Sockets: XPIf abonniert zwei Datarefs, ein Stellvertreter von X-Plane
+ * antwortet mit einem RREF-Paket und nimmt DREF und CMND an.
+ */
+static void testLoopbackExchange() {
+    sockaddr_in xpifAddress, simAddress;
+    const int xpif = openLoopbackSocket(xpifAddress);
+    const int sim = openLoopbackSocket(simAddress);
+    CHECK((xpif >= 0) && (sim >= 0));
+    if ((xpif < 0) || (sim < 0)) {
+        return;
+    }
+    const char *const dataRefs[] = {ALTITUDE, "sim/cockpit/misc/barometer_setting"};
+    const float simValues[] = {3500.0f, 29.92f};
+    char packet[XPLANE_UDP_MAX_PACKET];
+    for (int32_t index = 0; index < 2; ++index) {
+        const size_t length = encodeRrefRequest(packet, sizeof(packet), 10, index, dataRefs[index]);
+        sendto(xpif, packet, length, 0, reinterpret_cast<sockaddr *>(&simAddress), sizeof(simAddress));
+    }
+
+    // Stellvertreter: Abonnements annehmen und in einem Paket beantworten
+    RrefValue answer[2];
+    size_t subscriptions = 0;
+    sockaddr_in sender;
+    socklen_t senderLength = sizeof(sender);
+    while (subscriptions < 2) {
+        const ssize_t received = recvfrom(sim, packet, sizeof(packet), 0, reinterpret_cast<sockaddr *>(&sender),
+                                          &senderLength);
+        RrefRequest request;
+        if ((received <= 0) || ! decodeRrefRequest(packet, static_cast<size_t>(received), request)) {
+            break;
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            if (strcmp(request.dataRef, dataRefs[i]) == 0) {
+                answer[subscriptions++] = {request.index, simValues[i]};
+            }
+        }
+    }
+    CHECK(subscriptions == 2);
+    const size_t answerLength = encodeRrefValues(packet, sizeof(packet), answer, subscriptions);
+    sendto(sim, packet, answerLength, 0, reinterpret_cast<sockaddr *>(&sender), senderLength);
+
+    // XPIf: Antwort in den Snapshot schreiben
+    float snapshot[2] = {NAN, NAN};
+    const ssize_t received = recv(xpif, packet, sizeof(packet), 0);
+    CHECK(decodeRrefValues(packet, (received > 0) ? static_cast<size_t>(received) : 0, [&](int32_t index, float value) {
+        if ((index >= 0) && (index < 2)) {
+            snapshot[index] = value;
+        }
+    }));
+    CHECK((snapshot[0] == 3500.0f) && (snapshot[1] == 29.92f));
+
+    // XPIf: Baro schreiben und Commands am Ende des Durchlaufs senden
+    const size_t drefLength = encodeDref(packet, sizeof(packet), 30.01f, dataRefs[1]);
+    sendto(xpif, packet, drefLength, 0, reinterpret_cast<sockaddr *>(&simAddress), sizeof(simAddress));
+    CommandBatch<4> batch;
+    batch.add("sim/transponder/transponder_ident");
+    batch.add("sim/transponder/transponder_ident");
+    batch.flush([&](const char *data, size_t length) {
+        sendto(xpif, data, length, 0, reinterpret_cast<sockaddr *>(&simAddress), sizeof(simAddress));
+    });
+
+    float value = 0.0f;
+    const char *dataRef = nullptr;
+    ssize_t length = recv(sim, packet, sizeof(packet), 0);
+    CHECK((length > 0) && decodeDref(packet, static_cast<size_t>(length), value, dataRef));
+    CHECK(value == 30.01f);
+    const char *command = nullptr;
+    size_t commandLength = 0;
+    length = recv(sim, packet, sizeof(packet), 0);
+    CHECK((length > 0) && decodeCmnd(packet, static_cast<size_t>(length), command, commandLength));
+    CHECK((commandLength == 33) && (memcmp(command, "sim/transponder/transponder_ident", 33) == 0));
+    close(xpif);
+    close(sim);
+}
+
+
+int main() {
+    testRrefRequestLayout();
+    testRrefValuesLayout();
+    testDrefAndCmndLayout();
+    testMalformedPackets();
+    testCommandBatch();
+    testLoopbackExchange();
+    return checkResult("test_xplaneudp");
+}
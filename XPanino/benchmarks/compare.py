@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Benchmark der Firmware und von XPIf ausführen und mit einer Baseline vergleichen.
+
+Die Firmware misst ihre zeitkritischen Teile selbst (siehe benchmark.hpp), XPIf die seinen mit
+bench_hotpaths (siehe XPIf/test/bench_hotpaths.cpp). Dieses Programm führt die Benchmarks aus,
+schreibt die Ergebnisse als JSON und meldet jeden Fall, der um mehr als die Schwelle langsamer ist
+als in baseline-<Board>.json, mit Exit-Code 1.
+
+    # auf dem PC (HostHal, Echtzeit); legt beim ersten Mal baseline-host.json an
+    make -C XPanino/test/host bench
+    XPanino/benchmarks/compare.py
+    # auf einem Uno mit dem Environment unobench
+    XPanino/benchmarks/compare.py --board uno --port /dev/ttyACM0
+    # Baseline neu schreiben statt vergleichen
+    XPanino/benchmarks/compare.py --board uno --port /dev/ttyACM0 --update
+
+Die Baselines werden nicht eingecheckt: Sie gelten nur für den Rechner bzw. das Board, auf dem sie
+gemessen wurden. Jeder Fall läuft mindestens --duration ms; der Benchmark wird mehrmals wiederholt
+und je Fall zählt der schnellste Durchlauf, weil Störungen (andere Prozesse, Interrupts) eine Messung
+nur verlangsamen können. Als Rauschen gilt die relative Streuung zwischen den Wiederholungen (Median
+gegenüber dem schnellsten, in der Messung und in der Baseline), mindestens aber --noise Prozent bzw.
+zwei Ticks von micros() über die Dauer des Falls.
+"""
+
+import argparse
+import json
+import os
+import re
+import select
+import subprocess
+import sys
+import termios
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+HOST_BUILD = os.path.join(HERE, "..", "test", "host", "build")
+BENCH_HOST = os.path.join(HOST_BUILD, "bench", "bench_host")
+PTY_BRIDGE = os.path.join(HOST_BUILD, "uno", "pty_bridge")
+BENCH_XPIF = os.path.join(HERE, "..", "..", "XPIf", "build", "bench_hotpaths")
+FIRMWARE_CASES = ["BPRS", "BQUE", "BDSP", "BCHR", "BLED", "BSCN"]
+XPIF_CASES = ["XDIF", "XSER", "XPTY"]
+CASES = {"host": FIRMWARE_CASES + XPIF_CASES, "uno": FIRMWARE_CASES}
+RESOLUTION_US = {"host": 1, "uno": 4}          # Auflösung von micros()
+EXIT_REGRESSION, EXIT_NO_RESULTS, EXIT_NO_BASELINE = 1, 2, 3
+TIMEOUT = 60
+LINE = re.compile(r"^SYS;([A-Z]{4});(\d+);(\d+)\s*$")
+
+
+def parse(lines, cases):
+    """Zeilen "SYS;<Fall>;<Durchläufe>;<µs>" der bekannten Fälle in Ergebnisse umwandeln."""
+    results = []
+    for line in lines:
+        match = LINE.match(line)
+        if match and match.group(1) in cases and int(match.group(2)) > 0:
+            iterations, total = int(match.group(2)), int(match.group(3))
+            results.append({"case": match.group(1), "iterations": iterations, "usPerOp": total / iterations})
+    return results
+
+
+def run_host(duration):
+    for program in (BENCH_HOST, PTY_BRIDGE, BENCH_XPIF):
+        if not os.access(program, os.X_OK):
+            sys.exit("%s fehlt; zuerst make -C XPanino/test/host bench" % os.path.normpath(program))
+    output = subprocess.run([BENCH_HOST, str(duration)], check=True, capture_output=True, text=True,
+                            timeout=TIMEOUT).stdout
+    output += subprocess.run([BENCH_XPIF, str(duration), PTY_BRIDGE], check=True, capture_output=True, text=True,
+                             timeout=TIMEOUT).stdout
+    return parse(output.splitlines(), CASES["host"])
+
+
+def run_board(port, duration):
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    try:
+        attributes = termios.tcgetattr(fd)
+        attributes[0] = attributes[1] = attributes[3] = 0           # roh: keine Umwandlungen, kein Echo
+        attributes[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attributes[4] = attributes[5] = termios.B115200
+        termios.tcsetattr(fd, termios.TCSANOW, attributes)
+        time.sleep(2)                                               # Uno startet beim Öffnen neu
+        termios.tcflush(fd, termios.TCIFLUSH)
+        os.write(fd, b"SYS;BNCH;%d\n" % duration)
+        pending, results = b"", []
+        deadline = time.monotonic() + TIMEOUT
+        while len(results) < len(CASES["uno"]) and time.monotonic() < deadline:
+            if select.select([fd], [], [], deadline - time.monotonic())[0]:
+                pending += os.read(fd, 256)
+                *lines, pending = pending.split(b"\n")
+                results += parse((line.decode(errors="replace") for line in lines), CASES["uno"])
+        return results
+    finally:
+        os.close(fd)
+
+
+def best_of(runs):
+    """Je Fall den schnellsten Durchlauf und die relative Streuung (Median / schnellster - 1).
+
+    Der Median statt des langsamsten Durchlaufs, damit ein einzelner gestörter Durchlauf das Rauschen
+    nicht so groß macht, dass es jede Verschlechterung verdeckt."""
+    best, all_times = {}, {}
+    for results in runs:
+        for result in results:
+            case = result["case"]
+            if case not in best or result["usPerOp"] < best[case]["usPerOp"]:
+                best[case] = dict(result)
+            all_times.setdefault(case, []).append(result["usPerOp"])
+    for case, result in best.items():
+        median = sorted(all_times[case])[len(all_times[case]) // 2]
+        result["spread"] = round(median / result["usPerOp"] - 1, 4) if result["usPerOp"] > 0 else 0.0
+    return list(best.values())
+
+
+def compare(results, baseline, threshold, noise_floor, resolution):
+    """Langsamer gewordene Fälle melden. @return Anzahl der Verschlechterungen."""
+    reference = {entry["case"]: entry for entry in baseline}
+    regressions = 0
+    for result in results:
+        old = reference.get(result["case"])
+        if old is None:
+            print("%-5s %10.4f µs  (nicht in der Baseline)" % (result["case"], result["usPerOp"]))
+            continue
+        change = (result["usPerOp"] / old["usPerOp"] - 1) if old["usPerOp"] > 0 else 0.0
+        ticks = 2 * resolution / (result["iterations"] * result["usPerOp"]) if result["usPerOp"] > 0 else 0.0
+        noise = max(noise_floor, ticks, result.get("spread", 0.0), old.get("spread", 0.0))
+        is_slower = change > threshold and change > noise
+        regressions += is_slower
+        print("%-5s %10.4f µs  Baseline %10.4f µs  %+6.1f %%  (Rauschen %.1f %%)%s" % (
+            result["case"], result["usPerOp"], old["usPerOp"], change * 100, noise * 100,
+            "  LANGSAMER" if is_slower else ""))
+    for case in sorted(set(reference) - {result["case"] for result in results}):
+        print("%-5s fehlt in der Messung" % case)
+        regressions += 1
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--board", choices=sorted(CASES), default="host")
+    parser.add_argument("--port", help="serielle Schnittstelle des Boards (nur --board uno)")
+    parser.add_argument("--duration", type=int, default=100, help="Mindestdauer je Fall in ms (Standard 100)")
+    parser.add_argument("--runs", type=int, default=3, help="Wiederholungen, der schnellste Wert zählt")
+    parser.add_argument("--threshold", type=float, default=10.0, help="erlaubte Verschlechterung in %%")
+    parser.add_argument("--noise", type=float, default=2.0, help="kleinstes Rauschen in %% (Standard 2)")
+    parser.add_argument("--baseline", help="Baseline-Datei (Standard: baseline-<Board>.json)")
+    parser.add_argument("--output", help="Ergebnisse zusätzlich als JSON hierhin schreiben")
+    parser.add_argument("--update", action="store_true", help="Baseline mit den Ergebnissen überschreiben")
+    args = parser.parse_args()
+    if (args.board == "uno") != (args.port is not None):
+        parser.error("--port gehört zu --board uno")
+    if not 0 < args.duration <= 65535:
+        parser.error("--duration 1..65535")
+    baseline_path = args.baseline or os.path.join(HERE, "baseline-%s.json" % args.board)
+    if not args.update and not os.path.exists(baseline_path):
+        # Keine Zahlen erfinden: ohne Messung auf demselben Rechner bzw. Board gibt es keinen Vergleich.
+        if args.board == "uno":
+            print("Keine Baseline %s: Auf einem echten Uno wurde noch nicht gemessen. Einmal mit "
+                  "--board uno --port … --update auf dem Board anlegen." % baseline_path, file=sys.stderr)
+        else:
+            print("Keine Baseline %s: make -C XPanino/test/host bench legt sie auf diesem Rechner an."
+                  % baseline_path, file=sys.stderr)
+        return EXIT_NO_BASELINE
+
+    runs = [run_board(args.port, args.duration) if args.port else run_host(args.duration) for _ in range(args.runs)]
+    results = sorted(best_of(runs), key=lambda result: result["case"])
+    if not results:
+        print("Keine Ergebnisse erhalten", file=sys.stderr)
+        return EXIT_NO_RESULTS
+    text = json.dumps(results, indent=2) + "\n"
+    if args.output:
+        with open(args.output, "w") as file:
+            file.write(text)
+    if args.update:
+        with open(baseline_path, "w") as file:
+            file.write(text)
+        print("Baseline geschrieben: %s" % baseline_path)
+        return 0
+
+    with open(baseline_path) as file:
+        baseline = json.load(file)
+    regressions = compare(results, baseline, args.threshold / 100, args.noise / 100, RESOLUTION_US[args.board])
+    print("%d Fall/Fälle langsamer als %.0f %%" % (regressions, args.threshold) if regressions else "OK")
+    return EXIT_REGRESSION if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
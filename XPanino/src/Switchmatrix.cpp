@@ -12,6 +12,12 @@
 
 #include <Arduino.h>
 #include <Switchmatrix.hpp>
+#include <dispatcher.hpp>
+#include <hal.hpp>
+#include <txbuffer.hpp>
+
+extern DispatcherClass dispatcher;
+extern TxBuffer txBuffer;
 
 /*********************************************************************************************************//**
  * Methoden für SwitchMatrix
@@ -21,71 +27,145 @@
 void SwitchMatrix::initHardware() {
     /// Alle Matrixzeilen-Pins als Output einstellen und auf HIGH setzen.
     for (uint8_t row = HW_MATRIX_ROWS_LSB_PIN; row <= HW_MATRIX_ROWS_MSB_PIN; ++row) {
-        pinMode(row, OUTPUT); // die Pins 2 und 3 auf Output setzen.
-        digitalWrite(row, HIGH);
+        Hal::pinOutput(row); // die Pins 2 und 3 auf Output setzen.
+        Hal::pinWrite(row, true);
     }
     /// Alle Matrixspalten-Pins als Input mit aktiviertem Pullup-Widerstand einstellen.
     for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
-        pinMode(col, INPUT_PULLUP);
+        Hal::pinInputPullup(col);
     }
 }
 
 
 /******************************************************************************/
 void SwitchMatrix::scanSwitchPins() {
-    uint8_t pinStatus = 0;
     size_t matrixRow = 0;
     size_t matrixCol = 0;
 
     for (uint8_t row = HW_MATRIX_ROWS_LSB_PIN; row <= HW_MATRIX_ROWS_MSB_PIN; ++row) {
-        digitalWrite(row, LOW);     // Die Matrixzeile aktivieren
+        Hal::pinWrite(row, false);     // Die Matrixzeile aktivieren
         for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
             matrixRow = row - HW_MATRIX_ROWS_LSB_PIN;   // Pin-Nummer auf Matrixzeile umrechnen.
             matrixCol = col - HW_MATRIX_COLS_LSB_PIN;   // Pin-Nummer auf Matrixspalte umrechnen.
             if (isValidMatrixPos(matrixRow, matrixCol)) {
                 /// Pinstatus einlesen und entprellen.
-                pinStatus = digitalRead(col);
-                /// Wenn eine Änderung erkannt wurde, den neuen Schalterstatus in der _SwitchMatrix speichern
-                /// und die Einschalt\"zeit\" merken.
-                /// Außerdem die neuen Status an PC übertragen.\n
-                /// @em 0 enspricht geschlossenem Schalter, da bei geschlossenem Schalter
-                /// das Col-Pin auf @em LOW gezogen wird.
-                if (pinStatus != (switchMatrix[matrixRow][matrixCol]).getStatusNoChange()) {
-                    if (pinStatus == LOW) {
-                        switchMatrix[matrixRow][matrixCol].setOn();
-                    }
-                    else {
-                        switchMatrix[matrixRow][matrixCol].setOff();
-                    };
-                    changed = true;
-                } else {
-                    /// Bei den nicht veränderten Schaltern die Einschaltzeiten aktualisieren.
-                    switchMatrix[matrixRow][matrixCol].updateOnTime(millis());
-                    /// Lange Tastendrücke identifizieren und ggf. ein Ereignis auslösen.
-                    switchMatrix[matrixRow][matrixCol].checkLongOn();
-                }
+                updateSwitch(matrixRow, matrixCol, Hal::pinRead(col) ? HIGH : LOW);
             } else {
                 // Ungültige Position, d.h. row oder col außerhalb der Matrix.
-                Serial.print(F("Error 001"));
+                Hal::uartPrintFlash(PSTR("Error 001"));
             }
         }   /// weiter geht's mit der nächsten Spalte
-        digitalWrite(row, HIGH);    /// Row-Pin wieder auf HIGH setzen und damit deaktivieren.
+        Hal::pinWrite(row, true);    /// Row-Pin wieder auf HIGH setzen und damit deaktivieren.
     }   /// weiter geht's mit der nächsten Row
 }
 
 
+#ifdef XPANINO_DUAL_CORE
+void SwitchMatrix::sampleSwitchPins() {
+    for (uint8_t row = HW_MATRIX_ROWS_LSB_PIN; row <= HW_MATRIX_ROWS_MSB_PIN; ++row) {
+        Hal::pinWrite(row, false);     // Die Matrixzeile aktivieren
+        const uint8_t matrixRow = row - HW_MATRIX_ROWS_LSB_PIN;
+        for (uint8_t col = HW_MATRIX_COLS_LSB_PIN; col <= HW_MATRIX_COLS_MSB_PIN; ++col) {
+            const uint8_t matrixCol = col - HW_MATRIX_COLS_LSB_PIN;
+            const uint8_t mask = static_cast<uint8_t>(1 << matrixCol);
+            const uint8_t pinStatus = Hal::pinRead(col) ? HIGH : LOW;
+            if ((pinStatus == LOW) != ((sampledClosed[matrixRow] & mask) != 0)) {
+                // Ist die Queue voll, wird die Änderung bei der nächsten Abfrage erneut gemeldet.
+                if (switchChanges.push(SwitchChange{matrixRow, matrixCol, pinStatus})) {
+                    sampledClosed[matrixRow] ^= mask;
+                }
+            }
+        }
+        Hal::pinWrite(row, true);    /// Row-Pin wieder auf HIGH setzen und damit deaktivieren.
+    }
+}
+
+
+/**
+ * Jeder Schalter wird je Aufruf höchstens einmal umgeschaltet. Meldet der I/O-Kern für einen
+ * Schalter mehrere Änderungen (z.B. kurzes Drücken und Loslassen zwischen zwei loop()-Durchläufen),
+ * wird die zweite zurückgehalten und erst beim nächsten Aufruf verarbeitet. So sieht
+ * transmitStatus() jede Flanke, wie bei scanSwitchPins().
+ */
+void SwitchMatrix::processSwitchChanges() {
+    uint8_t touched[SWITCH_MATRIX_ROWS] = {};
+    SwitchChange change;
+    bool isChangeAvailable = hasHeldChange || switchChanges.pop(change);
+    if (hasHeldChange) {
+        change = heldChange;
+        hasHeldChange = false;
+    }
+    while (isChangeAvailable) {
+        const uint8_t mask = static_cast<uint8_t>(1 << change.col);
+        if ((touched[change.row] & mask) != 0) {
+            heldChange = change;
+            hasHeldChange = true;
+            break;
+        }
+        touched[change.row] |= mask;
+        if (change.status == LOW) {
+            closed[change.row] |= mask;
+        } else {
+            closed[change.row] &= static_cast<uint8_t>(~mask);
+        }
+        updateSwitch(change.row, change.col, change.status);
+        isChangeAvailable = switchChanges.pop(change);
+    }
+    // Einschaltzeiten aller Schalter aktualisieren und lange Tastendrücke erkennen.
+    for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; ++row) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; ++col) {
+            updateSwitch(row, col, ((closed[row] >> col) & 1) != 0 ? LOW : HIGH);
+        }
+    }
+}
+#endif
+
+
+/**
+ * @brief Neuen Pinstatus eines Schalters übernehmen.
+ *
+ * Wenn eine Änderung erkannt wurde, den neuen Schalterstatus in der switchMatrix speichern und die
+ * Einschalt"zeit" merken; andernfalls die Einschaltzeit aktualisieren und lange Tastendrücke
+ * identifizieren. @em LOW entspricht geschlossenem Schalter, da bei geschlossenem Schalter das
+ * Col-Pin auf @em LOW gezogen wird.
+ *
+ * @param matrixRow Zeile in der switchMatrix.
+ * @param matrixCol Spalte in der switchMatrix.
+ * @param pinStatus Eingelesener Pinstatus, @em HIGH oder @em LOW.
+ */
+void SwitchMatrix::updateSwitch(const uint8_t matrixRow, const uint8_t matrixCol, const uint8_t pinStatus) {
+    Switch &sw = switchMatrix[matrixRow][matrixCol];
+    if (pinStatus != sw.getStatusNoChange()) {
+        if (pinStatus == LOW) {
+            sw.setOn();
+        } else {
+            sw.setOff();
+        }
+        changed = true;
+    } else {
+        /// Bei den nicht veränderten Schaltern die Einschaltzeiten aktualisieren.
+        sw.updateOnTime(Hal::millis());
+        /// Lange Tastendrücke identifizieren und ggf. ein Ereignis auslösen.
+        sw.checkLongOn();
+    }
+}
+
+
 void SwitchMatrix::transmitStatus(const bool changedOnly) {
     for (uint8_t row = 0; row < SWITCH_MATRIX_ROWS; row++) {
         for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; col++) {
-            if (changedOnly && switchMatrix[row][col].isChanged()) {
-                switchMatrix[row][col].transmitStatus(row, col);        // Methode eines einzelnen Switches
-           } else {
-                if (! changedOnly) {
-                    switchMatrix[row][col].transmitStatus(row, col);
+            if ((! changedOnly) || switchMatrix[row][col].isChanged()) {
+                uint8_t switchState = switchMatrix[row][col].fetchSwitchState();
+                // Schalter, die ein Gerät lokal verarbeitet, werden nicht an den PC übertragen.
+                if (! dispatcher.dispatchSwitch(row, col, switchState)) {
+                    switchMatrix[row][col].transmit(row, col, switchState);   // Methode eines einzelnen Switches
                 }
             }
         }
     }
+    // Schalterstände sind dringend: Alle in diesem Durchlauf geänderten Schalter gemeinsam in einem
+    // Paket sofort senden, ohne die Wartezeit des TxBuffers abzuwarten.
+    txBuffer.flush();
 }
 
 #ifdef DEBUG
@@ -125,7 +205,7 @@ void SwitchMatrix::printMatrix() {
  * @return true Die Zeilennummer ist gültig.
  * @return false Die Zeilennummer ist ungültig.
  */
-bool SwitchMatrix::isValidMatrixRow(const uint8_t row) { return ((row >= 0) && (row <= SWITCH_MATRIX_ROWS)); }
+bool SwitchMatrix::isValidMatrixRow(const uint8_t row) { return (row < SWITCH_MATRIX_ROWS); }
 
 
 /**
@@ -136,7 +216,7 @@ bool SwitchMatrix::isValidMatrixRow(const uint8_t row) { return ((row >= 0) && (
  * @return true Die Spaltennummer ist gültig.
  * @return false Die Spaltennummer ist ungültig.
  */
-bool SwitchMatrix::isValidMatrixCol(const uint8_t col) { return ((col >= 0) && (col <= SWITCH_MATRIX_COLS)); }
+bool SwitchMatrix::isValidMatrixCol(const uint8_t col) { return (col < SWITCH_MATRIX_COLS); }
 
 
 /**
@@ -14,6 +14,9 @@
 #pragma once
 
 #include <switch.hpp>
+#ifdef XPANINO_DUAL_CORE
+#include <spscqueue.hpp>
+#endif
 
 // Konstanten
 const bool TRANSMIT_ONLY_CHANGED_SWITCHES = true; ///< nur veränderte Schalter-Status übertragen
@@ -29,6 +32,17 @@ const unsigned int HW_MATRIX_COLS_MSB_PIN = 13;  ///< Pin-Nummer des höchstwert
 constexpr uint8_t SWITCH_MATRIX_ROWS = HW_MATRIX_ROWS_MSB_PIN - HW_MATRIX_ROWS_LSB_PIN + 1;  ///< Anzahl Matrixzeilen
 constexpr uint8_t SWITCH_MATRIX_COLS = HW_MATRIX_COLS_MSB_PIN - HW_MATRIX_COLS_LSB_PIN + 1;  ///< Anzahl Matrixspalten
 
+#ifdef XPANINO_DUAL_CORE
+const uint8_t SWITCH_QUEUE_SIZE = 32;   ///< Plätze der Queue für Schalteränderungen vom I/O-Kern
+
+/// @brief Vom I/O-Kern gemeldete Änderung eines Schalters.
+struct SwitchChange {
+    uint8_t row;        ///< Zeile in der Schaltermatrix
+    uint8_t col;        ///< Spalte in der Schaltermatrix
+    uint8_t status;     ///< Neuer Pinstatus, @em LOW = eingeschaltet
+};
+#endif
+
 
 /*********************************************************************************************************//**
  * @brief Schaltermatrix zur Aufnahme von Schaltern der Klasse @em switch.
@@ -58,12 +72,34 @@ public:
     void scanSwitchPins();
 
 
+    #ifdef XPANINO_DUAL_CORE
+    /**
+     * @brief I/O-Kern: Die Hardware-Schalter abfragen und Änderungen in die Queue für den
+     *        Gerätekern stellen.
+     *
+     * Ersetzt im Dual-Core-Betrieb scanSwitchPins(); wird regelmäßig im loop1() aufgerufen und
+     * verändert die Schalter selbst nicht.
+     */
+    void sampleSwitchPins();
+
+
+    /**
+     * @brief Gerätekern: Die vom I/O-Kern gemeldeten Änderungen in die Schalter übernehmen.
+     *
+     * Ersetzt im Dual-Core-Betrieb scanSwitchPins() im loop(); anschließend überträgt
+     * transmitStatus() die geänderten Schalter wie gewohnt.
+     */
+    void processSwitchChanges();
+    #endif
+
+
     /**
      * @brief Schalterstatus (@em ON, @e OFF, @em LON) übermitteln und
      *        den Status aller Schalter in der Matrix ablegen.
      *
      * Überträgt den Status der einzelnen Schalter in die Schaltermatrix.
-     * Hierzu wird die Methode @em Switch::transmitStatus() des jeweiligen Schalters verwendet.
+     * Der Status wird zuerst über den Dispatcher den Geräten angeboten; nur Schalter, die kein Gerät
+     * lokal verarbeitet, werden mit der Methode @em Switch::transmit() des jeweiligen Schalters übertragen.
      *
      * @param changedOnly @em true ==>  nur den Status der Schalter, die sich seit
      *                                  der letzten Abfrage geändert haben, übertragen.\n
@@ -86,8 +122,17 @@ private:
     Switch switchMatrix[SWITCH_MATRIX_ROWS][SWITCH_MATRIX_COLS];    ///< Switchmatrix anlegen.
     bool changed = false;   ///< Änderungsstatus der gesamten Matrix. Sobald sich ein Schalter ändert, ist @em changed @em true.
     const unsigned int debounceTime = 9;  ///< Zeit in Millisekunden zum Entprellen
+    #ifdef XPANINO_DUAL_CORE
+    static_assert(SWITCH_MATRIX_COLS <= 8, "Eine Matrixzeile muss in ein Byte passen");
+    uint8_t sampledClosed[SWITCH_MATRIX_ROWS] = {};  ///< I/O-Kern: zuletzt gemeldeter Status, je Spalte ein Bit (1 = geschlossen)
+    uint8_t closed[SWITCH_MATRIX_ROWS] = {};         ///< Gerätekern: übernommener Status, je Spalte ein Bit (1 = geschlossen)
+    SpscQueue<SwitchChange, SWITCH_QUEUE_SIZE> switchChanges;    ///< Änderungen vom I/O- zum Gerätekern
+    SwitchChange heldChange;                    ///< Zurückgehaltene zweite Änderung eines Schalters
+    bool hasHeldChange = false;                 ///< @em true: @em heldChange ist gültig
+    #endif
 
     inline bool isValidMatrixRow(const uint8_t row);
     inline bool isValidMatrixCol(const uint8_t col);
     inline bool isValidMatrixPos(const uint8_t row, const uint8_t col);
+    void updateSwitch(uint8_t matrixRow, uint8_t matrixCol, uint8_t pinStatus);
 };
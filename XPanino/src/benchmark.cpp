@@ -0,0 +1,128 @@
+/***************************************************************************************************
+ * @file benchmark.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em Benchmark.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#ifdef XPANINO_BENCHMARK
+
+#include <benchmark.hpp>
+#include <buffer.hpp>
+#include <charmap7seg.hpp>
+#include <diagnostics.hpp>
+#include <dispatcher.hpp>
+#include <hal.hpp>
+#include <ledmatrix.hpp>
+#include <Switchmatrix.hpp>
+#include <txbuffer.hpp>
+
+extern DispatcherClass dispatcher;
+extern BufferClass inBuffer;
+extern LedMatrix leds;
+extern SwitchMatrix switches;
+extern TxBuffer txBuffer;
+
+const char BENCHMARK_LINE[] = "XPDR;CODE;7000";         ///< Beispielzeile für BPRS
+const char BENCHMARK_CHARS[] = "0123456789-AbCdEF";     ///< Beispielzeichen für BCHR
+const uint8_t MAX_NUMBER_LENGTH = 11;                   ///< Max. Länge einer unsigned long als String inkl. '\0'
+
+static EventQueueClass benchmarkQueue;          ///< Eigene Queue für BQUE, wartende Events bleiben unangetastet
+static EventClass benchmarkEvent;               ///< Event für BQUE und BDSP
+
+
+/// Eingabe parsen; parseString() zerlegt den Puffer, deshalb vor jedem Durchlauf neu kopieren.
+static void parseBatch(const uint16_t count) {
+    char line[MAX_BUFFER_LENGTH];
+    for (uint16_t i = 0; i != count; ++i) {
+        strcpy(line, BENCHMARK_LINE);
+        delete inBuffer.parseString(line);
+    }
+}
+
+
+static void queueBatch(const uint16_t count) {
+    for (uint16_t i = 0; i != count; ++i) {
+        benchmarkQueue.addEvent(&benchmarkEvent);
+        benchmarkQueue.getHeadEvent();
+    }
+}
+
+
+/// Das Device "BNCH" gibt es nicht, es werden also alle Vergleiche durchlaufen.
+static void dispatchBatch(const uint16_t count) {
+    for (uint16_t i = 0; i != count; ++i) {
+        dispatcher.dispatch(&benchmarkEvent);
+    }
+}
+
+
+static void charMapBatch(const uint16_t count) {
+    Led7SegmentCharMap charMap;
+    volatile uint8_t bitMap = 0;
+    for (uint16_t i = 0; i != count; ++i) {
+        bitMap = charMap.get7SegBitMap(BENCHMARK_CHARS[i % (sizeof(BENCHMARK_CHARS) - 1)]);
+    }
+    (void)bitMap;
+}
+
+
+static void ledBatch(const uint16_t count) {
+    for (uint16_t i = 0; i != count; ++i) {
+        leds.writeToHardware();
+    }
+}
+
+
+/// Schalter abfragen. Ohne transmitStatus(): Es würde geänderte Schalter über dispatchSwitch() an
+/// die Geräte geben bzw. senden und damit ihren Zustand verändern. Erkannte Änderungen bleiben
+/// markiert und werden im nächsten loop() wie gewohnt übertragen.
+static void scanBatch(const uint16_t count) {
+    for (uint16_t i = 0; i != count; ++i) {
+        switches.scanSwitchPins();
+    }
+}
+
+
+void Benchmark::run(const uint16_t minDuration) {
+    const unsigned long minDurationUs = minDuration * 1000UL;
+    strcpy(benchmarkEvent.device, "BNCH");
+    measure("BPRS", parseBatch, minDurationUs);
+    measure("BQUE", queueBatch, minDurationUs);
+    measure("BDSP", dispatchBatch, minDurationUs);
+    measure("BCHR", charMapBatch, minDurationUs);
+    measure("BLED", ledBatch, minDurationUs);
+    measure("BSCN", scanBatch, minDurationUs);
+}
+
+
+void Benchmark::measure(const char *name, void (*batch)(uint16_t), const unsigned long minDuration) {
+    unsigned long iterations = 0;
+    unsigned long duration;
+    uint16_t count = 1;
+    const unsigned long start = Hal::micros();
+    do {
+        batch(count);
+        iterations += count;
+        count = (count < UINT16_MAX / 2) ? count * 2 : count;
+        duration = Hal::micros() - start;
+    } while (duration < minDuration);
+    transmitResult(name, iterations, duration);
+}
+
+
+void Benchmark::transmitResult(const char *name, const unsigned long iterations, const unsigned long duration) {
+    char count[MAX_NUMBER_LENGTH];
+    char total[MAX_NUMBER_LENGTH];
+    snprintf(count, MAX_NUMBER_LENGTH, "%lu", iterations);
+    snprintf(total, MAX_NUMBER_LENGTH, "%lu", duration);
+    transmitEvent(DEVICE_SYSTEM, name, count, total);
+    // Sofort senden, damit das Senden nicht in die Messung des nächsten Falls fällt.
+    txBuffer.flush();
+    Hal::uartFlush();
+}
+
+#endif
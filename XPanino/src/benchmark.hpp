@@ -0,0 +1,68 @@
+/***************************************************************************************************
+ * @file benchmark.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em Benchmark zum Messen der zeitkritischen Teile der Firmware.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#ifdef XPANINO_BENCHMARK
+
+#ifdef XPANINO_DUAL_CORE
+#error "Der Benchmark misst LED- und Schaltermatrix auf dem ersten Kern und ist nur ohne XPANINO_DUAL_CORE möglich."
+#endif
+
+#include <Arduino.h>
+#include <device.hpp>
+
+const char SYSTEM_BENCHMARK[] = "BNCH";         ///< PC -> Arduino: Benchmark; Parameter 1 = Mindestdauer je Fall in ms
+const uint16_t BENCHMARK_DEFAULT_DURATION = 20;         ///< Mindestdauer je Fall in ms ohne Parameter
+
+
+/***************************************************************************************************
+ * @brief Misst auf dem Arduino die zeitkritischen Teile der Firmware.
+ *
+ * Wird nur mit dem Build-Flag @em XPANINO_BENCHMARK übersetzt (PlatformIO-Environment
+ * @em unobench). Auf "SYS;BNCH;<ms>" wird jeder Fall so oft ausgeführt, dass er mindestens @em ms
+ * Millisekunden dauert, und das Ergebnis als "SYS;<Fall>;<Durchläufe>;<Gesamtdauer in µs>" gesendet.
+ * Die Durchläufe laufen in Stapeln, deren Größe sich jedes Mal verdoppelt; micros() wird nur
+ * zwischen zwei Stapeln abgefragt und fällt deshalb auch bei sehr kurzen Fällen nicht ins Gewicht.
+ *
+ * | Fall   | Gemessen                                                                  |
+ * | ------ | ------------------------------------------------------------------------- |
+ * | `BPRS` | BufferClass::parseString() einer Zeile inkl. Freigeben des Events          |
+ * | `BQUE` | EventQueueClass::addEvent() und getHeadEvent() (eigene Queue)              |
+ * | `BDSP` | DispatcherClass::dispatch() eines Events ohne passendes Device             |
+ * | `BCHR` | Led7SegmentCharMap::get7SegBitMap() für ein Zeichen                        |
+ * | `BLED` | LedMatrix::writeToHardware()                                               |
+ * | `BSCN` | SwitchMatrix::scanSwitchPins() (Einlesen und Entprellen)                   |
+ *
+ * Die Fälle verändern weder Anzeigen noch den Zustand der Geräte und senden nichts außer dem
+ * Ergebnis. Während BSCN betätigte Schalter werden erst im nächsten loop() übertragen.
+ *
+ * Dieselben Zeilen liefert auch XPIf für seine Fälle (`XPIf/test/bench_hotpaths.cpp`); beide wertet
+ * `benchmarks/compare.py` aus.
+ *
+ **************************************************************************************************/
+class Benchmark : public Device {
+public:
+    /**
+     * @brief Alle Fälle messen und die Ergebnisse senden.
+     *
+     * @param minDuration Mindestdauer je Fall in ms.
+     */
+    static void run(uint16_t minDuration);
+
+private:
+    /// Einen Fall in Stapeln von @em batch(n) ausführen, bis er mindestens @em minDuration µs gedauert hat.
+    static void measure(const char *name, void (*batch)(uint16_t), unsigned long minDuration);
+
+    /// Ergebnis eines Falls senden.
+    static void transmitResult(const char *name, unsigned long iterations, unsigned long duration);
+};
+
+#endif
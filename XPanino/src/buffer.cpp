@@ -19,7 +19,7 @@
  ************************************************************************************************************/
 
 uint8_t BufferClass::addChar(const char inChar) {
-    if (actPos < MAX_BUFFER_LENGTH) {
+    if (actPos < MAX_BUFFER_LENGTH - 1) {      // Platz für das abschließende '\0' lassen
         buffer[actPos] = toupper(inChar);
         actPos += 1;
         buffer[actPos] = '\0';
@@ -36,19 +36,26 @@ EventClass* BufferClass::parseString(char *inBuffer) {
     char*  ptrParameter = nullptr; // NOLINT
     uint8_t paramCount = 1;                     // Zähler für die richtige Variable der struct
     EventClass* ptrEvent = new EventClass {};
+    if (ptrEvent == nullptr) {
+        return nullptr;     // Pool erschöpft; die Zeile wird verworfen.
+    }
     ptrEvent->setNext(nullptr);
 
     ptrParameter = strtok(inBuffer, TOKEN_DELIMITER);  // ptrParameter enthält jetzt den Stringabschnitt bis zum ersten Blank.
     if (ptrParameter != nullptr) {  // NOLINT modernize-use-nullptr ;vorsichtshalber testen, ob was gefunden wurde.
-        strcpy(ptrEvent->device, ptrParameter);        // Diesen in device kopieren.
+        strncpy(ptrEvent->device, ptrParameter, MAX_SRC_DEV_LENGTH - 1);  // Diesen in device kopieren.
         while (ptrParameter != nullptr) {       // NOLINT Das Zerlegen fortsetzen bis nichts mehr da ist.
             paramCount++;   // Zähler hochzählen, für die richtige Variable der struct
                             // In die richtige Variable den Teilstring bis zum
             ptrParameter = strtok(nullptr, TOKEN_DELIMITER);   // NOLINT
+            if (ptrParameter == nullptr) {
+                break;                          // weniger als 4 Tokens; die restlichen Teile bleiben leer
+            }
             switch (paramCount) {               // jeweils nächsten Blank hineinkopieren.
-                case 2: { strcpy(ptrEvent->event, ptrParameter); break; }
-                case 3: { strcpy(ptrEvent->parameter1, ptrParameter); break; }
-                case 4: { strcpy(ptrEvent->parameter2, ptrParameter); break; }
+                // Das letzte Zeichen bleibt immer '\0', da das Event mit leeren Strings angelegt wird.
+                case 2: { strncpy(ptrEvent->event, ptrParameter, MAX_SRC_DEV_LENGTH - 1); break; }
+                case 3: { strncpy(ptrEvent->parameter1, ptrParameter, MAX_PARA_LENGTH - 1); break; }
+                case 4: { strncpy(ptrEvent->parameter2, ptrParameter, MAX_PARA_LENGTH - 1); break; }
                 default: ;  // mehr als 4 Tokens; das ist ein Fehler; die überzähligen Token ignorieren
             }
         }
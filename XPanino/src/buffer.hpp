@@ -68,8 +68,8 @@ public:
      *
      * @param inBuffer Enthält die eingelesenen Zeichen, die von der seriellen Schnittstelle gelesen wurden.
      *                 Der inBuffer wird dabei zerstört.
-     * @return @em true  Parsen wurde fehlerfrei abgeschlossen.\n
-     *         @em false Fehler beim Parsen aufgetreten.
+     * @return Zeiger auf das neue Event (aus dem Pool, vgl. EventClass); @em nullptr, falls kein
+     *         Platz im Pool frei ist. Zu lange Teile werden abgeschnitten.
      */
     EventClass* parseString(char *inBuffer);
 
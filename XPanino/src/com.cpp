@@ -0,0 +1,217 @@
+/***************************************************************************************************
+ * @file com.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em ComRadio.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <com.hpp>
+
+extern LedMatrix leds;
+
+/// Endungen (Zehner und Einer der kHz) der Kanalnamen je 100 kHz im 8,33-kHz-Raster
+const uint8_t CHANNEL_NAMES_833[COM_833_NAMES_PER_100KHZ] PROGMEM = {
+     0,  5, 10, 15,     // 25-kHz-Kanal .x00 und 8,33-kHz-Kanäle .x05, .x10, .x15
+    25, 30, 35, 40,
+    50, 55, 60, 65,
+    75, 80, 85, 90
+};
+
+
+/**************************************************************************************************
+ * ComRadio - public Methoden
+ *
+ **************************************************************************************************/
+
+ComRadio::ComRadio(const char *deviceName, const char *powerDevice) {
+    this->deviceName = deviceName;
+    this->powerDevice = powerDevice;
+    active = {COM_MIN_MHZ, 0};
+    standby = {COM_MIN_MHZ, 0};
+    is833 = false;
+    isChanged = true;
+    isPowered = false;
+
+    ///< Define the display for the active frequency.
+    activeDisplay = 0;
+    leds.defineDisplayField(activeDisplay, 0, {0, 8});      ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 8 bis 15: Hunderterstelle MHz.
+    leds.defineDisplayField(activeDisplay, 1, {1, 8});      ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 8 bis 15: Zehnerstelle MHz.
+    leds.defineDisplayField(activeDisplay, 2, {2, 8});      ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 8 bis 15: Einerstelle MHz.
+    leds.defineDisplayField(activeDisplay, 3, {3, 8});      ///< Die 4. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 8 bis 15: Hunderterstelle kHz.
+    leds.defineDisplayField(activeDisplay, 4, {4, 8});      ///< Die 5. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 8 bis 15: Zehnerstelle kHz.
+    leds.defineDisplayField(activeDisplay, 5, {5, 8});      ///< Die 6. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 8 bis 15: Einerstelle kHz.
+
+    ///< Define the display for the standby frequency.
+    standbyDisplay = 1;
+    leds.defineDisplayField(standbyDisplay, 0, {0, 16});    ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 16 bis 23: Hunderterstelle MHz.
+    leds.defineDisplayField(standbyDisplay, 1, {1, 16});    ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 16 bis 23: Zehnerstelle MHz.
+    leds.defineDisplayField(standbyDisplay, 2, {2, 16});    ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 16 bis 23: Einerstelle MHz.
+    leds.defineDisplayField(standbyDisplay, 3, {3, 16});    ///< Die 4. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 16 bis 23: Hunderterstelle kHz.
+    leds.defineDisplayField(standbyDisplay, 4, {4, 16});    ///< Die 5. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 16 bis 23: Zehnerstelle kHz.
+    leds.defineDisplayField(standbyDisplay, 5, {5, 16});    ///< Die 6. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 16 bis 23: Einerstelle kHz.
+
+    ///< Define the leds which do not belong to a displayField.
+    LED_833 = {0, 4};       ///< Die LED "8.33" liegt auf Row=0 und Col=4.
+    leds.ledOff(LED_833);
+}
+
+
+void ComRadio::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
+    }
+    if (strcmp(event->event, COM_ACTIVE) == 0) {
+        isChanged = parseFrequency(event->parameter1, active) || isChanged;
+    } else if (strcmp(event->event, COM_STANDBY) == 0) {
+        isChanged = parseFrequency(event->parameter1, standby) || isChanged;
+    }
+}
+
+
+bool ComRadio::processSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) {
+    if ((row != COM_SWITCH_ROW) || (col > COM_SWITCH_833)) {
+        return false;
+    }
+    if (col == COM_SWITCH_833) {
+        // Kippschalter: bei jeder Änderung die Standby-Frequenz auf das neue Raster setzen.
+        if (switchState != SWITCH_STATE_LONG_ON) {
+            is833 = (switchState == SWITCH_STATE_ON);
+            standby.khz = toChannel(standby.khz);
+            isChanged = true;
+        }
+        return true;
+    }
+    if ((switchState != SWITCH_STATE_ON) || (! isDevicePowerAvailable())) {
+        return true;
+    }
+    switch (col) {
+        case COM_SWITCH_FLIP_FLOP : flipFlop(); break;
+        case COM_SWITCH_MHZ_UP    : stepMhz(1); break;
+        case COM_SWITCH_MHZ_DOWN  : stepMhz(-1); break;
+        case COM_SWITCH_KHZ_UP    : stepKhz(1); break;
+        case COM_SWITCH_KHZ_DOWN  : stepKhz(-1); break;
+        default : ;
+    }
+    return true;
+}
+
+
+void ComRadio::show() {
+    const bool hasPower = isDevicePowerAvailable();
+    if (hasPower != isPowered) {
+        isPowered = hasPower;
+        isChanged = true;
+    }
+    if (! isChanged) {
+        return;
+    }
+    if (isPowered) {
+        // Anzeige im Format "118.005"; der Punkt wird als Dezimalpunkt der 3. Stelle angezeigt.
+        char text[COM_FREQUENCY_LENGTH + 2];
+        leds.display(activeDisplay, frequencyToText(active, text));
+        leds.display(standbyDisplay, frequencyToText(standby, text));
+        if (is833) {
+            leds.ledOn(LED_833);
+        } else {
+            leds.ledOff(LED_833);
+        }
+    } else {
+        leds.display(activeDisplay, "      ");
+        leds.display(standbyDisplay, "      ");
+        leds.ledOff(LED_833);
+    }
+    isChanged = false;
+}
+
+
+/**************************************************************************************************
+ * ComRadio - private Methoden
+ *
+ **************************************************************************************************/
+
+void ComRadio::stepKhz(const int8_t direction) {
+    const uint8_t channels = is833 ? COM_CHANNELS_833 : COM_CHANNELS_25;
+    const uint8_t channel = khzToChannel(standby.khz);
+    standby.khz = channelToKhz((direction > 0) ? (channel + 1) % channels : (channel + channels - 1) % channels);
+    isChanged = true;
+}
+
+
+void ComRadio::stepMhz(const int8_t direction) {
+    if (direction > 0) {
+        standby.mhz = (standby.mhz >= COM_MAX_MHZ) ? COM_MIN_MHZ : standby.mhz + 1;
+    } else {
+        standby.mhz = (standby.mhz <= COM_MIN_MHZ) ? COM_MAX_MHZ : standby.mhz - 1;
+    }
+    isChanged = true;
+}
+
+
+void ComRadio::flipFlop() {
+    const ComFrequency previous = active;
+    active = standby;
+    standby = previous;
+    isChanged = true;
+    char digits[COM_FREQUENCY_LENGTH + 1];
+    transmitEvent(deviceName, COM_ACTIVE, frequencyToDigits(active, digits));
+}
+
+
+uint16_t ComRadio::toChannel(const uint16_t khz) const {
+    return channelToKhz(khzToChannel(khz));
+}
+
+
+uint16_t ComRadio::channelToKhz(const uint8_t channel) const {
+    if (is833) {
+        return (channel / COM_833_NAMES_PER_100KHZ) * 100
+               + pgm_read_byte(&CHANNEL_NAMES_833[channel % COM_833_NAMES_PER_100KHZ]);
+    }
+    return channel * 25;
+}
+
+
+uint8_t ComRadio::khzToChannel(const uint16_t khz) const {
+    if (is833) {
+        // Den größten Kanalnamen suchen, der nicht größer als khz ist.
+        const uint8_t rest = khz % 100;
+        uint8_t index = COM_833_NAMES_PER_100KHZ - 1;
+        while ((index != 0) && (pgm_read_byte(&CHANNEL_NAMES_833[index]) > rest)) {
+            --index;
+        }
+        return (khz / 100) * COM_833_NAMES_PER_100KHZ + index;
+    }
+    // 8,33-kHz-Kanäle dem 25-kHz-Kanal ihres Blocks zuordnen
+    return khz / 25;
+}
+
+
+bool ComRadio::parseFrequency(const char *digits, ComFrequency &frequency) {
+    if (strlen(digits) != COM_FREQUENCY_LENGTH) {
+        return false;
+    }
+    const uint32_t khz = static_cast<uint32_t>(atol(digits));
+    const uint8_t mhz = khz / 1000;
+    if ((mhz < COM_MIN_MHZ) || (mhz > COM_MAX_MHZ)) {
+        return false;
+    }
+    frequency = {mhz, static_cast<uint16_t>(khz % 1000)};
+    return true;
+}
+
+
+char *ComRadio::frequencyToDigits(const ComFrequency &frequency, char *digits) {
+    snprintf(digits, COM_FREQUENCY_LENGTH + 1, "%03u%03u", static_cast<unsigned int>(frequency.mhz % 1000),
+             static_cast<unsigned int>(frequency.khz % 1000));
+    return digits;
+}
+
+
+char *ComRadio::frequencyToText(const ComFrequency &frequency, char *text) {
+    snprintf(text, COM_FREQUENCY_LENGTH + 2, "%03u.%03u", static_cast<unsigned int>(frequency.mhz % 1000),
+             static_cast<unsigned int>(frequency.khz % 1000));
+    return text;
+}
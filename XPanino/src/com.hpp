@@ -0,0 +1,152 @@
+/***************************************************************************************************
+ * @file com.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em ComRadio sowie die zugehörigen Konstanten.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <buffer.hpp>
+#include <device.hpp>
+#include <ledmatrix.hpp>
+#include <Switchmatrix.hpp>
+
+const char DEVICE_COM_1[] = "COM1";     ///< Device COM 1
+const char DEVICE_COM_2[] = "COM2";     ///< Device COM 2
+const char COM_1_POWER[] = "PC1";       ///< Power-Device COM 1 (vgl. Doku "Kommunikation")
+const char COM_2_POWER[] = "PC2";       ///< Power-Device COM 2 (vgl. Doku "Kommunikation")
+
+// Event-Konstanten (vgl. Doku "Kommunikation")
+const char COM_ACTIVE[] = "ACT";        ///< Aktive Frequenz (Kanalname in kHz, 6-stellig)
+const char COM_STANDBY[] = "STBY";      ///< Standby-Frequenz (Kanalname in kHz, 6-stellig)
+
+// Position der Taster des COM-Panels in der Schaltermatrix. Die Drehgeber liefern je Raste einen
+// Tastendruck auf "auf" bzw. "ab".
+const uint8_t COM_SWITCH_ROW = 0;           ///< Row der Taster in der Schaltermatrix
+const uint8_t COM_SWITCH_FLIP_FLOP = 0;     ///< Col des Tasters zum Tauschen von aktiver und Standby-Frequenz
+const uint8_t COM_SWITCH_MHZ_UP = 1;        ///< Col des äußeren Drehgebers (MHz), Richtung auf
+const uint8_t COM_SWITCH_MHZ_DOWN = 2;      ///< Col des äußeren Drehgebers (MHz), Richtung ab
+const uint8_t COM_SWITCH_KHZ_UP = 3;        ///< Col des inneren Drehgebers (kHz), Richtung auf
+const uint8_t COM_SWITCH_KHZ_DOWN = 4;      ///< Col des inneren Drehgebers (kHz), Richtung ab
+const uint8_t COM_SWITCH_833 = 5;           ///< Col des Schalters für das 8,33-kHz-Kanalraster (ON = 8,33 kHz)
+
+// Frequenzbereich des Flugfunks
+const uint8_t COM_MIN_MHZ = 118;            ///< Kleinste Frequenz in MHz
+const uint8_t COM_MAX_MHZ = 136;            ///< Größte Frequenz in MHz
+const uint8_t COM_CHANNELS_25 = 40;         ///< Anzahl Kanäle je MHz im 25-kHz-Raster
+const uint8_t COM_CHANNELS_833 = 160;       ///< Anzahl Kanalnamen je MHz im 8,33-kHz-Raster
+const uint8_t COM_833_NAMES_PER_100KHZ = 16;     ///< Anzahl Kanalnamen je 100 kHz im 8,33-kHz-Raster
+const uint8_t COM_FREQUENCY_LENGTH = 6;     ///< Anzahl Stellen der Frequenz (Kanalname in kHz)
+
+
+/***************************************************************************************************
+ * @brief Eine Frequenz bzw.\ ein Kanalname des Flugfunks, z.B.\ 118.005.
+ *
+ */
+class ComFrequency {
+public:
+    uint8_t mhz;        ///< MHz-Anteil, 118 bis 136
+    uint16_t khz;       ///< kHz-Anteil des Kanalnamens, 0 bis 990
+};
+
+
+/***************************************************************************************************
+ * @brief Modell eines COM-Funkgeräts mit aktiver und Standby-Frequenz.
+ *
+ * Die Standby-Frequenz wird lokal auf dem Arduino eingestellt; dabei wird weder die Frequenz noch
+ * ein Tastendruck an den PC übertragen. Erst beim Tauschen (Flip-Flop) wird die neue aktive
+ * Frequenz mit einer einzigen Nachricht an den PC übertragen.
+ *
+ * Im 25-kHz-Raster sind alle Vielfachen von 25 kHz zulässig. Im 8,33-kHz-Raster werden die
+ * Kanalnamen verwendet: je 25-kHz-Block .x00 bzw.\ .x25 usw.\ für den 25-kHz-Kanal sowie drei
+ * 8,33-kHz-Kanäle mit den Endungen 05, 10, 15 bzw.\ 30, 35, 40 usw.
+ *
+ */
+class ComRadio : public Device {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param deviceName  Name des Geräts, z.B.\ @em DEVICE_COM_1.
+     * @param powerDevice Name des zugehörigen Power-Devices, z.B.\ @em COM_1_POWER.
+     */
+    ComRadio(const char *deviceName, const char *powerDevice);
+
+
+    /// @brief Den Namen des Geräts abfragen.
+    inline const char *getDeviceName() const { return deviceName; }
+
+
+    /// @brief Den Namen des zugehörigen Power-Devices abfragen.
+    inline const char *getPowerDevice() const { return powerDevice; }
+
+
+    /**
+     * @brief Vom PC empfangene Daten (aktive und Standby-Frequenz) verarbeiten.
+     *
+     * @param event Das zu verarbeitende Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Den Status eines Schalters des COM-Panels verarbeiten.
+     *
+     * @param row         Row des Schalters in der Schaltermatrix.
+     * @param col         Col des Schalters in der Schaltermatrix.
+     * @param switchState @em SWITCH_STATE_OFF, @em SWITCH_STATE_ON oder @em SWITCH_STATE_LONG_ON.
+     * @return @em true falls der Schalter zum COM-Panel gehört und lokal verarbeitet wurde, sonst @em false.
+     */
+    bool processSwitch(uint8_t row, uint8_t col, uint8_t switchState);
+
+
+    /**
+     * @brief Aktive und Standby-Frequenz anzeigen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     */
+    void show();
+
+private:
+    const char *deviceName;             ///< Name des Geräts
+    const char *powerDevice;            ///< Name des zugehörigen Power-Devices
+    uint8_t activeDisplay;              ///< Display-Feld für die aktive Frequenz
+    uint8_t standbyDisplay;             ///< Display-Feld für die Standby-Frequenz
+    LedMatrixPos LED_833;               ///< LED "8.33": 8,33-kHz-Raster ist eingeschaltet
+    ComFrequency active;                ///< Aktive Frequenz
+    ComFrequency standby;               ///< Standby-Frequenz
+    bool is833;                         ///< 8,33-kHz-Raster ist eingeschaltet
+    bool isChanged;                     ///< Anzeige muss aktualisiert werden
+    bool isPowered;                     ///< Zuletzt angezeigter Stromstatus
+
+    /// Den kHz-Anteil um einen Kanal weiterschalten. Es erfolgt kein Übertrag in die MHz.
+    void stepKhz(int8_t direction);
+
+    /// Den MHz-Anteil um 1 MHz weiterschalten; nach 136 folgt 118.
+    void stepMhz(int8_t direction);
+
+    /// Aktive und Standby-Frequenz tauschen und die neue aktive Frequenz an den PC übertragen.
+    void flipFlop();
+
+    /// Den kHz-Anteil auf einen Kanal des aktuellen Rasters setzen.
+    uint16_t toChannel(uint16_t khz) const;
+
+    /// Kanalnummer innerhalb eines MHz in den kHz-Anteil des Kanalnamens umrechnen.
+    uint16_t channelToKhz(uint8_t channel) const;
+
+    /// kHz-Anteil des Kanalnamens in die Kanalnummer innerhalb eines MHz umrechnen.
+    uint8_t khzToChannel(uint16_t khz) const;
+
+    /// Einen 6-stelligen Kanalnamen (z.B.\ "118005") in eine Frequenz umrechnen.
+    static bool parseFrequency(const char *digits, ComFrequency &frequency);
+
+    /// Eine Frequenz als 6-stelligen Kanalnamen ohne Punkt darstellen.
+    static char *frequencyToDigits(const ComFrequency &frequency, char *digits);
+
+    /// Eine Frequenz zur Anzeige im Format "118.005" darstellen.
+    static char *frequencyToText(const ComFrequency &frequency, char *text);
+};
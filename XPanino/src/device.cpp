@@ -9,6 +9,9 @@
  **************************************************************************************************/
 
 #include <device.hpp>
+#include <txbuffer.hpp>
+
+extern TxBuffer txBuffer;
 
 /**
  * @brief Construct a new Device:: Device object
@@ -32,6 +35,8 @@ void Device::processEvent(EventClass *event) const {
         Serial.println(F("  !!! nullptr statt event angekommen."));
     }
     Serial.println(F("***End Device.processEvent()"));
+    #else
+    (void)event;
     #endif
 }
 
@@ -45,26 +50,56 @@ void Device::setDevicePower(bool devicePowerSwitchState) {
     devicePower = devicePowerSwitchState;
 }
 
-inline bool Device::isBatteryPowerOn() {
+void Device::setBatteryPower(bool powerState) {
+    batteryPower = powerState;
+}
+
+
+void Device::setAvionics1Power(bool powerState) {
+    avionics1Power = powerState;
+}
+
+
+void Device::setAvionics2Power(bool powerState) {
+    avionics2Power = powerState;
+}
+
+
+bool Device::isBatteryPowerOn() {
     return batteryPower;
 };
 
 
-inline bool Device::isAvionics1PowerOn() {
+bool Device::isAvionics1PowerOn() {
     return avionics1Power;
 };
 
 
-inline bool Device::isAvionics2PowerOn() {
+bool Device::isAvionics2PowerOn() {
     return avionics2Power;
 };
 
 
-inline bool Device::isPowerAvailable() {
+bool Device::isPowerAvailable() {
     return isBatteryPowerOn() and isAvionics1PowerOn();
 }
 
 
 void Device::show() {
     ;
-}
\ No newline at end of file
+}
+
+
+void Device::transmitEvent(const char *device, const char *event,
+                           const char *parameter1, const char *parameter2, const bool isUrgent) {
+    char message[TX_PACKET_SIZE];
+    if (*parameter1 == '\0') {
+        snprintf(message, TX_PACKET_SIZE, "%s;%s", device, event);
+    } else if (*parameter2 == '\0') {
+        snprintf(message, TX_PACKET_SIZE, "%s;%s;%s", device, event, parameter1);
+    } else {
+        snprintf(message, TX_PACKET_SIZE, "%s;%s;%s;%s", device, event, parameter1, parameter2);
+    }
+    // Sofern nicht dringend, bündelt der TxBuffer die Nachricht mit weiteren Nachrichten.
+    txBuffer.addMessage(message, isUrgent);
+}
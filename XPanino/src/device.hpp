@@ -12,6 +12,13 @@
 
 #include <event.hpp>
 
+// Device-Konstanten für die Stromversorgung (vgl. Doku "Kommunikation")
+const char BATT_POWER[] = "PB";         ///< Battery-Power
+const char AVIONICS_1_POWER[] = "PA1";  ///< Avionics-Bus-1-Power
+const char AVIONICS_2_POWER[] = "PA2";  ///< Avionics-Bus-2-Power
+const char EVENT_ON[] = "ON";           ///< Power ist vorhanden bzw. eingeschaltet
+const char EVENT_OFF[] = "OFF";         ///< Keine Power vorhanden bzw. ausgeschaltet
+
 
 /***************************************************************************************************
  * @brief @em Device ist die Basisklasse für alle weiteren Geräte.
@@ -56,6 +63,30 @@ public:
     void setDevicePower(bool devicePowerSwitchState);
 
 
+    /**
+     * @brief Den Status der Batterie-Stromversorgung setzen.
+     *
+     * @param powerState @em true falls Batteriestrom verfügbar ist, sonst @em false.
+     */
+    void setBatteryPower(bool powerState);
+
+
+    /**
+     * @brief Den Status des Avionics-Bus 1 setzen.
+     *
+     * @param powerState @em true falls Strom am Avionicsbus 1 verfügbar ist, sonst @em false.
+     */
+    void setAvionics1Power(bool powerState);
+
+
+    /**
+     * @brief Den Status des Avionics-Bus 2 setzen.
+     *
+     * @param powerState @em true falls Strom am Avionicsbus 2 verfügbar ist, sonst @em false.
+     */
+    void setAvionics2Power(bool powerState);
+
+
     /**
      * @brief Check, ob Batterie-Strom zur Verfügung steht
      *        bzw. das Gerät eingeschaltet ist.
@@ -101,6 +132,21 @@ public:
     void show();
 
 
+protected:
+    /**
+     * @brief Ein Kommando an den PC senden. Die Teile werden wie bei den empfangenen Kommandos
+     *        durch ';' getrennt; leere Parameter werden weggelassen.
+     *
+     * @param device     Gerät, von dem das Kommando stammt.
+     * @param event      Event, z.B. "CODE".
+     * @param parameter1 1. Parameter. Optionaler Parameter.
+     * @param parameter2 2. Parameter. Optionaler Parameter.
+     * @param isUrgent   @em true: Nicht bündeln, sondern sofort senden (vgl. TxBuffer::addMessage()).
+     */
+    static void transmitEvent(const char *device, const char *event,
+                              const char *parameter1 = "", const char *parameter2 = "", bool isUrgent = false);
+
+
 private:
     bool batteryPower;      ///< @true : Battery power is available, otherwise @false.
     bool avionics1Power;    ///< @true : Avionics bus 1 is powered, otherwise @false.
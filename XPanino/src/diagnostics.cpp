@@ -0,0 +1,143 @@
+/***************************************************************************************************
+ * @file diagnostics.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em Diagnostics.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <benchmark.hpp>
+#include <diagnostics.hpp>
+#include <hal.hpp>
+
+
+/// Namen der Phasen im Trace (als Event gesendet), Reihenfolge wie TracePhase.
+const char TRACE_PHASE_NAMES[NO_OF_TRACE_PHASES][MAX_SRC_DEV_LENGTH] PROGMEM = {
+    "SCAN", "DISP", "SHOW", "LEDS"
+};
+
+const uint8_t MAX_NUMBER_LENGTH = 11;   ///< Max. Länge einer unsigned long als String inkl. '\0'
+
+#ifdef __AVR__
+extern char *__brkval;                  ///< Aktuelles Ende des Heaps; nullptr, solange nichts angefordert wurde
+extern char __heap_start;               ///< Beginn des Heaps (Linker-Symbol)
+#endif
+
+
+Diagnostics::Diagnostics() {
+    isTracing = false;
+    traceThreshold = 0;
+    currentPhase = NO_OF_TRACE_PHASES;
+    phaseStart = 0;
+    loopEnd = 0;
+    loopTimeSum = 0;
+    loopTimeMax = 0;
+    loopCount = 0;
+    minFreeRam = INT16_MAX;
+}
+
+
+void Diagnostics::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
+    }
+    if (strcmp(event->event, SYSTEM_PING) == 0) {
+        char stamp[MAX_NUMBER_LENGTH];
+        snprintf(stamp, MAX_NUMBER_LENGTH, "%lu", Hal::micros());
+        // Die Antwort nicht puffern, sonst verfälscht die Wartezeit den Zeitabgleich.
+        transmitEvent(DEVICE_SYSTEM, SYSTEM_PONG, event->parameter1, stamp, true);
+    } else if (strcmp(event->event, SYSTEM_TRACE) == 0) {
+        isTracing = (event->parameter1[0] != '\0');
+        traceThreshold = strtoul(event->parameter1, nullptr, 10);
+        currentPhase = NO_OF_TRACE_PHASES;
+    } else if (strcmp(event->event, SYSTEM_STATS) == 0) {
+        transmitStats();
+#ifdef XPANINO_BENCHMARK
+    } else if (strcmp(event->event, SYSTEM_BENCHMARK) == 0) {
+        const uint16_t minDuration = static_cast<uint16_t>(atoi(event->parameter1));
+        Benchmark::run((minDuration == 0) ? BENCHMARK_DEFAULT_DURATION : minDuration);
+#endif
+    }
+}
+
+
+void Diagnostics::endLoop() {
+    if (isTracing) {
+        traceSpan(NO_OF_TRACE_PHASES);
+    }
+    const unsigned long now = Hal::micros();
+    const unsigned long loopTime = now - loopEnd;
+    const bool isFirstLoop = (loopEnd == 0);    // der erste loop() enthielte die Dauer von setup()
+    loopEnd = now;
+    if ((! isFirstLoop) && (loopCount != UINT16_MAX)) {
+        loopTimeSum += loopTime;
+        loopTimeMax = max(loopTimeMax, loopTime);
+        ++loopCount;
+    }
+    // Das freie RAM je loop() nachführen, damit auch kurzzeitige Tiefstwerte zwischen zwei
+    // Abfragen erfasst werden.
+    minFreeRam = min(minFreeRam, freeRam());
+}
+
+
+/**
+ * @brief Die laufende Phase beenden und die nächste Phase beginnen.
+ *
+ * Die Zeit für das Senden zählt nicht zur nächsten Phase, da deren Beginn erst danach gemessen wird.
+ *
+ * @param nextPhase Die beginnende Phase; NO_OF_TRACE_PHASES = Ende des loop().
+ */
+void Diagnostics::traceSpan(const uint8_t nextPhase) {
+    if (currentPhase < NO_OF_TRACE_PHASES) {
+        const unsigned long duration = Hal::micros() - phaseStart;
+        if (duration >= traceThreshold) {
+            char name[MAX_SRC_DEV_LENGTH];
+            char start[MAX_NUMBER_LENGTH];
+            char length[MAX_NUMBER_LENGTH];
+            memcpy_P(name, TRACE_PHASE_NAMES[currentPhase], MAX_SRC_DEV_LENGTH);
+            snprintf(start, MAX_NUMBER_LENGTH, "%lu", phaseStart);
+            snprintf(length, MAX_NUMBER_LENGTH, "%lu", duration);
+            transmitEvent(DEVICE_SYSTEM, name, start, length);
+        }
+    }
+    currentPhase = nextPhase;
+    phaseStart = Hal::micros();
+}
+
+
+void Diagnostics::transmitStats() {
+    char first[MAX_NUMBER_LENGTH];
+    char second[MAX_NUMBER_LENGTH];
+    snprintf(first, MAX_NUMBER_LENGTH, "%lu", (loopCount == 0) ? 0UL : loopTimeSum / loopCount);
+    snprintf(second, MAX_NUMBER_LENGTH, "%lu", loopTimeMax);
+    transmitEvent(DEVICE_SYSTEM, SYSTEM_LOOP, first, second);
+    loopTimeSum = 0;
+    loopTimeMax = 0;
+    loopCount = 0;
+
+    const int freeBytes = freeRam();
+    minFreeRam = min(minFreeRam, freeBytes);   // falls seit dem Start noch kein loop() beendet wurde
+    snprintf(first, MAX_NUMBER_LENGTH, "%d", freeBytes);
+    snprintf(second, MAX_NUMBER_LENGTH, "%d", minFreeRam);
+    transmitEvent(DEVICE_SYSTEM, SYSTEM_RAM, first, second);
+}
+
+
+/**
+ * @brief Abstand zwischen dem Ende des Heaps und dem Stack.
+ *
+ * Freie Blöcke innerhalb des Heaps sind nicht enthalten. Auf dem PC (Tests) gibt es kein
+ * vergleichbares Maß; dort wird -1 geliefert.
+ *
+ * @return Freies RAM in Byte.
+ */
+int Diagnostics::freeRam() {
+#ifdef __AVR__
+    char top;
+    return &top - ((__brkval == nullptr) ? &__heap_start : __brkval);
+#else
+    return -1;
+#endif
+}
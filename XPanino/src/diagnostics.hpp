@@ -0,0 +1,104 @@
+/***************************************************************************************************
+ * @file diagnostics.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em Diagnostics für Zeitabgleich, Tracing und Statistik der loop()-Phasen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <device.hpp>
+#include <event.hpp>
+
+const char DEVICE_SYSTEM[] = "SYS";     ///< Device für Diagnose-Kommandos (vgl. Doku "Kommunikation")
+
+// Event-Konstanten (vgl. Doku "Kommunikation")
+const char SYSTEM_PING[] = "PING";      ///< PC -> Arduino: Zeitstempel anfordern; Parameter 1 = Id
+const char SYSTEM_PONG[] = "PONG";      ///< Arduino -> PC: Antwort auf PING; Parameter 1 = Id, Parameter 2 = micros()
+const char SYSTEM_TRACE[] = "TRC";      ///< PC -> Arduino: Tracing; Parameter 1 = Schwelle in µs, leer = aus
+const char SYSTEM_STATS[] = "STAT";     ///< PC -> Arduino: Statistik anfordern
+const char SYSTEM_LOOP[] = "LOOP";      ///< Arduino -> PC: Parameter 1 = mittlere, Parameter 2 = max. Dauer des loop() in µs
+const char SYSTEM_RAM[] = "RAM";        ///< Arduino -> PC: Parameter 1 = freies RAM, Parameter 2 = kleinstes freies RAM in Byte
+
+/**************************************************************************************************
+ * @brief Phasen des loop(), die beim Tracing gemessen werden.
+ *
+ */
+enum class TracePhase : uint8_t {
+    SCAN,           ///< Schalter abfragen und geänderte Schalter verarbeiten
+    DISPATCH,       ///< Eventqueue abarbeiten
+    SHOW,           ///< Anzeigen der Geräte aktualisieren
+    LEDS            ///< LED-Matrix ausgeben
+};
+const uint8_t NO_OF_TRACE_PHASES = static_cast<uint8_t>(TracePhase::LEDS) + 1;    ///< Anzahl Phasen
+
+
+/***************************************************************************************************
+ * @brief Diagnose-Funktionen für die Fehlersuche am PC.
+ *
+ * - Zeitabgleich: Auf "SYS;PING;<Id>" antwortet der Arduino sofort mit "SYS;PONG;<Id>;<micros()>".
+ *   Aus Sende- und Empfangszeit am PC und dem Zeitstempel des Arduino kann der PC die Uhr des Arduino
+ *   auf die eigene Zeitachse umrechnen.
+ * - Tracing: Nach "SYS;TRC;<Schwelle>" sendet der Arduino jede Phase des loop(), die mindestens
+ *   <Schwelle> Mikrosekunden gedauert hat, als "SYS;<Phase>;<Start in µs>;<Dauer in µs>". Ohne
+ *   Parameter wird das Tracing ausgeschaltet. Ausgeschaltet kostet jede Phase nur eine Abfrage von
+ *   @em isTracing.
+ * - Statistik: Auf "SYS;STAT" sendet der Arduino die mittlere und die max. Dauer des loop() seit der
+ *   letzten Abfrage ("SYS;LOOP;<Mittel>;<Max>") sowie das freie RAM zwischen Heap und Stack
+ *   ("SYS;RAM;<frei>;<kleinster Wert>"). Die Zähler werden danach zurückgesetzt. Gemessen wird je
+ *   loop() nur ein micros(), eine Addition und das freie RAM für den kleinsten Wert; der Mittelwert
+ *   wird erst bei der Abfrage berechnet.
+ * - Benchmark: Nur mit dem Build-Flag @em XPANINO_BENCHMARK, siehe @ref Benchmark.
+ *
+ **************************************************************************************************/
+class Diagnostics : public Device {
+public:
+    Diagnostics();
+
+    /**
+     * @brief Vom PC empfangene Diagnose-Kommandos verarbeiten.
+     *
+     * @param event Das zu verarbeitende Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Den Beginn einer Phase des loop() markieren; die vorherige Phase endet damit.
+     *
+     * @param phase Die beginnende Phase.
+     */
+    inline void beginPhase(TracePhase phase) {
+        if (isTracing) {
+            traceSpan(static_cast<uint8_t>(phase));
+        }
+    }
+
+
+    /// @brief Das Ende des loop() markieren; die letzte Phase endet damit.
+    void endLoop();
+
+private:
+    bool isTracing;                     ///< Tracing ist eingeschaltet
+    unsigned long traceThreshold;       ///< Nur Phasen ab dieser Dauer in µs senden
+    uint8_t currentPhase;               ///< Laufende Phase; NO_OF_TRACE_PHASES = keine
+    unsigned long phaseStart;           ///< Beginn der laufenden Phase (micros())
+    unsigned long loopEnd;              ///< Ende des letzten loop() (micros())
+    unsigned long loopTimeSum;          ///< Summe der Dauer aller loop() seit der letzten Abfrage in µs
+    unsigned long loopTimeMax;          ///< Max. Dauer eines loop() seit der letzten Abfrage in µs
+    uint16_t loopCount;                 ///< Anzahl loop() seit der letzten Abfrage
+    int minFreeRam;                     ///< Kleinstes am Ende eines loop() gemessenes freies RAM in Byte
+
+    /// Die laufende Phase beenden, ggf. senden und die nächste Phase beginnen.
+    void traceSpan(uint8_t nextPhase);
+
+    /// Statistik senden und zurücksetzen.
+    void transmitStats();
+
+    /// Freies RAM zwischen Heap und Stack in Byte.
+    static int freeRam();
+};
@@ -13,21 +13,78 @@
 extern EventQueueClass eventQueue;
 
 
+#ifdef XPANINO_COM_PANEL
+void DispatcherClass::dispatch(EventClass *event) const {
+    if (strcmp(event->device, com.getDeviceName()) == 0) {
+        com.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_READOUT) == 0) {
+        readouts.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_TRAFFIC) == 0) {
+        traffic.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_SYSTEM) == 0) {
+        diagnostics.processEvent(event);
+    } else if (strcmp(event->device, com.getPowerDevice()) == 0) {
+        com.setDevicePower(strcmp(event->event, EVENT_ON) == 0);
+    } else if (strcmp(event->device, BATT_POWER) == 0) {
+        com.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+        readouts.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+        traffic.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+    } else if (strcmp(event->device, AVIONICS_1_POWER) == 0) {
+        com.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+        readouts.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+        traffic.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+    } else {
+        // kein passendes Device gefunden.
+    }
+}
+
+
+bool DispatcherClass::dispatchSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) const {
+    return com.processSwitch(row, col, switchState);
+}
+#else
 void DispatcherClass::dispatch(EventClass *event) const {
     if (strcmp(event->device, DEVICE_M803) == 0) {
         m803.processEvent(event);
     } else if (strcmp(event->device, DEVICE_XPDR) == 0) {
         xpdr.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_READOUT) == 0) {
+        readouts.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_TRAFFIC) == 0) {
+        traffic.processEvent(event);
+    } else if (strcmp(event->device, DEVICE_SYSTEM) == 0) {
+        diagnostics.processEvent(event);
+    } else if (strcmp(event->device, BATT_POWER) == 0) {
+        m803.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+        xpdr.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+        readouts.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+        traffic.setBatteryPower(strcmp(event->event, EVENT_ON) == 0);
+    } else if (strcmp(event->device, AVIONICS_1_POWER) == 0) {
+        m803.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+        xpdr.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+        readouts.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+        traffic.setAvionics1Power(strcmp(event->event, EVENT_ON) == 0);
+    } else if (strcmp(event->device, AVIONICS_2_POWER) == 0) {
+        m803.setAvionics2Power(strcmp(event->event, EVENT_ON) == 0);
+        xpdr.setAvionics2Power(strcmp(event->event, EVENT_ON) == 0);
     } else {
         // kein passendes Device gefunden.
     }
 }
 
 
+bool DispatcherClass::dispatchSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) const {
+    return m803.processSwitch(row, col, switchState) || xpdr.processSwitch(row, col, switchState);
+}
+#endif
+
+
 void DispatcherClass::dispatchAll() {
     EventClass* ptr = eventQueue.getHeadEvent();
     while (ptr != nullptr) {
+        #ifdef DEBUG
         Serial.println(F("---DispatchAll---"));
+        #endif
         dispatch(ptr);
         eventQueue.deleteHeadEvent(ptr);
         ptr = eventQueue.getHeadEvent();
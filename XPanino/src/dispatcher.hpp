@@ -10,12 +10,24 @@
 
 #pragma once
 
+#include <diagnostics.hpp>
 #include <event.hpp>
+#include <readout.hpp>
+#include <traffic.hpp>
+#ifdef XPANINO_COM_PANEL
+#include <com.hpp>
+
+extern ComRadio com;
+#else
 #include <m803.hpp>
 #include <xpdr.hpp>
 
 extern ClockDavtronM803 m803;
 extern TransponderKT76C xpdr;
+#endif
+extern ReadoutDevice readouts;
+extern TrafficAnnunciator traffic;
+extern Diagnostics diagnostics;
 extern EventQueueClass eventQueue;
 
 
@@ -33,6 +45,18 @@ public:
     void dispatch(EventClass *event) const;
 
 
+    /**
+     * @brief Den Status eines Schalters den Geräten zur lokalen Verarbeitung anbieten.
+     *
+     * @param row         Row des Schalters in der Schaltermatrix.
+     * @param col         Col des Schalters in der Schaltermatrix.
+     * @param switchState @em SWITCH_STATE_OFF, @em SWITCH_STATE_ON oder @em SWITCH_STATE_LONG_ON.
+     * @return @em true falls ein Gerät den Schalter verarbeitet hat. Der Status muss dann nicht
+     *         an den PC übertragen werden.
+     */
+    bool dispatchSwitch(uint8_t row, uint8_t col, uint8_t switchState) const;
+
+
     /**
      * @brief dispatch all events in the event queue.
      *
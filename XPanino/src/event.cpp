@@ -19,11 +19,54 @@
  *
  ************************************************************************************************************/
 
+/*********************************************************************************************************//**
+ * @brief Pool für die Events
+ *
+ ************************************************************************************************************/
+
+/// Ein Platz im Pool; solange er frei ist, dient er als Element der Liste der freien Plätze.
+union EventPoolSlot {
+    EventPoolSlot *nextFree;                        ///< Nächster freier Platz
+    alignas(EventClass) uint8_t event[sizeof(EventClass)];  ///< Speicher für ein Event
+};
+
+EventPoolSlot eventPool[EVENT_POOL_SIZE];           ///< Speicher aller Events
+EventPoolSlot *freeEventSlots = nullptr;            ///< Liste der freien Plätze
+bool isEventPoolInitialized = false;                ///< Die Liste der freien Plätze wurde aufgebaut
+
+
 /*********************************************************************************************************//**
  * @brief Event - public Methoden
  *
  ************************************************************************************************************/
 
+void *EventClass::operator new(const size_t size) noexcept {
+    if (! isEventPoolInitialized) {
+        // Beim ersten Aufruf alle Plätze in die Liste der freien Plätze eintragen.
+        for (uint8_t index = 0; index != EVENT_POOL_SIZE; ++index) {
+            eventPool[index].nextFree = freeEventSlots;
+            freeEventSlots = &eventPool[index];
+        }
+        isEventPoolInitialized = true;
+    }
+    if ((size > sizeof(EventPoolSlot)) || (freeEventSlots == nullptr)) {
+        return nullptr;
+    }
+    EventPoolSlot *slot = freeEventSlots;
+    freeEventSlots = slot->nextFree;
+    return slot;
+}
+
+
+void EventClass::operator delete(void *ptr) noexcept {
+    if (ptr != nullptr) {
+        EventPoolSlot *slot = static_cast<EventPoolSlot *>(ptr);
+        slot->nextFree = freeEventSlots;
+        freeEventSlots = slot;
+    }
+}
+
+
 /**
  * @brief Konstruktor
  */
@@ -16,11 +16,17 @@
 // Einige Konstanten für die Stringlängen
 const uint8_t MAX_SRC_DEV_LENGTH = 5;   ///< Max. Länge für je Kommando, Source und Device = 4 zzgl. '\0'.
 const uint8_t MAX_PARA_LENGTH = 7;      ///< Max. Länge der geparsten Kommandoparameter = 6 zzgl. '\0'.
+const uint8_t EVENT_POOL_SIZE = 8;      ///< Max. Anzahl gleichzeitig vorhandener Events (vgl. EventClass::operator new)
 
 
 /*********************************************************************************************************//**
  * @brief Event - Daten zum Event, das noch abgearbeitet werden muss
  *
+ * Events werden mit @em new angelegt und mit @em delete freigegeben. Der Speicher kommt dabei nicht
+ * vom Heap, sondern aus einem festen Pool mit EVENT_POOL_SIZE Plätzen, so dass der Heap auch bei
+ * langem Betrieb nicht fragmentiert. Ist der Pool erschöpft, liefert @em new nullptr; das Event geht
+ * dann verloren.
+ *
  ************************************************************************************************************/
 class EventClass {
 public:
@@ -34,6 +40,12 @@ public:
     EventClass* getNext();
     void printEvent();
 
+    /// @brief Einen freien Platz aus dem Pool holen; nullptr, falls alle Plätze belegt sind.
+    static void *operator new(size_t size) noexcept;
+
+    /// @brief Den Platz an den Pool zurückgeben.
+    static void operator delete(void *ptr) noexcept;
+
 private:
     EventClass* next = nullptr;         ///< Zeiger auf das nächste Event in der Liste
 };
@@ -0,0 +1,113 @@
+/***************************************************************************************************
+ * @file hal.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Hardware-Abstraktion (HAL) für Pins, Uhr und serielle Schnittstelle.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+
+/***************************************************************************************************
+ * @brief Schnittstelle der Hardware-Abstraktion als CRTP-Basisklasse.
+ *
+ * Die Geräte und Matrizen greifen nicht direkt auf digitalWrite(), millis(), Serial usw. zu, sondern
+ * nur über die Klasse @em Hal. Welche Implementierung dahinter steht, wird beim Übersetzen
+ * festgelegt (siehe unten); alle Methoden sind statisch und inline, so dass kein virtueller Aufruf
+ * und kein zusätzlicher Speicher entsteht. Eine Implementierung @em Impl leitet von
+ * HalBase<Impl> ab und stellt die Methoden mit der Endung @em Impl bereit.
+ *
+ * Periodische Vorgänge (Blinken, Timer der Zustandsautomaten, Sendepuffer, Stoppuhren) werden in der
+ * Firmware durch Differenzen der monotonen Uhr millis() bzw. micros() gesteuert; eigene
+ * Hardware-Timer werden deshalb nicht benötigt.
+ *
+ * @tparam Impl Die konkrete Implementierung, z.B. @em AvrHal, @em ArduinoHal oder @em HostHal.
+ **************************************************************************************************/
+template <class Impl>
+class HalBase {
+public:
+    /// @name GPIO
+    /// @{
+    /// @brief Pin als Ausgang schalten.
+    static inline void pinOutput(const uint8_t pin) { Impl::pinOutputImpl(pin); }
+
+    /// @brief Pin als Eingang mit Pullup-Widerstand schalten.
+    static inline void pinInputPullup(const uint8_t pin) { Impl::pinInputPullupImpl(pin); }
+
+    /// @brief Ausgang auf @em HIGH (@em true) oder @em LOW (@em false) setzen.
+    static inline void pinWrite(const uint8_t pin, const bool level) { Impl::pinWriteImpl(pin, level); }
+
+    /// @brief Eingang lesen; @em true = @em HIGH.
+    static inline bool pinRead(const uint8_t pin) { return Impl::pinReadImpl(pin); }
+    /// @}
+
+    /// @name Monotone Uhr
+    /// @{
+    /// @brief Millisekunden seit dem Start; läuft nach ca. 50 Tagen über.
+    static inline unsigned long millis() { return Impl::millisImpl(); }
+
+    /// @brief Mikrosekunden seit dem Start; läuft nach ca. 71 Minuten über.
+    static inline unsigned long micros() { return Impl::microsImpl(); }
+
+    /// @brief Aktiv warten.
+    static inline void delayMillis(const unsigned long ms) { Impl::delayMillisImpl(ms); }
+
+    /// @brief Aktiv warten.
+    static inline void delayMicros(const unsigned int us) { Impl::delayMicrosImpl(us); }
+    /// @}
+
+    /// @name Serielle Schnittstelle (UART)
+    /// @{
+    /// @brief Schnittstelle mit 8N1 öffnen und den Empfangspuffer leeren.
+    static inline void uartBegin(const unsigned long baudrate) { Impl::uartBeginImpl(baudrate); }
+
+    /// @brief Zeichen in den Sendepuffer schreiben.
+    static inline void uartWrite(const char *buffer, const size_t length) { Impl::uartWriteImpl(buffer, length); }
+
+    /**
+     * @brief Konstanten Text aus dem Flash senden, z.B. `Hal::uartPrintFlash(PSTR("XPanino\r\n"))`.
+     *
+     * Für Meldungen außerhalb des Protokolls (Begrüßung, Fehler); Nachrichten des Protokolls gehen
+     * über den TxBuffer.
+     */
+    static inline void uartPrintFlash(const char *text) { Impl::uartPrintFlashImpl(text); }
+
+    /// @brief Warten, bis der Sendepuffer vollständig gesendet ist.
+    static inline void uartFlush() { Impl::uartFlushImpl(); }
+
+    /// @brief Anzahl empfangener, noch nicht gelesener Zeichen.
+    static inline int uartAvailable() { return Impl::uartAvailableImpl(); }
+
+    /// @brief Nächstes empfangenes Zeichen lesen; -1, falls keines vorliegt.
+    static inline int uartRead() { return Impl::uartReadImpl(); }
+    /// @}
+
+    /// @name Nebenläufigkeit
+    /// @{
+    /**
+     * @brief Speicherbarriere.
+     *
+     * Schreib- und Lesezugriffe werden weder vom Compiler noch von der CPU über die Barriere hinweg
+     * umsortiert. Wird von SpscQueue und dem Doppelpuffer der LedMatrix zwischen zwei Kernen
+     * (@em XPANINO_DUAL_CORE) benötigt.
+     */
+    static inline void memoryBarrier() { Impl::memoryBarrierImpl(); }
+    /// @}
+};
+
+
+#if defined(ARDUINO_ARCH_AVR) && defined(__AVR_ATmega328P__)
+#include <hal_avr.hpp>
+using Hal = AvrHal;     ///< Auf dem Arduino Uno
+#elif defined(ARDUINO)
+#include <hal_arduino.hpp>
+using Hal = ArduinoHal; ///< Auf anderen Boards mit Arduino-Core, z.B. Arduino Micro oder Raspberry Pi Pico
+#else
+#include <hal_host.hpp>
+using Hal = HostHal;    ///< Auf dem PC, z.B. für Tests und Simulationen
+#endif
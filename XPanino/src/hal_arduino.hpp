@@ -0,0 +1,68 @@
+/***************************************************************************************************
+ * @file hal_arduino.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Hardware-Abstraktion über die allgemeine Arduino-API.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+// Nicht direkt einbinden, sondern über hal.hpp; dort ist HalBase definiert.
+
+
+/***************************************************************************************************
+ * @brief Hardware-Abstraktion für Boards ohne eigene Implementierung, z.B. den Arduino Micro
+ *        (ATmega32u4) oder den Raspberry Pi Pico.
+ *
+ * Reicht alle Aufrufe an die Arduino-API (pinMode(), digitalWrite(), millis(), Serial usw.) weiter.
+ * Die Pin-Nummern sind die des jeweiligen Boards, beim Pico also die GPIO-Nummern.
+ *
+ **************************************************************************************************/
+class ArduinoHal : public HalBase<ArduinoHal> {
+    friend class HalBase<ArduinoHal>;
+
+    static inline void pinOutputImpl(const uint8_t pin) { pinMode(pin, OUTPUT); }
+    static inline void pinInputPullupImpl(const uint8_t pin) { pinMode(pin, INPUT_PULLUP); }
+    static inline void pinWriteImpl(const uint8_t pin, const bool level) { digitalWrite(pin, level ? HIGH : LOW); }
+    static inline bool pinReadImpl(const uint8_t pin) { return digitalRead(pin) == HIGH; }
+
+    static inline unsigned long millisImpl() { return ::millis(); }
+    static inline unsigned long microsImpl() { return ::micros(); }
+    static inline void delayMillisImpl(const unsigned long ms) { ::delay(ms); }
+    static inline void delayMicrosImpl(const unsigned int us) { ::delayMicroseconds(us); }
+
+    static inline void uartBeginImpl(const unsigned long baudrate) {
+        Serial.begin(baudrate);
+        // wait for serial port to connect. Needed for native USB
+        while (!Serial) {}
+        // Lesepuffer leeren
+        while (Serial.available() > 0) {
+            Serial.read();
+        }
+    }
+
+    static inline void uartWriteImpl(const char *buffer, const size_t length) {
+        Serial.write(reinterpret_cast<const uint8_t *>(buffer), length);
+    }
+
+    static inline void uartPrintFlashImpl(const char *text) {
+        Serial.print(reinterpret_cast<const __FlashStringHelper *>(text));
+    }
+
+    static inline void uartFlushImpl() { Serial.flush(); }
+    static inline int uartAvailableImpl() { return Serial.available(); }
+    static inline int uartReadImpl() { return Serial.read(); }
+
+    static inline void memoryBarrierImpl() {
+        #ifdef __AVR__
+        __asm__ __volatile__("" ::: "memory");     // AVR: nur ein Kern, vgl. AvrHal
+        #else
+        __sync_synchronize();
+        #endif
+    }
+};
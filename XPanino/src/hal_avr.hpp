@@ -0,0 +1,114 @@
+/***************************************************************************************************
+ * @file hal_avr.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Hardware-Abstraktion für den Arduino Uno (ATmega328P).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+#if !defined(__AVR_ATmega328P__)
+#error "AvrHal kennt nur die Pinbelegung des Arduino Uno (ATmega328P)."
+#endif
+
+// Nicht direkt einbinden, sondern über hal.hpp; dort ist HalBase definiert.
+
+
+/***************************************************************************************************
+ * @brief Hardware-Abstraktion für den Arduino Uno.
+ *
+ * Die Pins werden direkt über die Port-Register angesprochen (Pins 0-7 = PORTD, 8-13 = PORTB,
+ * 14-19 = PORTC). Ist die Pin-Nummer eine Konstante, wird daraus nach dem Inlining ein einziger
+ * sbi/cbi-Befehl; digitalWrite() braucht dagegen mehrere Mikrosekunden je Aufruf. Die Pins werden
+ * nicht für PWM verwendet, deshalb muss kein Timer abgeschaltet werden.
+ *
+ **************************************************************************************************/
+class AvrHal : public HalBase<AvrHal> {
+    friend class HalBase<AvrHal>;
+
+    /// Ausgangsregister des Ports, zu dem der Pin gehört.
+    static inline volatile uint8_t &portRegister(const uint8_t pin) {
+        return (pin < 8) ? PORTD : ((pin < 14) ? PORTB : PORTC);
+    }
+
+    /// Richtungsregister des Ports, zu dem der Pin gehört.
+    static inline volatile uint8_t &ddrRegister(const uint8_t pin) {
+        return (pin < 8) ? DDRD : ((pin < 14) ? DDRB : DDRC);
+    }
+
+    /// Eingangsregister des Ports, zu dem der Pin gehört.
+    static inline volatile uint8_t &pinRegister(const uint8_t pin) {
+        return (pin < 8) ? PIND : ((pin < 14) ? PINB : PINC);
+    }
+
+    /// Bitmaske des Pins im Port.
+    static inline uint8_t pinMask(const uint8_t pin) {
+        return static_cast<uint8_t>(1 << ((pin < 8) ? pin : ((pin < 14) ? pin - 8 : pin - 14)));
+    }
+
+    static inline void pinOutputImpl(const uint8_t pin) {
+        const uint8_t oldSREG = SREG;
+        cli();
+        ddrRegister(pin) |= pinMask(pin);
+        SREG = oldSREG;
+    }
+
+    static inline void pinInputPullupImpl(const uint8_t pin) {
+        const uint8_t oldSREG = SREG;
+        cli();
+        ddrRegister(pin) &= static_cast<uint8_t>(~pinMask(pin));
+        portRegister(pin) |= pinMask(pin);
+        SREG = oldSREG;
+    }
+
+    static inline void pinWriteImpl(const uint8_t pin, const bool level) {
+        // Bei konstantem Pin atomar (sbi/cbi); sonst wie digitalWrite() mit gesperrten Interrupts.
+        const uint8_t oldSREG = SREG;
+        cli();
+        if (level) {
+            portRegister(pin) |= pinMask(pin);
+        } else {
+            portRegister(pin) &= static_cast<uint8_t>(~pinMask(pin));
+        }
+        SREG = oldSREG;
+    }
+
+    static inline bool pinReadImpl(const uint8_t pin) { return (pinRegister(pin) & pinMask(pin)) != 0; }
+
+    static inline unsigned long millisImpl() { return ::millis(); }
+    static inline unsigned long microsImpl() { return ::micros(); }
+    static inline void delayMillisImpl(const unsigned long ms) { ::delay(ms); }
+    static inline void delayMicrosImpl(const unsigned int us) { ::delayMicroseconds(us); }
+
+    static inline void uartBeginImpl(const unsigned long baudrate) {
+        Serial.begin(baudrate, SERIAL_8N1);
+        // wait for serial port to connect. Needed for native USB
+        while (!Serial) {}
+        // Schreibpuffer leeren
+        Serial.flush();
+        // Lesepuffer leeren
+        while (Serial.available() > 0) {
+            Serial.read();
+        }
+    }
+
+    static inline void uartWriteImpl(const char *buffer, const size_t length) {
+        Serial.write(reinterpret_cast<const uint8_t *>(buffer), length);
+    }
+
+    static inline void uartPrintFlashImpl(const char *text) {
+        Serial.print(reinterpret_cast<const __FlashStringHelper *>(text));
+    }
+
+    static inline void uartFlushImpl() { Serial.flush(); }
+    static inline int uartAvailableImpl() { return Serial.available(); }
+    static inline int uartReadImpl() { return Serial.read(); }
+
+    // Nur ein Kern: Es genügt, dass der Compiler nicht umsortiert.
+    static inline void memoryBarrierImpl() { __asm__ __volatile__("" ::: "memory"); }
+};
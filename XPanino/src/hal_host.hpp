@@ -0,0 +1,206 @@
+/***************************************************************************************************
+ * @file hal_host.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Hardware-Abstraktion für den PC (Tests und Simulationen).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>     // auf dem PC der Ersatz aus test/host/shim
+#include <string.h>
+
+// Nicht direkt einbinden, sondern über hal.hpp; dort ist HalBase definiert.
+
+const uint8_t HOST_HAL_PINS = 20;           ///< Anzahl simulierter Pins (wie beim Arduino Uno)
+const uint8_t HOST_HAL_RX_SIZE = 64;        ///< Größe des simulierten Empfangspuffers (wie beim Arduino Uno)
+const size_t HOST_HAL_TX_SIZE = 4096;       ///< Größe des Puffers für die gesendeten Zeichen
+
+
+/***************************************************************************************************
+ * @brief Hardware-Abstraktion für den PC.
+ *
+ * Simuliert die Pins, eine Uhr und die serielle Schnittstelle, so dass die Firmware ohne Arduino
+ * übersetzt und getestet werden kann:
+ * - Die Uhr steht, bis sie mit advanceMicros() weitergestellt wird; delayMillis() und
+ *   delayMicros() stellen sie ebenfalls weiter. Ist mit setClock() eine Uhr gesetzt (z.B. die
+ *   Echtzeit für Laufzeitmessungen), liefert micros() deren Wert und die Verzögerungen warten aktiv.
+ * - Die Pegel der Eingänge werden mit setInput() vorgegeben; unbeschaltete Eingänge mit Pullup
+ *   lesen sich als @em HIGH. Die Ausgänge können mit output() abgefragt werden; eine mit
+ *   setPinWriteHandler() gesetzte Funktion bekommt zusätzlich jeden geschriebenen Pegel.
+ * - Mit receive() werden Zeichen in den Empfangspuffer gelegt. Gesendete Zeichen werden gesammelt
+ *   und können mit transmitted() abgefragt und mit clearTransmitted() gelöscht werden; was nicht
+ *   mehr in den Puffer passt, geht verloren. transmitCount() zählt die Aufrufe von uartWrite(), d.h.
+ *   die einzeln gesendeten Pakete. Ist mit setTransmitHandler() eine Funktion gesetzt, bekommt sie
+ *   jedes Paket, statt dass es gesammelt wird (z.B. um es an ein Pseudo-Terminal weiterzugeben).
+ *
+ * Der Zustand liegt in funktionslokalen statischen Variablen, deshalb kommt die Klasse ohne
+ * eigene .cpp-Datei aus.
+ *
+ **************************************************************************************************/
+class HostHal : public HalBase<HostHal> {
+    friend class HalBase<HostHal>;
+
+public:
+    /// @brief Simulierte Uhr um @em us Mikrosekunden weiterstellen.
+    static inline void advanceMicros(const unsigned long us) { state().now += us; }
+
+    /// @brief Uhr in µs setzen, die statt der simulierten Uhr gilt; @em nullptr: simulierte Uhr.
+    static inline void setClock(unsigned long (*clock)()) { state().clock = clock; }
+
+    /// @brief Pegel eines Eingangs vorgeben; @em true = @em HIGH.
+    static inline void setInput(const uint8_t pin, const bool level) {
+        if (pin < HOST_HAL_PINS) {
+            state().inputs[pin] = level;
+        }
+    }
+
+    /// @brief Funktion, die jeden mit pinWrite() geschriebenen Pegel bekommt; @em nullptr = keine.
+    static inline void setPinWriteHandler(void (*handler)(uint8_t pin, bool level)) {
+        state().pinHandler = handler;
+    }
+
+    /// @brief Zuletzt geschriebener Pegel eines Ausgangs.
+    static inline bool output(const uint8_t pin) { return (pin < HOST_HAL_PINS) && state().outputs[pin]; }
+
+    /// @brief Zeichen in den Empfangspuffer legen; was nicht mehr hineinpasst, geht verloren.
+    static inline void receive(const char *text) {
+        State &s = state();
+        for (; *text != '\0'; ++text) {
+            const uint8_t next = static_cast<uint8_t>((s.rxHead + 1) % HOST_HAL_RX_SIZE);
+            if (next == s.rxTail) {
+                return;
+            }
+            s.rx[s.rxHead] = *text;
+            s.rxHead = next;
+        }
+    }
+
+    /// @brief Bisher gesendete Zeichen als C-String.
+    static inline const char *transmitted() { return state().tx; }
+
+    /// @brief Anzahl der Aufrufe von uartWrite() seit dem Start.
+    static inline unsigned long transmitCount() { return state().txCount; }
+
+    /// @brief Funktion, die jedes gesendete Paket bekommt; @em nullptr = Zeichen sammeln.
+    static inline void setTransmitHandler(void (*handler)(const char *buffer, size_t length)) {
+        state().txHandler = handler;
+    }
+
+    /// @brief Gesendete Zeichen löschen.
+    static inline void clearTransmitted() {
+        state().txLength = 0;
+        state().tx[0] = '\0';
+    }
+
+private:
+    /// Zustand der simulierten Hardware.
+    struct State {
+        unsigned long now;
+        bool outputs[HOST_HAL_PINS];
+        bool inputs[HOST_HAL_PINS];
+        char rx[HOST_HAL_RX_SIZE];
+        uint8_t rxHead;
+        uint8_t rxTail;
+        char tx[HOST_HAL_TX_SIZE];
+        size_t txLength;
+        unsigned long txCount;
+        void (*txHandler)(const char *buffer, size_t length);
+        unsigned long (*clock)();
+        void (*pinHandler)(uint8_t pin, bool level);
+
+        State()
+            : now(0), rxHead(0), rxTail(0), txLength(0), txCount(0), txHandler(nullptr), clock(nullptr),
+              pinHandler(nullptr) {
+            tx[0] = '\0';
+            for (uint8_t pin = 0; pin < HOST_HAL_PINS; ++pin) {
+                outputs[pin] = false;
+                inputs[pin] = true;
+            }
+        }
+    };
+
+    static inline State &state() {
+        static State s;
+        return s;
+    }
+
+    static inline void pinOutputImpl(const uint8_t pin) { (void)pin; }
+    static inline void pinInputPullupImpl(const uint8_t pin) { (void)pin; }
+
+    static inline void pinWriteImpl(const uint8_t pin, const bool level) {
+        State &s = state();
+        if (pin < HOST_HAL_PINS) {
+            s.outputs[pin] = level;
+        }
+        if (s.pinHandler != nullptr) {
+            s.pinHandler(pin, level);
+        }
+    }
+
+    static inline bool pinReadImpl(const uint8_t pin) { return (pin >= HOST_HAL_PINS) || state().inputs[pin]; }
+
+    static inline unsigned long millisImpl() { return microsImpl() / 1000; }
+
+    static inline unsigned long microsImpl() {
+        const State &s = state();
+        return (s.clock != nullptr) ? s.clock() : s.now;
+    }
+
+    static inline void delayMillisImpl(const unsigned long ms) { wait(ms * 1000); }
+    static inline void delayMicrosImpl(const unsigned int us) { wait(us); }
+
+    /// Simulierte Uhr weiterstellen bzw. auf die mit setClock() gesetzte Uhr warten.
+    static inline void wait(const unsigned long us) {
+        State &s = state();
+        if (s.clock != nullptr) {
+            const unsigned long start = s.clock();
+            while (s.clock() - start < us) {
+            }
+        } else {
+            s.now += us;
+        }
+    }
+
+    static inline void uartBeginImpl(const unsigned long baudrate) {
+        (void)baudrate;
+        state().rxTail = state().rxHead;
+    }
+
+    static inline void uartWriteImpl(const char *buffer, const size_t length) {
+        State &s = state();
+        ++s.txCount;
+        if (s.txHandler != nullptr) {
+            s.txHandler(buffer, length);
+            return;
+        }
+        const size_t count = min(length, HOST_HAL_TX_SIZE - 1 - s.txLength);
+        memcpy(s.tx + s.txLength, buffer, count);
+        s.txLength += count;
+        s.tx[s.txLength] = '\0';
+    }
+
+    static inline void uartPrintFlashImpl(const char *text) { uartWriteImpl(text, strlen(text)); }
+
+    static inline void uartFlushImpl() {}
+
+    static inline int uartAvailableImpl() {
+        const State &s = state();
+        return (s.rxHead + HOST_HAL_RX_SIZE - s.rxTail) % HOST_HAL_RX_SIZE;
+    }
+
+    static inline int uartReadImpl() {
+        State &s = state();
+        if (s.rxHead == s.rxTail) {
+            return -1;
+        }
+        const char c = s.rx[s.rxTail];
+        s.rxTail = static_cast<uint8_t>((s.rxTail + 1) % HOST_HAL_RX_SIZE);
+        return static_cast<unsigned char>(c);
+    }
+
+    static inline void memoryBarrierImpl() { __sync_synchronize(); }
+};
@@ -0,0 +1,315 @@
+/***************************************************************************************************
+ * @file hsm.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Tabellengesteuerter, hierarchischer Zustandsautomat (HSM) für die Betriebsmodi der Geräte.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Die Zustands- und Übergangstabellen liegen im Flash (PROGMEM). Ein Event wird je Hierarchieebene
+ * mit genau einem Tabellenzugriff verarbeitet (Index = Zustand x Event); da die Schachtelungstiefe
+ * auf @em HSM_MAX_DEPTH begrenzt ist, ist die Verarbeitung eines Events O(1).
+ * Aktionen und Guards sind statische Funktionen des Geräts, die über einen Index in einer
+ * Funktionszeigertabelle (ebenfalls im Flash) aufgerufen werden. Virtuelle Aufrufe gibt es nicht.
+ *
+ * Konventionen für die Tabellen:
+ * - Zustands-Ids beginnen bei 1. Die Id 0 (@em HSM_NO_STATE) steht für "kein Zustand", d.h.\ die
+ *   oberste Ebene bzw.\ "keine Transition". Dadurch bedeuten nicht angegebene (mit 0 initialisierte)
+ *   Tabelleneinträge automatisch "Event wird in diesem Zustand nicht behandelt".
+ * - Der Index 0 in der Aktions- und Guard-Tabelle steht für "keine Aktion" bzw.\ "kein Guard".
+ * - Die Übergangstabelle hat je Zustand eine Zeile mit je einem Eintrag je Event.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <hal.hpp>
+
+const uint8_t HSM_NO_STATE = 0;       ///< Kein Zustand bzw. keine Transition.
+const uint8_t HSM_INTERNAL = 0xFF;    ///< Interne Transition: nur die Aktion ausführen, Zustand bleibt.
+const uint8_t HSM_NO_FUNC = 0;        ///< Keine Aktion bzw. kein Guard.
+const uint8_t HSM_MAX_DEPTH = 4;      ///< Maximale Schachtelungstiefe der Zustände.
+
+
+/***************************************************************************************************
+ * @brief Beschreibung eines Zustands in der Zustandstabelle.
+ *
+ */
+class HsmState {
+public:
+    uint8_t parent;     ///< Übergeordneter Zustand oder @em HSM_NO_STATE.
+    uint8_t initial;    ///< Bei zusammengesetzten Zuständen der Startzustand, sonst @em HSM_NO_STATE.
+    uint8_t entry;      ///< Index der Entry-Aktion oder @em HSM_NO_FUNC.
+    uint8_t exit;       ///< Index der Exit-Aktion oder @em HSM_NO_FUNC.
+};
+
+
+/***************************************************************************************************
+ * @brief Ein Eintrag der Übergangstabelle.
+ *
+ */
+class HsmTransition {
+public:
+    uint8_t target;     ///< Zielzustand, @em HSM_INTERNAL oder @em HSM_NO_STATE (= nicht behandelt).
+    uint8_t action;     ///< Index der Transitionsaktion oder @em HSM_NO_FUNC.
+    uint8_t guard;      ///< Index des Guards oder @em HSM_NO_FUNC.
+};
+
+
+/**
+ * @brief Eintrag der Übergangstabelle erzeugen.
+ *
+ * @param target Zielzustand bzw. @em HSM_INTERNAL.
+ * @param action Index der Transitionsaktion. Optionaler Parameter.
+ * @param guard  Index des Guards. Optionaler Parameter.
+ */
+constexpr HsmTransition hsmTo(const uint8_t target, const uint8_t action = HSM_NO_FUNC,
+                              const uint8_t guard = HSM_NO_FUNC) {
+    return HsmTransition{target, action, guard};
+}
+
+
+/**
+ * @brief Eintrag der Übergangstabelle für eine interne Transition (nur Aktion) erzeugen.
+ *
+ * @param action Index der Aktion.
+ * @param guard  Index des Guards. Optionaler Parameter.
+ */
+constexpr HsmTransition hsmDo(const uint8_t action, const uint8_t guard = HSM_NO_FUNC) {
+    return HsmTransition{HSM_INTERNAL, action, guard};
+}
+
+
+/**
+ * @brief Eintrag der Übergangstabelle für "Event wird hier nicht behandelt".
+ */
+constexpr HsmTransition hsmNone() {
+    return HsmTransition{HSM_NO_STATE, HSM_NO_FUNC, HSM_NO_FUNC};
+}
+
+
+template <class Owner> using HsmAction = void (*)(Owner &owner);   ///< Aktion (Entry, Exit, Transition)
+template <class Owner> using HsmGuard = bool (*)(Owner &owner);    ///< Guard einer Transition
+
+
+/***************************************************************************************************
+ * @brief Verweise auf die (im Flash liegenden) Tabellen eines Zustandsautomaten.
+ *
+ */
+template <class Owner>
+class HsmDefinition {
+public:
+    const HsmState *states;             ///< Zustandstabelle (PROGMEM), Index = Zustand - 1.
+    const HsmTransition *transitions;   ///< Übergangstabelle (PROGMEM), Index = (Zustand - 1) * noOfEvents + Event.
+    const HsmAction<Owner> *actions;    ///< Aktionstabelle (PROGMEM), Index 0 ist unbelegt.
+    const HsmGuard<Owner> *guards;      ///< Guardtabelle (PROGMEM), Index 0 ist unbelegt.
+    uint8_t noOfStates;                 ///< Anzahl Zustände.
+    uint8_t noOfEvents;                 ///< Anzahl Events.
+    uint8_t timeoutEvent;               ///< Event, das beim Ablauf des Timers ausgelöst wird.
+};
+
+
+/***************************************************************************************************
+ * @brief Hierarchischer Zustandsautomat.
+ *
+ * Der Automat gehört zu einem Gerät (@em Owner), dessen statische Funktionen als Aktionen und Guards
+ * aufgerufen werden. Je Automat gibt es einen Timer; läuft er ab, wird das Timeout-Event verarbeitet.
+ * Bei jedem Zustandswechsel wird der Timer gestoppt, bevor die Exit-Aktionen aufgerufen werden;
+ * Entry-Aktionen können ihn anschließend neu starten.
+ *
+ * @tparam Owner Klasse des Geräts, zu dem der Automat gehört.
+ */
+template <class Owner>
+class Hsm {
+public:
+    /**
+     * @brief Constructor. Der Automat befindet sich danach in keinem Zustand; siehe @em start().
+     *
+     * @param owner      Gerät, dessen Aktionen und Guards aufgerufen werden.
+     * @param definition Tabellen des Automaten.
+     */
+    Hsm(Owner &owner, const HsmDefinition<Owner> &definition) : owner(owner), def(definition) {}
+
+
+    /**
+     * @brief Den Automaten in den Startzustand bringen und dabei die Entry-Aktionen ausführen.
+     *
+     * @param initialState Startzustand.
+     */
+    void start(const uint8_t initialState) {
+        state = HSM_NO_STATE;
+        enterPath(HSM_NO_STATE, initialState);
+    }
+
+
+    /**
+     * @brief Ein Event verarbeiten.
+     *
+     * Ist im aktuellen Zustand keine Transition für das Event eingetragen oder ist der Guard nicht
+     * erfüllt, wird das Event an den übergeordneten Zustand weitergereicht.
+     *
+     * @param event Nummer des Events.
+     * @return @em true falls das Event verarbeitet wurde, sonst @em false.
+     */
+    bool dispatch(const uint8_t event) {
+        if ((event >= def.noOfEvents) || (state == HSM_NO_STATE)) {
+            return false;
+        }
+        uint8_t source = state;
+        for (uint8_t depth = 0; (depth != HSM_MAX_DEPTH) && (source != HSM_NO_STATE); ++depth) {
+            HsmTransition t;
+            memcpy_P(&t, &def.transitions[(source - 1) * def.noOfEvents + event], sizeof(t));
+            if ((t.target != HSM_NO_STATE) && ((t.guard == HSM_NO_FUNC) || callGuard(t.guard))) {
+                if (t.target == HSM_INTERNAL) {
+                    callAction(t.action);
+                } else {
+                    transition(source, t.target, t.action);
+                }
+                return true;
+            }
+            source = readState(source).parent;
+        }
+        return false;
+    }
+
+
+    /**
+     * @brief Den Timer prüfen und bei Ablauf das Timeout-Event verarbeiten.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     *
+     * @param now Aktueller Zeitstempel in Millisekunden, z.B. millis().
+     */
+    void tick(const unsigned long now) {
+        // Die Differenz ist auch beim Überlauf von millis() korrekt.
+        if (timerActive && (now - timerStart >= timerDuration)) {
+            timerActive = false;
+            dispatch(def.timeoutEvent);
+        }
+    }
+
+
+    /**
+     * @brief Den Timer (neu) starten.
+     *
+     * @param duration Dauer in Millisekunden bis zum Timeout-Event.
+     */
+    void startTimer(const unsigned long duration) {
+        timerStart = Hal::millis();
+        timerDuration = duration;
+        timerActive = true;
+    }
+
+
+    /// @brief Den Timer anhalten.
+    void stopTimer() { timerActive = false; }
+
+
+    /// @brief Den aktuellen (innersten) Zustand abfragen.
+    inline uint8_t getState() const { return state; }
+
+
+    /**
+     * @brief Prüfen, ob sich der Automat im Zustand @em checkState oder einem seiner Unterzustände befindet.
+     *
+     * @param checkState Zu prüfender Zustand.
+     */
+    bool isIn(const uint8_t checkState) const {
+        uint8_t s = state;
+        for (uint8_t depth = 0; (depth != HSM_MAX_DEPTH) && (s != HSM_NO_STATE); ++depth) {
+            if (s == checkState) {
+                return true;
+            }
+            s = readState(s).parent;
+        }
+        return false;
+    }
+
+private:
+    Owner &owner;                       ///< Gerät, zu dem der Automat gehört.
+    const HsmDefinition<Owner> &def;    ///< Tabellen des Automaten.
+    uint8_t state{HSM_NO_STATE};        ///< Aktueller (innerster) Zustand.
+    bool timerActive{false};            ///< @em true, solange der Timer läuft.
+    unsigned long timerStart{0};        ///< Startzeitpunkt des Timers in Millisekunden.
+    unsigned long timerDuration{0};     ///< Dauer des Timers in Millisekunden.
+
+    HsmState readState(const uint8_t s) const {
+        HsmState info;
+        memcpy_P(&info, &def.states[s - 1], sizeof(info));
+        return info;
+    }
+
+    void callAction(const uint8_t index) {
+        if (index != HSM_NO_FUNC) {
+            HsmAction<Owner> action;
+            memcpy_P(&action, &def.actions[index], sizeof(action));
+            action(owner);
+        }
+    }
+
+    bool callGuard(const uint8_t index) {
+        HsmGuard<Owner> guard;
+        memcpy_P(&guard, &def.guards[index], sizeof(guard));
+        return guard(owner);
+    }
+
+    /**
+     * @brief Prüfen, ob @em ancestor der Zustand @em s selbst oder ein übergeordneter Zustand von @em s ist.
+     */
+    bool isAncestorOrSelf(const uint8_t ancestor, uint8_t s) const {
+        for (uint8_t depth = 0; (depth != HSM_MAX_DEPTH) && (s != HSM_NO_STATE); ++depth) {
+            if (s == ancestor) {
+                return true;
+            }
+            s = readState(s).parent;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Transition von @em source nach @em target ausführen.
+     *
+     * Verlassen werden alle Zustände vom aktuellen Zustand bis ausschließlich zum gemeinsamen
+     * Vorfahren (LCA) von @em source und @em target. Ist @em target gleich @em source oder ein
+     * übergeordneter Zustand, wird auch dieser verlassen und neu betreten (externe Transition).
+     */
+    void transition(const uint8_t source, const uint8_t target, const uint8_t action) {
+        uint8_t lca = source;
+        for (uint8_t depth = 0; (depth != HSM_MAX_DEPTH) && (lca != HSM_NO_STATE); ++depth) {
+            if ((lca != target) && isAncestorOrSelf(lca, target)) {
+                break;
+            }
+            lca = readState(lca).parent;
+        }
+        timerActive = false;
+        for (uint8_t depth = 0; (depth != HSM_MAX_DEPTH) && (state != lca); ++depth) {
+            const HsmState info = readState(state);
+            callAction(info.exit);
+            state = info.parent;
+        }
+        callAction(action);
+        enterPath(lca, target);
+    }
+
+    /**
+     * @brief Alle Zustände unterhalb von @em from bis einschließlich @em target betreten und
+     *        anschließend ggf.\ den Startzuständen folgen.
+     */
+    void enterPath(const uint8_t from, const uint8_t target) {
+        uint8_t path[HSM_MAX_DEPTH];
+        uint8_t count = 0;
+        for (uint8_t s = target; (s != from) && (s != HSM_NO_STATE) && (count != HSM_MAX_DEPTH);
+                s = readState(s).parent) {
+            path[count++] = s;
+        }
+        while (count != 0) {
+            state = path[--count];
+            callAction(readState(state).entry);
+        }
+        for (uint8_t initial = readState(state).initial; initial != HSM_NO_STATE;
+                initial = readState(state).initial) {
+            state = initial;
+            callAction(readState(state).entry);
+        }
+    }
+};
@@ -9,6 +9,7 @@
  *
  ************************************************************************************************************/
 
+#include <hal.hpp>
 #include <ledmatrix.hpp>
 
 /** Konstanten für die Zuordnung der Arduino-Pins zu den MIC5891- und MIC5821-Schieberegister-Leitungen */
@@ -54,7 +55,7 @@ LedMatrix::LedMatrix() {
             blinkStatus[speedClass][row] = 0;         // Keine LED blinkt
         }
         isBlinkDarkPhase[speedClass] = true;
-        blinkStartTime[speedClass] = millis(); // + speedClass * BLINK_VERSATZ;   // Startzeit mit Versatz
+        blinkStartTime[speedClass] = Hal::millis(); // + speedClass * BLINK_VERSATZ;   // Startzeit mit Versatz
     }
     /// Defaultwerte für die Blinkdauern der Speedklassen der nächsten anstehenden Hellphase
     nextBlinkInterval[BLINK_NORMAL] = blinkTimes[BLINK_NORMAL].getBrightTime();    // Dauer der Hellphase als Initialwert
@@ -68,27 +69,27 @@ LedMatrix::LedMatrix() {
  */
 void LedMatrix::initHardware() {
     /// Die eingebaute LED als Status aktivieren: die LED vier mal ein- und ausschalten
-    pinMode(LED_BUILTIN, OUTPUT);
+    Hal::pinOutput(LED_BUILTIN);
     for (unsigned int i = 1; i != 4; ++i) {
-        digitalWrite(LED_BUILTIN, HIGH);
-        delay(500); // NOLINT
-        digitalWrite(LED_BUILTIN, LOW);
-        delay(500); // NOLINT
+        Hal::pinWrite(LED_BUILTIN, true);
+        Hal::delayMillis(500); // NOLINT
+        Hal::pinWrite(LED_BUILTIN, false);
+        Hal::delayMillis(500); // NOLINT
     }
 
     /// Die benötigten Pins für die Ansteuerung der Schieberegister initialisieren.
-    pinMode(CLOCK, OUTPUT);
-    pinMode(DATA_IN, OUTPUT);
-    pinMode(STRB, OUTPUT);
-    pinMode(OE, OUTPUT);
-    delay(1);   // NOLINT: notwendig, da sonst die folgenden Write-Anweisungen nicht funktionieren
-    digitalWrite(CLOCK, LOW);
-    digitalWrite(DATA_IN, LOW);
-    digitalWrite(STRB, LOW);
-    delayMicroseconds(500); // NOLINT
-    digitalWrite(STRB, HIGH);       // Latches umgehen --> immer auf HIGH setzen
-    digitalWrite(OE, LOW);
-    delayMicroseconds(500);  // NOLINT
+    Hal::pinOutput(CLOCK);
+    Hal::pinOutput(DATA_IN);
+    Hal::pinOutput(STRB);
+    Hal::pinOutput(OE);
+    Hal::delayMillis(1);   // NOLINT: notwendig, da sonst die folgenden Write-Anweisungen nicht funktionieren
+    Hal::pinWrite(CLOCK, false);
+    Hal::pinWrite(DATA_IN, false);
+    Hal::pinWrite(STRB, false);
+    Hal::delayMicros(500); // NOLINT
+    Hal::pinWrite(STRB, true);       // Latches umgehen --> immer auf HIGH setzen
+    Hal::pinWrite(OE, false);
+    Hal::delayMicros(500);  // NOLINT
 }
 
 
@@ -109,17 +110,55 @@ void LedMatrix::initHardware() {
 void LedMatrix::writeToHardware() {
     // Alle Berechnungen zum Blinken erledigen
     doBlink();
-    // Die hwMatrix serialisieren, in die Schieberegister schieben und die Outputs scharf schalten
+    shiftOut(hwMatrix);
+}
+
+
+#ifdef XPANINO_DUAL_CORE
+/**
+ * Der Frame wird nur in den hinteren Puffer geschrieben, wenn der I/O-Kern den zuletzt
+ * bereitgestellten Frame bereits übernommen hat; andernfalls wird dieser Aufruf ausgelassen und der
+ * Frame beim nächsten loop() neu berechnet. Der I/O-Kern liest so nie einen halb geschriebenen Frame.
+ */
+void LedMatrix::updateFrame() {
+    if (isFramePending) {
+        return;
+    }
+    doBlink();
+    memcpy(frames[1 - frontFrame], hwMatrix, sizeof(hwMatrix));
+    Hal::memoryBarrier();   // Frame schreiben, bevor er freigegeben wird
+    isFramePending = true;
+}
+
+
+void LedMatrix::writeFrameToHardware() {
+    if (isFramePending) {
+        Hal::memoryBarrier();   // erst das Flag lesen, dann den Frame
+        frontFrame = static_cast<uint8_t>(1 - frontFrame);
+        Hal::memoryBarrier();   // umschalten, bevor der hintere Puffer wieder beschrieben wird
+        isFramePending = false;
+    }
+    shiftOut(frames[frontFrame]);
+}
+#endif
+
+
+/**
+ * @brief Die Bits der LEDs zeilenweise in die Schieberegister schieben und die Outputs scharf schalten.
+ *
+ * @param rows Status ein/aus je LED, je Zeile ein Element (@em LED_ROWS Elemente).
+ */
+void LedMatrix::shiftOut(const uint32_t *rows) {
     for (uint8_t row = 0; row != LED_ROWS; ++row) {
-        digitalWrite(STRB, LOW);    // STROBE unbedingt auf LOW setzen damit die Registerinhalte in die Latches übernommen werden
+        Hal::pinWrite(STRB, false);    // STROBE unbedingt auf LOW setzen damit die Registerinhalte in die Latches übernommen werden
 
         // die 32 Column-Bits der jeweiligen Row durch/in die Schieberegister schieben
         // NOLINTNEXTLINE
-        for (uint32_t bit = sizeof(hwMatrix[row]) * 8; bit != 0; --bit) {
-            digitalWrite(DATA_IN, (hwMatrix[row] >> (bit - 1)) & 1);  // NOLINT: es funktioniert...
-            digitalWrite(CLOCK, HIGH);                  // DATA_IN in Shift-Register übernehmen
-            delayMicroseconds(1);
-            digitalWrite(CLOCK, LOW);
+        for (uint32_t bit = sizeof(rows[row]) * 8; bit != 0; --bit) {
+            Hal::pinWrite(DATA_IN, ((rows[row] >> (bit - 1)) & 1) != 0);  // NOLINT: es funktioniert...
+            Hal::pinWrite(CLOCK, true);                  // DATA_IN in Shift-Register übernehmen
+            Hal::delayMicros(1);
+            Hal::pinWrite(CLOCK, false);
         }
 
         // nachdem alle Column-Bits übertragen sind, muss noch das zugehörige Row-Bit übertragen werden.
@@ -128,15 +167,15 @@ void LedMatrix::writeToHardware() {
         uint8_t activeRow = static_cast<uint8_t>(1) << row;
         // NOLINTNEXTLINE
         for (uint8_t bit = sizeof(activeRow) * 8; bit != 0; --bit) {
-            digitalWrite(DATA_IN, (activeRow >> (bit - 1)) & 1); // NOLINT
-            digitalWrite(CLOCK, HIGH);                  // DATA_IN in Shift-Register übernehmen
-            delayMicroseconds(1);
-            digitalWrite(CLOCK, LOW);
-            delayMicroseconds(1);
+            Hal::pinWrite(DATA_IN, ((activeRow >> (bit - 1)) & 1) != 0); // NOLINT
+            Hal::pinWrite(CLOCK, true);                  // DATA_IN in Shift-Register übernehmen
+            Hal::delayMicros(1);
+            Hal::pinWrite(CLOCK, false);
+            Hal::delayMicros(1);
         }
 
-        digitalWrite(STRB, HIGH);   // STROBE wieder auf HIGH setzen, damit die Latch-Inhalte auf die Outputs geschaltet werden
-        delayMicroseconds(1);     // lt. Datenblatt erforderlich, aber funktioniert auch ohne
+        Hal::pinWrite(STRB, true);   // STROBE wieder auf HIGH setzen, damit die Latch-Inhalte auf die Outputs geschaltet werden
+        Hal::delayMicros(1);     // lt. Datenblatt erforderlich, aber funktioniert auch ohne
     }
 }
 
@@ -349,11 +388,16 @@ void LedMatrix::defineDisplayField(const uint8_t &fieldId, const uint8_t &led7Se
 };
 
 
+LedMatrixPos LedMatrix::get7SegmentPos(const uint8_t &fieldId, const uint8_t &led7SegmentId) const {
+    return {displays[fieldId].led7SegmentRows[led7SegmentId], displays[fieldId].led7SegmentCol0s[led7SegmentId]};
+}
+
+
 /**
  *
  *
  */
-void LedMatrix::display(const uint8_t &fieldId, const String &outString) {
+void LedMatrix::display(const uint8_t &fieldId, const char *outString) {
     bool dpOn = false;         // Flag, ob Dezimalpunkt im akt. 7-Segment-Display angezeigt wird
     uint8_t dpKorrektur = 0;   // Korrektur zum Positionszähler, falls Dezimalpunkt(e) gefunden
     uint8_t led7SegmentIndex = 0;  // Index für die 7-Segm.-Anz., wo das Zeichen ausgegeben wird
@@ -362,12 +406,17 @@ void LedMatrix::display(const uint8_t &fieldId, const String &outString) {
     uint8_t charBitMap = 0;    // Bitmap des auf der 7-Segment-Anzeige darzustellenden Zeichens
 
     // Den anzuzeigenden outString Zeichen für Zeichen abklappern...
-    for (const auto &outChar : outString) {
+    for (char outChar = *outString; outChar != '\0'; outChar = outString[led7SegmentIndex]) {
         // Konstante zum Ausrechnen des charMapIndex aus dem ASCII-Code
         // Falls das aktuelle Zeichen ein Dezimalpunkt ist, dieses übergehen, da es bereits
         // verarbeitet bzw. anderweitig verarbeitet wird.
         if (outChar == '.') {
             dpKorrektur++;
+        } else if ((led7SegmentIndex - dpKorrektur >= MAX_7SEGMENT_UNITS)
+                   || (led7SegmentIndex - dpKorrektur > displays[fieldId].count7SegmentUnits)) {
+            // Mehr Zeichen als 7-Segment-Anzeigen im Feld; der Rest wird ignoriert. Eine nicht definierte
+            // Anzeige läge auf Row 0, Col 0 und würde dort die Cols 0 bis 7 überschreiben.
+            break;
         } else {
             // Bitmap für das Zeichen holen;
             charBitMap = charMap.get7SegBitMap(outChar);
@@ -456,14 +505,14 @@ void LedMatrix::doBlink() {
     if (blinkOn) {
         /// Check auf Zeitablauf, so dass die Hell- und Dunkelphasen umgeschaltet werden müssen
         for (uint8_t speedClass = 0; speedClass != NO_OF_SPEED_CLASSES; ++speedClass) {
-            if (millis() - blinkStartTime[speedClass] > nextBlinkInterval[speedClass]) {
+            if (Hal::millis() - blinkStartTime[speedClass] > nextBlinkInterval[speedClass]) {
                 if (isBlinkDarkPhase[speedClass]) {
                     nextBlinkInterval[speedClass] = blinkTimes[speedClass].getBrightTime();
                 } else {
                     nextBlinkInterval[speedClass] = blinkTimes[speedClass].getDarkTime();
                 }
                 isBlinkDarkPhase[speedClass] = ! isBlinkDarkPhase[speedClass];
-                blinkStartTime[speedClass] = millis(); // + speedClass * BLINK_VERSATZ;
+                blinkStartTime[speedClass] = Hal::millis(); // + speedClass * BLINK_VERSATZ;
             }
         }
     }
@@ -25,7 +25,7 @@ constexpr const uint32_t LED_COLS = sizeof(uint32_t) * 8;  ///< Anzahl Spalten i
 /// Achtung: durch Verwendung von uint32_t ist die Spaltenzahl immer 32
 
 // Konstanten für die Anzahl und Größe der Display-Felder
-const uint8_t MAX_DISPLAY_FIELDS = 4;       ///< Maximal mögliche Anzahl Display-Felder
+const uint8_t MAX_DISPLAY_FIELDS = 6;       ///< Maximal mögliche Anzahl Display-Felder
 const uint8_t MAX_7SEGMENT_UNITS = 6;       ///< Maximal mögliche Anzahl 7-Segment-Anzeigen je Display-Feld
 
 
@@ -71,7 +71,7 @@ class DisplayField {
 public:
     uint8_t led7SegmentRows[MAX_7SEGMENT_UNITS];    ///< Rows in der LED-Matrix für die einzelnen 7-Segment-Anzeigen.
     uint8_t led7SegmentCol0s[MAX_7SEGMENT_UNITS];   ///< Cols des Segment a in der LED-Matrix für die einzelnen 7-Segment-Anzeigen.
-    uint8_t count7SegmentUnits;                     ///< Anzahl 7-Segment-Anzeigen, aus denen das Display-Feld besteht.
+    uint8_t count7SegmentUnits;                     ///< Index der letzten 7-Segment-Anzeige des Display-Felds (Anzahl - 1).
 };
 
 
@@ -114,6 +114,24 @@ public:
     void writeToHardware();
 
 
+    #ifdef XPANINO_DUAL_CORE
+    /**
+     * @brief Gerätekern: Blinken berechnen und den aktuellen Status aller LEDs als Frame für
+     *        den I/O-Kern bereitstellen.
+     * @note Ersetzt im Dual-Core-Betrieb den Aufruf von writeToHardware() im loop().
+     */
+    void updateFrame();
+
+
+    /**
+     * @brief I/O-Kern: Den zuletzt bereitgestellten Frame übernehmen und an die MIC5891/5821-Chips
+     *        übertragen.
+     * @note Wird im Dual-Core-Betrieb regelmäßig im loop1() aufgerufen.
+     */
+    void writeFrameToHardware();
+    #endif
+
+
     /**
      * @brief Prüfen, ob LED an der Position (@em row, @em col) in der LedMatrix angeschaltet ist.
      *
@@ -278,13 +296,28 @@ public:
 
 
     /**
-     * @brief Einen Wert (String) auf einem Display, d.h\. ggf\. über mehrere 7-Segment-Anzeigen
+     * @brief Position einer 7-Segment-Anzeige eines Display-Felds in der LedMatrix ermitteln,
+     *        z.B.\ um eine einzelne Stelle des Display-Felds blinken zu lassen.
+     *
+     * @param fieldId       Id des Display-Felds
+     * @param led7SegmentId Id der 7-Segment-Anzeige innerhalb des Display-Felds
+     * @return Position der ersten LED (Segment a) der 7-Segment-Anzeige in der LedMatrix.
+     */
+    LedMatrixPos get7SegmentPos(const uint8_t &fieldId, const uint8_t &led7SegmentId) const;
+
+
+    /**
+     * @brief Einen Wert (C-String) auf einem Display, d.h\. ggf\. über mehrere 7-Segment-Anzeigen
      *        hinweg, ausgeben.
      *
+     * Es wird bewusst kein @em String verwendet: Jeder temporäre @em String belegt Speicher auf dem
+     * Heap und fragmentiert ihn auf Dauer.
+     *
      * @param fieldId   Id des Display-Felds, auf dem der outString ausgegeben werden soll
-     * @param outString Die auszugebenden Zeichen.
+     * @param outString Die auszugebenden Zeichen; max. so viele, wie das Feld 7-Segment-Anzeigen hat, zzgl.
+     *                  Dezimalpunkte. Weitere Zeichen werden ignoriert.
      */
-    void display(const uint8_t &fieldId, const String &outString);
+    void display(const uint8_t &fieldId, const char *outString);
 
 
 private:
@@ -296,9 +329,15 @@ private:
     unsigned long int blinkStartTime[NO_OF_SPEED_CLASSES];  ///< Gibt den Takt des normal-schnellen Blinkens für alle LEDs vor.
     bool isBlinkDarkPhase[NO_OF_SPEED_CLASSES];  ///< Flag für die Dunkelphase beim normalen Blinken.
     unsigned long int nextBlinkInterval[NO_OF_SPEED_CLASSES];  ///< Dauer des nächsten Blink-Intervalls (abhängig von blinkTimes[].brightTime und ...darkTime.
+    #ifdef XPANINO_DUAL_CORE
+    uint32_t frames[2][LED_ROWS] = {};      ///< Doppelpuffer für den I/O-Kern: vorderer und hinterer Frame.
+    volatile uint8_t frontFrame = 0;        ///< Index des Frames, den der I/O-Kern ausgibt.
+    volatile bool isFramePending = false;   ///< @em true: Der hintere Frame ist neu und noch nicht übernommen.
+    #endif
 
     bool isValidRowCol(LedMatrixPos pos);
     bool isValidBlinkSpeed(uint8_t blinkSpeed);
     bool isSomethingToBlink();
     void doBlink();
+    void shiftOut(const uint32_t *rows);
 };
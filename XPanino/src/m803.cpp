@@ -9,33 +9,166 @@
  ************************************************************************************************************/
 
 #include <device.hpp>
+#include <hal.hpp>
 #include <m803.hpp>
 
 extern LedMatrix leds;
 
-// Konstanten der möglichen Event-Strings
-const uint8_t NO_OF_EVENT_STRINGS = 6;
-const String eventStrings[NO_OF_EVENT_STRINGS] = {
-    "S;S",
-    "BTN_SEL ON", "BTN_SEL OFF",
-    "BTN_CTL ON", "BTN_CTL LON", "BTN_CTL OFF"
+/**************************************************************************************************
+ * Tabellen der Zustandsautomaten
+ *
+ **************************************************************************************************/
+
+// Indizes der Aktionen in ClockDavtronM803::actions
+const uint8_t ACTION_MARK_CLOCK_MODE_CHANGED = 1;       ///< Unteres Display neu anzeigen
+const uint8_t ACTION_MARK_OAT_VOLTS_MODE_CHANGED = 2;   ///< Oberes Display neu anzeigen
+const uint8_t ACTION_BEGIN_EDIT = 3;                    ///< Stellmodus beginnen
+const uint8_t ACTION_NEXT_DIGIT = 4;                    ///< Im Stellmodus die nächste Ziffer auswählen
+const uint8_t ACTION_INCREMENT_DIGIT = 5;               ///< Im Stellmodus die blinkende Ziffer erhöhen
+const uint8_t ACTION_COMMIT_EDIT = 6;                   ///< Eingestellten Wert übernehmen und an den PC übertragen
+const uint8_t ACTION_START_FLIGHT_TIME = 7;             ///< Flight Time auf 0 setzen und starten
+const uint8_t ACTION_STOP_FLIGHT_TIME = 8;              ///< Flight Time anhalten
+const uint8_t ACTION_TOGGLE_ELAPSED_TIME = 9;           ///< Elapsed Time starten bzw. anhalten
+const uint8_t ACTION_RESET_ELAPSED_TIME = 10;           ///< Elapsed Time anhalten und auf 0 setzen
+
+// Indizes der Guards in ClockDavtronM803::guards
+const uint8_t GUARD_IS_LAST_DIGIT = 1;                  ///< Im Stellmodus ist die letzte Ziffer ausgewählt
+
+/// Zustands-Id für die Tabellen
+static constexpr uint8_t id(const ClockModeState state) { return static_cast<uint8_t>(state); }
+static constexpr uint8_t id(const OatVoltsModeState state) { return static_cast<uint8_t>(state); }
+
+
+const HsmAction<ClockDavtronM803> ClockDavtronM803::actions[] PROGMEM = {
+    nullptr,
+    ClockDavtronM803::markClockModeChanged,         // ACTION_MARK_CLOCK_MODE_CHANGED
+    ClockDavtronM803::markOatVoltsModeChanged,      // ACTION_MARK_OAT_VOLTS_MODE_CHANGED
+    ClockDavtronM803::beginEdit,                    // ACTION_BEGIN_EDIT
+    ClockDavtronM803::nextDigit,                    // ACTION_NEXT_DIGIT
+    ClockDavtronM803::incrementDigit,               // ACTION_INCREMENT_DIGIT
+    ClockDavtronM803::commitEdit,                   // ACTION_COMMIT_EDIT
+    ClockDavtronM803::startFlightTime,              // ACTION_START_FLIGHT_TIME
+    ClockDavtronM803::stopFlightTime,               // ACTION_STOP_FLIGHT_TIME
+    ClockDavtronM803::toggleElapsedTime,            // ACTION_TOGGLE_ELAPSED_TIME
+    ClockDavtronM803::resetElapsedTime              // ACTION_RESET_ELAPSED_TIME
+};
+
+
+const HsmGuard<ClockDavtronM803> ClockDavtronM803::guards[] PROGMEM = {
+    nullptr,
+    ClockDavtronM803::isLastDigit                   // GUARD_IS_LAST_DIGIT
+};
+
+
+const HsmState ClockDavtronM803::clockStates[] PROGMEM = {
+    // parent,                 initial,                 entry,                          exit
+    {HSM_NO_STATE,             HSM_NO_STATE,            ACTION_MARK_CLOCK_MODE_CHANGED, HSM_NO_FUNC},   // OFF
+    {HSM_NO_STATE,             id(ClockModeState::LT),  ACTION_START_FLIGHT_TIME,       ACTION_STOP_FLIGHT_TIME},   // ON
+    {id(ClockModeState::ON),   HSM_NO_STATE,            ACTION_MARK_CLOCK_MODE_CHANGED, HSM_NO_FUNC},   // LT
+    {id(ClockModeState::ON),   HSM_NO_STATE,            ACTION_MARK_CLOCK_MODE_CHANGED, HSM_NO_FUNC},   // UT
+    {id(ClockModeState::ON),   HSM_NO_STATE,            ACTION_MARK_CLOCK_MODE_CHANGED, HSM_NO_FUNC},   // ET
+    {id(ClockModeState::ON),   HSM_NO_STATE,            ACTION_MARK_CLOCK_MODE_CHANGED, HSM_NO_FUNC},   // FT
+    {id(ClockModeState::ON),   HSM_NO_STATE,            HSM_NO_FUNC,                    HSM_NO_FUNC},   // SET
+    {id(ClockModeState::SET),  HSM_NO_STATE,            ACTION_BEGIN_EDIT,              HSM_NO_FUNC},   // SET_LT
+    {id(ClockModeState::SET),  HSM_NO_STATE,            ACTION_BEGIN_EDIT,              HSM_NO_FUNC},   // SET_UT
+    {id(ClockModeState::SET),  HSM_NO_STATE,            ACTION_BEGIN_EDIT,              HSM_NO_FUNC}    // SET_ET
 };
 
+
+/// Spalten: POWER_ON, POWER_OFF, BTN_OAT, BTN_SEL, BTN_CTL, BTN_CTL_LON, BTN_SEL_CTL, TIMEOUT.
+/// Nicht angegebene Einträge bedeuten "nicht behandelt".
+/// Im Stellmodus wählt SELECT die nächste Ziffer; bei der letzten Ziffer wird der Wert übernommen
+/// (der Guard schlägt sonst fehl und das Event geht an SET). Beim Timeout wird der Wert verworfen.
+/// Bei Anzeige der ET startet bzw. stoppt CONTROL die ET; ein langer Druck setzt sie zurück.
+/// Bei Anzeige der FT setzt ein langer Druck auf CONTROL die FT auf 0 und startet sie neu.
+const HsmTransition ClockDavtronM803::clockTransitions[NO_OF_CLOCK_MODE_STATES][NO_OF_M803_EVENTS] PROGMEM = {
+    /* OFF    */ {hsmTo(id(ClockModeState::ON))},
+    /* ON     */ {hsmNone(), hsmTo(id(ClockModeState::OFF))},
+    /* LT     */ {hsmNone(), hsmNone(), hsmNone(), hsmTo(id(ClockModeState::UT)), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::SET_LT))},
+    /* UT     */ {hsmNone(), hsmNone(), hsmNone(), hsmTo(id(ClockModeState::ET)), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::SET_UT))},
+    /* ET     */ {hsmNone(), hsmNone(), hsmNone(), hsmTo(id(ClockModeState::FT)),
+                  hsmDo(ACTION_TOGGLE_ELAPSED_TIME), hsmDo(ACTION_RESET_ELAPSED_TIME),
+                  hsmTo(id(ClockModeState::SET_ET))},
+    /* FT     */ {hsmNone(), hsmNone(), hsmNone(), hsmTo(id(ClockModeState::LT)),
+                  hsmNone(), hsmDo(ACTION_START_FLIGHT_TIME)},
+    /* SET    */ {hsmNone(), hsmNone(), hsmNone(), hsmDo(ACTION_NEXT_DIGIT), hsmDo(ACTION_INCREMENT_DIGIT)},
+    /* SET_LT */ {hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::LT), ACTION_COMMIT_EDIT, GUARD_IS_LAST_DIGIT),
+                  hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::LT))},
+    /* SET_UT */ {hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::UT), ACTION_COMMIT_EDIT, GUARD_IS_LAST_DIGIT),
+                  hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::UT))},
+    /* SET_ET */ {hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::ET), ACTION_COMMIT_EDIT, GUARD_IS_LAST_DIGIT),
+                  hsmNone(), hsmNone(), hsmNone(),
+                  hsmTo(id(ClockModeState::ET))}
+};
+
+
+const HsmState ClockDavtronM803::oatVoltsStates[] PROGMEM = {
+    // parent,                     initial,                            entry,                              exit
+    {HSM_NO_STATE,                 HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC},  // OFF
+    {HSM_NO_STATE,                 id(OatVoltsModeState::CELSIUS),     HSM_NO_FUNC,                        HSM_NO_FUNC},  // ON
+    {id(OatVoltsModeState::ON),    HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC},  // EMF
+    {id(OatVoltsModeState::ON),    HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC},  // FAHRENHEIT
+    {id(OatVoltsModeState::ON),    HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC},  // CELSIUS
+    {id(OatVoltsModeState::ON),    HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC},  // QNH
+    {id(OatVoltsModeState::ON),    HSM_NO_STATE,                       ACTION_MARK_OAT_VOLTS_MODE_CHANGED, HSM_NO_FUNC}   // ALT
+};
+
+
+/// Spalten wie bei clockTransitions.
+const HsmTransition ClockDavtronM803::oatVoltsTransitions[NO_OF_OAT_VOLTS_MODE_STATES][NO_OF_M803_EVENTS] PROGMEM = {
+    /* OFF        */ {hsmTo(id(OatVoltsModeState::ON))},
+    /* ON         */ {hsmNone(), hsmTo(id(OatVoltsModeState::OFF))},
+    /* EMF        */ {hsmNone(), hsmNone(), hsmTo(id(OatVoltsModeState::FAHRENHEIT))},
+    /* FAHRENHEIT */ {hsmNone(), hsmNone(), hsmTo(id(OatVoltsModeState::CELSIUS))},
+    /* CELSIUS    */ {hsmNone(), hsmNone(), hsmTo(id(OatVoltsModeState::QNH))},
+    /* QNH        */ {hsmNone(), hsmNone(), hsmTo(id(OatVoltsModeState::ALT))},
+    /* ALT        */ {hsmNone(), hsmNone(), hsmTo(id(OatVoltsModeState::EMF))}
+};
+
+
+const HsmDefinition<ClockDavtronM803> ClockDavtronM803::clockDefinition = {
+    clockStates, &clockTransitions[0][0], actions, guards,
+    NO_OF_CLOCK_MODE_STATES, NO_OF_M803_EVENTS, static_cast<uint8_t>(M803Event::TIMEOUT)
+};
+
+
+const HsmDefinition<ClockDavtronM803> ClockDavtronM803::oatVoltsDefinition = {
+    oatVoltsStates, &oatVoltsTransitions[0][0], actions, guards,
+    NO_OF_OAT_VOLTS_MODE_STATES, NO_OF_M803_EVENTS, static_cast<uint8_t>(M803Event::TIMEOUT)
+};
+
+
 /**************************************************************************************************
  * ClockDavtronM803 - public Methoden
  *
  **************************************************************************************************/
 
-ClockDavtronM803::ClockDavtronM803() {
+ClockDavtronM803::ClockDavtronM803() : oatVoltsHsm(*this, oatVoltsDefinition), clockHsm(*this, clockDefinition) {
     Device();               ///< Call Device-Constructor;
-    oatVoltsMode = OatVoltsModeState::EMF;  ///< Show EMF voltage in upper display.
     isOatVoltsModeChanged = true;
-    clockMode = ClockModeState::LT;         ///< Lokale Zeit im unteren Display anzeigen.
     isClockModeChanged = true;
+    isPowered = false;      ///< Beim ersten show() wird der Stromstatus an die Zustandsautomaten gemeldet.
+    isSelectPressed = false;
+    isControlPressed = false;
+    isReleaseIgnored = false;
+    isControlLongSent = false;
+    strcpy(editDigits, "0000");
+    editMode = ClockModeState::SET_UT;
+    editPos = 0;
+    editLastPos = 0;
     localTime = 123456;     ///< Die lokale Zeit im Format 00HHMMSS @todo checken wies vom Flusi kommt
-    utc = 012345;                ///< Die UTC im Format 00HHMMSS @todo checken wies vom Flusi kommt
-    flightTime = 0;         ///< Die Flighttime im Format 00HHMMSS @todo checken wies vom Flusi kommt
-    elapsedTime = 0;        ///< Die elapsed time im Format 00HHMMSS
+    utc = 12345;            ///< Die UTC im Format 00HHMMSS @todo checken wies vom Flusi kommt
+    countdownSeconds = 0;
+    isCountdownPending = false;
+    isEtAlarm = false;
+    shownSeconds = 0;
     temperatureC = 0;       ///< Die Temperatur in Grad Celsius  @todo checken wie's vom Flusi kommt
     altimeter = STD_ALTIMETER_inHg; ///< Luftdruck in inHg
 
@@ -68,45 +201,146 @@ ClockDavtronM803::ClockDavtronM803() {
     leds.ledOff(LED_ET);
     LED_FT = {5, 4};                ///< Die LED "FT" liegt auf Row=3 und Col=4.
     leds.ledOff(LED_FT);
+
+    ///< Die Zustandsautomaten starten ohne Strom.
+    oatVoltsHsm.start(id(OatVoltsModeState::OFF));
+    clockHsm.start(id(ClockModeState::OFF));
 }
 
-ClockModeState ClockDavtronM803::toggleClockMode() {
-    int currentMode = static_cast<int>(clockMode);
-    if (currentMode < static_cast<int>(ClockModeState::UT)) {
-        currentMode++;
-        clockMode = static_cast<ClockModeState>(currentMode);
-    } else {
-        clockMode = ClockModeState::ET;
+
+bool ClockDavtronM803::processSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) {
+    if (row != M803_SWITCH_ROW) {
+        return false;
     }
-    return clockMode;
+    if (isEtAlarm && (getClockMode() == ClockModeState::ET) && (col != M803_SWITCH_OAT)
+            && (switchState == SWITCH_STATE_ON)) {
+        // Bei Anzeige der ET quittiert ein Druck auf SELECT oder CONTROL nur den Alarm; in den
+        // anderen Modi wirken die Taster wie gewohnt und der Alarm bleibt bestehen.
+        isEtAlarm = false;
+        isReleaseIgnored = true;
+        isClockModeChanged = true;
+        isSelectPressed = isSelectPressed || (col == M803_SWITCH_SELECT);
+        isControlPressed = isControlPressed || (col == M803_SWITCH_CONTROL);
+        return true;
+    }
+    switch (col) {
+        case M803_SWITCH_SELECT : {
+            if (switchState == SWITCH_STATE_ON) {
+                isSelectPressed = true;
+                if (isControlPressed) {
+                    isReleaseIgnored = true;
+                    post(M803Event::BTN_SEL_CTL);
+                }
+            } else if (switchState == SWITCH_STATE_OFF) {
+                isSelectPressed = false;
+                if (! isReleaseIgnored) {
+                    post(M803Event::BTN_SEL);
+                }
+                isReleaseIgnored = isReleaseIgnored && isControlPressed;
+            }
+            break;
+        }
+        case M803_SWITCH_CONTROL : {
+            if (switchState == SWITCH_STATE_ON) {
+                isControlPressed = true;
+                isControlLongSent = false;
+                if (isSelectPressed) {
+                    isReleaseIgnored = true;
+                    post(M803Event::BTN_SEL_CTL);
+                }
+            } else if (switchState == SWITCH_STATE_LONG_ON) {
+                if (! isReleaseIgnored) {
+                    isControlLongSent = true;
+                    post(M803Event::BTN_CTL_LON);
+                }
+            } else {
+                isControlPressed = false;
+                if ((! isReleaseIgnored) && (! isControlLongSent)) {
+                    post(M803Event::BTN_CTL);
+                }
+                isReleaseIgnored = isReleaseIgnored && isSelectPressed;
+            }
+            break;
+        }
+        case M803_SWITCH_OAT : {
+            if (switchState == SWITCH_STATE_ON) {
+                post(M803Event::BTN_OAT);
+            }
+            break;
+        }
+        default : {
+            return false;   // Schalter gehört nicht zur Uhr
+        }
+    }
+    return true;
 }
 
-
-OatVoltsModeState ClockDavtronM803::toggleOatVoltsMode() {
-    int currentMode{static_cast<int>(oatVoltsMode)};
-    if (currentMode < static_cast<int>(OatVoltsModeState::ALT)) {
-        currentMode++;
-        oatVoltsMode = static_cast<OatVoltsModeState>(currentMode);
-    } else {
-        oatVoltsMode = static_cast<OatVoltsModeState>(OatVoltsModeState::EMF);
+void ClockDavtronM803::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
     }
-    return oatVoltsMode;
-};
+    if (strcmp(event->event, M803_TIME) == 0) {
+        localTime = static_cast<uint32_t>(atol(event->parameter1));
+        utc = static_cast<uint32_t>(atol(event->parameter2));
+        isClockModeChanged = true;
+    } else if (strcmp(event->event, M803_FT) == 0) {
+        uint32_t seconds = static_cast<uint32_t>(atol(event->parameter1));
+        setFlightTime(seconds);
+    } else if (strcmp(event->event, M803_ELAPSED) == 0) {
+        uint32_t seconds = static_cast<uint32_t>(atol(event->parameter1));
+        setElapsedTime(seconds);
+    } else if (strcmp(event->event, M803_AIRBORNE) == 0) {
+        // Die Flight Time läuft nur, solange die Uhr Strom hat.
+        if ((strcmp(event->parameter1, EVENT_ON) == 0) && clockHsm.isIn(id(ClockModeState::ON))) {
+            flightTime.start();
+        } else if (strcmp(event->parameter1, EVENT_OFF) == 0) {
+            flightTime.stop();
+        }
+    }
+}
 
 
-void ClockDavtronM803::setTimeMode(ClockModeState &timeMode) { this->clockMode = timeMode; };
 void ClockDavtronM803::setLocalTime(uint32_t &localTime) { this->localTime = localTime; };
 void ClockDavtronM803::setUtc(uint32_t &utc) { this->utc = utc; };
-void ClockDavtronM803::setFlightTime(uint32_t &flightTime) { this->flightTime = flightTime; };
-void ClockDavtronM803::setElapsedTime(uint32_t &elapsedTime) { this->elapsedTime = elapsedTime; };
-void ClockDavtronM803::setOatVoltsMode(OatVoltsModeState &oatVoltsMode) {this->oatVoltsMode = oatVoltsMode; };
+void ClockDavtronM803::setFlightTime(uint32_t &seconds) { applyAnchor(flightTime, seconds); };
+void ClockDavtronM803::setElapsedTime(uint32_t &seconds) { applyAnchor(elapsedTime, seconds); };
 void ClockDavtronM803::setTemperature(int8_t &temperatureC) { this->temperatureC = temperatureC; };
 void ClockDavtronM803::setAltimeter(float &altimeter) { this->altimeter = altimeter; };
 
 
 void ClockDavtronM803::show() {
+    // Änderungen der Stromversorgung an die Zustandsautomaten melden
+    const bool hasPower = isBatteryPowerOn();   // Die Stellung des Avionics-Schalters ist nicht relevant.
+    if (hasPower != isPowered) {
+        isPowered = hasPower;
+        post(hasPower ? M803Event::POWER_ON : M803Event::POWER_OFF);
+    }
+    const unsigned long now = Hal::millis();
+    oatVoltsHsm.tick(now);
+    clockHsm.tick(now);
+
+    // Die Stoppuhren bei jedem Aufruf abfragen, damit der Überlauf von millis() unschädlich bleibt.
+    const uint32_t etSeconds = elapsedTime.getSeconds();
+    const uint32_t ftSeconds = flightTime.getSeconds();
+    if (isCountdownPending && (etSeconds >= countdownSeconds)) {
+        isCountdownPending = false;
+        isEtAlarm = true;
+        isClockModeChanged = true;
+    }
+    // Bei Anzeige der ET bzw. FT jede neue Sekunde anzeigen.
+    const uint32_t seconds = (getClockMode() == ClockModeState::FT) ? ftSeconds : etSeconds;
+    if (((getClockMode() == ClockModeState::ET) || (getClockMode() == ClockModeState::FT))
+            && (seconds != shownSeconds)) {
+        shownSeconds = seconds;
+        isClockModeChanged = true;
+    }
+
     if (isOatVoltsModeChanged) {
-        switch (oatVoltsMode) {
+        switch (getOatVoltsMode()) {
+            case OatVoltsModeState::OFF        : {
+                        leds.display(upperDisplay, "    ");
+                        break;
+            }
             case OatVoltsModeState::EMF        : {
                         leds.display(upperDisplay, "EMF.");
                         break;
@@ -120,11 +354,18 @@ void ClockDavtronM803::show() {
                         break;
             }
             case OatVoltsModeState::QNH        : {
-                        leds.display(upperDisplay, (static_cast<String>(qnh()).substring(0, 4)));
+                        // Ganze hPa, die Nachkommastellen werden abgeschnitten.
+                        char text[M803_EDIT_DIGITS + 1];
+                        snprintf(text, sizeof(text), "%4u", static_cast<unsigned int>(qnh()));
+                        leds.display(upperDisplay, text);
                         break;
             }
             case OatVoltsModeState::ALT        : {
-                        leds.display(upperDisplay, static_cast<String>(altimeter));
+                        // inHg mit zwei Nachkommastellen, z.B. "29.92"
+                        char text[M803_EDIT_DIGITS + 2];
+                        const unsigned int hundredths = static_cast<unsigned int>(altimeter * 100.0 + 0.5);
+                        snprintf(text, sizeof(text), "%2u.%02u", hundredths / 100 % 100, hundredths % 100);
+                        leds.display(upperDisplay, text);
                         break;
             }
             default : {
@@ -135,53 +376,77 @@ void ClockDavtronM803::show() {
         isOatVoltsModeChanged = false;
     }
     if (isClockModeChanged) {
-        switch (clockMode) {
+        // Alle Modus-LEDs und das Blinken der Ziffern ausschalten; die zum aktuellen Modus gehörende LED
+        // bzw. die im Stellmodus ausgewählte Ziffer wird unten eingeschaltet.
+        for (uint8_t digit = 0; digit != M803_EDIT_DIGITS; ++digit) {
+            leds.set7SegBlinkOff(leds.get7SegmentPos(lowerDisplay, digit));
+        }
+        leds.ledOff(LED_LT);
+        leds.ledOff(LED_UT);
+        leds.ledOff(LED_ET);
+        leds.ledOff(LED_FT);
+        switch (getClockMode()) {
+            case ClockModeState::OFF : {
+                        leds.display(lowerDisplay, "    ");
+                        break;
+            }
             case ClockModeState::LT : {
-                        leds.display(lowerDisplay, (static_cast<String>(localTime)).substring(0, 4));
+                        char digits[M803_EDIT_DIGITS + 1];
+                        leds.display(lowerDisplay, timeToDigits(localTime, false, digits));
                         leds.ledOn(LED_LT);
-                        leds.ledOn(LED_TRENNER_1);
-                        leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
-                        leds.ledOn(LED_TRENNER_2);
-                        leds.ledBlinkOn(LED_TRENNER_2, BLINK_NORMAL);
                         break;
             }
             case ClockModeState::UT : {
-                        leds.display(lowerDisplay, (static_cast<String>(utc)).substring(0, 4));
-                        leds.ledOff(LED_LT);
+                        char digits[M803_EDIT_DIGITS + 1];
+                        leds.display(lowerDisplay, timeToDigits(utc, false, digits));
                         leds.ledOn(LED_UT);
-                        leds.ledOn(LED_TRENNER_1);
-                        leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
-                        leds.ledOn(LED_TRENNER_2);
-                        leds.ledBlinkOn(LED_TRENNER_2, BLINK_NORMAL);
                         break;
             }
             case ClockModeState::ET : {
-                        leds.display(lowerDisplay, "ET00");
-                        leds.ledOff(LED_UT);
-                        leds.ledOff(LED_ET);
-                        leds.ledOn(LED_TRENNER_1);
-                        leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
-                        leds.ledOn(LED_TRENNER_2);
-                        leds.ledBlinkOn(LED_TRENNER_2, BLINK_NORMAL);
+                        // Solange der Countdown läuft, die Restzeit anzeigen; danach wird weiter aufwärts gezählt.
+                        // Setzt ein Anker vom PC die ET unter den Countdown zurück, läuft der Countdown wieder.
+                        char digits[M803_EDIT_DIGITS + 1];
+                        const bool isCountingDown = (etSeconds < countdownSeconds);
+                        leds.display(lowerDisplay, secondsToDigits(isCountingDown ? countdownSeconds - etSeconds
+                                                                   : etSeconds - countdownSeconds, digits));
+                        if (isEtAlarm) {
+                            for (uint8_t digit = 0; digit != M803_EDIT_DIGITS; ++digit) {
+                                leds.set7SegBlinkOn(leds.get7SegmentPos(lowerDisplay, digit));
+                            }
+                        }
+                        leds.ledOn(LED_ET);
                         break;
             }
             case ClockModeState::FT : {
-                        leds.display(lowerDisplay, "FT00");
-                        leds.ledOff(LED_ET);
-                        leds.ledOff(LED_UT);
-                        leds.ledOn(LED_TRENNER_1);
-                        leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
-                        leds.ledOn(LED_TRENNER_2);
-                        leds.ledBlinkOn(LED_TRENNER_2, BLINK_NORMAL);
+                        char digits[M803_EDIT_DIGITS + 1];
+                        leds.display(lowerDisplay, secondsToDigits(ftSeconds, digits));
+                        leds.ledOn(LED_FT);
+                        break;
+            }
+            case ClockModeState::SET_LT :
+            case ClockModeState::SET_UT :
+            case ClockModeState::SET_ET : {
+                        leds.display(lowerDisplay, editDigits);
+                        leds.set7SegBlinkOn(leds.get7SegmentPos(lowerDisplay, editPos));
                         break;
             }
             default : {
                 // this must not ever happen!
                 leds.display(lowerDisplay, "Err");
-                leds.ledOff(LED_TRENNER_1);
-                leds.ledOff(LED_TRENNER_2);
             }
         }
+        // Die Stunden-Minuten-Trenner blinken, solange die Uhr Strom hat und nicht gestellt wird.
+        if (clockHsm.isIn(id(ClockModeState::ON)) && (! clockHsm.isIn(id(ClockModeState::SET)))) {
+            leds.ledOn(LED_TRENNER_1);
+            leds.ledBlinkOn(LED_TRENNER_1, BLINK_NORMAL);
+            leds.ledOn(LED_TRENNER_2);
+            leds.ledBlinkOn(LED_TRENNER_2, BLINK_NORMAL);
+        } else {
+            leds.ledBlinkOff(LED_TRENNER_1, BLINK_NORMAL);
+            leds.ledOff(LED_TRENNER_1);
+            leds.ledBlinkOff(LED_TRENNER_2, BLINK_NORMAL);
+            leds.ledOff(LED_TRENNER_2);
+        }
         isClockModeChanged = false;
     }
 }
@@ -189,12 +454,209 @@ void ClockDavtronM803::show() {
 
 /// @todo richtig implementieren; gibt momentan immer "124356" zurück.
 char* ClockDavtronM803::getLocalTimeDigits() {
-    char r[] = {"999999"};
-    char *p = r;
-    return p;
+    static char r[] = {"999999"};
+    return r;
 };
 
 
+/**************************************************************************************************
+ * ClockDavtronM803 - private Methoden
+ *
+ **************************************************************************************************/
+
+void ClockDavtronM803::post(const M803Event event) {
+    oatVoltsHsm.dispatch(static_cast<uint8_t>(event));
+    clockHsm.dispatch(static_cast<uint8_t>(event));
+}
+
+
+void ClockDavtronM803::markClockModeChanged(ClockDavtronM803 &clock) {
+    clock.isClockModeChanged = true;
+}
+
+
+void ClockDavtronM803::markOatVoltsModeChanged(ClockDavtronM803 &clock) {
+    clock.isOatVoltsModeChanged = true;
+}
+
+
+void ClockDavtronM803::beginEdit(ClockDavtronM803 &clock) {
+    clock.editMode = clock.getClockMode();
+    switch (clock.editMode) {
+        case ClockModeState::SET_LT : {
+            // Bei der Local Time können nur die Stunden gestellt werden; die Minuten kommen von der UT.
+            timeToDigits(clock.localTime, false, clock.editDigits);
+            clock.editLastPos = 1;
+            break;
+        }
+        case ClockModeState::SET_UT : {
+            timeToDigits(clock.utc, false, clock.editDigits);
+            clock.editLastPos = M803_EDIT_DIGITS - 1;
+            break;
+        }
+        default : {
+            // SET_ET: Countdown von maximal 59:59 einstellen
+            secondsToDigits(clock.countdownSeconds, clock.editDigits);
+            clock.editLastPos = M803_EDIT_DIGITS - 1;
+        }
+    }
+    clock.editPos = 0;
+    clock.isClockModeChanged = true;
+    clock.clockHsm.startTimer(M803_EDIT_TIMEOUT);
+}
+
+
+void ClockDavtronM803::nextDigit(ClockDavtronM803 &clock) {
+    ++clock.editPos;
+    // Eine durch die neue Zehnerstelle unzulässig gewordene Einerstelle (z.B. 29 Uhr) korrigieren.
+    if (clock.editDigits[clock.editPos] > clock.maxEditDigit(clock.editPos)) {
+        clock.editDigits[clock.editPos] = clock.maxEditDigit(clock.editPos);
+    }
+    clock.isClockModeChanged = true;
+    clock.clockHsm.startTimer(M803_EDIT_TIMEOUT);
+}
+
+
+void ClockDavtronM803::incrementDigit(ClockDavtronM803 &clock) {
+    char &digit = clock.editDigits[clock.editPos];
+    digit = (digit >= clock.maxEditDigit(clock.editPos)) ? '0' : static_cast<char>(digit + 1);
+    clock.isClockModeChanged = true;
+    clock.clockHsm.startTimer(M803_EDIT_TIMEOUT);
+}
+
+
+void ClockDavtronM803::commitEdit(ClockDavtronM803 &clock) {
+    // Die Transitionsaktion läuft nach dem Verlassen des Stellmodus; daher editMode statt getClockMode().
+    const uint32_t value = static_cast<uint32_t>(atol(clock.editDigits));
+    char para[MAX_PARA_LENGTH];
+    switch (clock.editMode) {
+        case ClockModeState::SET_LT : {
+            // nur die Stunden übernehmen
+            clock.localTime = (value / 100) * 10000 + clock.localTime % 10000;
+            transmitEvent(DEVICE_M803, M803_LT, timeToString(clock.localTime, para));
+            break;
+        }
+        case ClockModeState::SET_UT : {
+            clock.utc = value * 100;
+            transmitEvent(DEVICE_M803, M803_UT, timeToString(clock.utc, para));
+            break;
+        }
+        default : {
+            // MMSS in Sekunden umrechnen; CONTROL startet den Countdown.
+            clock.countdownSeconds = static_cast<uint16_t>((value / 100) * 60 + value % 100);
+            resetElapsedTime(clock);
+            transmitEvent(DEVICE_M803, M803_ET, clock.editDigits);
+        }
+    }
+}
+
+
+void ClockDavtronM803::startFlightTime(ClockDavtronM803 &clock) {
+    clock.flightTime.reset();
+    clock.flightTime.start();
+}
+
+
+void ClockDavtronM803::stopFlightTime(ClockDavtronM803 &clock) {
+    clock.flightTime.stop();
+}
+
+
+void ClockDavtronM803::toggleElapsedTime(ClockDavtronM803 &clock) {
+    if (clock.elapsedTime.isRunning()) {
+        clock.elapsedTime.stop();
+    } else {
+        clock.elapsedTime.start();
+    }
+    clock.isClockModeChanged = true;
+}
+
+
+void ClockDavtronM803::resetElapsedTime(ClockDavtronM803 &clock) {
+    clock.elapsedTime.reset();
+    clock.isCountdownPending = (clock.countdownSeconds != 0);
+    clock.isEtAlarm = false;
+    clock.isClockModeChanged = true;
+}
+
+
+bool ClockDavtronM803::isLastDigit(ClockDavtronM803 &clock) {
+    return clock.editPos >= clock.editLastPos;
+}
+
+
+char ClockDavtronM803::maxEditDigit(const uint8_t pos) const {
+    if (editMode == ClockModeState::SET_ET) {
+        // MMSS: Zehnerstellen bis 5, Einerstellen bis 9
+        return ((pos % 2) == 0) ? '5' : '9';
+    }
+    // HHMM: Stunden bis 23, Minuten bis 59
+    switch (pos) {
+        case 0  : return '2';
+        case 1  : return (editDigits[0] == '2') ? '3' : '9';
+        case 2  : return '5';
+        default : return '9';
+    }
+}
+
+
+/**
+ * @brief Eine Dauer in Sekunden vierstellig darstellen: unter einer Stunde als MMSS, sonst als HHMM.
+ *        Die Anzeige bleibt bei 99:59 stehen.
+ *
+ * @param seconds Dauer in Sekunden.
+ * @param digits  Puffer für mindestens @em M803_EDIT_DIGITS + 1 Zeichen.
+ * @return @em digits
+ */
+char *ClockDavtronM803::secondsToDigits(uint32_t seconds, char *digits) {
+    seconds = min(seconds, M803_MAX_SECONDS);
+    const uint32_t minutes = seconds / 60;
+    if (minutes < 60) {
+        return timeToDigits(minutes * 100 + seconds % 60, true, digits);
+    }
+    return timeToDigits((minutes / 60) * 10000 + (minutes % 60) * 100, false, digits);
+}
+
+
+void ClockDavtronM803::applyAnchor(Stopwatch &stopwatch, const uint32_t seconds) {
+    const uint32_t current = stopwatch.getSeconds();
+    const uint32_t deviation = (current > seconds) ? current - seconds : seconds - current;
+    if (deviation > M803_ANCHOR_TOLERANCE) {
+        stopwatch.setSeconds(seconds);
+    }
+}
+
+
+/**
+ * @brief Eine Zeit im Format 00HHMMSS als sechsstellige Ziffernfolge HHMMSS darstellen.
+ *
+ * @param time   Zeit im Format 00HHMMSS.
+ * @param digits Puffer für mindestens 7 Zeichen.
+ * @return @em digits
+ */
+char *ClockDavtronM803::timeToString(const uint32_t time, char *digits) {
+    snprintf(digits, MAX_PARA_LENGTH, "%02u%02u%02u", static_cast<unsigned int>((time / 10000) % 100),
+             static_cast<unsigned int>((time / 100) % 100), static_cast<unsigned int>(time % 100));
+    return digits;
+}
+
+
+/**
+ * @brief Eine Zeit im Format 00HHMMSS als vierstellige Ziffernfolge HHMM bzw.\ MMSS darstellen.
+ *
+ * @param time          Zeit im Format 00HHMMSS.
+ * @param minutesSeconds @em true für MMSS, @em false für HHMM.
+ * @param digits        Puffer für mindestens @em M803_EDIT_DIGITS + 1 Zeichen.
+ * @return @em digits
+ */
+char *ClockDavtronM803::timeToDigits(const uint32_t time, const bool minutesSeconds, char *digits) {
+    const unsigned int high = minutesSeconds ? (time / 100) % 100 : (time / 10000) % 100;
+    const unsigned int low = minutesSeconds ? time % 100 : (time / 100) % 100;
+    snprintf(digits, M803_EDIT_DIGITS + 1, "%02u%02u", high, low);
+    return digits;
+}
+
+
 /** qnh
  * @brief Altimeter in Hg in QNH umrechnen.
  *
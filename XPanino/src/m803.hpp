@@ -13,24 +13,55 @@
 #include <Arduino.h>
 #include <buffer.hpp>
 #include <device.hpp>
+#include <hsm.hpp>
 #include <ledmatrix.hpp>
+#include <stopwatch.hpp>
 #include <Switchmatrix.hpp>
 
 const char DEVICE_M803[] = "M803";  ///< Kommando, das von X-Plane kommt.
 
+// Position der Taster der Uhr in der Schaltermatrix (vgl. Doku "Hardware für die Uhr und den Transponder")
+const uint8_t M803_SWITCH_ROW = 2;          ///< Row der Taster in der Schaltermatrix
+const uint8_t M803_SWITCH_SELECT = 0;       ///< Col des Tasters SELECT
+const uint8_t M803_SWITCH_CONTROL = 1;      ///< Col des Tasters CONTROL
+const uint8_t M803_SWITCH_OAT = 2;          ///< Col des Tasters OAT/VOLTS
+
+// Event-Konstanten für die an den PC übertragenen, an der Uhr eingestellten Zeiten (vgl. Doku "Kommunikation")
+const char M803_LT[] = "LT";                ///< Local Time im Format HHMMSS
+const char M803_UT[] = "UT";                ///< Universal Time im Format HHMMSS
+const char M803_ET[] = "ET";                ///< Countdown der Elapsed Time im Format MMSS
+
+// Event-Konstanten für die vom PC empfangenen Daten (vgl. Doku "Kommunikation")
+const char M803_TIME[] = "TIME";            ///< Local Time und UTC im Format HHMMSS
+const char M803_ELAPSED[] = "EL";           ///< Elapsed Time in Sekunden
+const char M803_FT[] = "FT";                ///< Flight Time in Sekunden
+const char M803_AIRBORNE[] = "AIR";         ///< Flugzeug ist in der Luft (ON) bzw. gelandet (OFF)
+
+const uint32_t M803_ANCHOR_TOLERANCE = 1;   ///< Vom PC gemeldete ET/FT erst bei mehr als 1 Sekunde Abweichung übernehmen
+const uint32_t M803_MAX_SECONDS = 99UL * 3600 + 59 * 60 + 59;  ///< ET und FT werden höchstens bis 99:59 angezeigt
+
+const uint8_t M803_EDIT_DIGITS = 4;                 ///< Anzahl Stellen, die im Stellmodus angezeigt werden
+const unsigned long M803_EDIT_TIMEOUT = 10000;      ///< Stellmodus ohne Übernahme verlassen, wenn 10 Sekunden kein Taster gedrückt wurde
+
+
 /***************************************************************************************************
- * @brief Eventklasse - wird wahrscheinlich nicht benötigt.
+ * @brief Aufzählungstyp für die möglichen Events, die von den Zustandsautomaten der Uhr
+ *        verarbeitet werden.
  *
+ * SELECT und CONTROL lösen ihr Event erst beim Loslassen aus. Nur so lassen sich ein einfacher Druck,
+ * ein langer Druck und das gleichzeitige Drücken beider Taster unterscheiden.
  */
-enum class Event {
-    BTN_OAT_ON,         // Der Taster OAT/VOLTS wurde gedrückt
-    BTN_SEL_ON,         // der Taster SELECT wurde gedrückt
-    BTN_SEL_OFF,        // der Taster SELECT wurde wieder losgelassen
-    BTN_CTL_ON,         // der Taster CONTROL wurde gedrückt
-    BTN_CTL_LON,        // der Taster CONTROL wurde mindestens 3 Sekunden lang gedrückt
-    XP_TIME,            // Neue Uhrzeit vom X-Plane empfangen
-    XP_TEMPERATURE      // Neue Temperatur vom X-Plane empfangen
+enum class M803Event : uint8_t {
+    POWER_ON,           ///< Die Uhr hat Strom bekommen
+    POWER_OFF,          ///< Die Uhr hat keinen Strom mehr
+    BTN_OAT,            ///< Der Taster OAT/VOLTS wurde gedrückt
+    BTN_SEL,            ///< Der Taster SELECT wurde gedrückt und wieder losgelassen
+    BTN_CTL,            ///< Der Taster CONTROL wurde kurz gedrückt und wieder losgelassen
+    BTN_CTL_LON,        ///< Der Taster CONTROL wurde mindestens 3 Sekunden lang gedrückt
+    BTN_SEL_CTL,        ///< Die Taster SELECT und CONTROL wurden gleichzeitig gedrückt
+    TIMEOUT             ///< Der Timer des Zustandsautomaten ist abgelaufen
 };
+const uint8_t NO_OF_M803_EVENTS = static_cast<uint8_t>(M803Event::TIMEOUT) + 1;  ///< Anzahl Events
 
 
 /***************************************************************************************************
@@ -39,44 +70,40 @@ enum class Event {
  **************************************************************************************************/
 
 /***************************************************************************************************
- * @brief Aufzählungstyp für die verschiedenen Zeitvarianten, die angezeigt werden.
+ * @brief Zustände des unteren Displays, d.h. die verschiedenen Zeitvarianten, die angezeigt werden.
  *
+ * Die Zustände OFF und ON sind die übergeordneten Zustände; LT, UT, ET, FT und SET liegen in ON.
+ * Die Stellmodi SET_LT, SET_UT und SET_ET liegen in SET.
  */
-enum class ClockModeState {
+enum class ClockModeState : uint8_t {
+    OFF = 1,    ///< Keine Stromversorgung; Anzeige dunkel
+    ON,         ///< Übergeordneter Zustand: Uhr hat Strom
     LT,         ///< Local Time
     UT,         ///< Universal Time
     ET,         ///< Elapsed Time (seit Avionics on)
     FT,         ///< Flight Time
-    SET_LT,     ///< Set local time directly at the device
+    SET,        ///< Übergeordneter Zustand der Stellmodi: Ziffer auswählen und erhöhen
+    SET_LT,     ///< Set local time directly at the device (nur die Stunden)
     SET_UT,     ///< Set UTC directly at the device
-    SET_ET      ///< Set ET directly at the device
+    SET_ET      ///< Set ET (Countdown MMSS) directly at the device
 };
+const uint8_t NO_OF_CLOCK_MODE_STATES = static_cast<uint8_t>(ClockModeState::SET_ET);  ///< Anzahl Zustände in der Tabelle
 
 /***************************************************************************************************
- * @brief Aufzählungstyp für die nur alternativ möglichen Anzeigen.
+ * @brief Zustände des oberen Displays, d.h. die nur alternativ möglichen Anzeigen.
  *
+ * Die Zustände OFF und ON sind die übergeordneten Zustände; alle Anzeigen liegen in ON.
  */
-enum class OatVoltsModeState {
+enum class OatVoltsModeState : uint8_t {
+    OFF = 1,        ///< Keine Stromversorgung; Anzeige dunkel
+    ON,             ///< Übergeordneter Zustand: Uhr hat Strom
     EMF,            ///< Show EMF Voltage in upper display.
     FAHRENHEIT,     ///< Show temperature in Fahrenheit in upper display.
     CELSIUS,        ///< Show temperatur in Celsius upper display.
     QNH,            ///< Show current QNH in upper Display.
     ALT             ///< Show current Altimeter in inHG in upper display.
 };
-
-/***************************************************************************************************
- * @brief Aufzählungstyp für die möglichen Events, die verarbeitet werden müssen.
- *
- */
-enum class m803Event {
-    BTN_OAT_ON,         // Der Taster OAT/VOLTS wurde gedrückt
-    BTN_SEL_ON,         // der Taster SELECT wurde gedrückt
-    BTN_SEL_OFF,        // der Taster SELECT wurde wieder losgelassen
-    BTN_CTL_ON,         // der Taster CONTROL wurde gedrückt
-    BTN_CTL_LON,        // der Taster CONTROL wurde mindestens 3 Sekunden lang gedrückt
-    XP_TIME,            // Neue Uhrzeit vom X-Plane empfangen
-    XP_TEMPERATURE      // Neue Temperatur vom X-Plane empfangen
-};
+const uint8_t NO_OF_OAT_VOLTS_MODE_STATES = static_cast<uint8_t>(OatVoltsModeState::ALT);  ///< Anzahl Zustände
 
 /***************************************************************************************************
  * @brief Modell der Uhr Davtron M803.
@@ -89,34 +116,45 @@ public:
     ClockDavtronM803();
 
     /**
-     * @brief Switch to next time mode of the lower diplay but skip the SET_xx modes.
+     * @brief Den Status eines Tasters der Uhr verarbeiten.
      *
-     * @return ClockModeState The new ClockMode.
+     * @param row         Row des Schalters in der Schaltermatrix.
+     * @param col         Col des Schalters in der Schaltermatrix.
+     * @param switchState @em SWITCH_STATE_OFF, @em SWITCH_STATE_ON oder @em SWITCH_STATE_LONG_ON.
+     * @return @em true falls der Schalter zur Uhr gehört und lokal verarbeitet wurde, sonst @em false.
      */
-    ClockModeState toggleClockMode();
+    bool processSwitch(uint8_t row, uint8_t col, uint8_t switchState);
 
 
     /**
-     * @brief Switch to the next mode of the upper display (OAT-VOLTS).
+     * @brief Vom PC empfangene Daten (Uhrzeit, Anker für ET und FT, airborne) verarbeiten.
      *
-     * @return OatVoltsModeState The new OatVolsMode
+     * @param event Das zu verarbeitende Event.
      */
-    OatVoltsModeState toggleOatVoltsMode();
+    void processEvent(EventClass *event);
+
+
+    /// @brief Aktuellen Modus des unteren Displays abfragen.
+    inline ClockModeState getClockMode() const { return static_cast<ClockModeState>(clockHsm.getState()); }
+
+
+    /// @brief Aktuellen Modus des oberen Displays abfragen.
+    inline OatVoltsModeState getOatVoltsMode() const {
+        return static_cast<OatVoltsModeState>(oatVoltsHsm.getState());
+    }
 
 
-    void setTimeMode(ClockModeState &timeMode);
     void setLocalTime(uint32_t &localTime);
     void setUtc(uint32_t &utc);
-    void setFlightTime(uint32_t &flightTime);
-    void setElapsedTime(uint32_t &elapsedTime);
-    void setOatVoltsMode(OatVoltsModeState &OatVoltsMode);
+    void setFlightTime(uint32_t &seconds);
+    void setElapsedTime(uint32_t &seconds);
     void setTemperature(int8_t &temperatureC);
-    void setPowerState(bool &powerStatus);
     void setAltimeter(float &altimeter);
 
 
     /**
-     * @brief Display the current values in upper and lower display.
+     * @brief Stromversorgung und Timer prüfen und die aktuellen Werte im oberen und unteren Display anzeigen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
      *
      */
     void show();
@@ -137,17 +175,72 @@ private:
     LedMatrixPos LED_UT;                    ///< Led for UTC
     LedMatrixPos LED_ET;                    ///< Led for elapsed time
     LedMatrixPos LED_FT;                    ///< Led for flight time
-    OatVoltsModeState oatVoltsMode;     ///< Modus/Status des oberen Displays.
+    Hsm<ClockDavtronM803> oatVoltsHsm;  ///< Zustandsautomat des oberen Displays.
     bool isOatVoltsModeChanged;
-    ClockModeState clockMode;           ///< Modus/Status des unteren Displays.
+    Hsm<ClockDavtronM803> clockHsm;     ///< Zustandsautomat des unteren Displays.
     bool isClockModeChanged;
+    bool isPowered;                     ///< Zuletzt an die Zustandsautomaten gemeldeter Stromstatus.
+    bool isSelectPressed;               ///< Taster SELECT ist gedrückt.
+    bool isControlPressed;              ///< Taster CONTROL ist gedrückt.
+    bool isReleaseIgnored;              ///< SEL+CTL gedrückt oder Alarm quittiert: beim Loslassen kein Event senden.
+    bool isControlLongSent;             ///< BTN_CTL_LON wurde gesendet; beim Loslassen kein BTN_CTL senden.
+    char editDigits[M803_EDIT_DIGITS + 1];  ///< Im Stellmodus angezeigte Ziffern (HHMM bzw. MMSS)
+    ClockModeState editMode;            ///< Aktueller bzw. zuletzt aktiver Stellmodus
+    uint8_t editPos;                    ///< Im Stellmodus blinkende Ziffer
+    uint8_t editLastPos;                ///< Letzte im Stellmodus einstellbare Ziffer
     uint32_t localTime;                 ///< Die lokale Zeit im Format 00HHMMSS.
     uint32_t utc;                       ///< Die UTC im Format 00HHMMSS.
-    uint32_t flightTime;                ///< Die Flighttime im Format 00HHMMSS.
-    uint32_t elapsedTime;               ///< Die elapsed time im Format 00HHMMSS.
+    Stopwatch flightTime;               ///< Die Flighttime; läuft, solange die Uhr Strom hat bzw. airborne.
+    Stopwatch elapsedTime;              ///< Die elapsed time; wird mit CONTROL gestartet und gestoppt.
+    uint16_t countdownSeconds;          ///< Im Stellmodus SET_ET eingestellter Countdown in Sekunden.
+    bool isCountdownPending;            ///< Der Countdown ist noch nicht abgelaufen.
+    bool isEtAlarm;                     ///< Countdown abgelaufen; Anzeige der ET blinkt, bis dort SELECT oder CONTROL gedrückt wird.
+    uint32_t shownSeconds;              ///< Zuletzt angezeigte Sekunden der ET bzw. FT.
     int8_t temperatureC;                ///< Die Temperatur in Grad Celsius.
     float altimeter;                    ///< Luftdruck in inHg.
 
+    static const HsmState clockStates[];                        ///< Zustandstabelle unteres Display
+    static const HsmTransition clockTransitions[][NO_OF_M803_EVENTS];  ///< Übergangstabelle unteres Display
+    static const HsmState oatVoltsStates[];                     ///< Zustandstabelle oberes Display
+    static const HsmTransition oatVoltsTransitions[][NO_OF_M803_EVENTS];  ///< Übergangstabelle oberes Display
+    static const HsmAction<ClockDavtronM803> actions[];         ///< Aktionen beider Zustandsautomaten
+    static const HsmGuard<ClockDavtronM803> guards[];           ///< Guards beider Zustandsautomaten
+    static const HsmDefinition<ClockDavtronM803> clockDefinition;     ///< Tabellen unteres Display
+    static const HsmDefinition<ClockDavtronM803> oatVoltsDefinition;  ///< Tabellen oberes Display
+
+    /// Ein Event an beide Zustandsautomaten senden.
+    void post(M803Event event);
+
+    /// Aktionen der Zustandsautomaten
+    static void markClockModeChanged(ClockDavtronM803 &clock);
+    static void markOatVoltsModeChanged(ClockDavtronM803 &clock);
+    static void beginEdit(ClockDavtronM803 &clock);
+    static void nextDigit(ClockDavtronM803 &clock);
+    static void incrementDigit(ClockDavtronM803 &clock);
+    static void commitEdit(ClockDavtronM803 &clock);
+    static void startFlightTime(ClockDavtronM803 &clock);
+    static void stopFlightTime(ClockDavtronM803 &clock);
+    static void toggleElapsedTime(ClockDavtronM803 &clock);
+    static void resetElapsedTime(ClockDavtronM803 &clock);
+
+    /// Guards der Zustandsautomaten
+    static bool isLastDigit(ClockDavtronM803 &clock);
+
+    /// Eine Zeit im Format 00HHMMSS als HHMM bzw. MMSS darstellen.
+    static char *timeToDigits(uint32_t time, bool minutesSeconds, char *digits);
+
+    /// Eine Dauer in Sekunden als MMSS (unter einer Stunde) bzw. HHMM darstellen.
+    static char *secondsToDigits(uint32_t seconds, char *digits);
+
+    /// Die Zeit einer Stoppuhr auf den vom PC gemeldeten Wert korrigieren.
+    static void applyAnchor(Stopwatch &stopwatch, uint32_t seconds);
+
+    /// Eine Zeit im Format 00HHMMSS als HHMMSS darstellen.
+    static char *timeToString(uint32_t time, char *digits);
+
+    /// Höchster zulässiger Wert der Ziffer an der Position @em pos im Stellmodus.
+    char maxEditDigit(uint8_t pos) const;
+
     /// Altimeter in QNH umrechnen
     inline float qnh();
 };
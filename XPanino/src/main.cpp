@@ -17,8 +17,17 @@
 #include <Switchmatrix.hpp>
 #include <ledmatrix.hpp>
 #include <buffer.hpp>
+#include <diagnostics.hpp>
+#include <hal.hpp>
+#include <readout.hpp>
+#include <traffic.hpp>
+#include <txbuffer.hpp>
+#ifdef XPANINO_COM_PANEL
+#include <com.hpp>
+#else
 #include <m803.hpp>
 #include <xpdr.hpp>
+#endif
 //#include <commands.hpp>
 
 // Makros für serielle Schnittstelle definieren
@@ -29,10 +38,24 @@ DispatcherClass dispatcher; ///< Dispatcher
 EventQueueClass eventQueue; ///< Event
 BufferClass inBuffer;       ///< Eingabepuffer anlegen
 LedMatrix leds;             ///< LedMatrix anlegen
+TxBuffer txBuffer;          ///< Sendepuffer für die Nachrichten an den PC anlegen
+Diagnostics diagnostics;    ///< Zeitabgleich und Tracing anlegen
 SwitchMatrix switches;      ///< Schaltermatrix - SwitchMatrix - anlegen
 
+ReadoutDevice readouts;     ///< Tabellengesteuerte Zahlenanzeigen anlegen (vgl. READOUTS in readout.cpp)
+TrafficAnnunciator traffic; ///< Warnstufen-LEDs der Verkehrswarnung anlegen (Byte 0, Col 5)
+
+#ifdef XPANINO_COM_PANEL
+// Ein COM-Panel belegt die Cols 8 bis 23 der LED-Matrix; XPANINO_COM_PANEL gibt die Nummer des Funkgeräts an.
+#if XPANINO_COM_PANEL == 2
+ComRadio com(DEVICE_COM_2, COM_2_POWER);    ///< COM 2 anlegen
+#else
+ComRadio com(DEVICE_COM_1, COM_1_POWER);    ///< COM 1 anlegen
+#endif
+#else
 ClockDavtronM803 m803;      ///< Uhr anlegen (ClockDavtron M803)
 TransponderKT76C xpdr;      ///< Transponder anlegen
+#endif
 
 
 /*********************************************************************************************************//**
@@ -40,8 +63,8 @@ TransponderKT76C xpdr;      ///< Transponder anlegen
  *
  ************************************************************************************************************/
 void serialEvent() {
-    while (Serial.available() > 0) {
-        char inChar = char(Serial.read());
+    while (Hal::uartAvailable() > 0) {
+        char inChar = char(Hal::uartRead());
         // prüfen auf gültige Zeichen.
         // gültige Zeichen in den Buffer aufnehmen, ungültige Zeichen ignorieren
         // gültig sind: Space, '_' und alle alfanumerischen Zeichen
@@ -73,43 +96,18 @@ void serialEvent() {
  ************************************************************************************************************/
 void setup() {
     // Serielle Schnittstelle initialisieren
-    if (Serial) {
-        Serial.begin(_SERIAL_BAUDRATE, SERIAL_8N1);
-        // wait for serial port to connect. Needed for native USB
-        while (!Serial);
-        // Schreibpuffer leeren
-        Serial.flush();
-        // Lesepuffer leeren
-        while (Serial.available() > 0) {
-            Serial.read();
-        }
-        Serial.println(F("XPanino"));
-    }
+    Hal::uartBegin(_SERIAL_BAUDRATE);
+    Hal::uartPrintFlash(PSTR("XPanino\r\n"));
 
+    #ifdef XPANINO_DUAL_CORE
+    // LED- und Schaltermatrix gehören dem I/O-Kern (vgl. setup1()). Zunächst werden alle Schalter als
+    // ausgeschaltet gemeldet; die tatsächlichen Schalterstände folgen mit den ersten Abfragen als Änderungen.
+    #else
     leds.initHardware();                      ///< Arduino-Hardware der LED-Matrix initialisieren.
 
-    const uint8_t FL = 2;
-    leds.defineDisplayField(FL, 0, {0, 8});         ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 8 bis 15: Hunderterstelle.
-    leds.defineDisplayField(FL, 1, {1, 8});         ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 8 bis 15: Zehnerstelle .
-    leds.defineDisplayField(FL, 2, {2, 8});         ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 8 bis 15: Einerstelle.
-    leds.display(FL, "0.20");
-    leds.set7SegBlinkOn({0, 8}, true, BLINK_NORMAL);
-
-    const uint8_t SQUAWK = 3;
-    leds.defineDisplayField(SQUAWK, 0, {3, 8});        ///< Die 1. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 8 bis 15: Tausenderstelle.
-    leds.defineDisplayField(SQUAWK, 1, {4, 8});        ///< Die 2. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 8 bis 15: Hunderterstelle.
-    leds.defineDisplayField(SQUAWK, 2, {5, 8});        ///< Die 3. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 8 bis 15: Zehnerstelle.
-    leds.defineDisplayField(SQUAWK, 3, {6, 8});        ///< Die 4. 7-Segment-Anzeige liegt auf der Row 6 und den Cols 8 bis 15: Einerstelle.
-    leds.display(SQUAWK, "7000");
-
-    const LedMatrixPos LED_ALT{6, 4};       ///< Die LED "ALT" liegt auf Row=2 und Col=4.leds.ledOn(LED_ALT);
-    leds.ledOn(LED_ALT);
-    const LedMatrixPos LED_R = {7, 4};      ///< Die LED "R" liegt auf Row=3 und Col=4.
-    leds.ledOn(LED_R);
-    leds.ledBlinkOn(LED_R, BLINK_SLOW);
-
     switches.initHardware();            ///< Die Arduino-Hardware der Schaltermatrix initialisieren.
     switches.scanSwitchPins();          ///< Initiale Schalterstände abfragen und übertragen.
+    #endif
     switches.transmitStatus(TRANSMIT_ALL_SWITCHES);     ///< Den aktuellen ein-/aus-Status der Schalter an den PC senden.
     #ifdef DEBUG
     switches.printMatrix();
@@ -122,11 +120,58 @@ void setup() {
  *
  ************************************************************************************************************/
 void loop() {
+    diagnostics.beginPhase(TracePhase::SCAN);
+    #ifdef XPANINO_DUAL_CORE
+    serialEvent();              ///< Nicht jeder Arduino-Core ruft serialEvent() nach loop() auf.
+    switches.processSwitchChanges();    ///< Vom I/O-Kern gemeldete Schalteränderungen übernehmen
+    #else
     switches.scanSwitchPins();  ///< Hardware-Schalter abfragen
+    #endif
     switches.transmitStatus(TRANSMIT_ONLY_CHANGED_SWITCHES);    ///< Geänderte Schalterstände verarbeiten
     //readXplane()  -  Daten vom X-Plane einlesen (besser als Interrupt realisieren)
+    diagnostics.beginPhase(TracePhase::DISPATCH);
     dispatcher.dispatchAll();   ///< Eventqueue abarbeiten
+    diagnostics.beginPhase(TracePhase::SHOW);
+    readouts.show();
+    traffic.show();
+    #ifdef XPANINO_COM_PANEL
+    com.show();
+    #else
     m803.show();
-    //xpdr.show();
+    xpdr.show();
+    #endif
+    diagnostics.beginPhase(TracePhase::LEDS);
+    #ifdef XPANINO_DUAL_CORE
+    leds.updateFrame();         ///< Neuen Frame für den I/O-Kern bereitstellen
+    #else
     leds.writeToHardware();     ///< LEDs anzeigen bzw. refreshen
+    #endif
+    diagnostics.endLoop();
+    txBuffer.poll();            ///< Gepufferte Nachrichten nach Ablauf der Wartezeit senden
+}
+
+
+#ifdef XPANINO_DUAL_CORE
+/*********************************************************************************************************//**
+ * @brief Initialisierungen des I/O-Kerns (zweiter Kern, z.B. beim Raspberry Pi Pico).
+ *
+ * Im Dual-Core-Betrieb bedient der zweite Kern ausschließlich die LED- und die Schaltermatrix. Mit dem
+ * ersten Kern tauscht er Daten nur über die Queue der Schalteränderungen und den Doppelpuffer der
+ * LED-Matrix aus; Dispatcher, Geräte, TxBuffer und Diagnostics werden nur vom ersten Kern benutzt.
+ *
+ ************************************************************************************************************/
+void setup1() {
+    leds.initHardware();                ///< Hardware der LED-Matrix initialisieren.
+    switches.initHardware();            ///< Hardware der Schaltermatrix initialisieren.
+}
+
+
+/*********************************************************************************************************//**
+ * @brief Lfd. Verarbeitung des I/O-Kerns: Schalter abfragen und LEDs refreshen.
+ *
+ ************************************************************************************************************/
+void loop1() {
+    switches.sampleSwitchPins();        ///< Hardware-Schalter abfragen, Änderungen an den ersten Kern melden
+    leds.writeFrameToHardware();        ///< Zuletzt bereitgestellten Frame anzeigen
 }
+#endif
@@ -0,0 +1,209 @@
+/***************************************************************************************************
+ * @file readout.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em ReadoutDevice sowie die Tabelle der Anzeigen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <hal.hpp>
+#include <readout.hpp>
+
+extern LedMatrix leds;
+
+/// Tabelle der Anzeigen. Die Display-Felder liegen in den freien Cols 24 bis 31 der LED-Matrix.
+const ReadoutDefinition READOUTS[] PROGMEM = {
+    // valueId, fieldId, firstPos, digits, decimals, flags,              min,  max
+    {1,         4,       {0, 24},  4,      1,        READOUT_BLANK_ZERO, 110,  150},    // Bordspannung in V
+    {2,         5,       {4, 24},  4,      0,        0,                  0,    1650}    // EGT in °F
+};
+static_assert(sizeof(READOUTS) / sizeof(READOUTS[0]) == NO_OF_READOUTS,
+              "NO_OF_READOUTS (readout.hpp) muss der Anzahl Einträge in READOUTS entsprechen");
+
+
+/**************************************************************************************************
+ * ReadoutDevice - public Methoden
+ *
+ **************************************************************************************************/
+
+ReadoutDevice::ReadoutDevice() {
+    isPowered = false;
+    for (uint8_t index = 0; index != NO_OF_READOUTS; ++index) {
+        const ReadoutDefinition definition = readDefinition(index);
+        for (uint8_t digit = 0; digit != definition.digits; ++digit) {
+            leds.defineDisplayField(definition.fieldId, digit,
+                                    {static_cast<uint8_t>(definition.firstPos.row + digit), definition.firstPos.col});
+        }
+        values[index] = 0;
+        rates[index] = 0;
+        valueTimes[index] = 0;
+        shownValues[index] = 0;
+        isValid[index] = false;
+        isChanged[index] = true;
+    }
+}
+
+
+void ReadoutDevice::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
+    }
+    const bool isValue = (strcmp(event->event, READOUT_VALUE) == 0);
+    if ((! isValue) && (strcmp(event->event, READOUT_RATE) != 0)) {
+        return;
+    }
+    const uint8_t valueId = static_cast<uint8_t>(atoi(event->parameter1));
+    for (uint8_t index = 0; index != NO_OF_READOUTS; ++index) {
+        if (pgm_read_byte(&READOUTS[index].valueId) == valueId) {
+            const int16_t parameter = static_cast<int16_t>(atoi(event->parameter2));
+            if (isValue) {
+                isChanged[index] = isChanged[index] || (! isValid[index]) || (parameter != shownValues[index]);
+                values[index] = parameter;
+                isValid[index] = true;
+            } else {
+                // Ab dem aktuell angezeigten Wert mit der neuen Rate weiterrechnen.
+                values[index] = currentValue(index);
+                rates[index] = parameter;
+            }
+            valueTimes[index] = Hal::millis();
+            return;
+        }
+    }
+}
+
+
+void ReadoutDevice::show() {
+    const bool hasPower = isPowerAvailable();
+    const bool isPowerChanged = (hasPower != isPowered);
+    isPowered = hasPower;
+    for (uint8_t index = 0; index != NO_OF_READOUTS; ++index) {
+        const int16_t value = currentValue(index);
+        if (! (isChanged[index] || isPowerChanged || (value != shownValues[index]))) {
+            continue;
+        }
+        shownValues[index] = value;
+        const ReadoutDefinition definition = readDefinition(index);
+        char text[MAX_7SEGMENT_UNITS + 2];
+        const bool isShown = isPowered && isValid[index];
+        if (isShown) {
+            format(definition, value, text);
+        } else {
+            memset(text, ' ', definition.digits);
+            text[definition.digits] = '\0';
+        }
+        leds.display(definition.fieldId, text);
+        // Außerhalb des zulässigen Bereichs blinkt die Anzeige.
+        const bool isOutOfRange = isShown
+                && ((value < definition.minValue) || (value > definition.maxValue));
+        for (uint8_t digit = 0; digit != definition.digits; ++digit) {
+            const LedMatrixPos pos = leds.get7SegmentPos(definition.fieldId, digit);
+            if (isOutOfRange) {
+                leds.set7SegBlinkOn(pos, true);
+            } else {
+                leds.set7SegBlinkOff(pos, true);
+            }
+        }
+        isChanged[index] = false;
+    }
+}
+
+
+/**************************************************************************************************
+ * ReadoutDevice - private Methoden
+ *
+ **************************************************************************************************/
+
+/**
+ * @brief Wert + Rate * vergangene Zeit in Festkomma-Arithmetik (int32) berechnen.
+ *
+ * Die vergangene Zeit wird auf READOUT_MAX_EXTRAPOLATION begrenzt; bei max. 32767 Rohwert pro
+ * Minute und 10 s bleibt das Produkt weit unter dem Wertebereich von int32_t.
+ *
+ * @param index Index der Anzeige in der Tabelle READOUTS.
+ * @return Aktueller Rohwert, begrenzt auf @em minValue bis @em maxValue des Tabelleneintrags bzw.
+ *         auf den zuletzt empfangenen Wert, falls dieser außerhalb liegt.
+ */
+int16_t ReadoutDevice::currentValue(const uint8_t index) const {
+    if (rates[index] == 0) {
+        return values[index];
+    }
+    // Die Differenz ist auch beim Überlauf von millis() korrekt.
+    unsigned long elapsed = Hal::millis() - valueTimes[index];
+    if (elapsed > READOUT_MAX_EXTRAPOLATION) {
+        elapsed = READOUT_MAX_EXTRAPOLATION;
+    }
+    const int32_t value = values[index] + static_cast<int32_t>(rates[index]) * static_cast<int32_t>(elapsed) / 60000L;
+    // Nicht über die Grenzen des Tabelleneintrags hinaus extrapolieren. Liegt schon der empfangene
+    // Wert außerhalb, bleibt er stehen (die Anzeige blinkt dann).
+    const int16_t minValue = static_cast<int16_t>(pgm_read_word(&READOUTS[index].minValue));
+    const int16_t maxValue = static_cast<int16_t>(pgm_read_word(&READOUTS[index].maxValue));
+    const int32_t lower = (values[index] < minValue) ? values[index] : minValue;
+    const int32_t upper = (values[index] > maxValue) ? values[index] : maxValue;
+    return static_cast<int16_t>(constrain(value, lower, upper));
+}
+
+
+ReadoutDefinition ReadoutDevice::readDefinition(const uint8_t index) {
+    ReadoutDefinition definition;
+    memcpy_P(&definition, &READOUTS[index], sizeof(definition));
+    return definition;
+}
+
+
+/**
+ * @brief Einen Rohwert rechtsbündig formatieren.
+ *
+ * Die Ziffern werden von rechts nach links erzeugt; vor dem Dezimalpunkt steht mindestens eine
+ * Ziffer. Die restlichen Stellen werden mit Blanks bzw.\ (READOUT_LEADING_ZEROS) mit Nullen
+ * aufgefüllt. Passt der Wert nicht in die Anzeige, werden nur Minuszeichen angezeigt.
+ *
+ * @param definition Tabelleneintrag der Anzeige.
+ * @param value      Rohwert (Festkomma).
+ * @param text       Puffer für mindestens MAX_7SEGMENT_UNITS + 2 Zeichen.
+ * @return @em text
+ */
+char *ReadoutDevice::format(const ReadoutDefinition &definition, const int16_t value, char *text) {
+    const uint8_t digits = min(definition.digits, MAX_7SEGMENT_UNITS);
+    const bool isNegative = (value < 0);
+    uint16_t magnitude = isNegative ? static_cast<uint16_t>(-static_cast<int32_t>(value)) : static_cast<uint16_t>(value);
+    char buffer[MAX_7SEGMENT_UNITS];
+    int8_t pos = static_cast<int8_t>(digits) - 1;
+
+    if ((value == 0) && ((definition.flags & READOUT_BLANK_ZERO) != 0)) {
+        memset(text, ' ', digits);
+        text[digits] = '\0';
+        return text;
+    }
+    // Ziffern erzeugen, mindestens bis zur Einerstelle
+    for (uint8_t count = 0; (pos >= 0) && ((magnitude != 0) || (count <= definition.decimals)); ++count, --pos) {
+        buffer[pos] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    // Vorzeichen und Auffüllen
+    const char fill = ((definition.flags & READOUT_LEADING_ZEROS) != 0) ? '0' : ' ';
+    for (int8_t p = pos; p >= 0; --p) {
+        buffer[p] = fill;
+    }
+    if (isNegative) {
+        if (pos < 0) {
+            magnitude = 1;      // kein Platz für das Vorzeichen -> Überlauf
+        } else {
+            buffer[(fill == '0') ? 0 : pos] = '-';
+        }
+    }
+    if (magnitude != 0) {
+        memset(buffer, '-', digits);
+    }
+    // Ausgabe mit Dezimalpunkt hinter der letzten Vorkommastelle
+    uint8_t out = 0;
+    for (uint8_t p = 0; p != digits; ++p) {
+        text[out++] = buffer[p];
+        if ((definition.decimals != 0) && (p + 1 + definition.decimals == digits)) {
+            text[out++] = '.';
+        }
+    }
+    text[out] = '\0';
+    return text;
+}
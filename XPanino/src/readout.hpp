@@ -0,0 +1,100 @@
+/***************************************************************************************************
+ * @file readout.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em ReadoutDevice für tabellengesteuerte Zahlenanzeigen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <buffer.hpp>
+#include <device.hpp>
+#include <ledmatrix.hpp>
+
+const char DEVICE_READOUT[] = "RD";     ///< Device der tabellengesteuerten Anzeigen
+const char READOUT_VALUE[] = "V";       ///< Event: Wert anzeigen; Parameter 1 = Value-Id, Parameter 2 = Rohwert
+const char READOUT_RATE[] = "R";        ///< Event: Änderungsrate; Parameter 1 = Value-Id, Parameter 2 = Rohwert pro Minute
+
+// Formatierungsregeln (Bitmaske, vgl. ReadoutDefinition::flags)
+const uint8_t READOUT_LEADING_ZEROS = 0x01;     ///< Führende Nullen anzeigen statt Blanks
+const uint8_t READOUT_BLANK_ZERO = 0x02;        ///< Beim Wert 0 nichts anzeigen
+
+const uint8_t NO_OF_READOUTS = 2;       ///< Anzahl Einträge in der Tabelle READOUTS (readout.cpp, per static_assert geprüft)
+const unsigned long READOUT_MAX_EXTRAPOLATION = 10000;  ///< Max. Dauer der Extrapolation ohne neuen Wert in Millisekunden
+
+
+/***************************************************************************************************
+ * @brief Ein Eintrag der Tabelle der Anzeigen (im Flash).
+ *
+ * Der Wert kommt als ganze Zahl (Festkomma) vom PC; @em decimals gibt an, wie viele der Stellen
+ * hinter dem Dezimalpunkt stehen. Beispiel: decimals = 1, Rohwert 138 -> Anzeige "13.8".
+ * Liegt der Rohwert außerhalb von @em minValue bis @em maxValue, blinkt die Anzeige.
+ *
+ */
+class ReadoutDefinition {
+public:
+    uint8_t valueId;        ///< Id des Werts im Protokoll ("RD;V;<valueId>;<Rohwert>")
+    uint8_t fieldId;        ///< Id des Display-Felds
+    LedMatrixPos firstPos;  ///< Position der ersten 7-Segment-Anzeige; die weiteren folgen in den nächsten Rows
+    uint8_t digits;         ///< Anzahl 7-Segment-Anzeigen
+    uint8_t decimals;       ///< Anzahl Nachkommastellen
+    uint8_t flags;          ///< Formatierungsregeln READOUT_xxx
+    int16_t minValue;       ///< Kleinster Rohwert ohne Blinken
+    int16_t maxValue;       ///< Größter Rohwert ohne Blinken
+};
+
+
+/***************************************************************************************************
+ * @brief Generische Zahlenanzeigen, die vollständig über die Tabelle @em READOUTS konfiguriert werden.
+ *
+ * Für eine neue Anzeige (z.B.\ Volts, EGT, Fuel) genügt ein weiterer Tabelleneintrag; eine eigene
+ * Klasse ist nicht nötig.
+ *
+ * Für gleichmäßig veränderliche Werte (z.B.\ Flightlevel im Steigflug) kann der PC zusätzlich die
+ * Änderungsrate senden ("RD;R;<valueId>;<Rohwert pro Minute>"). Die Anzeige rechnet dann ab dem
+ * Empfang des letzten Werts lokal mit ganzen Zahlen weiter, sodass der PC nur noch bei einer
+ * merklichen Abweichung einen neuen Wert senden muss. Ein neuer Wert ersetzt den extrapolierten Wert
+ * sofort. Kommt länger als READOUT_MAX_EXTRAPOLATION Millisekunden kein Wert, bleibt die Anzeige stehen.
+ * Die Extrapolation endet außerdem an @em minValue bzw. @em maxValue des Tabelleneintrags.
+ *
+ */
+class ReadoutDevice : public Device {
+public:
+    ReadoutDevice();
+
+    /**
+     * @brief Vom PC empfangene Werte übernehmen.
+     *
+     * @param event Das zu verarbeitende Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Geänderte Werte anzeigen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     */
+    void show();
+
+private:
+    int16_t values[NO_OF_READOUTS];     ///< Zuletzt empfangene bzw. beim Empfang der Rate extrapolierte Rohwerte
+    int16_t rates[NO_OF_READOUTS];      ///< Änderungsrate in Rohwert pro Minute; 0 = nicht extrapolieren
+    unsigned long valueTimes[NO_OF_READOUTS];  ///< Zeitpunkt (millis()), zu dem @em values gültig war
+    int16_t shownValues[NO_OF_READOUTS];       ///< Zuletzt angezeigte Rohwerte
+    bool isValid[NO_OF_READOUTS];       ///< Für die Anzeige wurde schon ein Wert empfangen
+    bool isChanged[NO_OF_READOUTS];     ///< Die Anzeige muss aktualisiert werden
+    bool isPowered;                     ///< Zuletzt angezeigter Stromstatus
+
+    /// Den aktuellen, ggf. extrapolierten Rohwert einer Anzeige berechnen.
+    int16_t currentValue(uint8_t index) const;
+
+    /// Tabelleneintrag aus dem Flash lesen.
+    static ReadoutDefinition readDefinition(uint8_t index);
+
+    /// Einen Rohwert gemäß Tabelleneintrag als anzuzeigenden String (inkl. Dezimalpunkt) formatieren.
+    static char *format(const ReadoutDefinition &definition, int16_t value, char *text);
+};
@@ -0,0 +1,75 @@
+/***************************************************************************************************
+ * @file spscqueue.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Sperrfreie Queue für genau einen Erzeuger und einen Verbraucher (SPSC).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <hal.hpp>
+
+
+/***************************************************************************************************
+ * @brief Ringpuffer fester Größe für genau einen Erzeuger und einen Verbraucher.
+ *
+ * Erzeuger und Verbraucher dürfen auf verschiedenen Kernen laufen (vgl. @em XPANINO_DUAL_CORE).
+ * push() schreibt nur @em head, pop() nur @em tail; die Indizes sind einzelne Bytes und werden
+ * deshalb atomar gelesen und geschrieben. Die Speicherbarrieren stellen sicher, dass ein Element
+ * vollständig geschrieben ist, bevor der Verbraucher es sieht, und vollständig gelesen ist, bevor
+ * der Erzeuger den Platz wiederverwendet.
+ *
+ * @tparam T    Typ der Elemente; wird kopiert.
+ * @tparam SIZE Anzahl Plätze; es passen @em SIZE - 1 Elemente in die Queue.
+ **************************************************************************************************/
+template <class T, uint8_t SIZE>
+class SpscQueue {
+public:
+    /**
+     * @brief Element hinten anfügen. Nur vom Erzeuger aufrufen.
+     *
+     * @return true Das Element wurde angefügt.
+     * @return false Die Queue ist voll; das Element wurde nicht angefügt.
+     */
+    bool push(const T &item) {
+        const uint8_t next = static_cast<uint8_t>((head + 1) % SIZE);
+        if (next == tail) {
+            return false;
+        }
+        items[head] = item;
+        Hal::memoryBarrier();   // Element schreiben, bevor head es freigibt
+        head = next;
+        return true;
+    }
+
+    /**
+     * @brief Vorderstes Element entnehmen. Nur vom Verbraucher aufrufen.
+     *
+     * @return true Das Element wurde nach @em item kopiert.
+     * @return false Die Queue ist leer; @em item ist unverändert.
+     */
+    bool pop(T &item) {
+        if (tail == head) {
+            return false;
+        }
+        Hal::memoryBarrier();   // erst head lesen, dann das Element
+        item = items[tail];
+        Hal::memoryBarrier();   // Element lesen, bevor tail den Platz freigibt
+        tail = static_cast<uint8_t>((tail + 1) % SIZE);
+        return true;
+    }
+
+    /// @brief @em true, wenn die Queue leer ist.
+    bool isEmpty() const { return tail == head; }
+
+private:
+    static_assert(SIZE >= 2, "SpscQueue braucht mindestens zwei Plätze");
+
+    T items[SIZE];                  ///< Die Elemente
+    volatile uint8_t head = 0;      ///< Nächster freier Platz; nur der Erzeuger schreibt
+    volatile uint8_t tail = 0;      ///< Vorderstes Element; nur der Verbraucher schreibt
+};
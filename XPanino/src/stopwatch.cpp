@@ -0,0 +1,70 @@
+/***************************************************************************************************
+ * @file stopwatch.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em Stopwatch.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <hal.hpp>
+#include <stopwatch.hpp>
+
+const unsigned long MILLIS_PER_SECOND = 1000;
+
+
+Stopwatch::Stopwatch() {
+    running = false;
+    seconds = 0;
+    lastMillis = 0;
+    remainderMillis = 0;
+}
+
+
+void Stopwatch::start() {
+    if (! running) {
+        running = true;
+        // Den beim Anhalten angebrochenen Rest der Sekunde weiterzählen.
+        lastMillis = Hal::millis() - remainderMillis;
+    }
+}
+
+
+void Stopwatch::stop() {
+    if (running) {
+        update();
+        remainderMillis = Hal::millis() - lastMillis;
+        running = false;
+    }
+}
+
+
+void Stopwatch::reset() {
+    running = false;
+    seconds = 0;
+    remainderMillis = 0;
+}
+
+
+uint32_t Stopwatch::getSeconds() {
+    update();
+    return seconds;
+}
+
+
+void Stopwatch::setSeconds(const uint32_t newSeconds) {
+    seconds = newSeconds;
+    lastMillis = Hal::millis();
+    remainderMillis = 0;
+}
+
+
+void Stopwatch::update() {
+    if (running) {
+        // Die Differenz ist auch beim Überlauf von millis() korrekt.
+        const unsigned long fullSeconds = (Hal::millis() - lastMillis) / MILLIS_PER_SECOND;
+        seconds += fullSeconds;
+        lastMillis += fullSeconds * MILLIS_PER_SECOND;
+    }
+}
@@ -0,0 +1,64 @@
+/***************************************************************************************************
+ * @file stopwatch.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em Stopwatch.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+/***************************************************************************************************
+ * @brief Stoppuhr mit Sekundenauflösung auf Basis von millis(), z.B.\ für Elapsed und Flight Time.
+ *
+ * Die Stoppuhr zählt volle Sekunden; der Rest in Millisekunden bleibt im Startzeitpunkt
+ * @em lastMillis erhalten, sodass keine Zeit verloren geht; beim Anhalten wird er in
+ * @em remainderMillis gemerkt und beim nächsten Start weitergezählt. Da nur die Differenz zweier
+ * millis()-Werte verwendet wird, ist der Überlauf von millis() (nach ca. 50 Tagen) unschädlich,
+ * solange @em getSeconds() mindestens einmal je Überlaufperiode aufgerufen wird.
+ *
+ */
+class Stopwatch {
+public:
+    Stopwatch();
+
+    /// @brief Die Zählung starten bzw. fortsetzen.
+    void start();
+
+    /// @brief Die Zählung anhalten. Die bisher gezählte Zeit bleibt erhalten.
+    void stop();
+
+    /// @brief Die Zählung anhalten und auf 0 zurücksetzen.
+    void reset();
+
+    /// @brief Prüfen, ob die Stoppuhr läuft.
+    inline bool isRunning() const { return running; }
+
+    /**
+     * @brief Die gezählte Zeit abrufen.
+     *
+     * @return Gezählte Zeit in Sekunden.
+     */
+    uint32_t getSeconds();
+
+    /**
+     * @brief Die gezählte Zeit setzen, z.B.\ um eine vom PC gemeldete Zeit zu übernehmen.
+     *        Ob die Stoppuhr läuft, bleibt unverändert.
+     *
+     * @param newSeconds Neue Zeit in Sekunden.
+     */
+    void setSeconds(uint32_t newSeconds);
+
+private:
+    bool running;               ///< @em true, solange die Stoppuhr zählt.
+    uint32_t seconds;           ///< Gezählte volle Sekunden.
+    unsigned long lastMillis;   ///< millis() zum Zeitpunkt der zuletzt gezählten vollen Sekunde.
+    unsigned long remainderMillis;  ///< Beim Anhalten angebrochener Rest der Sekunde in Millisekunden.
+
+    /// Seit dem letzten Aufruf vergangene volle Sekunden aufaddieren.
+    void update();
+};
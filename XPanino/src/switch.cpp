@@ -10,7 +10,11 @@
 
 #include <buffer.hpp>
 #include <event.hpp>
+#include <hal.hpp>
 #include <switch.hpp>
+#include <txbuffer.hpp>
+
+extern TxBuffer txBuffer;
 
 /// @brief Dauer, ab wann ein Schalter lange eingeschaltet ist (3000 Millisekunden)
 const unsigned long LONG_ON = 3000;
@@ -20,7 +24,7 @@ const unsigned long LONG_ON = 3000;
 void Switch::setOn() {
     status = LOW;
     changed = true;
-    switchPressTime = millis();     // Einschalt"zeit" merken
+    switchPressTime = Hal::millis();     // Einschalt"zeit" merken
     longOnSent = false;
     longOn = false;
     onTime = 0;
@@ -30,7 +34,7 @@ void Switch::setOn() {
 void Switch::setOff() {
     status = HIGH;
     changed = true;
-    onTime = calcTimeDiff(switchPressTime, millis());   // Differenz zwischen Ein- und Ausschalt"zeit" merken
+    onTime = calcTimeDiff(switchPressTime, Hal::millis());   // Differenz zwischen Ein- und Ausschalt"zeit" merken
     longOnSent = true;
     longOn = false;
 }
@@ -50,23 +54,23 @@ void Switch::updateOnTime(const unsigned long &newOnTime) {
 
 
 void Switch::transmitStatus(uint8_t &row, uint8_t &col) {
-    // switchState = 0: Switch is off
-    // switchState = 1: Switch is on
-    // switchState = 2: Switch is long on
-    uint8_t switchState = 0;
+    uint8_t switchState = fetchSwitchState();
+    // Ereignis senden
+    // Diese Methode muss überschrieben werden.
+    transmit(row, col, switchState);
+}
+
+
+uint8_t Switch::fetchSwitchState() {
     if ((! longOnSent) && longOn) {
         // wenn der Schalter lang gedrückt ist und dieser Lang-Gedrückt-Status noch
         // nicht übertragen wurde, den Status "LON" (Long on) übertragen.
         longOnSent = true;
         changed = false;
-        switchState = 2;
-    } else {
-        // Den An- (1) / Aus- (0) Status des Schalters übertragen.
-        switchState = ((getStatus() == LOW) ? 1 : 0);
+        return SWITCH_STATE_LONG_ON;
     }
-    // Ereignis senden
-    // Diese Methode muss überschrieben werden.
-    transmit(row, col, switchState);
+    // Den An- (1) / Aus- (0) Status des Schalters übertragen.
+    return ((getStatus() == LOW) ? SWITCH_STATE_ON : SWITCH_STATE_OFF);
 }
 
 
@@ -82,14 +86,14 @@ void Switch::transmit(uint8_t &row, uint8_t &col, uint8_t &switchState) {
     char charRowCol[MAX_PARA_LENGTH * 2] = "";
 
     // set charsToSend according to value of data
-    if (switchState == 2) {
+    if (switchState == SWITCH_STATE_LONG_ON) {
         strcat(charsToSend, "LON;");
     } else {
-        strcat(charsToSend, ((switchState == 1) ? "ON;" : "OFF;"));
+        strcat(charsToSend, ((switchState == SWITCH_STATE_ON) ? "ON;" : "OFF;"));
     }
     snprintf (charRowCol, MAX_PARA_LENGTH * 2, "%u;%u", row, col);
     strcat(charsToSend, charRowCol);
-    Serial.println(charsToSend);
+    txBuffer.addMessage(charsToSend);
 }
 
 
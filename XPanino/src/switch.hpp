@@ -13,6 +13,11 @@
 
 #include <Arduino.h>
 
+// Konstanten für den übertragenen Schalterstatus
+const uint8_t SWITCH_STATE_OFF = 0;         ///< Schalter ist ausgeschaltet.
+const uint8_t SWITCH_STATE_ON = 1;          ///< Schalter ist eingeschaltet.
+const uint8_t SWITCH_STATE_LONG_ON = 2;     ///< Schalter ist lange (länger als 3 Sekunden) eingeschaltet.
+
 /*********************************************************************************************************//**
  * @brief Abbildung eines Schalters
  *
@@ -69,6 +74,18 @@ public:
     void transmitStatus(uint8_t &row, uint8_t &col);
 
 
+    /**
+     * @brief Den zu übertragenden Status des Schalters ermitteln. Dabei wird die Eigenschaft
+     *        @em changed des Schalters auf @false gesetzt.
+     *
+     * Wenn der Schalter länger als @em LONG_ON Millisekunden an ist, wird -- aber nur einmal --
+     * @em SWITCH_STATE_LONG_ON zurückgegeben.
+     *
+     * @return @em SWITCH_STATE_OFF, @em SWITCH_STATE_ON oder @em SWITCH_STATE_LONG_ON.
+     */
+    uint8_t fetchSwitchState();
+
+
     /**
      * @brief Physical transmitssion of the data. This method has to be overwritten in every derived class.
      *
@@ -0,0 +1,61 @@
+/***************************************************************************************************
+ * @file traffic.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em TrafficAnnunciator.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <traffic.hpp>
+
+extern LedMatrix leds;
+
+
+/**************************************************************************************************
+ * TrafficAnnunciator - public Methoden
+ *
+ **************************************************************************************************/
+
+TrafficAnnunciator::TrafficAnnunciator() {
+    level = 0;
+    shownLevel = 0;
+    isChanged = true;
+}
+
+
+void TrafficAnnunciator::processEvent(EventClass *event) {
+    if ((event == nullptr) || (strcmp(event->event, TRAFFIC_LEVEL) != 0)) {
+        return;
+    }
+    const int parameter = atoi(event->parameter1);
+    if ((parameter < 0) || (parameter > TRAFFIC_LEVEL_RESOLUTION)) {
+        return;
+    }
+    level = static_cast<uint8_t>(parameter);
+    isChanged = true;
+}
+
+
+void TrafficAnnunciator::show() {
+    const uint8_t current = isPowerAvailable() ? level : 0;
+    if ((! isChanged) && (current == shownLevel)) {
+        return;
+    }
+    const LedMatrixPos positions[NO_OF_TRAFFIC_LEDS] = {TRAFFIC_LED_TFC, TRAFFIC_LED_TA, TRAFFIC_LED_RA};
+    for (uint8_t index = 0; index != NO_OF_TRAFFIC_LEDS; ++index) {
+        if (index + 1 == current) {
+            leds.ledOn(positions[index]);
+        } else {
+            leds.ledOff(positions[index]);
+        }
+    }
+    if (current == TRAFFIC_LEVEL_RESOLUTION) {
+        leds.ledBlinkOn(TRAFFIC_LED_RA);
+    } else {
+        leds.ledBlinkOff(TRAFFIC_LED_RA);
+    }
+    shownLevel = current;
+    isChanged = false;
+}
@@ -0,0 +1,62 @@
+/***************************************************************************************************
+ * @file traffic.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em TrafficAnnunciator (Warnstufen-LEDs der Verkehrswarnung).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+#include <device.hpp>
+#include <ledmatrix.hpp>
+
+const char DEVICE_TRAFFIC[] = "TC";     ///< Device der Verkehrswarnung
+const char TRAFFIC_LEVEL[] = "LVL";     ///< Event: Warnstufe; Parameter 1 = 0 (kein Verkehr) bis 3 (RA)
+
+const uint8_t TRAFFIC_LEVEL_PROXIMATE = 1;  ///< Proximate Traffic: LED TFC
+const uint8_t TRAFFIC_LEVEL_TRAFFIC = 2;    ///< Traffic Advisory: LED TA
+const uint8_t TRAFFIC_LEVEL_RESOLUTION = 3; ///< Resolution Advisory: LED RA, blinkt
+const uint8_t NO_OF_TRAFFIC_LEDS = 3;
+
+// Position der LEDs in der LED-Matrix: Byte 0, Col 5 (Col 4 belegen Uhr und Transponder)
+const LedMatrixPos TRAFFIC_LED_TFC = {0, 5};    ///< Proximate Traffic
+const LedMatrixPos TRAFFIC_LED_TA = {1, 5};     ///< Traffic Advisory
+const LedMatrixPos TRAFFIC_LED_RA = {2, 5};     ///< Resolution Advisory
+
+
+/***************************************************************************************************
+ * @brief Anzeige der Warnstufe der Verkehrswarnung von XPIf mit drei LEDs.
+ *
+ * Es leuchtet nur die LED der aktuellen Stufe, bei einer Resolution Advisory blinkend. Die Stufe
+ * berechnet XPIf (Doku "XPIf", Abschnitt "Verkehrswarnung") und sendet sie nur bei einer Änderung;
+ * Richtung und Entfernung des gefährlichsten Flugzeugs kommen als Anzeigeinstrumente (`RD`). Ohne
+ * Batterie- und Avionics-Strom bleiben die LEDs dunkel.
+ *
+ */
+class TrafficAnnunciator : public Device {
+public:
+    TrafficAnnunciator();
+
+    /**
+     * @brief Die vom PC empfangene Warnstufe übernehmen.
+     *
+     * @param event Das zu verarbeitende Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Eine geänderte Warnstufe bzw. Stromversorgung anzeigen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     */
+    void show();
+
+private:
+    uint8_t level;          ///< Zuletzt empfangene Warnstufe
+    uint8_t shownLevel;     ///< Zuletzt angezeigte Warnstufe; 0 auch ohne Strom
+    bool isChanged;         ///< Die Anzeige muss aktualisiert werden
+};
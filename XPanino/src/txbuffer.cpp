@@ -0,0 +1,58 @@
+/***************************************************************************************************
+ * @file txbuffer.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Implementierung der Klasse @em TxBuffer.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <hal.hpp>
+#include <txbuffer.hpp>
+
+
+TxBuffer::TxBuffer() {
+    length = 0;
+    firstMessageTime = 0;
+    latencyBudget = TX_LATENCY_BUDGET;
+}
+
+
+void TxBuffer::addMessage(const char *message, const bool isUrgent) {
+    size_t messageLength = strlen(message);
+    if (messageLength > TX_PACKET_SIZE - TX_LINE_END_LENGTH) {
+        // Passt in kein Paket; zu lange Nachrichten werden abgeschnitten.
+        messageLength = TX_PACKET_SIZE - TX_LINE_END_LENGTH;
+    }
+    if (length + messageLength + TX_LINE_END_LENGTH > TX_PACKET_SIZE) {
+        // Die Nachricht passt nicht mehr in das aktuelle Paket.
+        flush();
+    }
+    if (length == 0) {
+        firstMessageTime = Hal::millis();
+    }
+    memcpy(buffer + length, message, messageLength);
+    length += messageLength;
+    buffer[length++] = '\r';     // Zeilenende wie Serial.println()
+    buffer[length++] = '\n';
+    if (isUrgent || (length == TX_PACKET_SIZE) || (latencyBudget == 0)) {
+        flush();
+    }
+}
+
+
+void TxBuffer::poll() {
+    // Die Differenz ist auch beim Überlauf von millis() korrekt.
+    if ((length != 0) && (Hal::millis() - firstMessageTime >= latencyBudget)) {
+        flush();
+    }
+}
+
+
+void TxBuffer::flush() {
+    if (length != 0) {
+        Hal::uartWrite(buffer, length);
+        length = 0;
+    }
+}
@@ -0,0 +1,67 @@
+/***************************************************************************************************
+ * @file txbuffer.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Interface der Klasse @em TxBuffer zum Bündeln der an den PC gesendeten Nachrichten.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <Arduino.h>
+
+const uint8_t TX_PACKET_SIZE = 64;              ///< Größe eines USB-Pakets des USB-Seriell-Wandlers 16U2
+const uint8_t TX_LINE_END_LENGTH = 2;           ///< Länge des Zeilenendes "\r\n"
+const unsigned long TX_LATENCY_BUDGET = 5;      ///< Max. Wartezeit einer Nachricht im Puffer in Millisekunden
+
+
+/***************************************************************************************************
+ * @brief Sendepuffer für die an den PC gesendeten Nachrichten.
+ *
+ * Der USB-Seriell-Wandler des Arduino Uno überträgt die Daten in USB-Paketen zu 64 Byte. Einzeln
+ * gesendete kurze Nachrichten (z.B. "S;S;ON;1;3") belegen jeweils nur einen kleinen Teil eines
+ * Pakets. Der TxBuffer sammelt deshalb die Nachrichten und gibt sie paketweise mit einem einzigen
+ * Hal::uartWrite() aus:
+ * - sobald die nächste Nachricht nicht mehr in das Paket passt bzw. das Paket voll ist,
+ * - spätestens @em latencyBudget Millisekunden nach der ersten Nachricht im Puffer (vgl. poll()),
+ * - sofort bei dringenden Nachrichten (z.B. die Antwort auf PING) bzw. bei flush() (z.B. nach den
+ *   geänderten Schaltern eines Durchlaufs).
+ *
+ * Jede Nachricht wird wie bei Serial.println() mit "\\r\\n" abgeschlossen.
+ *
+ **************************************************************************************************/
+class TxBuffer {
+public:
+    TxBuffer();
+
+    /**
+     * @brief Eine Nachricht (ohne Zeilenende) an den Puffer anhängen.
+     *
+     * @param message  Die Nachricht, z.B. "M803;LT;143000".
+     * @param isUrgent @em true: Die Nachricht und alle vorher gepufferten Nachrichten sofort senden.
+     */
+    void addMessage(const char *message, bool isUrgent = false);
+
+
+    /**
+     * @brief Den Puffer senden, wenn die Wartezeit der ersten Nachricht abgelaufen ist.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     */
+    void poll();
+
+
+    /// @brief Alle gepufferten Nachrichten sofort senden.
+    void flush();
+
+
+    /// @brief Max. Wartezeit einer Nachricht im Puffer in Millisekunden setzen; 0 = nicht puffern.
+    inline void setLatencyBudget(unsigned long budget) { latencyBudget = budget; }
+
+private:
+    char buffer[TX_PACKET_SIZE];        ///< Gepufferte Nachrichten, jeweils mit "\\r\\n" abgeschlossen
+    uint8_t length;                     ///< Anzahl belegter Zeichen in @em buffer
+    unsigned long firstMessageTime;     ///< Zeitpunkt, zu dem die erste Nachricht gepuffert wurde
+    unsigned long latencyBudget;        ///< Max. Wartezeit einer Nachricht im Puffer in Millisekunden
+};
@@ -1,13 +1,402 @@
 /*********************************************************************************************************//**
  * @file xpdr.cpp
  * @author Christian Harraeus <christian@harraeus.de>
- * @brief Implementierung der Klasse @em ClockDavtronM803
+ * @brief Implementierung der Klasse @em TransponderKT76C
  * @version 0.2
  * @date 2022-12-08
  *
  * Copyright © 2017 - 2022. All rights reserved.
  ************************************************************************************************************/
 
+#include <hal.hpp>
 #include <xpdr.hpp>
 
-// Konstanten der möglichen Event-Strings
+extern LedMatrix leds;
+
+const char VFR_CODE[] = "7000";     ///< Voreingestellter VFR-Code
+
+/**************************************************************************************************
+ * Tabellen des Zustandsautomaten
+ *
+ **************************************************************************************************/
+
+// Indizes der Aktionen in TransponderKT76C::actions
+const uint8_t ACTION_ENTER_MODE = 1;        ///< Betriebsmodus anzeigen und an den PC übertragen
+const uint8_t ACTION_ENTER_TEST = 2;        ///< Testmodus starten
+const uint8_t ACTION_ENTER_DIGIT = 3;       ///< Eine Stelle des Codes eingeben
+const uint8_t ACTION_CLEAR_DIGIT = 4;       ///< Die zuletzt eingegebene Stelle löschen
+const uint8_t ACTION_CANCEL_ENTRY = 5;      ///< Unvollständige Eingabe verwerfen
+const uint8_t ACTION_SELECT_VFR = 6;        ///< VFR-Code einstellen
+const uint8_t ACTION_RESTORE_CODE = 7;      ///< Vor VFR aktiven Code wieder einstellen
+const uint8_t ACTION_IDENT = 8;             ///< Squawk-Ident senden
+const uint8_t ACTION_ENTER_OFF = 9;         ///< Anzeige ausschalten
+const uint8_t ACTION_TRANSMIT_OFF = 10;     ///< Betriebsmodus OFF an den PC übertragen
+
+// Indizes der Guards in TransponderKT76C::guards
+const uint8_t GUARD_KNOB_NOT_OFF = 1;       ///< Betriebsmodus-Wahlschalter steht nicht auf OFF
+const uint8_t GUARD_HAS_POWER = 2;          ///< Batterie und Avionics haben Strom
+
+/// Zustands-Id für die Tabellen
+static constexpr uint8_t id(const XpdrModeState state) { return static_cast<uint8_t>(state); }
+
+
+const HsmAction<TransponderKT76C> TransponderKT76C::actions[] PROGMEM = {
+    nullptr,
+    TransponderKT76C::enterMode,        // ACTION_ENTER_MODE
+    TransponderKT76C::enterTest,        // ACTION_ENTER_TEST
+    TransponderKT76C::enterDigit,       // ACTION_ENTER_DIGIT
+    TransponderKT76C::clearDigit,       // ACTION_CLEAR_DIGIT
+    TransponderKT76C::cancelCodeEntry,  // ACTION_CANCEL_ENTRY
+    TransponderKT76C::selectVfrCode,    // ACTION_SELECT_VFR
+    TransponderKT76C::restoreCode,      // ACTION_RESTORE_CODE
+    TransponderKT76C::ident,            // ACTION_IDENT
+    TransponderKT76C::enterOff,         // ACTION_ENTER_OFF
+    TransponderKT76C::transmitOff       // ACTION_TRANSMIT_OFF
+};
+
+
+const HsmGuard<TransponderKT76C> TransponderKT76C::guards[] PROGMEM = {
+    nullptr,
+    TransponderKT76C::isKnobNotOff,     // GUARD_KNOB_NOT_OFF
+    TransponderKT76C::hasPower          // GUARD_HAS_POWER
+};
+
+
+const HsmState TransponderKT76C::states[] PROGMEM = {
+    // parent,                   initial,                 entry,              exit
+    {HSM_NO_STATE,               HSM_NO_STATE,            ACTION_ENTER_OFF,   HSM_NO_FUNC},   // OFF
+    {HSM_NO_STATE,               id(XpdrModeState::SBY),  HSM_NO_FUNC,        HSM_NO_FUNC},   // ACTIVE
+    {id(XpdrModeState::ACTIVE),  HSM_NO_STATE,            ACTION_ENTER_MODE,  HSM_NO_FUNC},   // SBY
+    {id(XpdrModeState::ACTIVE),  HSM_NO_STATE,            ACTION_ENTER_TEST,  HSM_NO_FUNC},   // TST
+    {id(XpdrModeState::ACTIVE),  HSM_NO_STATE,            ACTION_ENTER_MODE,  HSM_NO_FUNC},   // ON
+    {id(XpdrModeState::ACTIVE),  HSM_NO_STATE,            ACTION_ENTER_MODE,  HSM_NO_FUNC}    // ALT
+};
+
+
+/// Spalten: POWER_ON, POWER_OFF, KNOB_OFF, KNOB_SBY, KNOB_TST, KNOB_ON, KNOB_ALT, BTN_IDT, BTN_VFR,
+/// BTN_VFR_LON, BTN_CLR, BTN_DIGIT, TIMEOUT. Nicht angegebene Einträge bedeuten "nicht behandelt".
+/// SBY, ON und ALT erben alle Transitionen von ACTIVE.
+const HsmTransition TransponderKT76C::transitions[NO_OF_XPDR_MODE_STATES][NO_OF_XPDR_EVENTS] PROGMEM = {
+    /* OFF    */ {hsmTo(id(XpdrModeState::ACTIVE), HSM_NO_FUNC, GUARD_KNOB_NOT_OFF),
+                  hsmNone(),
+                  hsmNone(),
+                  hsmTo(id(XpdrModeState::SBY), HSM_NO_FUNC, GUARD_HAS_POWER),
+                  hsmTo(id(XpdrModeState::TST), HSM_NO_FUNC, GUARD_HAS_POWER),
+                  hsmTo(id(XpdrModeState::ON), HSM_NO_FUNC, GUARD_HAS_POWER),
+                  hsmTo(id(XpdrModeState::ALT), HSM_NO_FUNC, GUARD_HAS_POWER)},
+    /* ACTIVE */ {hsmNone(),
+                  hsmTo(id(XpdrModeState::OFF), ACTION_TRANSMIT_OFF),
+                  hsmTo(id(XpdrModeState::OFF), ACTION_TRANSMIT_OFF),
+                  hsmTo(id(XpdrModeState::SBY)),
+                  hsmTo(id(XpdrModeState::TST)),
+                  hsmTo(id(XpdrModeState::ON)),
+                  hsmTo(id(XpdrModeState::ALT)),
+                  hsmDo(ACTION_IDENT),
+                  hsmDo(ACTION_SELECT_VFR),
+                  hsmDo(ACTION_RESTORE_CODE),
+                  hsmDo(ACTION_CLEAR_DIGIT),
+                  hsmDo(ACTION_ENTER_DIGIT),
+                  hsmDo(ACTION_CANCEL_ENTRY)},
+    /* SBY    */ {},
+    /* TST    */ {hsmNone(), hsmNone(), hsmNone(), hsmNone(), hsmNone(), hsmNone(), hsmNone(),
+                  hsmDo(HSM_NO_FUNC),           // Im Testmodus werden die Tasten ignoriert.
+                  hsmDo(HSM_NO_FUNC),
+                  hsmDo(HSM_NO_FUNC),
+                  hsmDo(HSM_NO_FUNC),
+                  hsmDo(HSM_NO_FUNC),
+                  hsmTo(id(XpdrModeState::SBY))},
+    /* ON     */ {},
+    /* ALT    */ {}
+};
+
+
+const HsmDefinition<TransponderKT76C> TransponderKT76C::definition = {
+    states, &transitions[0][0], actions, guards,
+    NO_OF_XPDR_MODE_STATES, NO_OF_XPDR_EVENTS, static_cast<uint8_t>(XpdrEvent::TIMEOUT)
+};
+
+
+/**************************************************************************************************
+ * TransponderKT76C - public Methoden
+ *
+ **************************************************************************************************/
+
+TransponderKT76C::TransponderKT76C() : hsm(*this, definition) {
+    isChanged = true;
+    isPowered = false;      ///< Beim ersten show() wird der Stromstatus an den Zustandsautomaten gemeldet.
+    knobPosition = static_cast<uint8_t>(XpdrEvent::KNOB_OFF);
+    pendingDigit = 0;
+    isVfrLongSent = false;
+    entryPos = 0;
+    strcpy(code, VFR_CODE);
+    strcpy(previousCode, VFR_CODE);
+    strcpy(entryCode, "    ");
+    strcpy(flightLevel, "000");
+    isIdentActive = false;
+    identStartTime = 0;
+
+    ///< Define the FL display.
+    flDisplay = 2;
+    leds.defineDisplayField(flDisplay, 0, {0, 8});      ///< Die 1. 7-Segment-Anzeige liegt auf der Row 0 und den Cols 8 bis 15: Hunderterstelle.
+    leds.defineDisplayField(flDisplay, 1, {1, 8});      ///< Die 2. 7-Segment-Anzeige liegt auf der Row 1 und den Cols 8 bis 15: Zehnerstelle .
+    leds.defineDisplayField(flDisplay, 2, {2, 8});      ///< Die 3. 7-Segment-Anzeige liegt auf der Row 2 und den Cols 8 bis 15: Einerstelle.
+
+    ///< Define the squawk code display.
+    codeDisplay = 3;
+    leds.defineDisplayField(codeDisplay, 0, {3, 8});    ///< Die 1. 7-Segment-Anzeige liegt auf der Row 3 und den Cols 8 bis 15: Tausenderstelle.
+    leds.defineDisplayField(codeDisplay, 1, {4, 8});    ///< Die 2. 7-Segment-Anzeige liegt auf der Row 4 und den Cols 8 bis 15: Hunderterstelle.
+    leds.defineDisplayField(codeDisplay, 2, {5, 8});    ///< Die 3. 7-Segment-Anzeige liegt auf der Row 5 und den Cols 8 bis 15: Zehnerstelle.
+    leds.defineDisplayField(codeDisplay, 3, {6, 8});    ///< Die 4. 7-Segment-Anzeige liegt auf der Row 6 und den Cols 8 bis 15: Einerstelle.
+
+    LED_ALT = {6, 4};       ///< Die LED "ALT" liegt auf Row=6 und Col=4.
+    LED_R = {7, 4};         ///< Die LED "R" liegt auf Row=7 und Col=4.
+
+    ///< Der Zustandsautomat startet ohne Strom.
+    hsm.start(id(XpdrModeState::OFF));
+}
+
+
+void TransponderKT76C::processEvent(EventClass *event) {
+    if (event == nullptr) {
+        return;
+    }
+    if ((strcmp(event->event, XPDR_CODE) == 0) && (strlen(event->parameter1) == XPDR_CODE_LENGTH)) {
+        strcpy(code, event->parameter1);
+        isChanged = true;
+    } else if (strcmp(event->event, XPDR_FL) == 0) {
+        strncpy(flightLevel, event->parameter1, XPDR_FL_LENGTH);
+        flightLevel[XPDR_FL_LENGTH] = '\0';
+        isChanged = true;
+    }
+}
+
+
+bool TransponderKT76C::processSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) {
+    if (row == XPDR_SWITCH_ROW_DIGITS) {
+        if (col > XPDR_MAX_DIGIT) {
+            return false;   // Schalter gehört nicht zum Transponder
+        }
+        if (switchState == SWITCH_STATE_ON) {
+            pendingDigit = col;
+            post(XpdrEvent::BTN_DIGIT);
+        }
+        return true;
+    }
+    if (row != XPDR_SWITCH_ROW_FUNCTIONS) {
+        return false;
+    }
+    if (col >= XPDR_SWITCH_KNOB_OFF) {
+        // Betriebsmodus-Wahlschalter: nur die neu eingestellte Position ist relevant.
+        if (switchState == SWITCH_STATE_ON) {
+            knobPosition = static_cast<uint8_t>(XpdrEvent::KNOB_OFF) + col - XPDR_SWITCH_KNOB_OFF;
+            hsm.dispatch(knobPosition);
+        }
+        return true;
+    }
+    switch (col) {
+        case XPDR_SWITCH_VFR : {
+            // Kurzer oder langer Druck steht erst beim Loslassen bzw. nach LONG_ON fest.
+            if (switchState == SWITCH_STATE_ON) {
+                isVfrLongSent = false;
+            } else if (switchState == SWITCH_STATE_LONG_ON) {
+                isVfrLongSent = true;
+                post(XpdrEvent::BTN_VFR_LON);
+            } else if (! isVfrLongSent) {
+                post(XpdrEvent::BTN_VFR);
+            }
+            break;
+        }
+        case XPDR_SWITCH_IDT : {
+            if (switchState == SWITCH_STATE_ON) {
+                post(XpdrEvent::BTN_IDT);
+            }
+            break;
+        }
+        case XPDR_SWITCH_CLR : {
+            if (switchState == SWITCH_STATE_ON) {
+                post(XpdrEvent::BTN_CLR);
+            }
+            break;
+        }
+        default : ;
+    }
+    return true;
+}
+
+
+void TransponderKT76C::show() {
+    // Änderungen der Stromversorgung an den Zustandsautomaten melden
+    const bool powerAvailable = isDevicePowerAvailable();
+    if (powerAvailable != isPowered) {
+        isPowered = powerAvailable;
+        if (powerAvailable) {
+            // Direkt in den Modus der Stellung des Wahlschalters wechseln, damit nur dieser an den
+            // PC geht. Steht er auf TST, verhält sich der Transponder wie im Modus SBY.
+            if (knobPosition == static_cast<uint8_t>(XpdrEvent::KNOB_TST)) {
+                post(XpdrEvent::POWER_ON);
+            } else {
+                hsm.dispatch(knobPosition);
+            }
+        } else {
+            post(XpdrEvent::POWER_OFF);
+        }
+    }
+    const unsigned long now = Hal::millis();
+    hsm.tick(now);
+    if (isIdentActive && (now - identStartTime >= XPDR_IDENT_DURATION)) {
+        isIdentActive = false;
+        isChanged = true;
+    }
+
+    if (isChanged) {
+        switch (getMode()) {
+            case XpdrModeState::OFF : {
+                leds.display(flDisplay, "   ");
+                leds.display(codeDisplay, "    ");
+                leds.ledOff(LED_ALT);
+                leds.ledBlinkOff(LED_R, BLINK_SLOW);
+                leds.ledOff(LED_R);
+                break;
+            }
+            case XpdrModeState::TST : {
+                leds.display(flDisplay, "8.8.8.");
+                leds.display(codeDisplay, "8.8.8.8.");
+                leds.ledOn(LED_ALT);
+                leds.ledBlinkOff(LED_R, BLINK_SLOW);
+                leds.ledOn(LED_R);
+                break;
+            }
+            default : {
+                // SBY, ON und ALT
+                leds.display(flDisplay, flightLevel);
+                leds.display(codeDisplay, (entryPos != 0) ? entryCode : code);
+                if (getMode() == XpdrModeState::ALT) {
+                    leds.ledOn(LED_ALT);
+                } else {
+                    leds.ledOff(LED_ALT);
+                }
+                if (isIdentActive && (getMode() != XpdrModeState::SBY)) {
+                    leds.ledBlinkOff(LED_R, BLINK_SLOW);
+                    leds.ledOn(LED_R);
+                } else if (getMode() == XpdrModeState::ALT) {
+                    leds.ledOn(LED_R);
+                    leds.ledBlinkOn(LED_R, BLINK_SLOW);
+                } else {
+                    leds.ledBlinkOff(LED_R, BLINK_SLOW);
+                    leds.ledOff(LED_R);
+                }
+            }
+        }
+        isChanged = false;
+    }
+}
+
+
+/**************************************************************************************************
+ * TransponderKT76C - private Methoden
+ *
+ **************************************************************************************************/
+
+void TransponderKT76C::enterOff(TransponderKT76C &xpdr) {
+    xpdr.entryPos = 0;
+    xpdr.isChanged = true;
+}
+
+
+void TransponderKT76C::transmitOff(TransponderKT76C & /* xpdr */) {
+    transmitEvent(DEVICE_XPDR, XPDR_MODE, "OFF");
+}
+
+
+void TransponderKT76C::enterMode(TransponderKT76C &xpdr) {
+    const char *modeName = "SBY";
+    switch (xpdr.getMode()) {
+        case XpdrModeState::TST : modeName = "TST"; break;
+        case XpdrModeState::ON  : modeName = "ON";  break;
+        case XpdrModeState::ALT : modeName = "ALT"; break;
+        default : ;
+    }
+    xpdr.entryPos = 0;      // Eine unvollständige Code-Eingabe verfällt beim Moduswechsel.
+    xpdr.isChanged = true;
+    transmitEvent(DEVICE_XPDR, XPDR_MODE, modeName);
+}
+
+
+void TransponderKT76C::enterTest(TransponderKT76C &xpdr) {
+    enterMode(xpdr);
+    xpdr.hsm.startTimer(XPDR_TEST_DURATION);
+}
+
+
+void TransponderKT76C::enterDigit(TransponderKT76C &xpdr) {
+    if (xpdr.entryPos == 0) {
+        strcpy(xpdr.entryCode, "    ");
+    }
+    xpdr.entryCode[xpdr.entryPos++] = static_cast<char>('0' + xpdr.pendingDigit);
+    if (xpdr.entryPos == XPDR_CODE_LENGTH) {
+        // Code vollständig: übernehmen und an den PC übertragen.
+        xpdr.entryPos = 0;
+        xpdr.hsm.stopTimer();
+        xpdr.commitCode(xpdr.entryCode);
+    } else {
+        xpdr.hsm.startTimer(XPDR_CODE_ENTRY_TIMEOUT);
+    }
+    xpdr.isChanged = true;
+}
+
+
+void TransponderKT76C::clearDigit(TransponderKT76C &xpdr) {
+    if (xpdr.entryPos != 0) {
+        xpdr.entryCode[--xpdr.entryPos] = ' ';
+        xpdr.hsm.startTimer(XPDR_CODE_ENTRY_TIMEOUT);
+        xpdr.isChanged = true;
+    }
+}
+
+
+void TransponderKT76C::cancelCodeEntry(TransponderKT76C &xpdr) {
+    xpdr.entryPos = 0;
+    xpdr.isChanged = true;
+}
+
+
+void TransponderKT76C::selectVfrCode(TransponderKT76C &xpdr) {
+    xpdr.entryPos = 0;
+    xpdr.hsm.stopTimer();
+    // Ein zweiter Druck auf VFR darf den gemerkten Code nicht mit dem VFR-Code überschreiben.
+    if (strcmp(xpdr.code, VFR_CODE) != 0) {
+        strcpy(xpdr.previousCode, xpdr.code);
+    }
+    xpdr.commitCode(VFR_CODE);
+}
+
+
+void TransponderKT76C::restoreCode(TransponderKT76C &xpdr) {
+    xpdr.commitCode(xpdr.previousCode);
+}
+
+
+void TransponderKT76C::ident(TransponderKT76C &xpdr) {
+    xpdr.isIdentActive = true;
+    xpdr.identStartTime = Hal::millis();
+    xpdr.isChanged = true;
+    transmitEvent(DEVICE_XPDR, XPDR_IDT);
+}
+
+
+bool TransponderKT76C::isKnobNotOff(TransponderKT76C &xpdr) {
+    return xpdr.knobPosition != static_cast<uint8_t>(XpdrEvent::KNOB_OFF);
+}
+
+
+bool TransponderKT76C::hasPower(TransponderKT76C &xpdr) {
+    return xpdr.isPowered;
+}
+
+
+void TransponderKT76C::commitCode(const char *newCode) {
+    strncpy(code, newCode, XPDR_CODE_LENGTH);
+    code[XPDR_CODE_LENGTH] = '\0';
+    isChanged = true;
+    transmitEvent(DEVICE_XPDR, XPDR_CODE, code);
+}
@@ -13,16 +13,79 @@
 #include <Arduino.h>
 #include <buffer.hpp>
 #include <device.hpp>
+#include <hsm.hpp>
 #include <Switchmatrix.hpp>
 #include <ledmatrix.hpp>
 
 const char DEVICE_XPDR[] = "XPDR";
 
+// Event-Konstanten (vgl. Doku "Kommunikation")
+const char XPDR_CODE[] = "CODE";    ///< XPDR-Code anzeigen bzw. eingestellten Code an den PC übertragen
+const char XPDR_FL[] = "F";         ///< Flightlevel für Transponder
+const char XPDR_IDT[] = "IDT";      ///< Squawk-Ident an den PC übertragen
+const char XPDR_MODE[] = "MODE";    ///< Betriebsmodus an den PC übertragen
+
+// Position der Taster und des Betriebsmodus-Wahlschalters in der Schaltermatrix
+// (vgl. Doku "Hardware für die Uhr und den Transponder")
+const uint8_t XPDR_SWITCH_ROW_FUNCTIONS = 0;    ///< Row der Funktionstaster und des Betriebsmodus-Wahlschalters
+const uint8_t XPDR_SWITCH_ROW_DIGITS = 1;       ///< Row der Code-Entry-Tasten 0 bis 7; Col = Ziffer
+const uint8_t XPDR_MAX_DIGIT = 7;               ///< Höchste Ziffer; die Cols dahinter gehören nicht zum Transponder
+const uint8_t XPDR_SWITCH_IDT = 0;              ///< Col der Taste IDT
+const uint8_t XPDR_SWITCH_VFR = 1;              ///< Col der Taste VFR
+const uint8_t XPDR_SWITCH_CLR = 2;              ///< Col der Taste CLR
+const uint8_t XPDR_SWITCH_KNOB_OFF = 3;         ///< Col der Stellung OFF; es folgen SBY, TST, ON, ALT
+
+const uint8_t XPDR_CODE_LENGTH = 4;             ///< Anzahl Stellen des Transponder-Codes
+const uint8_t XPDR_FL_LENGTH = 3;               ///< Anzahl Stellen des Flightlevels
+const unsigned long XPDR_CODE_ENTRY_TIMEOUT = 4000;  ///< Abbruch einer unvollständigen Code-Eingabe nach 4 Sekunden
+const unsigned long XPDR_TEST_DURATION = 4000;  ///< Dauer des Testmodus in Millisekunden
+const unsigned long XPDR_IDENT_DURATION = 18000;     ///< Leuchtdauer der LED R nach Druck auf IDT
+
+
+/***************************************************************************************************
+ * @brief Aufzählungstyp für die möglichen Events, die vom Zustandsautomaten des Transponders
+ *        verarbeitet werden.
+ *
+ * Die Reihenfolge von KNOB_OFF bis KNOB_ALT entspricht der Reihenfolge in der Schaltermatrix.
+ */
+enum class XpdrEvent : uint8_t {
+    POWER_ON,       ///< Batterie und Avionics haben Strom
+    POWER_OFF,      ///< Keine Stromversorgung mehr
+    KNOB_OFF,       ///< Betriebsmodus-Wahlschalter auf OFF
+    KNOB_SBY,       ///< Betriebsmodus-Wahlschalter auf SBY
+    KNOB_TST,       ///< Betriebsmodus-Wahlschalter auf TST
+    KNOB_ON,        ///< Betriebsmodus-Wahlschalter auf ON
+    KNOB_ALT,       ///< Betriebsmodus-Wahlschalter auf ALT
+    BTN_IDT,        ///< Taste IDT gedrückt
+    BTN_VFR,        ///< Taste VFR kurz gedrückt (beim Loslassen gemeldet)
+    BTN_VFR_LON,    ///< Taste VFR lange gedrückt
+    BTN_CLR,        ///< Taste CLR gedrückt
+    BTN_DIGIT,      ///< Eine der Code-Entry-Tasten 0 bis 7 gedrückt
+    TIMEOUT         ///< Der Timer des Zustandsautomaten ist abgelaufen
+};
+const uint8_t NO_OF_XPDR_EVENTS = static_cast<uint8_t>(XpdrEvent::TIMEOUT) + 1;  ///< Anzahl Events
+
+
 /**************************************************************************************************
  * Status-Aufzählungstpyen
  *
  **************************************************************************************************/
 
+/***************************************************************************************************
+ * @brief Betriebsmodi des Transponders. SBY, TST, ON und ALT liegen im übergeordneten Zustand ACTIVE.
+ *
+ */
+enum class XpdrModeState : uint8_t {
+    OFF = 1,        ///< Ausgeschaltet oder keine Stromversorgung
+    ACTIVE,         ///< Übergeordneter Zustand: eingeschaltet und Strom vorhanden
+    SBY,            ///< Standby
+    TST,            ///< Testmodus: alle Segmente und LEDs leuchten
+    ON,             ///< Modus A
+    ALT             ///< Modus C, die LED R blinkt
+};
+const uint8_t NO_OF_XPDR_MODE_STATES = static_cast<uint8_t>(XpdrModeState::ALT);  ///< Anzahl Zustände
+
+
 /** ************************************************************************************************
  * @brief Modell des Transponders KT76C
  *
@@ -31,7 +94,81 @@ const char DEVICE_XPDR[] = "XPDR";
  **************************************************************************************************/
 class TransponderKT76C : public Device {
 public:
+    TransponderKT76C();
+
+    /**
+     * @brief Vom PC empfangene Daten (Transponder-Code, Flightlevel) verarbeiten.
+     *
+     * @param event Das zu verarbeitende Event.
+     */
+    void processEvent(EventClass *event);
+
+
+    /**
+     * @brief Den Status eines Schalters des Transponders verarbeiten.
+     *
+     * @param row         Row des Schalters in der Schaltermatrix.
+     * @param col         Col des Schalters in der Schaltermatrix.
+     * @param switchState @em SWITCH_STATE_OFF, @em SWITCH_STATE_ON oder @em SWITCH_STATE_LONG_ON.
+     * @return @em true falls der Schalter zum Transponder gehört und lokal verarbeitet wurde, sonst @em false.
+     */
+    bool processSwitch(uint8_t row, uint8_t col, uint8_t switchState);
+
+
+    /// @brief Aktuellen Betriebsmodus abfragen.
+    inline XpdrModeState getMode() const { return static_cast<XpdrModeState>(hsm.getState()); }
+
+
+    /**
+     * @brief Stromversorgung und Timer prüfen und Flightlevel, Code und LEDs anzeigen.
+     * @note Diese Methode muss regelmäßig im loop() aufgerufen werden.
+     */
+    void show();
 
 private:
-    int dummy = 0;
-};
\ No newline at end of file
+    uint8_t flDisplay;                  ///< Display-Feld für den Flightlevel
+    uint8_t codeDisplay;                ///< Display-Feld für den Transponder-Code
+    LedMatrixPos LED_ALT;               ///< LED "ALT"
+    LedMatrixPos LED_R;                 ///< LED "R" (Reply-Indikator)
+    Hsm<TransponderKT76C> hsm;          ///< Zustandsautomat des Betriebsmodus
+    bool isChanged;                     ///< Anzeige muss aktualisiert werden
+    bool isPowered;                     ///< Zuletzt an den Zustandsautomaten gemeldeter Stromstatus
+    uint8_t knobPosition;               ///< Aktuelle Stellung des Betriebsmodus-Wahlschalters (Event KNOB_xxx)
+    uint8_t pendingDigit;               ///< Zuletzt gedrückte Code-Entry-Taste (für BTN_DIGIT)
+    bool isVfrLongSent;                 ///< Der aktuelle Druck auf VFR wurde bereits als langer Druck gemeldet
+    uint8_t entryPos;                   ///< Anzahl bereits eingegebener Stellen; 0 = keine Eingabe aktiv
+    char code[XPDR_CODE_LENGTH + 1];         ///< Aktiver Transponder-Code
+    char previousCode[XPDR_CODE_LENGTH + 1]; ///< Vor dem Druck auf VFR aktiver Code
+    char entryCode[XPDR_CODE_LENGTH + 1];    ///< Code während der Eingabe
+    char flightLevel[XPDR_FL_LENGTH + 1];    ///< Flightlevel, 3-stellig
+    bool isIdentActive;                 ///< IDT wurde gedrückt; LED R leuchtet
+    unsigned long identStartTime;       ///< Zeitpunkt des letzten Drucks auf IDT
+
+    static const HsmState states[];                                 ///< Zustandstabelle
+    static const HsmTransition transitions[][NO_OF_XPDR_EVENTS];    ///< Übergangstabelle
+    static const HsmAction<TransponderKT76C> actions[];             ///< Aktionen
+    static const HsmGuard<TransponderKT76C> guards[];               ///< Guards
+    static const HsmDefinition<TransponderKT76C> definition;        ///< Tabellen des Zustandsautomaten
+
+    /// Ein Event an den Zustandsautomaten senden.
+    inline void post(XpdrEvent event) { hsm.dispatch(static_cast<uint8_t>(event)); }
+
+    /// Aktionen des Zustandsautomaten
+    static void enterOff(TransponderKT76C &xpdr);
+    static void transmitOff(TransponderKT76C &xpdr);
+    static void enterMode(TransponderKT76C &xpdr);
+    static void enterTest(TransponderKT76C &xpdr);
+    static void enterDigit(TransponderKT76C &xpdr);
+    static void clearDigit(TransponderKT76C &xpdr);
+    static void cancelCodeEntry(TransponderKT76C &xpdr);
+    static void selectVfrCode(TransponderKT76C &xpdr);
+    static void restoreCode(TransponderKT76C &xpdr);
+    static void ident(TransponderKT76C &xpdr);
+
+    /// Guards des Zustandsautomaten
+    static bool isKnobNotOff(TransponderKT76C &xpdr);
+    static bool hasPower(TransponderKT76C &xpdr);
+
+    /// Neuen Code übernehmen und an den PC übertragen.
+    void commitCode(const char *newCode);
+};
@@ -0,0 +1,196 @@
+/***************************************************************************************************
+ * @file avrheap.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Modell der Heap-Verwaltung (malloc/free) der avr-libc für die Host-Tests der Firmware.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Bildet die Freispeicherliste der avr-libc nach: Jeder Block hat einen Kopf mit seiner Größe
+ * (2 Byte), freie Blöcke stehen nach Adressen sortiert in einer Liste. malloc() nimmt einen genau
+ * passenden freien Block, sonst den kleinsten passenden und teilt ihn (der belegte Teil liegt oben),
+ * sonst wird der Heap (__brkval) vergrößert. free() fügt benachbarte freie Blöcke zusammen und gibt
+ * den obersten Block an den Heap zurück. Adressen und Verwaltungsdaten liegen in einem simulierten
+ * Heap mit 16-Bit-Adressen; der Speicher für die Objekte selbst kommt weiter vom PC.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+const uint16_t AVR_HEAP_NULL = 0xFFFF;      ///< Kein Block (nullptr)
+const uint16_t AVR_SIZE_LENGTH = 2;         ///< Größe des Blockkopfs (size_t der avr-libc)
+const uint16_t AVR_FREELIST_LENGTH = 4;     ///< Größe eines Eintrags der Freispeicherliste (Größe + Zeiger)
+const uint16_t AVR_HEAP_MAX_SIZE = 2048;    ///< Max. Größe des simulierten Heaps (SRAM des ATmega328P)
+
+
+/***************************************************************************************************
+ * @brief Simulierter Heap mit der Freispeicherliste der avr-libc.
+ *
+ * Adressen sind Offsets im Heap; allocate() liefert wie malloc() die Adresse hinter dem Blockkopf.
+ * Alle Zahlen in Byte und einschließlich der Blockköpfe.
+ **************************************************************************************************/
+class AvrHeap {
+public:
+    /// @brief Leerer Heap; @em size Byte zwischen __heap_start und der Grenze zum Stack.
+    explicit AvrHeap(const uint16_t size) : limit(size) { memset(memory, 0, sizeof(memory)); }
+
+    /// @brief Block mit @em length Byte belegen (malloc); @return Adresse oder AVR_HEAP_NULL.
+    uint16_t allocate(uint16_t length) {
+        if (length < AVR_FREELIST_LENGTH - AVR_SIZE_LENGTH) {
+            length = AVR_FREELIST_LENGTH - AVR_SIZE_LENGTH;
+        }
+        // Genau passenden Block nehmen oder den kleinsten passenden merken
+        uint16_t best = AVR_HEAP_NULL, bestPrevious = AVR_HEAP_NULL, bestSize = 0;
+        for (uint16_t previous = AVR_HEAP_NULL, block = freeList; block != AVR_HEAP_NULL;
+             previous = block, block = next(block)) {
+            if (size(block) == length) {
+                unlink(previous, block);
+                return taken(block);
+            }
+            if ((size(block) > length) && ((bestSize == 0) || (size(block) < bestSize))) {
+                best = block;
+                bestPrevious = previous;
+                bestSize = size(block);
+            }
+        }
+        if (bestSize != 0) {
+            if (bestSize - length < AVR_FREELIST_LENGTH) {
+                unlink(bestPrevious, best);         // Rest zu klein für einen freien Block
+                return taken(best);
+            }
+            // Oberen Teil belegen, der untere bleibt frei
+            const uint16_t block = best + (bestSize - length);
+            setSize(best, bestSize - length - AVR_SIZE_LENGTH);
+            setSize(block, length);
+            return taken(block);
+        }
+        // Heap vergrößern
+        if ((breakValue >= limit) || (limit - breakValue < length + AVR_SIZE_LENGTH)) {
+            ++failures;
+            return AVR_HEAP_NULL;
+        }
+        const uint16_t block = breakValue;
+        breakValue += length + AVR_SIZE_LENGTH;
+        highWater = (breakValue > highWater) ? breakValue : highWater;
+        setSize(block, length);
+        return taken(block);
+    }
+
+    /// @brief Block an der Adresse @em address freigeben (free).
+    void release(const uint16_t address) {
+        if (address == AVR_HEAP_NULL) {
+            return;
+        }
+        const uint16_t block = address - AVR_SIZE_LENGTH;
+        inUse -= size(block) + AVR_SIZE_LENGTH;
+        // Nach Adresse sortiert einfügen und mit den Nachbarn zusammenfassen
+        uint16_t previous = AVR_HEAP_NULL, following = freeList;
+        while ((following != AVR_HEAP_NULL) && (following < block)) {
+            previous = following;
+            following = next(following);
+        }
+        setNext(block, following);
+        if ((following != AVR_HEAP_NULL) && (end(block) == following)) {
+            setSize(block, size(block) + AVR_SIZE_LENGTH + size(following));
+            setNext(block, next(following));
+        }
+        if (previous == AVR_HEAP_NULL) {
+            freeList = block;
+        } else {
+            setNext(previous, block);
+            if (end(previous) == block) {
+                setSize(previous, size(previous) + AVR_SIZE_LENGTH + size(block));
+                setNext(previous, next(block));
+            }
+        }
+        // Liegt der letzte freie Block oben, geht er an den Heap zurück
+        uint16_t last = freeList, beforeLast = AVR_HEAP_NULL;
+        while (next(last) != AVR_HEAP_NULL) {
+            beforeLast = last;
+            last = next(last);
+        }
+        if (end(last) == breakValue) {
+            breakValue = last;
+            if (beforeLast == AVR_HEAP_NULL) {
+                freeList = AVR_HEAP_NULL;
+            } else {
+                setNext(beforeLast, AVR_HEAP_NULL);
+            }
+        }
+    }
+
+    /// @brief Belegter Speicher.
+    uint16_t getInUse() const { return inUse; }
+
+    /// @brief Höchster Stand von __brkval seit dem letzten resetHighWater().
+    uint16_t getHighWater() const { return highWater; }
+
+    /// @brief Höchststand auf den aktuellen Stand von __brkval setzen.
+    void resetHighWater() { highWater = breakValue; }
+
+    /// @brief Aktueller Stand von __brkval (Ende des Heaps).
+    uint16_t getBreak() const { return breakValue; }
+
+    /// @brief Freier Speicher in der Freispeicherliste und oberhalb von __brkval.
+    uint16_t getFree() const {
+        uint16_t total = limit - breakValue;
+        for (uint16_t block = freeList; block != AVR_HEAP_NULL; block = next(block)) {
+            total += size(block) + AVR_SIZE_LENGTH;
+        }
+        return total;
+    }
+
+    /// @brief Größter Block, den malloc() noch liefern kann (zzgl. Blockkopf).
+    uint16_t getLargestFree() const {
+        uint16_t largest = limit - breakValue;
+        for (uint16_t block = freeList; block != AVR_HEAP_NULL; block = next(block)) {
+            largest = (size(block) + AVR_SIZE_LENGTH > largest) ? size(block) + AVR_SIZE_LENGTH : largest;
+        }
+        return largest;
+    }
+
+    /// @brief Fragmentierung in Promille: 0 = der freie Speicher ist ein Block.
+    uint16_t getFragmentation() const {
+        const uint16_t total = getFree();
+        return (total == 0) ? 0 : static_cast<uint16_t>(1000 - 1000UL * getLargestFree() / total);
+    }
+
+    /// @brief Anzahl der fehlgeschlagenen allocate().
+    uint32_t getFailures() const { return failures; }
+
+private:
+    uint8_t memory[AVR_HEAP_MAX_SIZE];          ///< Blockköpfe und Einträge der Freispeicherliste
+    uint16_t limit;                             ///< Grenze des Heaps (Stack abzüglich __malloc_margin)
+    uint16_t breakValue = 0;                    ///< __brkval
+    uint16_t freeList = AVR_HEAP_NULL;          ///< __flp
+    uint16_t inUse = 0;
+    uint16_t highWater = 0;
+    uint32_t failures = 0;
+
+    uint16_t read(const uint16_t at) const { return static_cast<uint16_t>(memory[at] | (memory[at + 1] << 8)); }
+    void write(const uint16_t at, const uint16_t value) {
+        memory[at] = static_cast<uint8_t>(value);
+        memory[at + 1] = static_cast<uint8_t>(value >> 8);
+    }
+    uint16_t size(const uint16_t block) const { return read(block); }
+    void setSize(const uint16_t block, const uint16_t length) { write(block, length); }
+    uint16_t next(const uint16_t block) const { return read(block + AVR_SIZE_LENGTH); }
+    void setNext(const uint16_t block, const uint16_t following) { write(block + AVR_SIZE_LENGTH, following); }
+    uint16_t end(const uint16_t block) const { return block + AVR_SIZE_LENGTH + size(block); }
+
+    void unlink(const uint16_t previous, const uint16_t block) {
+        if (previous == AVR_HEAP_NULL) {
+            freeList = next(block);
+        } else {
+            setNext(previous, next(block));
+        }
+    }
+
+    uint16_t taken(const uint16_t block) {
+        inUse += size(block) + AVR_SIZE_LENGTH;
+        return block + AVR_SIZE_LENGTH;
+    }
+};
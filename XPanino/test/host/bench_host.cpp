@@ -0,0 +1,50 @@
+/***************************************************************************************************
+ * @file bench_host.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Den Benchmark der Firmware (benchmark.hpp) auf dem PC in Echtzeit ausführen.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufruf: bench_host [Mindestdauer je Fall in ms]
+ *
+ * Übersetzt mit XPANINO_BENCHMARK. Nach setup() folgt die Uhr der HostHal der Echtzeit; dann wird
+ * Benchmark::run() einmal ausgeführt und die Ergebnisse "SYS;<Fall>;<Durchläufe>;<µs>" gehen auf
+ * stdout. Wird von benchmarks/compare.py benutzt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <hal.hpp>
+#include <benchmark.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+
+void setup();
+
+
+/// Echtzeit in µs.
+static unsigned long realMicros() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<unsigned long>(now.tv_sec * 1000000L + now.tv_nsec / 1000);
+}
+
+
+/// Gesendete Zeichen auf stdout ausgeben.
+static void onTransmit(const char *buffer, const size_t length) { fwrite(buffer, 1, length, stdout); }
+
+
+int main(int argc, char *argv[]) {
+    const unsigned long minDuration = (argc > 1) ? strtoul(argv[1], nullptr, 10) : BENCHMARK_DEFAULT_DURATION;
+    if ((minDuration == 0) || (minDuration > UINT16_MAX)) {
+        fprintf(stderr, "Aufruf: %s [Mindestdauer je Fall in ms 1..%u]\n", argv[0], UINT16_MAX);
+        return 2;
+    }
+    setup();
+    HostHal::setClock(realMicros);
+    HostHal::setTransmitHandler(onTransmit);
+    Benchmark::run(static_cast<uint16_t>(minDuration));
+    return 0;
+}
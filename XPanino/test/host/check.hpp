@@ -0,0 +1,54 @@
+/***************************************************************************************************
+ * @file check.hpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Minimale Prüfmakros für die Host-Tests der Firmware.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Jeder Test ist ein eigenes Programm. Fehlgeschlagene Prüfungen werden mit Datei und Zeile
+ * ausgegeben; checkResult() liefert den Exit-Code für main().
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+static int checkFailures = 0;   ///< Anzahl fehlgeschlagener Prüfungen in diesem Testprogramm
+
+/// Bedingung prüfen.
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ++checkFailures; \
+            printf("%s:%d: CHECK(%s) fehlgeschlagen\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+/// Zwei C-Strings auf Gleichheit prüfen.
+#define CHECK_STR(expected, actual) \
+    do { \
+        const char *checkActual = (actual); \
+        if ((checkActual == nullptr) || (strcmp((expected), checkActual) != 0)) { \
+            ++checkFailures; \
+            printf("%s:%d: erwartet \"%s\", erhalten \"%s\"\n", __FILE__, __LINE__, (expected), \
+                   (checkActual == nullptr) ? "<nullptr>" : checkActual); \
+        } \
+    } while (0)
+
+/// Prüfen, ob @em text in @em actual enthalten ist.
+#define CHECK_CONTAINS(text, actual) \
+    do { \
+        if (strstr((actual), (text)) == nullptr) { \
+            ++checkFailures; \
+            printf("%s:%d: \"%s\" nicht enthalten in \"%s\"\n", __FILE__, __LINE__, (text), (actual)); \
+        } \
+    } while (0)
+
+/// Ergebnis ausgeben und Exit-Code für main() liefern.
+inline int checkResult(const char *testName) {
+    printf("%s: %s\n", testName, (checkFailures == 0) ? "OK" : "FEHLER");
+    return (checkFailures == 0) ? 0 : 1;
+}
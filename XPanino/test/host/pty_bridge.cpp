@@ -0,0 +1,126 @@
+/***************************************************************************************************
+ * @file pty_bridge.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Die Firmware in Echtzeit auf dem PC, angebunden an stdin/stdout (z.B. ein Pseudo-Terminal).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufruf: pty_bridge [Wartezeit des TxBuffers in ms]
+ *
+ * Die Uhr der HostHal folgt der Echtzeit. Empfangene Zeichen kommen von stdin. Jedes mit
+ * Hal::uartWrite() gesendete Paket wird gedrosselt an stdout weitergegeben, als ob es über den
+ * USB-Seriell-Wandler des Arduino Uno ginge: ein Paket belegt mindestens einen USB-Frame (1 ms), dazu
+ * kommen 87 µs je Zeichen (115200 Baud). Am Ende (stdin geschlossen) gehen die Anzahl der Pakete,
+ * Nachrichten und Zeichen seit dem ersten empfangenen Zeichen auf stderr; die Ausgaben von setup()
+ * zählen also nicht mit. Wird von pty_latency.py benutzt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include <hal.hpp>
+#include <txbuffer.hpp>
+
+#include <deque>
+#include <string>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+void setup();
+void loop();
+void serialEvent();
+
+extern TxBuffer txBuffer;
+
+const unsigned long USB_FRAME_US = 1000;    ///< Ein Paket belegt mindestens einen USB-Frame
+const unsigned long CHAR_US = 87;           ///< Dauer eines Zeichens bei 115200 Baud (10 Bit)
+
+/// Ein gesendetes Paket und der Zeitpunkt, ab dem es beim PC ankommt.
+struct Packet {
+    unsigned long releaseTime;
+    std::string data;
+};
+
+static std::deque<Packet> packets;          ///< Noch nicht weitergegebene Pakete
+static unsigned long channelFree = 0;       ///< Ab hier ist die gedrosselte Verbindung wieder frei
+static unsigned long packetCount = 0;       ///< Gesendete Pakete
+static unsigned long messageCount = 0;      ///< Gesendete Nachrichten (Zeilen)
+static unsigned long charCount = 0;         ///< Gesendete Zeichen
+
+
+/// Echtzeit in µs seit dem Start.
+static unsigned long realMicros() {
+    static timespec start = {0, 0};
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((start.tv_sec == 0) && (start.tv_nsec == 0)) {
+        start = now;
+    }
+    return static_cast<unsigned long>((now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000);
+}
+
+
+/// Paket der Firmware übernehmen und den Zeitpunkt (Echtzeit) berechnen, zu dem es beim PC ankommt.
+static void onTransmit(const char *buffer, const size_t length) {
+    const unsigned long now = realMicros();
+    channelFree = max(channelFree, now) + USB_FRAME_US + length * CHAR_US;
+    packets.push_back({channelFree, std::string(buffer, length)});
+    ++packetCount;
+    charCount += length;
+    for (size_t i = 0; i < length; ++i) {
+        messageCount += (buffer[i] == '\n') ? 1 : 0;
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        txBuffer.setLatencyBudget(strtoul(argv[1], nullptr, 10));
+    }
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    HostHal::setTransmitHandler(onTransmit);
+    setup();
+    // setup() hat die Uhr mit delayMillis() bereits vorgestellt; ab hier läuft sie mit der Echtzeit.
+    const unsigned long start = Hal::micros() - realMicros();
+
+    bool isOpen = true;
+    bool isReceiving = false;
+    while (isOpen || ! packets.empty()) {
+        const unsigned long now = start + realMicros();
+        if (now > Hal::micros()) {
+            HostHal::advanceMicros(now - Hal::micros());
+        }
+
+        // Nur so viel lesen, wie in den Empfangspuffer passt; der Rest bleibt im Pseudo-Terminal.
+        char input[HOST_HAL_RX_SIZE];
+        const ssize_t room = HOST_HAL_RX_SIZE - 1 - Hal::uartAvailable();
+        if (isOpen && (room > 0)) {
+            const ssize_t count = read(STDIN_FILENO, input, room);
+            if (count > 0) {
+                if (! isReceiving) {
+                    isReceiving = true;
+                    packetCount = messageCount = charCount = 0;
+                }
+                input[count] = '\0';
+                HostHal::receive(input);
+            } else if ((count == 0) || (errno != EAGAIN)) {
+                isOpen = false;     // Dateiende bzw. EIO, wenn die Gegenseite das Pseudo-Terminal schließt
+            }
+        }
+        serialEvent();
+        loop();
+
+        while ((! packets.empty()) && (realMicros() >= packets.front().releaseTime)) {
+            if (write(STDOUT_FILENO, packets.front().data.data(), packets.front().data.size()) < 0) {
+                isOpen = false;
+                packets.clear();
+                break;
+            }
+            packets.pop_front();
+        }
+        usleep(50);
+    }
+    fprintf(stderr, "packets=%lu messages=%lu chars=%lu\n", packetCount, messageCount, charCount);
+    return 0;
+}
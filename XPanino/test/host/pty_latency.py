@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Latenz und Byte je Paket der gebündelten Nachrichten (TxBuffer) über ein Pseudo-Terminal messen.
+
+Startet die Firmware als pty_bridge (siehe pty_bridge.cpp) einmal ohne Bündeln (Wartezeit 0 ms) und
+einmal mit der Wartezeit TX_LATENCY_BUDGET (5 ms). Je Runde werden vier SYS;STAT (je zwei nicht
+dringende Antworten LOOP und RAM) und ein SYS;PING (dringende Antwort PONG) auf einmal gesendet;
+gemessen wird die Zeit vom Senden bis zum Eintreffen jeder Antwortzeile.
+
+    make -C XPanino/test/host && XPanino/test/host/pty_latency.py [Runden]
+"""
+
+import os
+import pty
+import select
+import subprocess
+import sys
+import time
+import tty
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+BRIDGE = os.path.join(HERE, "build", "uno", "pty_bridge")
+STATS_PER_ROUND = 4
+TIMEOUT = 0.5
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+def measure(budget, rounds):
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+    bridge = subprocess.Popen([BRIDGE, str(budget)], stdin=slave, stdout=slave, stderr=subprocess.PIPE)
+    os.close(slave)
+    pending = b""
+
+    def drain(quiet):
+        while select.select([master], [], [], quiet)[0]:
+            os.read(master, 4096)
+
+    def read_lines(deadline):
+        nonlocal pending
+        lines = []
+        while time.monotonic() < deadline:
+            ready, _, _ = select.select([master], [], [], deadline - time.monotonic())
+            if not ready:
+                break
+            pending += os.read(master, 4096)
+            now = time.monotonic()
+            while b"\n" in pending:
+                line, pending = pending.split(b"\n", 1)
+                lines.append((now, line.rstrip(b"\r").decode(errors="replace")))
+            if lines:
+                return lines
+        return lines
+
+    drain(0.3)      # Begrüßung und Schalterstände nach setup()
+    urgent, buffered = [], []
+    for n in range(1, rounds + 1):
+        sent = time.monotonic()
+        os.write(master, b"SYS;STAT\n" * STATS_PER_ROUND + b"SYS;PING;%d\n" % n)
+        expected = 2 * STATS_PER_ROUND + 1
+        deadline = sent + TIMEOUT
+        while expected > 0 and time.monotonic() < deadline:
+            for arrived, line in read_lines(deadline):
+                if line.startswith("SYS;PONG;%d;" % n):
+                    urgent.append(arrived - sent)
+                    expected -= 1
+                elif line.startswith("SYS;LOOP;") or line.startswith("SYS;RAM;"):
+                    buffered.append(arrived - sent)
+                    expected -= 1
+        time.sleep(0.01)
+
+    os.close(master)
+    _, stats = bridge.communicate(timeout=5)
+    counters = dict(item.split("=") for item in stats.decode().split())
+    return urgent, buffered, {key: int(value) for key, value in counters.items()}
+
+
+def main():
+    rounds = int(sys.argv[1]) if len(sys.argv) > 1 else 200
+    print("Runden je Messung: %d, je Runde %d x SYS;STAT + 1 x SYS;PING" % (rounds, STATS_PER_ROUND))
+    print("%-10s %8s %10s %12s %12s %12s %12s" % ("Wartezeit", "Pakete", "Byte/Paket",
+                                                   "PONG p50", "PONG p99", "alle p50", "alle p99"))
+    for budget in (0, 5):
+        urgent, buffered, counters = measure(budget, rounds)
+        everything = urgent + buffered
+        print("%-10s %8d %10.1f %10.2fms %10.2fms %10.2fms %10.2fms" % (
+            "%d ms" % budget, counters["packets"], counters["chars"] / counters["packets"],
+            1000 * percentile(urgent, 50), 1000 * percentile(urgent, 99),
+            1000 * percentile(everything, 50), 1000 * percentile(everything, 99)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+/***************************************************************************************************
+ * @file Arduino.h
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Ersatz für Arduino.h zum Übersetzen der Firmware auf dem PC (Host-Build, vgl. Makefile).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Enthält nur, was die Firmware außerhalb von DEBUG neben der Hardware-Abstraktion (hal.hpp,
+ * HostHal) braucht: Typen, die PROGMEM-Makros aus avr/pgmspace.h, HIGH/LOW, die Pin-Konstanten
+ * und einige Hilfsfunktionen. Pins, Uhr und serielle Schnittstelle gibt es bewusst nicht; wer sie
+ * benutzt statt Hal, wird auf dem PC nicht übersetzt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// avr/pgmspace.h: Auf dem PC liegt alles im RAM.
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t *>(address))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+
+// Pegel und Pins wie beim Arduino Uno
+#define HIGH 0x1
+#define LOW 0x0
+#define LED_BUILTIN 13
+#define PIN2 2
+#define PIN3 3
+#define PIN4 4
+#define PIN5 5
+
+typedef uint8_t byte;
+
+inline bool isAlphaNumeric(const char c) { return isalnum(static_cast<unsigned char>(c)) != 0; }
+inline bool isPunct(const char c) { return ispunct(static_cast<unsigned char>(c)) != 0; }
+
+// Arduino definiert min, max und constrain als Makros; hier als Templates ohne Mehrfachauswertung.
+template <class A, class B> inline auto min(const A a, const B b) -> decltype(a + b) { return (a < b) ? a : b; }
+template <class A, class B> inline auto max(const A a, const B b) -> decltype(a + b) { return (a > b) ? a : b; }
+template <class T, class L, class H> inline T constrain(const T amount, const L low, const H high) {
+    return (amount < low) ? low : ((amount > high) ? high : amount);
+}
@@ -0,0 +1,70 @@
+/***************************************************************************************************
+ * @file test_benchmark.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Der Benchmark sendet nur seine Ergebnisse und lässt die Schalter unangetastet.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <benchmark.hpp>
+#include <Switchmatrix.hpp>
+
+void setup();
+void loop();
+
+extern SwitchMatrix switches;
+
+const char *const BENCHMARK_CASES[] = {"BPRS", "BQUE", "BDSP", "BCHR", "BLED", "BSCN"};
+
+
+/// Uhr, die bei jeder Abfrage um 100 µs weitergeht; so endet jeder Fall nach wenigen Stapeln.
+static unsigned long steppingClock() {
+    static unsigned long now = 0;
+    now += 100;
+    return now;
+}
+
+
+/// Jeder Fall dauert mindestens die verlangte Zeit; die Durchläufe verdoppeln sich je Stapel.
+/// Ein während des Benchmarks gedrückter Schalter wird erst im nächsten loop() verarbeitet.
+static void testBenchmarkLeavesSwitchesPending() {
+    setup();
+    // Spalte 0 schließen; nach der Entprellzeit erkennt die nächste Abfrage (in BSCN) die Änderung.
+    HostHal::setInput(HW_MATRIX_COLS_LSB_PIN, false);
+    switches.scanSwitchPins();
+    HostHal::advanceMicros(20000);
+
+    HostHal::clearTransmitted();
+    HostHal::setClock(steppingClock);
+    Benchmark::run(1);
+    HostHal::setClock(nullptr);
+    const char *line = HostHal::transmitted();
+    for (const char *name : BENCHMARK_CASES) {
+        char expected[16];
+        unsigned long iterations = 0, duration = 0;
+        snprintf(expected, sizeof(expected), "SYS;%s;", name);
+        CHECK(strncmp(line, expected, strlen(expected)) == 0);
+        CHECK(sscanf(line + strlen(expected), "%lu;%lu", &iterations, &duration) == 2);
+        // Stapel 1, 2, 4, ... bis mindestens 1000 µs vergangen sind
+        CHECK(duration >= 1000);
+        CHECK((iterations > 0) && (((iterations + 1) & iterations) == 0));
+        line = strchr(line, '\n');
+        line = (line == nullptr) ? "" : line + 1;
+    }
+    CHECK_STR("", line);
+
+    HostHal::clearTransmitted();
+    loop();
+    CHECK_STR("S;S;ON;3;0\r\n", HostHal::transmitted());
+    HostHal::setInput(HW_MATRIX_COLS_LSB_PIN, true);
+}
+
+
+int main() {
+    testBenchmarkLeavesSwitchesPending();
+    return checkResult("test_benchmark");
+}
@@ -0,0 +1,363 @@
+/***************************************************************************************************
+ * @file test_dualcore.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Dual-Core-Variante mit beiden Hälften als Threads; Queue, Doppelpuffer, Jitter.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Übersetzt mit XPANINO_DUAL_CORE. Zuerst wird mit der simulierten Uhr in einem Thread geprüft, was
+ * bei voller Queue der Schalteränderungen und bei noch nicht übernommenem Frame passiert. Danach
+ * laufen loop1() (I/O-Kern) und loop() (Gerätekern) bzw. nur die Übergabe der Frames als zwei
+ * Threads in Echtzeit: Es darf kein Frame zerrissen ankommen, jede Flanke eines Schalters und jede
+ * Antwort auf PING müssen ankommen. Ausgegeben werden Jitter und Durchsatz beider Hälften.
+ *
+ * Die LED-Matrix wird über die Pins CLOCK, DATA_IN und STRB (vgl. ledmatrix.cpp) mitgelesen. Jede
+ * Hälfte benutzt nur ihre eigenen Teile der HostHal: der I/O-Kern die Pins, der Gerätekern die
+ * serielle Schnittstelle; die Uhr ist vorher auf die Echtzeit gesetzt.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <ledmatrix.hpp>
+#include <Switchmatrix.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+void setup();
+void setup1();
+void loop();
+void loop1();
+
+extern LedMatrix leds;
+
+const uint8_t LED_STRB_PIN = 3;             ///< vgl. STRB in ledmatrix.cpp
+const uint8_t LED_CLOCK_PIN = 4;            ///< vgl. CLOCK in ledmatrix.cpp
+const uint8_t LED_DATA_IN_PIN = 5;          ///< vgl. DATA_IN in ledmatrix.cpp
+const uint8_t PRESS_COL = SWITCH_MATRIX_COLS - 1;   ///< Gedrückte Spalte; Zeile 3 meldet "S;S;ON;3;7"
+const unsigned long PRESS_LOOPS = 40;       ///< Durchläufe von loop1() je Drücken bzw. Loslassen
+const unsigned long PING_INTERVAL_US = 1000;
+const auto THREAD_RUN_TIME = std::chrono::milliseconds(1000);
+
+
+static unsigned long clockOffset = 0;       ///< Damit die Uhr beim Umschalten auf die Echtzeit nicht springt
+
+
+/// Echtzeit in µs, fortgesetzt ab dem Stand der simulierten Uhr.
+static unsigned long realMicros() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return clockOffset + static_cast<unsigned long>(now.tv_sec * 1000000L + now.tv_nsec / 1000);
+}
+
+
+/***************************************************************************************************
+ * Mitlesen der LED-Matrix und der seriellen Schnittstelle
+ **************************************************************************************************/
+
+static bool dataLevel = false;
+static uint64_t shiftRegister = 0;          ///< Zuletzt geschobene Bits: 32 Spalten, dann 8 Zeilen
+static uint32_t shownRows[LED_ROWS];        ///< Frame, der gerade ausgegeben wird
+static uint32_t lastFrame[LED_ROWS];        ///< Zuletzt vollständig ausgegebener Frame
+static unsigned long framesShown = 0;
+static unsigned long invalidRows = 0;       ///< Zeilenbits ohne genau eine aktive Zeile
+static void (*frameHandler)(const uint32_t *rows) = nullptr;
+
+
+/// Die Schieberegister der MIC5891/5821 nachbilden; mit STRB ist eine Zeile fertig.
+static void onPinWrite(const uint8_t pin, const bool level) {
+    if (pin == LED_DATA_IN_PIN) {
+        dataLevel = level;
+    } else if ((pin == LED_CLOCK_PIN) && level) {
+        shiftRegister = (shiftRegister << 1) | (dataLevel ? 1 : 0);
+    } else if ((pin == LED_STRB_PIN) && level) {
+        const uint8_t rowBits = static_cast<uint8_t>(shiftRegister);
+        uint8_t row = 0;
+        while ((row < LED_ROWS) && (rowBits != (1 << row))) {
+            ++row;
+        }
+        if (row == LED_ROWS) {
+            ++invalidRows;
+            return;
+        }
+        shownRows[row] = static_cast<uint32_t>(shiftRegister >> 8);
+        if (row == LED_ROWS - 1) {
+            memcpy(lastFrame, shownRows, sizeof(lastFrame));
+            ++framesShown;
+            if (frameHandler != nullptr) {
+                frameHandler(lastFrame);
+            }
+        }
+    }
+}
+
+
+static unsigned long switchOn = 0;          ///< Empfangene "S;S;ON;3;7"
+static unsigned long switchOff = 0;         ///< Empfangene "S;S;OFF;3;7"
+static unsigned long pongs = 0;
+
+
+/// Gesendete Pakete auswerten.
+static void onTransmit(const char *buffer, const size_t length) {
+    for (const char *line = buffer; (line != nullptr) && (line < buffer + length);) {
+        switchOn += (strncmp(line, "S;S;ON;3;7\r\n", 12) == 0) ? 1 : 0;
+        switchOff += (strncmp(line, "S;S;OFF;3;7\r\n", 13) == 0) ? 1 : 0;
+        pongs += (strncmp(line, "SYS;PONG;", 9) == 0) ? 1 : 0;
+        line = static_cast<const char *>(memchr(line, '\n', static_cast<size_t>(buffer + length - line)));
+        line = (line == nullptr) ? nullptr : line + 1;
+    }
+}
+
+
+/// Alle Spalten der Schaltermatrix öffnen bzw. schließen.
+static void setAllColumns(const bool level) {
+    for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; ++col) {
+        HostHal::setInput(HW_MATRIX_COLS_LSB_PIN + col, level);
+    }
+}
+
+
+/// Alle Zeilen des Frames auf @em value setzen (über die LEDs der Matrix).
+static void setAllRows(const uint32_t value) {
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {
+        for (uint8_t col = 0; col < LED_COLS; ++col) {
+            if (((value >> col) & 1) != 0) {
+                leds.ledOn({row, col});
+            } else {
+                leds.ledOff({row, col});
+            }
+        }
+    }
+}
+
+
+/// Perzentil einer sortierten Reihe.
+static unsigned long percentile(const std::vector<unsigned long> &sorted, const unsigned int p) {
+    return sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+}
+
+
+/***************************************************************************************************
+ * Tests mit der simulierten Uhr
+ **************************************************************************************************/
+
+/// SpscQueue<SwitchChange, SWITCH_QUEUE_SIZE>: SIZE - 1 Plätze, danach schlägt push() fehl.
+static void testSwitchQueueOverflow() {
+    SpscQueue<SwitchChange, SWITCH_QUEUE_SIZE> queue;
+    for (uint8_t index = 0; index != SWITCH_QUEUE_SIZE - 1; ++index) {
+        CHECK(queue.push(SwitchChange{static_cast<uint8_t>(index / 8), static_cast<uint8_t>(index % 8), LOW}));
+    }
+    CHECK(! queue.push(SwitchChange{3, 7, LOW}));
+    SwitchChange change;
+    CHECK(queue.pop(change) && (change.row == 0) && (change.col == 0));
+    CHECK(queue.push(SwitchChange{3, 7, LOW}));     // ein Platz frei: über das Ende des Rings hinweg
+    for (uint8_t index = 1; index != SWITCH_QUEUE_SIZE - 1; ++index) {
+        CHECK(queue.pop(change) && (change.row == index / 8) && (change.col == index % 8));
+    }
+    CHECK(queue.pop(change) && (change.row == 3) && (change.col == 7));
+    CHECK(queue.isEmpty() && ! queue.pop(change));
+
+    // Alle 32 Schalter auf einmal: 31 passen in die Queue, der letzte wird bei der nächsten Abfrage gemeldet.
+    HostHal::clearTransmitted();
+    setAllColumns(false);
+    loop1();
+    HostHal::advanceMicros(20000);
+    loop();
+    CHECK_CONTAINS("S;S;ON;3;6\r\n", HostHal::transmitted());
+    CHECK(strstr(HostHal::transmitted(), "S;S;ON;3;7") == nullptr);
+    HostHal::clearTransmitted();
+    loop1();
+    HostHal::advanceMicros(20000);
+    loop();
+    CHECK_STR("S;S;ON;3;7\r\n", HostHal::transmitted());
+
+    setAllColumns(true);
+    for (uint8_t pass = 0; pass != 2; ++pass) {
+        loop1();
+        HostHal::advanceMicros(20000);
+        loop();
+    }
+    CHECK_CONTAINS("S;S;OFF;3;7\r\n", HostHal::transmitted());
+    HostHal::clearTransmitted();
+}
+
+
+/// Solange der I/O-Kern den letzten Frame nicht übernommen hat, lässt updateFrame() ihn unverändert.
+static void testFrameHandoffWhilePending() {
+    leds.writeFrameToHardware();        // einen evtl. wartenden Frame übernehmen
+    setAllRows(0x11111111);
+    leds.updateFrame();                 // Frame A wartet
+    setAllRows(0x22222222);
+    leds.updateFrame();                 // wird übergangen, A wartet noch
+    leds.writeFrameToHardware();
+    CHECK((lastFrame[0] == 0x11111111) && (lastFrame[LED_ROWS - 1] == 0x11111111));
+    leds.writeFrameToHardware();        // kein neuer Frame: A wird wiederholt
+    CHECK(lastFrame[0] == 0x11111111);
+    leds.updateFrame();                 // jetzt wird B übernommen
+    leds.writeFrameToHardware();
+    CHECK((lastFrame[0] == 0x22222222) && (lastFrame[LED_ROWS - 1] == 0x22222222));
+    CHECK(invalidRows == 0);
+}
+
+
+/***************************************************************************************************
+ * Tests mit zwei Threads in Echtzeit
+ **************************************************************************************************/
+
+static unsigned long tornFrames = 0;        ///< Frames mit verschiedenen Zeilen
+static unsigned long reorderedFrames = 0;   ///< Frames, die älter sind als der vorher ausgegebene
+static uint32_t lastSequence = 0;
+static unsigned long handedFrames = 0;      ///< Verschiedene ausgegebene Frames
+
+
+/// Jeder Frame trägt in allen Zeilen dieselbe laufende Nummer.
+static void checkSequenceFrame(const uint32_t *rows) {
+    for (uint8_t row = 1; row < LED_ROWS; ++row) {
+        tornFrames += (rows[row] != rows[0]) ? 1 : 0;
+    }
+    reorderedFrames += (rows[0] < lastSequence) ? 1 : 0;
+    handedFrames += (rows[0] != lastSequence) ? 1 : 0;
+    lastSequence = rows[0];
+}
+
+
+/// Gerätekern erzeugt laufend Frames, I/O-Kern gibt sie aus: kein Frame darf zerrissen sein.
+static void testFrameHandoffThreads() {
+    std::atomic<bool> isRunning(true);
+    unsigned long updates = 0;
+    framesShown = 0;
+    frameHandler = checkSequenceFrame;
+    leds.writeFrameToHardware();
+    lastSequence = 0;
+    for (uint8_t row = 0; row < LED_ROWS; ++row) {     // Blinken (z.B. der Uhr) würde Zeilen verändern
+        for (uint8_t col = 0; col < LED_COLS; ++col) {
+            leds.ledBlinkOff({row, col}, BLINK_NORMAL);
+            leds.ledBlinkOff({row, col}, BLINK_SLOW);
+        }
+    }
+    setAllRows(0);
+    leds.updateFrame();
+    leds.writeFrameToHardware();
+
+    const unsigned long start = realMicros();
+    std::thread ioCore([&]() {
+        while (isRunning) {
+            leds.writeFrameToHardware();
+        }
+    });
+    std::thread deviceCore([&]() {
+        for (uint32_t sequence = 1; isRunning; ++sequence) {
+            setAllRows(sequence);
+            leds.updateFrame();
+            ++updates;
+        }
+    });
+    std::this_thread::sleep_for(THREAD_RUN_TIME);
+    isRunning = false;
+    ioCore.join();
+    deviceCore.join();
+    const double seconds = (realMicros() - start) / 1e6;
+    frameHandler = nullptr;
+
+    printf("  Frames: %lu updateFrame(), %lu ausgegeben, davon %lu neu (%.0f/s), %lu zerrissen\n", updates,
+           framesShown, handedFrames, handedFrames / seconds, tornFrames);
+    CHECK(handedFrames > 0);
+    CHECK(tornFrames == 0);
+    CHECK(reorderedFrames == 0);
+    CHECK(invalidRows == 0);
+}
+
+
+/// loop1() und loop() als Threads: Schalter drücken, PING senden, Jitter und Durchsatz messen.
+static void testLoopThreads() {
+    std::atomic<bool> isRunning(true);
+    std::vector<unsigned long> starts;
+    starts.reserve(1000000);
+    unsigned long presses = 0, loops = 0, pings = 0;
+    switchOn = switchOff = pongs = 0;
+    framesShown = 0;
+    HostHal::setTransmitHandler(onTransmit);
+
+    const unsigned long start = realMicros();
+    std::thread ioCore([&]() {
+        for (unsigned long count = 0; isRunning; ++count) {
+            const bool isPress = (count % (2 * PRESS_LOOPS) == PRESS_LOOPS);
+            if (count % PRESS_LOOPS == 0) {
+                HostHal::setInput(HW_MATRIX_COLS_LSB_PIN + PRESS_COL, ! isPress);
+            }
+            if (starts.size() < starts.capacity()) {
+                starts.push_back(realMicros());
+            }
+            loop1();
+            presses += isPress ? 1 : 0;     // erst zählen, wenn loop1() den Schalter gelesen hat
+        }
+        HostHal::setInput(HW_MATRIX_COLS_LSB_PIN + PRESS_COL, true);
+        loop1();
+    });
+    std::thread deviceCore([&]() {
+        unsigned long nextPing = realMicros();
+        char line[24];
+        while (isRunning) {
+            if (realMicros() >= nextPing) {
+                snprintf(line, sizeof(line), "SYS;PING;%lu\n", ++pings);
+                HostHal::receive(line);
+                nextPing += PING_INTERVAL_US;
+            }
+            loop();
+            ++loops;
+        }
+    });
+    std::this_thread::sleep_for(THREAD_RUN_TIME);
+    isRunning = false;
+    ioCore.join();
+    deviceCore.join();
+    const double seconds = (realMicros() - start) / 1e6;
+    // Noch wartende Änderungen und Events abarbeiten
+    for (uint8_t pass = 0; pass != 3; ++pass) {
+        loop1();
+        loop();
+    }
+    HostHal::setTransmitHandler(nullptr);
+
+    std::vector<unsigned long> periods;
+    for (size_t index = 1; index < starts.size(); ++index) {
+        periods.push_back(starts[index] - starts[index - 1]);
+    }
+    std::sort(periods.begin(), periods.end());
+    printf("  I/O-Kern: %.0f loop1()/s, Periode p50 %lu µs, p99 %lu µs, max %lu µs, %.0f Frames/s\n",
+           starts.size() / seconds, percentile(periods, 50), percentile(periods, 99),
+           periods.empty() ? 0 : periods.back(), framesShown / seconds);
+    printf("  Gerätekern: %.0f loop()/s, %lu PING, %lu PONG, %lu-mal gedrückt, %lu ON, %lu OFF\n", loops / seconds,
+           pings, pongs, presses, switchOn, switchOff);
+    CHECK(presses > 0);
+    CHECK((switchOn == presses) && (switchOff == presses));
+    CHECK(pongs == pings);
+    CHECK(invalidRows == 0);
+    CHECK(! periods.empty() && (percentile(periods, 50) < 10000));
+}
+
+
+int main() {
+    setup();
+    setup1();
+    HostHal::setPinWriteHandler(onPinWrite);
+    for (uint8_t pass = 0; pass != 3; ++pass) {
+        loop1();
+        loop();
+        HostHal::advanceMicros(20000);
+    }
+    testSwitchQueueOverflow();
+    testFrameHandoffWhilePending();
+
+    clockOffset = Hal::micros() - realMicros();
+    HostHal::setClock(realMicros);
+    testFrameHandoffThreads();
+    testLoopThreads();
+    return checkResult("test_dualcore");
+}
@@ -0,0 +1,81 @@
+/***************************************************************************************************
+ * @file test_hal.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: HostHal und ein Durchlauf der Firmware über die Hardware-Abstraktion.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <txbuffer.hpp>
+
+void setup();
+void loop();
+void serialEvent();
+
+
+/// Simulierte Uhr, Pins und Empfangspuffer der HostHal.
+static void testHostHal() {
+    const unsigned long start = Hal::micros();
+    HostHal::advanceMicros(1500);
+    CHECK(Hal::micros() - start == 1500);
+    Hal::delayMillis(2);
+    CHECK(Hal::micros() - start == 3500);
+
+    Hal::pinWrite(7, true);
+    CHECK(HostHal::output(7));
+    Hal::pinWrite(7, false);
+    CHECK(! HostHal::output(7));
+    CHECK(Hal::pinRead(8));             // offener Eingang mit Pullup
+    HostHal::setInput(8, false);
+    CHECK(! Hal::pinRead(8));
+    HostHal::setInput(8, true);
+
+    HostHal::receive("AB");
+    CHECK(Hal::uartAvailable() == 2);
+    CHECK(Hal::uartRead() == 'A');
+    CHECK(Hal::uartRead() == 'B');
+    CHECK(Hal::uartRead() == -1);
+}
+
+
+/// setup() und loop() laufen ohne Arduino; Ein- und Ausgaben gehen nur über Hal.
+static void testFirmware() {
+    HostHal::clearTransmitted();
+    setup();
+    CHECK(strncmp(HostHal::transmitted(), "XPanino\r\n", 9) == 0);
+    CHECK(HostHal::output(PIN3));       // STRB nach initHardware() auf HIGH
+
+    HostHal::clearTransmitted();
+    HostHal::receive("SYS;PING;7\n");
+    serialEvent();
+    loop();
+    CHECK_CONTAINS("SYS;PONG;7;", HostHal::transmitted());
+}
+
+
+/// Nicht dringende Antworten wartet der TxBuffer ab und sendet sie gemeinsam in einem Paket.
+static void testTxBufferBudget() {
+    HostHal::clearTransmitted();
+    HostHal::receive("SYS;STAT\n");
+    serialEvent();
+    loop();
+    CHECK(strstr(HostHal::transmitted(), "SYS;LOOP;") == nullptr);
+    const unsigned long count = HostHal::transmitCount();
+    HostHal::advanceMicros(TX_LATENCY_BUDGET * 1000);
+    loop();
+    CHECK_CONTAINS("SYS;LOOP;", HostHal::transmitted());
+    CHECK_CONTAINS("SYS;RAM;", HostHal::transmitted());
+    CHECK(HostHal::transmitCount() == count + 1);
+}
+
+
+int main() {
+    testHostHal();
+    testFirmware();
+    testTxBufferBudget();
+    return checkResult("test_hal");
+}
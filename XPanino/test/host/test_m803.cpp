@@ -0,0 +1,194 @@
+/***************************************************************************************************
+ * @file test_m803.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Tasterbedienung und Anzeige der Uhr Davtron M803.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <m803.hpp>
+
+extern LedMatrix leds;
+extern ClockDavtronM803 m803;
+
+const uint8_t LOWER_DISPLAY = 1;    ///< Display-Feld des unteren Displays (vgl. Konstruktor der Uhr)
+
+
+/// LEDs des unteren Displays (Rows 4 bis 7, Cols 16 bis 23) als Bitmuster.
+static uint32_t lowerDisplayBits() {
+    uint32_t bits = 0;
+    for (uint8_t row = 4; row < 8; ++row) {
+        for (uint8_t col = 16; col < 24; ++col) {
+            bits = (bits << 1) | (leds.isLedOn({row, col}) ? 1 : 0);
+        }
+    }
+    return bits;
+}
+
+
+/// Prüfen, ob das untere Display @em digits zeigt; dazu wird @em digits in dasselbe Feld geschrieben.
+#define CHECK_LOWER_DISPLAY(digits) \
+    do { \
+        const uint32_t shown = lowerDisplayBits(); \
+        leds.display(LOWER_DISPLAY, (digits)); \
+        if (shown != lowerDisplayBits()) { \
+            ++checkFailures; \
+            printf("%s:%d: unteres Display zeigt nicht \"%s\"\n", __FILE__, __LINE__, (digits)); \
+        } \
+    } while (0)
+
+
+/// Einen Taster der Uhr drücken und wieder loslassen.
+static void press(const uint8_t col) {
+    m803.processSwitch(M803_SWITCH_ROW, col, SWITCH_STATE_ON);
+    m803.processSwitch(M803_SWITCH_ROW, col, SWITCH_STATE_OFF);
+}
+
+
+/// Die Uhr mit @em seconds Sekunden Abstand anzeigen lassen.
+static void advanceSeconds(const unsigned long seconds) {
+    HostHal::advanceMicros(seconds * 1000000UL);
+    m803.show();
+}
+
+
+/// Uhr einschalten und mit SELECT die FT auswählen.
+static void testPowerOnShowsFlightTime() {
+    m803.setBatteryPower(true);
+    m803.show();
+    CHECK(m803.getClockMode() == ClockModeState::LT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::FT);
+    advanceSeconds(65);
+    CHECK_LOWER_DISPLAY("0105");
+}
+
+
+/// Bei Anzeige der FT: kurzer Druck auf CONTROL ändert nichts, langer Druck setzt die FT zurück und startet sie.
+static void testControlLongPressRestartsFlightTime() {
+    press(M803_SWITCH_CONTROL);
+    advanceSeconds(1);
+    CHECK(m803.getClockMode() == ClockModeState::FT);
+    CHECK_LOWER_DISPLAY("0106");
+
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_ON);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_LONG_ON);
+    m803.show();
+    CHECK_LOWER_DISPLAY("0000");
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_OFF);
+    CHECK(m803.getClockMode() == ClockModeState::FT);
+
+    advanceSeconds(2);
+    CHECK_LOWER_DISPLAY("0002");
+}
+
+
+/// SELECT und CONTROL gleichzeitig drücken und wieder loslassen.
+static void pressSelectControl() {
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_SELECT, SWITCH_STATE_ON);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_ON);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_SELECT, SWITCH_STATE_OFF);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_OFF);
+}
+
+
+/// Von FT zur ET wechseln, einen Countdown von 10 Sekunden stellen und mit CONTROL starten.
+static void startCountdown() {
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::ET);
+    pressSelectControl();
+    CHECK(m803.getClockMode() == ClockModeState::SET_ET);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_CONTROL);     // 00:10
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);      // übernehmen
+    CHECK(m803.getClockMode() == ClockModeState::ET);
+    press(M803_SWITCH_CONTROL);     // ET starten
+    advanceSeconds(3);
+    CHECK_LOWER_DISPLAY("0007");
+}
+
+
+/// Nach dem Alarm setzt ein Anker die ET unter den Countdown zurück: Restzeit statt Unterlauf anzeigen.
+static void testAnchorBelowCountdown() {
+    advanceSeconds(8);
+    CHECK_LOWER_DISPLAY("0001");    // Alarm; die ET zählt aufwärts weiter
+    uint32_t anchor = 5;
+    m803.setElapsedTime(anchor);
+    advanceSeconds(0);
+    CHECK_LOWER_DISPLAY("0005");
+    advanceSeconds(2);
+    CHECK_LOWER_DISPLAY("0003");
+}
+
+
+/// Der Alarm wird nur bei Anzeige der ET quittiert; in den anderen Modi schalten die Taster wie gewohnt.
+static void testAlarmAcknowledgeOnlyInEt() {
+    press(M803_SWITCH_SELECT);      // quittiert den Alarm aus testAnchorBelowCountdown()
+    CHECK(m803.getClockMode() == ClockModeState::ET);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::FT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::ET);
+
+    // ET zurücksetzen, starten und den Countdown in der FT ablaufen lassen
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_ON);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_LONG_ON);
+    m803.processSwitch(M803_SWITCH_ROW, M803_SWITCH_CONTROL, SWITCH_STATE_OFF);
+    press(M803_SWITCH_CONTROL);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::FT);
+    advanceSeconds(11);
+
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::LT);
+    press(M803_SWITCH_SELECT);
+    press(M803_SWITCH_SELECT);
+    CHECK(m803.getClockMode() == ClockModeState::ET);
+    advanceSeconds(0);
+    CHECK_LOWER_DISPLAY("0001");
+    press(M803_SWITCH_CONTROL);     // quittiert nur; die ET läuft weiter
+    advanceSeconds(2);
+    CHECK_LOWER_DISPLAY("0003");
+}
+
+
+/// Wird die Stoppuhr mitten in einer Sekunde angehalten, zählt der Rest nach dem nächsten Start weiter.
+static void testStopwatchKeepsRemainder() {
+    Stopwatch stopwatch;
+    stopwatch.start();
+    HostHal::advanceMicros(600000UL);
+    stopwatch.stop();
+    HostHal::advanceMicros(5000000UL);
+    CHECK(stopwatch.getSeconds() == 0);
+    stopwatch.start();
+    HostHal::advanceMicros(600000UL);
+    CHECK(stopwatch.getSeconds() == 1);
+    stopwatch.stop();
+    stopwatch.stop();               // ein zweites stop() ändert den Rest nicht
+    stopwatch.start();
+    HostHal::advanceMicros(800000UL);
+    CHECK(stopwatch.getSeconds() == 2);
+}
+
+
+int main() {
+    testPowerOnShowsFlightTime();
+    testControlLongPressRestartsFlightTime();
+    startCountdown();
+    testAnchorBelowCountdown();
+    testAlarmAcknowledgeOnlyInEt();
+    testStopwatchKeepsRemainder();
+    return checkResult("test_m803");
+}
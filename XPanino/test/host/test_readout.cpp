@@ -0,0 +1,92 @@
+/***************************************************************************************************
+ * @file test_readout.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Extrapolation der tabellengesteuerten Anzeigen (RD).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <readout.hpp>
+
+extern LedMatrix leds;
+
+void setup();
+void loop();
+void serialEvent();
+
+const uint8_t EGT_FIELD = 5;        ///< Display-Feld der EGT (vgl. READOUTS in readout.cpp)
+
+
+/// LEDs der EGT-Anzeige (Rows 4 bis 7, Cols 24 bis 31) als Bitmuster.
+static uint32_t egtDisplayBits() {
+    uint32_t bits = 0;
+    for (uint8_t row = 4; row < 8; ++row) {
+        for (uint8_t col = 24; col < 32; ++col) {
+            bits = (bits << 1) | (leds.isLedOn({row, col}) ? 1 : 0);
+        }
+    }
+    return bits;
+}
+
+
+/// Prüfen, ob die EGT-Anzeige @em digits zeigt; dazu wird @em digits in dasselbe Feld geschrieben.
+#define CHECK_EGT_DISPLAY(digits) \
+    do { \
+        const uint32_t shown = egtDisplayBits(); \
+        leds.display(EGT_FIELD, (digits)); \
+        if (shown != egtDisplayBits()) { \
+            ++checkFailures; \
+            printf("%s:%d: EGT-Anzeige zeigt nicht \"%s\"\n", __FILE__, __LINE__, (digits)); \
+        } \
+    } while (0)
+
+
+/// Eine Zeile an die Firmware senden und einmal loop() ausführen.
+static void receiveLine(const char *line) {
+    HostHal::receive(line);
+    serialEvent();
+    loop();
+}
+
+
+/// Die Zeit um @em millis Millisekunden weiterstellen und einmal loop() ausführen.
+static void advanceMillis(const unsigned long millis) {
+    HostHal::advanceMicros(millis * 1000UL);
+    loop();
+}
+
+
+/// Die Extrapolation läuft mit der Rate weiter, endet aber am Maximum des Tabelleneintrags (1650).
+static void testExtrapolationStopsAtMaxValue() {
+    receiveLine("RD;V;2;1600\n");
+    receiveLine("RD;R;2;600\n");    // 10 je Sekunde
+    advanceMillis(2000);
+    CHECK_EGT_DISPLAY("1620");
+    advanceMillis(4000);
+    CHECK_EGT_DISPLAY("1650");
+    advanceMillis(3000);
+    CHECK_EGT_DISPLAY("1650");
+}
+
+
+/// Ein empfangener Wert außerhalb der Grenzen bleibt stehen und wird nicht weiter extrapoliert.
+static void testValueOutsideLimitsIsKept() {
+    receiveLine("RD;V;2;1700\n");
+    advanceMillis(2000);
+    CHECK_EGT_DISPLAY("1700");
+    receiveLine("RD;R;2;-600\n");
+    advanceMillis(3000);
+    CHECK_EGT_DISPLAY("1670");
+}
+
+
+int main() {
+    setup();
+    testExtrapolationStopsAtMaxValue();
+    testValueOutsideLimitsIsKept();
+    return checkResult("test_readout");
+}
@@ -0,0 +1,462 @@
+/***************************************************************************************************
+ * @file test_soak.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Dauerlauf der Firmware mit simuliertem Verkehr; Heap, Fragmentierung und Stack.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Aufruf: test_soak [simulierte Stunden]
+ *
+ * Die Firmware läuft mit der simulierten Uhr der HostHal beschleunigt über mehrere Stunden (Standard
+ * 2). Je simulierter Sekunde kommen Zeilen wie von XPIf (Uhrzeit, Flightlevel, Anzeigen, PING, STAT),
+ * dazu regelmäßig Schalter, Ein-/Ausschalten, zu lange und fehlerhafte Zeilen und Bündel, die mehr
+ * Events erzeugen als der Pool fasst. Global new/delete gehen durch ein Modell des malloc der avr-libc
+ * (avrheap.hpp); der Stack wird vor jedem Fenster mit einem Muster beschrieben ("Stack Painting").
+ *
+ * Je Fenster (10 simulierte Minuten) werden Höchststand des Heaps, belegter Speicher, Fragmentierung,
+ * größter freier Block, Stacktiefe und freie Plätze im Event-Pool festgehalten. Der Test schlägt fehl,
+ * wenn einer dieser Werte nach dem ersten Fenster (Einschwingen) steigt bzw. der freie Speicher sinkt.
+ * Die Größen sind die des PCs (Zeiger mit 8 Byte); es geht um den Verlauf, nicht um die Byte des Uno.
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "avrheap.hpp"
+#include "check.hpp"
+#include <hal.hpp>
+#include <buffer.hpp>
+#include <Switchmatrix.hpp>
+
+#include <new>
+#include <stdlib.h>
+
+void setup();
+void loop();
+void serialEvent();
+
+extern BufferClass inBuffer;
+extern EventQueueClass eventQueue;
+
+const uint16_t AVR_HEAP_SIZE = 512;         ///< Angenommener Platz für den Heap (SRAM abzüglich .data, .bss, Stack)
+const uint8_t MAX_HEAP_BLOCKS = 64;         ///< Max. Anzahl gleichzeitig belegter Blöcke im Modell
+const unsigned long LOOP_IDLE_US = 500;     ///< Zusätzliche Dauer eines loop() (die Wartezeiten der LED-Matrix kommen dazu)
+const unsigned long WINDOW_SECONDS = 600;   ///< Länge eines Messfensters
+const unsigned long MAX_WINDOWS = 200;
+const size_t STACK_PAINT_SIZE = 32768;      ///< So weit unterhalb des Messpunkts wird der Stack beschrieben
+const size_t STACK_PAINT_GAP = 512;         ///< Abstand zum eigenen Frame (Red Zone, lokale Variablen)
+const uint8_t STACK_PAINT = 0xC5;           ///< Muster
+
+
+/***************************************************************************************************
+ * Heap-Modell hinter global new/delete
+ **************************************************************************************************/
+
+static AvrHeap avrHeap(AVR_HEAP_SIZE);
+static bool isHeapModelActive = false;      ///< Nur während des Dauerlaufs; vorher und danach gilt malloc
+static uint32_t heapAllocations = 0;        ///< Anzahl der new während des Dauerlaufs
+
+/// Ein belegter Block: Speicher auf dem PC und Adresse im Modell.
+struct HeapBlock {
+    void *memory;
+    uint16_t address;
+};
+static HeapBlock heapBlocks[MAX_HEAP_BLOCKS];
+
+
+static void *modelAllocate(const size_t size) {
+    void *memory = malloc((size == 0) ? 1 : size);
+    if ((memory == nullptr) || ! isHeapModelActive) {
+        return memory;
+    }
+    ++heapAllocations;
+    const uint16_t address = avrHeap.allocate(static_cast<uint16_t>(size < AVR_HEAP_MAX_SIZE ? size : AVR_HEAP_MAX_SIZE));
+    // Schlägt das Modell fehl, zählt es den Fehler; der Speicher kommt trotzdem vom PC, damit der Lauf weitergeht.
+    for (HeapBlock &block : heapBlocks) {
+        if ((address != AVR_HEAP_NULL) && (block.memory == nullptr)) {
+            block = {memory, address};
+            break;
+        }
+    }
+    return memory;
+}
+
+
+static void modelRelease(void *memory) {
+    for (HeapBlock &block : heapBlocks) {
+        if ((memory != nullptr) && (block.memory == memory)) {
+            avrHeap.release(block.address);
+            block.memory = nullptr;
+            break;
+        }
+    }
+    free(memory);
+}
+
+
+void *operator new(size_t size) {
+    void *memory = modelAllocate(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *memory) noexcept { modelRelease(memory); }
+void operator delete[](void *memory) noexcept { modelRelease(memory); }
+void operator delete(void *memory, size_t) noexcept { modelRelease(memory); }
+void operator delete[](void *memory, size_t) noexcept { modelRelease(memory); }
+
+
+/***************************************************************************************************
+ * Stack Painting
+ **************************************************************************************************/
+
+/// Den Stack unterhalb des eigenen Frames bis STACK_PAINT_SIZE unter @em reference mit dem Muster beschreiben.
+__attribute__((noinline)) static void paintStack(const uint8_t *reference) {
+    volatile uint8_t marker = 0;
+    volatile uint8_t *limit = &marker - STACK_PAINT_GAP;
+    for (volatile uint8_t *p = const_cast<uint8_t *>(reference) - STACK_PAINT_SIZE; p < limit; ++p) {
+        *p = STACK_PAINT;
+    }
+}
+
+
+/// @return Größte Tiefe des Stacks unterhalb von @em reference seit paintStack().
+__attribute__((noinline)) static size_t measureStack(const uint8_t *reference) {
+    const volatile uint8_t *p = reference - STACK_PAINT_SIZE;
+    while ((p < reference) && (*p == STACK_PAINT)) {
+        ++p;
+    }
+    return static_cast<size_t>(reference - const_cast<const uint8_t *>(p));
+}
+
+
+/***************************************************************************************************
+ * Simulierter Verkehr
+ **************************************************************************************************/
+
+/// Zeilen, die in einem Stück (höchstens so viel wie der Empfangspuffer fasst) ankommen.
+struct Chunk {
+    char text[HOST_HAL_RX_SIZE];
+};
+
+static Chunk chunks[32];                    ///< Noch nicht zugestellte Stücke (Ring)
+static uint8_t chunkHead = 0;
+static uint8_t chunkTail = 0;
+static unsigned long pingsSent = 0;
+static unsigned long pongsReceived = 0;
+static unsigned long leakEvery = 0;         ///< Für den Selbsttest: alle n Sekunden Speicher nicht freigeben
+static char *volatile leaked = nullptr;     ///< Zuletzt nicht freigegebener Speicher (sonst entfernt der Compiler das new)
+
+
+static void addChunk(const char *format, const unsigned long p1 = 0, const unsigned long p2 = 0) {
+    snprintf(chunks[chunkHead].text, sizeof(Chunk::text), format, p1, p2);
+    chunkHead = static_cast<uint8_t>((chunkHead + 1) % (sizeof(chunks) / sizeof(chunks[0])));
+}
+
+
+/// Verkehr der simulierten Sekunde @em second einplanen.
+static void scheduleSecond(const unsigned long second) {
+    const unsigned long time = (second / 3600 % 24) * 10000 + (second / 60 % 60) * 100 + second % 60;
+    addChunk("M803;TIME;%06lu;%06lu\n", time, time);
+    addChunk("XPDR;F;%03lu\n", 50 + second / 10 % 300);
+    if (second % 2 == 0) {
+        addChunk("RD;V;1;%lu\n", 100 + second % 60);
+    }
+    if (second % 5 == 0) {
+        addChunk("SYS;PING;%lu\n", second % 100000);
+        ++pingsSent;
+    }
+    if (second % 10 == 0) {
+        addChunk("SYS;STAT\n");
+    }
+    if (second % 30 == 0) {
+        addChunk("XPDR;CODE;%04lu\n", 1000 + second % 6000);
+    }
+    switch (second % 60) {
+        case 15:    // 10 Events auf einmal; der Pool fasst EVENT_POOL_SIZE, der Rest geht verloren
+            addChunk("PB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\nPB;ON\n");
+            break;
+        case 16:    // zu lang, zu viele Teile, leer und unbekannt
+            addChunk("M803;TIMETIMETIME;1234567890;9876543210;EXTRA\n");
+            addChunk(";;;\nXYZ\n \n");
+            break;
+        default: ;
+    }
+    switch (second % 300) {
+        case 100: addChunk("PB;OFF\n"); break;
+        case 103: addChunk("PB;ON\nPA1;ON\nPA2;ON\n"); break;
+        default: ;
+    }
+    // Einen Schalter der Matrix eine Sekunde lang schließen
+    if (second % 20 == 5) {
+        HostHal::setInput(HW_MATRIX_COLS_LSB_PIN + second / 20 % SWITCH_MATRIX_COLS, false);
+    } else if (second % 20 == 6) {
+        for (uint8_t col = 0; col < SWITCH_MATRIX_COLS; ++col) {
+            HostHal::setInput(HW_MATRIX_COLS_LSB_PIN + col, true);
+        }
+    }
+    if ((leakEvery != 0) && (second % leakEvery == 0)) {
+        leaked = new char[8];   // Absichtlich nicht freigegeben
+    }
+}
+
+
+/// Gesendete Pakete auswerten, statt sie zu sammeln.
+static void onTransmit(const char *buffer, const size_t length) {
+    for (const char *line = buffer; (line != nullptr) && (line < buffer + length);) {
+        pongsReceived += (strncmp(line, "SYS;PONG;", 9) == 0) ? 1 : 0;
+        line = static_cast<const char *>(memchr(line, '\n', buffer + length - line));
+        line = (line == nullptr) ? nullptr : line + 1;
+    }
+}
+
+
+/***************************************************************************************************
+ * Dauerlauf
+ **************************************************************************************************/
+
+/// Messwerte eines Fensters.
+struct WindowStats {
+    uint32_t heapHighWater;     ///< Höchststand von __brkval
+    uint32_t heapInUse;         ///< Belegter Speicher am Ende des Fensters
+    uint32_t fragmentation;     ///< Fragmentierung am Ende in Promille
+    uint32_t largestFreeLoss;   ///< AVR_HEAP_SIZE minus größter freier Block (steigt, wenn er schrumpft)
+    uint32_t stackDepth;        ///< Größte Stacktiefe unterhalb von runWindow()
+    uint32_t freeEventSlots;    ///< Freie Plätze im Event-Pool am Ende
+};
+
+
+/// Freie Plätze im Event-Pool zählen.
+static uint8_t countFreeEventSlots() {
+    EventClass *events[EVENT_POOL_SIZE + 1];
+    uint8_t count = 0;
+    while ((count <= EVENT_POOL_SIZE) && ((events[count] = new EventClass {}) != nullptr)) {
+        ++count;
+    }
+    for (uint8_t index = 0; index != count; ++index) {
+        delete events[index];
+    }
+    return count;
+}
+
+
+/// Ein Fenster lang Verkehr erzeugen und die Firmware laufen lassen.
+__attribute__((noinline)) static WindowStats runWindow(unsigned long &second) {
+    uint8_t reference;
+    paintStack(&reference);
+    avrHeap.resetHighWater();
+    const unsigned long end = second + WINDOW_SECONDS;
+    while (second < end) {
+        if (Hal::millis() / 1000 >= second) {
+            scheduleSecond(second++);
+        }
+        if (chunkTail != chunkHead) {
+            HostHal::receive(chunks[chunkTail].text);
+            chunkTail = static_cast<uint8_t>((chunkTail + 1) % (sizeof(chunks) / sizeof(chunks[0])));
+        }
+        serialEvent();
+        loop();
+        HostHal::advanceMicros(LOOP_IDLE_US);
+    }
+    WindowStats stats;
+    stats.heapHighWater = avrHeap.getHighWater();
+    stats.heapInUse = avrHeap.getInUse();
+    stats.fragmentation = avrHeap.getFragmentation();
+    stats.largestFreeLoss = AVR_HEAP_SIZE - avrHeap.getLargestFree();
+    stats.stackDepth = static_cast<uint32_t>(measureStack(&reference));
+    stats.freeEventSlots = countFreeEventSlots();
+    return stats;
+}
+
+
+/**
+ * @brief Steigt die Reihe nach dem ersten Wert (Einschwingen)?
+ *
+ * Steigend heißt: Das Maximum der zweiten Hälfte liegt über dem der ersten und die Regressionsgerade
+ * steigt. Einzelne Spitzen in der zweiten Hälfte genügen also nicht.
+ */
+static bool isTrendingUp(const uint32_t *values, const size_t count) {
+    if (count < 3) {
+        return false;
+    }
+    const size_t first = 1, n = count - first, middle = first + n / 2;
+    uint32_t firstMax = 0, secondMax = 0;
+    double sumX = 0, sumY = 0, sumXY = 0, sumXX = 0;
+    for (size_t i = first; i < count; ++i) {
+        uint32_t &max = (i < middle) ? firstMax : secondMax;
+        max = (values[i] > max) ? values[i] : max;
+        sumX += i;
+        sumY += values[i];
+        sumXY += static_cast<double>(i) * values[i];
+        sumXX += static_cast<double>(i) * i;
+    }
+    const double slope = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+    return (secondMax > firstMax) && (slope > 0);
+}
+
+
+/// Ergebnis eines Dauerlaufs.
+struct SoakResult {
+    size_t windows;
+    bool isHeapTrendingUp;      ///< Höchststand oder belegter Speicher steigt
+    bool isFragmenting;         ///< Fragmentierung steigt oder der größte freie Block schrumpft
+    bool isStackTrendingUp;
+    bool isPoolLeaking;         ///< Plätze im Event-Pool gehen verloren
+};
+
+
+/// Die Firmware @em hours simulierte Stunden laufen lassen und die Fenster ausgeben.
+static SoakResult runSoak(const double hours, const bool isVerbose) {
+    static WindowStats stats[MAX_WINDOWS];
+    static uint32_t series[MAX_WINDOWS];
+    SoakResult result = {};
+    result.windows = static_cast<size_t>(hours * 3600 / WINDOW_SECONDS);
+    result.windows = (result.windows > MAX_WINDOWS) ? MAX_WINDOWS : result.windows;
+    pingsSent = pongsReceived = 0;
+    chunkHead = chunkTail = 0;
+
+    HostHal::setTransmitHandler(onTransmit);
+    unsigned long second = Hal::millis() / 1000 + 1;
+    isHeapModelActive = true;
+    for (size_t window = 0; window < result.windows; ++window) {
+        stats[window] = runWindow(second);
+        if (isVerbose) {
+            printf("  %5.1f h: Heap max %3u, belegt %3u, Fragm. %3u ‰, größter freier Block %3u, Stack %5u, Pool frei %u\n",
+                   (window + 1) * WINDOW_SECONDS / 3600.0, stats[window].heapHighWater, stats[window].heapInUse,
+                   stats[window].fragmentation, AVR_HEAP_SIZE - stats[window].largestFreeLoss,
+                   stats[window].stackDepth, stats[window].freeEventSlots);
+        }
+    }
+    isHeapModelActive = false;
+    HostHal::setTransmitHandler(nullptr);
+
+    // Jede Kennzahl als Reihe über die Fenster prüfen
+    const uint32_t WindowStats::*fields[] = {&WindowStats::heapHighWater, &WindowStats::heapInUse,
+                                             &WindowStats::fragmentation, &WindowStats::largestFreeLoss,
+                                             &WindowStats::stackDepth};
+    bool *flags[] = {&result.isHeapTrendingUp, &result.isHeapTrendingUp, &result.isFragmenting,
+                     &result.isFragmenting, &result.isStackTrendingUp};
+    for (size_t field = 0; field < sizeof(fields) / sizeof(fields[0]); ++field) {
+        for (size_t window = 0; window < result.windows; ++window) {
+            series[window] = stats[window].*fields[field];
+        }
+        *flags[field] = *flags[field] || isTrendingUp(series, result.windows);
+    }
+    for (size_t window = 0; window < result.windows; ++window) {
+        result.isPoolLeaking = result.isPoolLeaking || (stats[window].freeEventSlots != EVENT_POOL_SIZE);
+    }
+    return result;
+}
+
+
+/***************************************************************************************************
+ * Tests
+ **************************************************************************************************/
+
+/// Das Modell verhält sich wie malloc/free der avr-libc.
+static void testAvrHeapModel() {
+    AvrHeap heap(64);
+    const uint16_t a = heap.allocate(10);
+    const uint16_t b = heap.allocate(10);
+    const uint16_t c = heap.allocate(1);                // wird auf 2 Byte aufgerundet
+    CHECK((a == 2) && (b == 14) && (c == 26));
+    CHECK((heap.getBreak() == 28) && (heap.getInUse() == 28));
+    heap.release(a);
+    CHECK((heap.getFree() == 36 + 12) && (heap.getLargestFree() == 36));
+    CHECK(heap.getFragmentation() == 250);
+    CHECK(heap.allocate(4) == 8);                       // oberer Teil des freien Blocks
+    CHECK(heap.allocate(40) == AVR_HEAP_NULL);
+    CHECK(heap.getFailures() == 1);
+    heap.release(8);                                    // wieder zusammengefasst
+    heap.release(b);
+    CHECK(heap.getBreak() == 28);
+    CHECK(heap.allocate(22) == 2);                      // genau passend
+    heap.release(2);
+    heap.release(c);                                    // oberster Block: alles zurück an den Heap
+    CHECK((heap.getBreak() == 0) && (heap.getInUse() == 0) && (heap.getLargestFree() == 64));
+    CHECK(heap.getHighWater() == 28);
+}
+
+
+/// EVENT_POOL_SIZE + 1 Events: das letzte gibt es nicht, die Zeile geht verloren, danach geht es weiter.
+static void testEventPoolExhaustion() {
+    EventClass *events[EVENT_POOL_SIZE];
+    for (EventClass *&event : events) {
+        event = new EventClass {};
+        CHECK(event != nullptr);
+    }
+    CHECK(new EventClass {} == nullptr);
+    char line[] = "SYS;PING;1";
+    CHECK(inBuffer.parseString(line) == nullptr);
+    eventQueue.addEvent(nullptr);                       // darf die Queue nicht verändern
+    CHECK(eventQueue.getHeadEvent() == nullptr);
+    for (EventClass *event : events) {
+        delete event;
+    }
+
+    // Über die serielle Schnittstelle: 9 Zeilen vor dem nächsten dispatchAll(), davon passen 8 in den Pool.
+    HostHal::clearTransmitted();
+    HostHal::receive("SYS;PING;1\nSYS;PING;2\nSYS;PING;3\nSYS;PING;4\nSYS;PING;5\n");
+    serialEvent();
+    HostHal::receive("SYS;PING;6\nSYS;PING;7\nSYS;PING;8\nSYS;PING;9\n");
+    serialEvent();
+    loop();
+    CHECK_CONTAINS("SYS;PONG;8;", HostHal::transmitted());
+    CHECK(strstr(HostHal::transmitted(), "SYS;PONG;9;") == nullptr);
+    CHECK(countFreeEventSlots() == EVENT_POOL_SIZE);
+
+    HostHal::clearTransmitted();
+    HostHal::receive("SYS;PING;10\n");
+    serialEvent();
+    loop();
+    CHECK_CONTAINS("SYS;PONG;10;", HostHal::transmitted());
+}
+
+
+/// Ein absichtliches Leck im Verkehr muss der Dauerlauf erkennen.
+static void testSoakDetectsLeak() {
+    leakEvery = 120;
+    const SoakResult result = runSoak(1.0, false);
+    leakEvery = 0;
+    for (HeapBlock &block : heapBlocks) {   // Leck für den eigentlichen Dauerlauf aufräumen
+        if (block.memory != nullptr) {
+            avrHeap.release(block.address);
+            free(block.memory);
+            block.memory = nullptr;
+        }
+    }
+    CHECK(avrHeap.getInUse() == 0);
+    CHECK(result.isHeapTrendingUp);
+    CHECK(! result.isPoolLeaking);
+}
+
+
+/// Der eigentliche Dauerlauf.
+static void testSoak(const double hours) {
+    printf("Dauerlauf über %.1f simulierte Stunden, Heap-Modell %u Byte:\n", hours, AVR_HEAP_SIZE);
+    const uint32_t allocationsBefore = heapAllocations;
+    const SoakResult result = runSoak(hours, true);
+    printf("  %lu PING, %lu PONG, %lu new, %lu Fehler im Heap-Modell\n", pingsSent, pongsReceived,
+           static_cast<unsigned long>(heapAllocations - allocationsBefore),
+           static_cast<unsigned long>(avrHeap.getFailures()));
+    CHECK(result.windows >= 3);
+    CHECK(! result.isHeapTrendingUp);
+    CHECK(! result.isFragmenting);
+    CHECK(! result.isStackTrendingUp);
+    CHECK(! result.isPoolLeaking);
+    CHECK(pongsReceived == pingsSent);
+    CHECK(avrHeap.getFailures() == 0);
+}
+
+
+int main(int argc, char *argv[]) {
+    const double hours = (argc > 1) ? atof(argv[1]) : 2.0;
+    setup();
+    testAvrHeapModel();
+    testEventPoolExhaustion();
+    testSoakDetectsLeak();
+    testSoak(hours);
+    return checkResult("test_soak");
+}
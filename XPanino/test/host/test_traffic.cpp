@@ -0,0 +1,90 @@
+/***************************************************************************************************
+ * @file test_traffic.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Warnstufen-LEDs der Verkehrswarnung (TC).
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <traffic.hpp>
+
+#include <string>
+
+extern LedMatrix leds;
+
+void setup();
+void loop();
+void serialEvent();
+
+
+/// Eine Zeile an die Firmware senden und einmal loop() ausführen.
+static void receiveLine(const char *line) {
+    HostHal::receive(line);
+    serialEvent();
+    loop();
+}
+
+
+/// Leuchtende LEDs als "TFC/TA/RA", blinkend mit '*'; z.B.\ "-/-/RA*".
+static std::string shownLeds() {
+    std::string text;
+    text += leds.isLedOn(TRAFFIC_LED_TFC) ? "TFC" : "-";
+    text += leds.isLedOn(TRAFFIC_LED_TA) ? "/TA" : "/-";
+    text += leds.isLedOn(TRAFFIC_LED_RA) ? "/RA" : "/-";
+    text += (leds.isLedBlinkOn(TRAFFIC_LED_RA) == 1) ? "*" : "";
+    return text;
+}
+
+
+/// Ohne Strom bleiben die LEDs dunkel; die empfangene Stufe wird danach angezeigt.
+static void testPower() {
+    receiveLine("PB;OFF\n");
+    receiveLine("PA1;OFF\n");
+    receiveLine("TC;LVL;2\n");
+    CHECK_STR("-/-/-", shownLeds().c_str());
+    receiveLine("PB;ON\n");
+    CHECK_STR("-/-/-", shownLeds().c_str());
+    receiveLine("PA1;ON\n");
+    CHECK_STR("-/TA/-", shownLeds().c_str());
+}
+
+
+/// Es leuchtet nur die aktuelle Stufe, RA blinkend; ungültige Stufen werden ignoriert.
+static void testLevels() {
+    receiveLine("TC;LVL;3\n");
+    CHECK_STR("-/-/RA*", shownLeds().c_str());
+    receiveLine("TC;LVL;7\n");
+    CHECK_STR("-/-/RA*", shownLeds().c_str());
+    receiveLine("TC;LVL;1\n");
+    CHECK_STR("TFC/-/-", shownLeds().c_str());
+    receiveLine("TC;LVL;0\n");
+    CHECK_STR("-/-/-", shownLeds().c_str());
+    receiveLine("TC;LVL;3\n");
+    receiveLine("PA1;OFF\n");
+    CHECK_STR("-/-/-", shownLeds().c_str());
+    receiveLine("PA1;ON\n");
+    CHECK_STR("-/-/RA*", shownLeds().c_str());
+}
+
+
+/// Die LEDs liegen neben den Einzel-LEDs von Uhr und Transponder (Col 4), nicht darauf.
+static void testLedsAreSeparate() {
+    receiveLine("TC;LVL;0\n");
+    const bool isClockLedOn = leds.isLedOn({0, 4});
+    receiveLine("TC;LVL;1\n");
+    CHECK(leds.isLedOn({0, 4}) == isClockLedOn);
+    CHECK(leds.isLedOn(TRAFFIC_LED_TFC));
+}
+
+
+int main() {
+    setup();
+    testPower();
+    testLevels();
+    testLedsAreSeparate();
+    return checkResult("test_traffic");
+}
@@ -0,0 +1,92 @@
+/***************************************************************************************************
+ * @file test_xpdr.cpp
+ * @author Christian Harraeus (christian@harraeus.de)
+ * @brief Host-Test: Einschalten und Tasterbedienung des Transponders KT76C.
+ * @version 0.2
+ * @date 2026-10-18
+ *
+ * Copyright © 2017 - 2026. All rights reserved.
+ **************************************************************************************************/
+
+#include "check.hpp"
+#include <hal.hpp>
+#include <txbuffer.hpp>
+#include <xpdr.hpp>
+
+extern TxBuffer txBuffer;
+extern TransponderKT76C xpdr;
+
+
+/// Einen Schalter des Transponders setzen und die gesendeten Nachrichten sofort übertragen.
+static void setSwitch(const uint8_t row, const uint8_t col, const uint8_t switchState) {
+    xpdr.processSwitch(row, col, switchState);
+    txBuffer.flush();
+}
+
+
+/// Eine Code-Entry-Taste drücken und wieder loslassen.
+static void pressDigit(const uint8_t digit) {
+    setSwitch(XPDR_SWITCH_ROW_DIGITS, digit, SWITCH_STATE_ON);
+    setSwitch(XPDR_SWITCH_ROW_DIGITS, digit, SWITCH_STATE_OFF);
+}
+
+
+/// Steht der Wahlschalter beim Einschalten auf ALT, geht nur MODE;ALT an den PC, kein MODE;SBY.
+static void testPowerOnEntersKnobMode() {
+    xpdr.setBatteryPower(false);
+    xpdr.show();
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_KNOB_OFF + 4, SWITCH_STATE_ON);   // ALT
+    CHECK(xpdr.getMode() == XpdrModeState::OFF);
+
+    HostHal::clearTransmitted();
+    xpdr.setBatteryPower(true);
+    xpdr.show();
+    txBuffer.flush();
+    CHECK(xpdr.getMode() == XpdrModeState::ALT);
+    CHECK_STR("XPDR;MODE;ALT\r\n", HostHal::transmitted());
+}
+
+
+/// Kurzer Druck auf VFR stellt 7000 ein, langer Druck den vorher aktiven Code.
+static void testVfrShortAndLongPress() {
+    pressDigit(1);
+    pressDigit(2);
+    pressDigit(3);
+    HostHal::clearTransmitted();
+    pressDigit(4);
+    CHECK_STR("XPDR;CODE;1234\r\n", HostHal::transmitted());
+
+    // Kurzer Druck: erst beim Loslassen wird der VFR-Code eingestellt.
+    HostHal::clearTransmitted();
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_VFR, SWITCH_STATE_ON);
+    CHECK_STR("", HostHal::transmitted());
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_VFR, SWITCH_STATE_OFF);
+    CHECK_STR("XPDR;CODE;7000\r\n", HostHal::transmitted());
+
+    // Langer Druck: nur der gemerkte Code, kein VFR-Code davor oder beim Loslassen.
+    HostHal::clearTransmitted();
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_VFR, SWITCH_STATE_ON);
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_VFR, SWITCH_STATE_LONG_ON);
+    setSwitch(XPDR_SWITCH_ROW_FUNCTIONS, XPDR_SWITCH_VFR, SWITCH_STATE_OFF);
+    CHECK_STR("XPDR;CODE;1234\r\n", HostHal::transmitted());
+}
+
+
+/// Cols hinter der Taste 7 gehören nicht zum Transponder und ergeben keine Ziffer.
+static void testDigitColOutOfRange() {
+    HostHal::clearTransmitted();
+    CHECK(! xpdr.processSwitch(XPDR_SWITCH_ROW_DIGITS, XPDR_MAX_DIGIT + 1, SWITCH_STATE_ON));
+    pressDigit(0);
+    pressDigit(0);
+    pressDigit(0);
+    pressDigit(7);
+    CHECK_STR("XPDR;CODE;0007\r\n", HostHal::transmitted());
+}
+
+
+int main() {
+    testPowerOnEntersKnobMode();
+    testVfrShortAndLongPress();
+    testDigitColOutOfRange();
+    return checkResult("test_xpdr");
+}